@@ -0,0 +1,204 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file bench_concurrent_subscribe.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 会话线程并发 subscribe()/unsubscribe() 时的投递吞吐量测试程序：
+ *          std::mutex 保护的 xmsg_publisher_t 对比 xmsg_concurrent_publisher_t 。
+ *          用法：bench_concurrent_subscribe [最大会话线程数] [消息数]
+ * </pre>
+ */
+
+#include "../xmsg_pubsub.h"
+#include "../xmsg_mpsc_queue.h"
+#include "../xmsg_concurrent_publisher.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< size_t > >;
+using xclock_t    = std::chrono::steady_clock;
+
+/** 消息键的数量 */
+static const int XKEY_COUNT = 64;
+
+/** 每次加锁投递的消息数量 */
+static const size_t XLOCKED_BATCH = 256;
+
+/**
+ * @class xlocked_publisher_t
+ * @brief 作为对比基准：订阅操作 与 投递操作 使用同一个 std::mutex 互斥。
+ */
+class xlocked_publisher_t
+{
+public:
+    using x_publisher_t = xmsg_publisher_t< xmsg_ctxt_t, xmsg_mpsc_queue_t< xmsg_ctxt_t > >;
+    using x_subkey_t    = x_publisher_t::x_subkey_t;
+
+    template< typename __func_t >
+    x_subkey_t subscribe(int xmkey, __func_t && xfunc)
+    {
+        std::lock_guard< std::mutex > xlock(m_xmutex);
+        return m_xpublisher.subscribe(xmkey, std::forward< __func_t >(xfunc));
+    }
+
+    void unsubscribe(const x_subkey_t & xsub_key)
+    {
+        std::lock_guard< std::mutex > xlock(m_xmutex);
+        m_xpublisher.unsubscribe(xsub_key);
+    }
+
+    bool publish(int xmkey, size_t xvalue)
+    {
+        return m_xpublisher.publish(xmkey, xvalue);
+    }
+
+    size_t dispatch(void)
+    {
+        std::lock_guard< std::mutex > xlock(m_xmutex);
+        return m_xpublisher.dispatch(XLOCKED_BATCH);
+    }
+
+private:
+    std::mutex    m_xmutex;
+    x_publisher_t m_xpublisher;
+};
+
+/**
+ * @class xconcurrent_t
+ * @brief xmsg_concurrent_publisher_t（投递操作不加锁）。
+ */
+class xconcurrent_t : public xmsg_concurrent_publisher_t< xmsg_ctxt_t >
+{
+public:
+    size_t dispatch(void)
+    {
+        return xmsg_concurrent_publisher_t< xmsg_ctxt_t >::dispatch(XLOCKED_BATCH);
+    }
+};
+
+/**********************************************************/
+/**
+ * @brief 一个生产者线程发布 xmsg_count 条消息，投递线程投递，
+ *        同时 xsessions 个会话线程不断地订阅/取消订阅；
+ *        输出 每秒投递的消息数量 与 每秒的订阅操作数量。
+ */
+template< typename __publisher_t >
+void run_bench(size_t xsessions, size_t xmsg_count, double & xmsg_rate, double & xsub_rate)
+{
+    __publisher_t xpub;
+    size_t xsum = 0;
+    for (int xkey = 0; xkey < XKEY_COUNT; ++xkey)
+        xpub.subscribe(xkey, [&xsum](size_t xvalue) { xsum += xvalue; });
+
+    std::atomic< bool >   xdone(false);
+    std::atomic< size_t > xsub_ops(0);
+
+    std::vector< std::thread > xthreads;
+    for (size_t xiter = 0; xiter < xsessions; ++xiter)
+    {
+        xthreads.push_back(std::thread(
+            [&xpub, &xdone, &xsub_ops, xiter](void)
+            {
+                size_t xops = 0;
+                int xkey = static_cast< int >(xiter);
+                while (!xdone.load(std::memory_order_relaxed))
+                {
+                    xkey = (xkey + 1) % XKEY_COUNT;
+                    auto xsub_key = xpub.subscribe(xkey, [](size_t) { });
+                    xpub.unsubscribe(xsub_key);
+                    xops += 2;
+                }
+                xsub_ops += xops;
+            }));
+    }
+
+    xclock_t::time_point xtm_beg = xclock_t::now();
+
+    std::thread xproducer(
+        [&xpub, xmsg_count](void)
+        {
+            for (size_t xiter = 0; xiter < xmsg_count; ++xiter)
+                xpub.publish(static_cast< int >(xiter % XKEY_COUNT), xiter);
+        });
+
+    size_t xmsg_dispatched = 0;
+    while (xmsg_dispatched < xmsg_count)
+    {
+        size_t xcount = xpub.dispatch();
+        if (0 == xcount)
+            std::this_thread::yield();
+        xmsg_dispatched += xcount;
+    }
+
+    std::chrono::duration< double > xtm_cost = xclock_t::now() - xtm_beg;
+
+    xdone = true;
+    xproducer.join();
+    for (std::thread & xthread : xthreads)
+        xthread.join();
+
+    if (xsum != xmsg_count * (xmsg_count - 1) / 2)
+        std::printf("checksum mismatch!\n");
+
+    xmsg_rate = xmsg_count / xtm_cost.count();
+    xsub_rate = xsub_ops.load() / xtm_cost.count();
+}
+
+int main(int argc, char * argv[])
+{
+    size_t xmax_sessions = 4;
+    size_t xmsg_count    = 2000000;
+
+    if (argc > 1) xmax_sessions = std::strtoul(argv[1], nullptr, 10);
+    if (argc > 2) xmsg_count    = std::strtoul(argv[2], nullptr, 10);
+
+    std::printf("%-9s %16s %16s %16s %16s\n",
+                "sessions", "mutex(msg/s)", "mutex(sub/s)", "cow(msg/s)", "cow(sub/s)");
+
+    for (size_t xsessions = 0; xsessions <= xmax_sessions; ++xsessions)
+    {
+        double xlocked_msg = 0.0, xlocked_sub = 0.0;
+        double xcow_msg    = 0.0, xcow_sub    = 0.0;
+        run_bench< xlocked_publisher_t >(xsessions, xmsg_count, xlocked_msg, xlocked_sub);
+        run_bench< xconcurrent_t       >(xsessions, xmsg_count, xcow_msg, xcow_sub);
+
+        std::printf("%-9zu %16.0f %16.0f %16.0f %16.0f\n",
+                    xsessions, xlocked_msg, xlocked_sub, xcow_msg, xcow_sub);
+    }
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file bench_conflate.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 行情类（只关心最新值）突发发布的测试程序：
+ *          std::queue 对比 xmsg_conflate_queue_t ，
+ *          统计 每轮投递的耗时、订阅者的调用次数 以及 队列的最大深度。
+ *          用法：bench_conflate [消息键数量] [每轮每个消息键的更新次数] [轮数]
+ * </pre>
+ */
+
+#include "../xmsg_pubsub.h"
+#include "../xmsg_conflate_queue.h"
+
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< double, std::string > >;
+
+/**
+ * @struct xresult_t
+ * @brief 测试结果。
+ */
+struct xresult_t
+{
+    double xmsg_rate;  ///< 每秒 发布+投递 的消息数量
+    size_t xinvokes;   ///< 订阅者的调用次数
+    size_t xmax_depth; ///< 队列的最大深度
+};
+
+/**********************************************************/
+/**
+ * @brief 每轮对 xmkeys 个消息键各突发发布 xupdates 次更新，再执行 dispatch_batch()。
+ */
+template< typename __publisher_t >
+xresult_t run_bench(int xmkeys, size_t xupdates, size_t xrounds)
+{
+    __publisher_t xpub;
+    xresult_t xresult = { 0.0, 0, 0 };
+    double xsum = 0.0;
+
+    for (int xmkey = 0; xmkey < xmkeys; ++xmkey)
+    {
+        xpub.subscribe(xmkey,
+            [&xresult, &xsum](double xprice, const std::string & xsymbol)
+            {
+                xsum += xprice + static_cast< double >(xsymbol.size());
+                xresult.xinvokes += 1;
+            });
+    }
+
+    const std::string xsymbol = "SYMBOL-WITH-A-HEAP-ALLOCATED-NAME";
+
+    std::chrono::steady_clock::time_point xtm_beg =
+        std::chrono::steady_clock::now();
+
+    for (size_t xround = 0; xround < xrounds; ++xround)
+    {
+        for (size_t xupdate = 0; xupdate < xupdates; ++xupdate)
+            for (int xmkey = 0; xmkey < xmkeys; ++xmkey)
+                xpub.publish(xmkey, static_cast< double >(xupdate), xsymbol);
+
+        if (xpub.size() > xresult.xmax_depth)
+            xresult.xmax_depth = xpub.size();
+
+        xpub.dispatch_batch();
+    }
+
+    std::chrono::duration< double > xtm_cost =
+        std::chrono::steady_clock::now() - xtm_beg;
+
+    xresult.xmsg_rate = (xrounds * xupdates * xmkeys) / xtm_cost.count();
+    return xresult;
+}
+
+int main(int argc, char * argv[])
+{
+    int    xmkeys   = 1000;
+    size_t xupdates = 100;
+    size_t xrounds  = 20;
+
+    if (argc > 1) xmkeys   = std::atoi(argv[1]);
+    if (argc > 2) xupdates = std::strtoul(argv[2], nullptr, 10);
+    if (argc > 3) xrounds  = std::strtoul(argv[3], nullptr, 10);
+
+    using xpub_queue_t    = xmsg_publisher_t< xmsg_ctxt_t >;
+    using xpub_conflate_t = xmsg_publisher_t<
+                                    xmsg_ctxt_t,
+                                    xmsg_conflate_queue_t< xmsg_ctxt_t > >;
+
+    xresult_t xqueue    = run_bench< xpub_queue_t    >(xmkeys, xupdates, xrounds);
+    xresult_t xconflate = run_bench< xpub_conflate_t >(xmkeys, xupdates, xrounds);
+
+    std::printf("%-12s %18s %12s %12s\n", "queue", "msg/s", "invokes", "max depth");
+    std::printf("%-12s %18.0f %12zu %12zu\n", "std::queue",
+                xqueue.xmsg_rate, xqueue.xinvokes, xqueue.xmax_depth);
+    std::printf("%-12s %18.0f %12zu %12zu\n", "conflate",
+                xconflate.xmsg_rate, xconflate.xinvokes, xconflate.xmax_depth);
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file bench_fanout.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 单个消息键下 1/10/100/1000 个订阅者的投递（扇出）测试程序：
+ *          xmsg_subset_hash_t 对比 xmsg_subset_flat_t 。
+ *          用法：bench_fanout [每轮的订阅者调用总次数]
+ * </pre>
+ */
+
+#include "../xmsg_pubsub.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< size_t > >;
+
+/**
+ * @struct xcounter_t
+ * @brief 订阅者使用的仿函数（累加消息参数）。
+ */
+struct xcounter_t
+{
+    size_t * xsum;
+
+    void operator()(size_t xvalue) const
+    {
+        *xsum += xvalue;
+    }
+};
+
+/**********************************************************/
+/**
+ * @brief 在同一个消息键下订阅 xsubers 个订阅者，
+ *        返回每秒的订阅者调用次数。
+ */
+template< typename __publisher_t >
+double run_bench(size_t xsubers, size_t xinvk_count)
+{
+    __publisher_t xpub;
+    size_t xsum = 0;
+
+    for (size_t xiter = 0; xiter < xsubers; ++xiter)
+        xpub.subscribe(1, xcounter_t{ &xsum });
+
+    const size_t xmsg_count = (xinvk_count + xsubers - 1) / xsubers;
+    for (size_t xiter = 0; xiter < xmsg_count; ++xiter)
+        xpub.publish(1, xiter);
+
+    std::chrono::steady_clock::time_point xtm_beg =
+        std::chrono::steady_clock::now();
+
+    xpub.dispatch();
+
+    std::chrono::duration< double > xtm_cost =
+        std::chrono::steady_clock::now() - xtm_beg;
+
+    if (xsum != xsubers * (xmsg_count * (xmsg_count - 1) / 2))
+        std::printf("checksum mismatch!\n");
+
+    return (xmsg_count * xsubers) / xtm_cost.count();
+}
+
+int main(int argc, char * argv[])
+{
+    size_t xinvk_count = 10000000;
+    if (argc > 1) xinvk_count = std::strtoul(argv[1], nullptr, 10);
+
+    using xpub_hash_t = xmsg_publisher_t<
+                                xmsg_ctxt_t,
+                                std::queue< xmsg_ctxt_t >,
+                                xmsg_subset_hash_t >;
+    using xpub_flat_t = xmsg_publisher_t<
+                                xmsg_ctxt_t,
+                                std::queue< xmsg_ctxt_t >,
+                                xmsg_subset_flat_t >;
+
+    std::printf("%-12s %18s %18s %8s\n",
+                "subscribers", "hash(invk/s)", "flat(invk/s)", "ratio");
+
+    const size_t xsubers_list[] = { 1, 10, 100, 1000 };
+    for (size_t xsubers : xsubers_list)
+    {
+        double xhash = run_bench< xpub_hash_t >(xsubers, xinvk_count);
+        double xflat = run_bench< xpub_flat_t >(xsubers, xinvk_count);
+
+        std::printf("%-12zu %18.0f %18.0f %8.2f\n",
+                    xsubers, xhash, xflat, xflat / xhash);
+    }
+
+    return 0;
+}
@@ -0,0 +1,171 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file bench_invoke.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 订阅者调用开销的测试程序：分别以 普通函数、类成员函数、
+ *          lambda 表达式、自定义（虚函数）订阅者 订阅消息，
+ *          统计 dispatch() 每秒的订阅者调用次数。
+ *          用法：bench_invoke [每轮的订阅者调用总次数]
+ * </pre>
+ */
+
+#include "../xmsg_pubsub.h"
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< size_t > >;
+
+using xmsg_pub_t  = xmsg_publisher_t<
+                        xmsg_ctxt_t,
+                        std::queue< xmsg_ctxt_t >,
+                        xmsg_subset_flat_t >;
+
+/** 每个消息键下的订阅者数量 */
+static constexpr size_t XSUBERS = 100;
+
+/** 各个订阅者累加消息参数的目标变量 */
+static size_t g_xsum = 0;
+
+/**********************************************************/
+/**
+ * @brief 普通函数订阅者（附带一个绑定参数，用于体现绑定参数的拷贝开销）。
+ */
+static void xfunc_counter(const std::string & xname, size_t xvalue)
+{
+    g_xsum += xvalue + xname.size();
+}
+
+/**
+ * @struct xobject_t
+ * @brief 以类成员函数订阅消息的对象。
+ */
+struct xobject_t
+{
+    void on_value(size_t xvalue)
+    {
+        g_xsum += xvalue;
+    }
+};
+
+/**
+ * @class xvirtual_t
+ * @brief 自定义（重载虚函数 translate()）的订阅者。
+ */
+class xvirtual_t : public xmsg_subscriber_t< 1, xmsg_ctxt_t >
+{
+public:
+    virtual void translate(const xmsg_ctxt_t & xmsg_ctxt) override
+    {
+        g_xsum += std::get< 0 >(xmsg_ctxt.args());
+    }
+};
+
+/**********************************************************/
+/**
+ * @brief 以 xsubscribe 订阅 XSUBERS 个订阅者，投递消息后，
+ *        返回每秒的订阅者调用次数（同时累计校验和 xcheck）。
+ */
+template< typename __subscribe_t >
+double run_bench(size_t xinvk_count, size_t xcheck_unit, __subscribe_t xsubscribe)
+{
+    xmsg_pub_t xpub;
+    g_xsum = 0;
+
+    for (size_t xiter = 0; xiter < XSUBERS; ++xiter)
+        xsubscribe(xpub);
+
+    const size_t xmsg_count = (xinvk_count + XSUBERS - 1) / XSUBERS;
+    for (size_t xiter = 0; xiter < xmsg_count; ++xiter)
+        xpub.publish(1, xiter);
+
+    std::chrono::steady_clock::time_point xtm_beg =
+        std::chrono::steady_clock::now();
+
+    xpub.dispatch();
+
+    std::chrono::duration< double > xtm_cost =
+        std::chrono::steady_clock::now() - xtm_beg;
+
+    if (g_xsum != XSUBERS * (xmsg_count * (xmsg_count - 1) / 2 +
+                             xmsg_count * xcheck_unit))
+        std::printf("checksum mismatch!\n");
+
+    return (xmsg_count * XSUBERS) / xtm_cost.count();
+}
+
+int main(int argc, char * argv[])
+{
+    size_t xinvk_count = 10000000;
+    if (argc > 1) xinvk_count = std::strtoul(argv[1], nullptr, 10);
+
+    const std::string xname = "a bound argument longer than SSO buffer";
+    xobject_t xobject;
+    std::vector< xvirtual_t > xvirtuals(XSUBERS);
+    size_t xvindex = 0;
+
+    std::printf("%-12s %18s\n", "subscriber", "invk/s");
+
+    std::printf("%-12s %18.0f\n", "function",
+        run_bench(xinvk_count, xname.size(),
+            [&xname](xmsg_pub_t & xpub)
+            {
+                xpub.subscribe(1, &xfunc_counter, xname);
+            }));
+
+    std::printf("%-12s %18.0f\n", "member",
+        run_bench(xinvk_count, 0,
+            [&xobject](xmsg_pub_t & xpub)
+            {
+                xpub.subscribe(1, &xobject_t::on_value, &xobject);
+            }));
+
+    std::printf("%-12s %18.0f\n", "lambda",
+        run_bench(xinvk_count, 0,
+            [](xmsg_pub_t & xpub)
+            {
+                xpub.subscribe(1, [](size_t xvalue) { g_xsum += xvalue; });
+            }));
+
+    std::printf("%-12s %18.0f\n", "virtual",
+        run_bench(xinvk_count, 0,
+            [&xvirtuals, &xvindex](xmsg_pub_t & xpub)
+            {
+                xpub.subscribe(1, static_cast< xmsg_pub_t::x_subscriber_t * >(
+                                        &xvirtuals[xvindex++]));
+            }));
+
+    return 0;
+}
@@ -0,0 +1,179 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file bench_journal.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 消息日志 xmsg_journal_t 的测试程序：
+ *          追加吞吐量（每条消息提交 对比 组提交）、启动时的扫描 与 回放带宽。
+ *          用法：bench_journal [日志目录] [消息数] [每批提交的消息数] [参数字节数]
+ * </pre>
+ */
+
+#include "../xmsg_pubsub.h"
+#include "../xmsg_journal.h"
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include <dirent.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< uint64_t, std::string > >;
+using xjournal_t  = xmsg_journal_t< xmsg_ctxt_t >;
+using xclock_t    = std::chrono::steady_clock;
+
+/**********************************************************/
+/**
+ * @brief 删除日志目录中的分段文件。
+ */
+static void clear_dir(const std::string & xpath)
+{
+    DIR * xdir = ::opendir(xpath.c_str());
+    if (nullptr == xdir)
+        return;
+
+    while (struct dirent * xent = ::readdir(xdir))
+    {
+        if ('.' != xent->d_name[0])
+            ::unlink((xpath + "/" + xent->d_name).c_str());
+    }
+    ::closedir(xdir);
+}
+
+static inline double seconds_since(xclock_t::time_point xtm_beg)
+{
+    return std::chrono::duration< double >(xclock_t::now() - xtm_beg).count();
+}
+
+/**********************************************************/
+/**
+ * @brief 追加 xmsg_count 条消息，每 xbatch 条提交一次。
+ * 
+ * @return double : 每秒追加的消息数量。
+ */
+static double run_append(const std::string & xpath,
+                         size_t xmsg_count,
+                         size_t xbatch,
+                         size_t xbytes,
+                         size_t & xjournal_bytes)
+{
+    clear_dir(xpath);
+
+    xjournal_t xjournal;
+    xjournal.open(xpath);
+
+    const std::string xtext(xbytes, 'j');
+    const xclock_t::time_point xtm_beg = xclock_t::now();
+
+    for (size_t xiter = 0; xiter < xmsg_count; ++xiter)
+    {
+        xjournal.append(xmsg_ctxt_t(static_cast< int >(xiter & 63),
+                                    static_cast< uint64_t >(xiter),
+                                    xtext));
+        if (0 == ((xiter + 1) % xbatch))
+            xjournal.commit();
+    }
+    xjournal.commit();
+
+    const double xcost = seconds_since(xtm_beg);
+    xjournal_bytes = xmsg_count * (sizeof(xjournal_t::x_entry_t) +
+                                   xmsg_codec_t< xmsg_ctxt_t >::encoded_size(
+                                       xmsg_ctxt_t(0, static_cast< uint64_t >(0), xtext)));
+    return xmsg_count / xcost;
+}
+
+int main(int argc, char * argv[])
+{
+    const char * xtmp = std::getenv("TMPDIR");
+    std::string  xpath      = std::string((nullptr != xtmp) ? xtmp : "/tmp") + "/xmsg_bench_journal";
+    size_t       xmsg_count = 2000000;
+    size_t       xbatch     = 1024;
+    size_t       xbytes     = 100;
+
+    if (argc > 1) xpath      = argv[1];
+    if (argc > 2) xmsg_count = std::strtoul(argv[2], nullptr, 10);
+    if (argc > 3) xbatch     = std::strtoul(argv[3], nullptr, 10);
+    if (argc > 4) xbytes     = std::strtoul(argv[4], nullptr, 10);
+
+    size_t xjournal_bytes = 0;
+
+    // 每条消息提交一次（消息数量减少，避免耗时过长）
+    const size_t xsync_count = std::max< size_t >(xmsg_count / 100, 1);
+    const double xsync_rate  = run_append(xpath, xsync_count, 1, xbytes, xjournal_bytes);
+    const double xgroup_rate = run_append(xpath, xmsg_count, xbatch, xbytes, xjournal_bytes);
+
+    std::printf("journal: %s, %zu bytes/msg\n",
+                xpath.c_str(), xjournal_bytes / xmsg_count);
+    std::printf("%-28s %14.0f msg/s\n", "append, commit every msg", xsync_rate);
+    std::printf("%-28s %14.0f msg/s  (batch = %zu)\n", "append, group commit", xgroup_rate, xbatch);
+
+    // 启动：扫描分段文件（校验 + 重建索引）
+    xjournal_t xjournal;
+    xclock_t::time_point xtm_beg = xclock_t::now();
+    xjournal.open(xpath);
+    double xcost = seconds_since(xtm_beg);
+    std::printf("%-28s %14.0f msg/s  %8.1f MB/s\n", "open (scan + index)",
+                xjournal.next_offset() / xcost, xjournal_bytes / xcost / 1e6);
+
+    // 顺序回放：原地读取
+    uint64_t xsum = 0;
+    xtm_beg = xclock_t::now();
+    xjournal.replay(0, UINT64_MAX, [&xsum](uint64_t, const xjournal_t::x_view_t & xview)
+    {
+        xsum += xview.get< 0 >() + xview.get< 1 >().size();
+        return true;
+    });
+    xcost = seconds_since(xtm_beg);
+    std::printf("%-28s %14.0f msg/s  %8.1f MB/s\n", "replay (view)",
+                xmsg_count / xcost, xjournal_bytes / xcost / 1e6);
+
+    // 顺序回放：解码为消息对象
+    xtm_beg = xclock_t::now();
+    xjournal.replay(0, UINT64_MAX, [&xsum](uint64_t, const xjournal_t::x_view_t & xview)
+    {
+        xmsg_ctxt_t xctxt = xmsg_codec_t< xmsg_ctxt_t >::decode(xview.data());
+        xsum += std::get< 0 >(xctxt.args()) + std::get< 1 >(xctxt.args()).size();
+        return true;
+    });
+    xcost = seconds_since(xtm_beg);
+    std::printf("%-28s %14.0f msg/s  %8.1f MB/s\n", "replay (decode)",
+                xmsg_count / xcost, xjournal_bytes / xcost / 1e6);
+
+    xjournal.close();
+    clear_dir(xpath);
+    ::rmdir(xpath.c_str());
+
+    return (0 == xsum) ? 1 : 0;
+}
@@ -0,0 +1,193 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file bench_lanes.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 大量普通消息积压时，控制消息的投递延迟测试程序：
+ *          std::queue（单一 FIFO）对比 xmsg_lane_queue_t（严格优先级/加权轮转）。
+ *          延迟以 控制消息之前被投递的普通消息数量 以及 微秒数 衡量
+ *          （微秒数从 发布 与 开始投递 两者中较晚的时刻起算）。
+ *          用法：bench_lanes [普通消息数量] [每隔多少个普通消息发布一个控制消息]
+ * </pre>
+ */
+
+#include "../xmsg_pubsub.h"
+#include "../xmsg_lane_queue.h"
+
+#include <queue>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xclock_t = std::chrono::steady_clock;
+
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< size_t, xclock_t::time_point > >;
+
+/** 普通消息 与 控制消息 的消息键 */
+enum { XKEY_BULK = 1, XKEY_CONTROL = 2 };
+
+/**
+ * @struct xresult_t
+ * @brief 控制消息延迟的统计结果。
+ */
+struct xresult_t
+{
+    size_t xp50_ahead; ///< 控制消息之前投递的普通消息数量（P50）
+    size_t xp99_ahead; ///< 控制消息之前投递的普通消息数量（P99）
+    double xp50_usec;  ///< 控制消息从发布到投递的耗时（P50，微秒）
+    double xp99_usec;  ///< 控制消息从发布到投递的耗时（P99，微秒）
+};
+
+/**********************************************************/
+/**
+ * @brief 返回有序数组 xvec 的 xpct 分位值。
+ */
+template< typename __value_t >
+__value_t percentile(const std::vector< __value_t > & xvec, double xpct)
+{
+    if (xvec.empty())
+        return __value_t();
+    size_t xindex = static_cast< size_t >(xpct * (xvec.size() - 1));
+    return xvec[xindex];
+}
+
+/**********************************************************/
+/**
+ * @brief 先积压 xbulk_count 个普通消息，每隔 xinterval 个普通消息
+ *        插入一个控制消息（使用 xpublish_control 发布），
+ *        再一次性 dispatch()，统计控制消息的投递延迟。
+ */
+template< typename __publisher_t, typename __control_t >
+xresult_t run_bench(size_t xbulk_count,
+                    size_t xinterval,
+                    __control_t xpublish_control)
+{
+    __publisher_t xpub;
+
+    size_t xdispatched = 0;
+    xclock_t::time_point xtm_dispatch;
+    std::vector< size_t > xahead;
+    std::vector< double > xusec;
+
+    // 消息参数为 发布序号 与 发布时刻
+    xpub.subscribe(XKEY_BULK,
+        [&xdispatched](size_t, xclock_t::time_point)
+        {
+            xdispatched += 1;
+        });
+    xpub.subscribe(XKEY_CONTROL,
+        [&xdispatched, &xahead, &xusec, &xtm_dispatch](
+            size_t, xclock_t::time_point xtm_pub)
+        {
+            // 消息积压期间尚未开始投递，从 发布 与 开始投递 两者中较晚的时刻起算
+            std::chrono::duration< double, std::micro > xcost =
+                xclock_t::now() - std::max(xtm_pub, xtm_dispatch);
+            xahead.push_back(xdispatched);
+            xusec.push_back(xcost.count());
+        });
+
+    for (size_t xiter = 0; xiter < xbulk_count; ++xiter)
+    {
+        xpub.publish(XKEY_BULK, xiter, xclock_t::now());
+        if (0 == ((xiter + 1) % xinterval))
+            xpublish_control(xpub, xiter + 1);
+    }
+
+    xtm_dispatch = xclock_t::now();
+    xpub.dispatch();
+
+    std::sort(xahead.begin(), xahead.end());
+    std::sort(xusec.begin(), xusec.end());
+
+    xresult_t xresult;
+    xresult.xp50_ahead = percentile(xahead, 0.50);
+    xresult.xp99_ahead = percentile(xahead, 0.99);
+    xresult.xp50_usec  = percentile(xusec, 0.50);
+    xresult.xp99_usec  = percentile(xusec, 0.99);
+    return xresult;
+}
+
+int main(int argc, char * argv[])
+{
+    size_t xbulk_count = 100000;
+    size_t xinterval   = 1000;
+
+    if (argc > 1) xbulk_count = std::strtoul(argv[1], nullptr, 10);
+    if (argc > 2) xinterval   = std::strtoul(argv[2], nullptr, 10);
+    if (0 == xinterval) xinterval = 1;
+
+    using xpub_fifo_t     = xmsg_publisher_t<
+                                xmsg_ctxt_t,
+                                std::queue< xmsg_ctxt_t > >;
+    using xpub_strict_t   = xmsg_publisher_t<
+                                xmsg_ctxt_t,
+                                xmsg_lane_queue_t< xmsg_ctxt_t, 2, XLANE_STRICT > >;
+    using xpub_weighted_t = xmsg_publisher_t<
+                                xmsg_ctxt_t,
+                                xmsg_lane_queue_t< xmsg_ctxt_t, 2, XLANE_WEIGHTED > >;
+
+    xresult_t xresults[3];
+    xresults[0] = run_bench< xpub_fifo_t >(xbulk_count, xinterval,
+        [](xpub_fifo_t & xpub, size_t xseen)
+        {
+            xpub.publish(XKEY_CONTROL, xseen, xclock_t::now());
+        });
+    xresults[1] = run_bench< xpub_strict_t >(xbulk_count, xinterval,
+        [](xpub_strict_t & xpub, size_t xseen)
+        {
+            xpub.publish(xmsg_prio_t(0), XKEY_CONTROL, xseen, xclock_t::now());
+        });
+    xresults[2] = run_bench< xpub_weighted_t >(xbulk_count, xinterval,
+        [](xpub_weighted_t & xpub, size_t xseen)
+        {
+            xpub.publish(xmsg_prio_t(0), XKEY_CONTROL, xseen, xclock_t::now());
+        });
+
+    const char * xnames[3] = { "fifo", "lanes(strict)", "lanes(weighted)" };
+
+    std::printf("bulk = %zu, control every %zu bulk messages\n",
+                xbulk_count, xinterval);
+    std::printf("%-16s %12s %12s %12s %12s\n",
+                "queue", "p50(ahead)", "p99(ahead)", "p50(us)", "p99(us)");
+    for (size_t xiter = 0; xiter < 3; ++xiter)
+    {
+        std::printf("%-16s %12zu %12zu %12.1f %12.1f\n",
+                    xnames[xiter],
+                    xresults[xiter].xp50_ahead,
+                    xresults[xiter].xp99_ahead,
+                    xresults[xiter].xp50_usec,
+                    xresults[xiter].xp99_usec);
+    }
+
+    return 0;
+}
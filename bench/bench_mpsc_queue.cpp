@@ -0,0 +1,190 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file bench_mpsc_queue.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 多生产者并发 publish() 的竞争测试程序：
+ *          xmsg_mpsc_queue_t 对比 std::mutex + std::queue 。
+ *          用法：bench_mpsc_queue [最大生产者线程数] [每个线程的消息数]
+ * </pre>
+ */
+
+#include "../xmsg_pubsub.h"
+#include "../xmsg_mpsc_queue.h"
+
+#include <queue>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< size_t > >;
+
+/**
+ * @class xlocked_queue_t< __value_t >
+ * @brief 作为对比基准：使用 std::mutex 保护的 std::queue 。
+ */
+template< typename __value_t >
+class xlocked_queue_t
+{
+public:
+    typedef __value_t value_type;
+
+    size_t size(void) const
+    {
+        std::lock_guard< std::mutex > xlock(m_xmutex);
+        return m_xqueue.size();
+    }
+
+    bool empty(void) const
+    {
+        std::lock_guard< std::mutex > xlock(m_xmutex);
+        return m_xqueue.empty();
+    }
+
+    void push(value_type && xvalue)
+    {
+        std::lock_guard< std::mutex > xlock(m_xmutex);
+        m_xqueue.push(std::move(xvalue));
+    }
+
+    void push(const value_type & xvalue)
+    {
+        std::lock_guard< std::mutex > xlock(m_xmutex);
+        m_xqueue.push(xvalue);
+    }
+
+    template< typename... __args_t >
+    void emplace(__args_t &&... xargs)
+    {
+        std::lock_guard< std::mutex > xlock(m_xmutex);
+        m_xqueue.emplace(std::forward< __args_t >(xargs)...);
+    }
+
+    value_type & front(void)
+    {
+        std::lock_guard< std::mutex > xlock(m_xmutex);
+        return m_xqueue.front();
+    }
+
+    void pop(void)
+    {
+        std::lock_guard< std::mutex > xlock(m_xmutex);
+        m_xqueue.pop();
+    }
+
+private:
+    mutable std::mutex      m_xmutex;
+    std::queue< value_type > m_xqueue;
+};
+
+/**********************************************************/
+/**
+ * @brief 使用 xproducers 个生产者线程并发发布消息，
+ *        单个投递线程执行 dispatch()，返回每秒投递的消息数量。
+ */
+template< typename __publisher_t >
+double run_bench(size_t xproducers, size_t xmsg_count)
+{
+    __publisher_t xpub;
+    size_t xsum = 0;
+    xpub.subscribe(1, [&xsum](size_t xvalue) { xsum += xvalue; });
+
+    const size_t xmsg_total = xproducers * xmsg_count;
+    size_t xmsg_dispatched = 0;
+
+    std::chrono::steady_clock::time_point xtm_beg =
+        std::chrono::steady_clock::now();
+
+    std::vector< std::thread > xthreads;
+    for (size_t xiter = 0; xiter < xproducers; ++xiter)
+    {
+        xthreads.push_back(std::thread(
+            [&xpub, xmsg_count](void)
+            {
+                for (size_t xiter = 0; xiter < xmsg_count; ++xiter)
+                    xpub.publish(1, xiter);
+            }));
+    }
+
+    while (xmsg_dispatched < xmsg_total)
+    {
+        size_t xcount = xpub.dispatch();
+        if (0 == xcount)
+            std::this_thread::yield();
+        xmsg_dispatched += xcount;
+    }
+
+    for (std::thread & xthread : xthreads)
+        xthread.join();
+
+    std::chrono::duration< double > xtm_cost =
+        std::chrono::steady_clock::now() - xtm_beg;
+
+    if (xsum != xproducers * (xmsg_count * (xmsg_count - 1) / 2))
+        std::printf("checksum mismatch!\n");
+
+    return xmsg_total / xtm_cost.count();
+}
+
+int main(int argc, char * argv[])
+{
+    size_t xmax_producers = std::thread::hardware_concurrency();
+    if (xmax_producers < 4)
+        xmax_producers = 4;
+    size_t xmsg_count = 200000;
+
+    if (argc > 1) xmax_producers = std::strtoul(argv[1], nullptr, 10);
+    if (argc > 2) xmsg_count     = std::strtoul(argv[2], nullptr, 10);
+
+    using xpub_mpsc_t   = xmsg_publisher_t<
+                                xmsg_ctxt_t,
+                                xmsg_mpsc_queue_t< xmsg_ctxt_t > >;
+    using xpub_locked_t = xmsg_publisher_t<
+                                xmsg_ctxt_t,
+                                xlocked_queue_t< xmsg_ctxt_t > >;
+
+    std::printf("%-10s %18s %18s %8s\n",
+                "producers", "mutex+queue(msg/s)", "mpsc_queue(msg/s)", "ratio");
+
+    for (size_t xproducers = 1; xproducers <= xmax_producers; ++xproducers)
+    {
+        double xlocked = run_bench< xpub_locked_t >(xproducers, xmsg_count);
+        double xmpsc   = run_bench< xpub_mpsc_t   >(xproducers, xmsg_count);
+
+        std::printf("%-10zu %18.0f %18.0f %8.2f\n",
+                    xproducers, xlocked, xmpsc, xmpsc / xlocked);
+    }
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file bench_parallel.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 多个消息键下的并行投递测试程序：
+ *          dispatch_batch()（单线程）对比 dispatch_parallel()（1..N 个线程），
+ *          订阅者的消息处理接口以忙等待模拟固定的处理耗时。
+ *          用法：bench_parallel [最大线程数] [消息数量] [每个消息的处理耗时(ns)]
+ * </pre>
+ */
+
+#include "../xmsg_pubsub.h"
+#include "../xmsg_dispatch_pool.h"
+
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< size_t > >;
+
+using xmsg_pub_t  = xmsg_publisher_t< xmsg_ctxt_t >;
+
+using xclock_t    = std::chrono::steady_clock;
+
+/** 消息键的数量 */
+static constexpr int XMKEYS = 256;
+
+/**********************************************************/
+/**
+ * @brief 忙等待 xwork_ns 纳秒（模拟订阅者的处理耗时）。
+ */
+static void busy_work(size_t xwork_ns)
+{
+    xclock_t::time_point xtm_end =
+        xclock_t::now() + std::chrono::nanoseconds(xwork_ns);
+    while (xclock_t::now() < xtm_end)
+    {
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 在 XMKEYS 个消息键下各订阅一个订阅者，发布 xmsg_count 个消息，
+ *        xthreads 为 0 时使用 dispatch_batch() 投递，否则使用
+ *        dispatch_parallel() 投递；返回每秒投递的消息数量。
+ */
+double run_bench(size_t xthreads, size_t xmsg_count, size_t xwork_ns)
+{
+    xmsg_pub_t xpub;
+    std::vector< size_t > xlast(XMKEYS, 0);
+    size_t xorder_err = 0;
+
+    for (int xmkey = 0; xmkey < XMKEYS; ++xmkey)
+    {
+        size_t * xlast_ptr = &xlast[xmkey];
+        xpub.subscribe(xmkey,
+            [xlast_ptr, &xorder_err, xwork_ns](size_t xvalue)
+            {
+                // 同一个消息键下的消息须按发布顺序投递
+                if (xvalue < *xlast_ptr)
+                    xorder_err += 1;
+                *xlast_ptr = xvalue;
+                busy_work(xwork_ns);
+            });
+    }
+
+    for (size_t xiter = 0; xiter < xmsg_count; ++xiter)
+        xpub.publish(static_cast< int >(xiter % XMKEYS), xiter);
+
+    xmsg_dispatch_pool_t xpool((0 == xthreads) ? 1 : xthreads);
+
+    xclock_t::time_point xtm_beg = xclock_t::now();
+
+    if (0 == xthreads)
+        xpub.dispatch_batch();
+    else
+        xpub.dispatch_parallel(xpool);
+
+    std::chrono::duration< double > xtm_cost = xclock_t::now() - xtm_beg;
+
+    if (0 != xorder_err)
+        std::printf("per-key order violated!\n");
+
+    return xmsg_count / xtm_cost.count();
+}
+
+int main(int argc, char * argv[])
+{
+    size_t xmax_threads = std::thread::hardware_concurrency();
+    if (xmax_threads < 4)
+        xmax_threads = 4;
+    size_t xmsg_count = 200000;
+    size_t xwork_ns   = 1000;
+
+    if (argc > 1) xmax_threads = std::strtoul(argv[1], nullptr, 10);
+    if (argc > 2) xmsg_count   = std::strtoul(argv[2], nullptr, 10);
+    if (argc > 3) xwork_ns     = std::strtoul(argv[3], nullptr, 10);
+
+    double xbatch = run_bench(0, xmsg_count, xwork_ns);
+
+    std::printf("%-10s %18s %8s\n", "threads", "msg/s", "speedup");
+    std::printf("%-10s %18.0f %8.2f\n", "batch", xbatch, 1.0);
+
+    for (size_t xthreads = 1; xthreads <= xmax_threads; xthreads *= 2)
+    {
+        double xparallel = run_bench(xthreads, xmsg_count, xwork_ns);
+        std::printf("%-10zu %18.0f %8.2f\n",
+                    xthreads, xparallel, xparallel / xbatch);
+    }
+
+    return 0;
+}
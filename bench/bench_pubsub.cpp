@@ -0,0 +1,494 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file bench_pubsub.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : xmsg_publisher_t 的 Google Benchmark 测试集：
+ *          publish 吞吐量、不同扇出下的 dispatch 吞吐量、订阅/注销开销、
+ *          投递过程中注销的开销、多消息键的查找开销、
+ *          同一份参数发布到多个消息键（深拷贝 对比 共享参数）、
+ *          消息参数从堆 或 内存区（xmsg_arena_queue_t）中分配。
+ *          用法：bench_pubsub --benchmark_out=result.json --benchmark_out_format=json
+ *          （或在构建目录中执行 bench_json 目标）
+ * </pre>
+ */
+
+#include "../xmsg_pubsub.h"
+#include "../xmsg_payload.h"
+#include "../xmsg_arena.h"
+#include "../xmsg_hetero_publisher.h"
+#include "../xmsg_codec.h"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< size_t > >;
+
+using xpub_hash_t = xmsg_publisher_t< xmsg_ctxt_t,
+                                      std::queue< xmsg_ctxt_t >,
+                                      xmsg_subset_hash_t >;
+using xpub_flat_t = xmsg_publisher_t< xmsg_ctxt_t,
+                                      std::queue< xmsg_ctxt_t >,
+                                      xmsg_subset_flat_t >;
+
+/** 每次迭代发布/投递的消息数量（摊薄 dispatch() 调用本身的开销） */
+static constexpr size_t XMSG_BATCH = 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**********************************************************/
+/**
+ * @brief publish() 吞吐量（仅入队，每批消息之后在计时之外清空队列）。
+ */
+template< typename __publisher_t >
+static void BM_publish(benchmark::State & xstate)
+{
+    __publisher_t xpub;
+    size_t xsum = 0;
+    xpub.subscribe(1, [&xsum](size_t xvalue) { xsum += xvalue; });
+
+    for (auto _ : xstate)
+    {
+        for (size_t xiter = 0; xiter < XMSG_BATCH; ++xiter)
+            xpub.publish(1, xiter);
+
+        xstate.PauseTiming();
+        xpub.dispatch();
+        xstate.ResumeTiming();
+    }
+
+    benchmark::DoNotOptimize(xsum);
+    xstate.SetItemsProcessed(xstate.iterations() * XMSG_BATCH);
+}
+
+BENCHMARK_TEMPLATE(BM_publish, xpub_hash_t);
+BENCHMARK_TEMPLATE(BM_publish, xpub_flat_t);
+
+/**********************************************************/
+/**
+ * @brief publish() + dispatch() 的端到端吞吐量，扇出（订阅者数量）为 range(0)。
+ * @note items_processed 统计的是订阅者回调的调用次数。
+ */
+template< typename __publisher_t >
+static void BM_dispatch_fanout(benchmark::State & xstate)
+{
+    const size_t xfanout = static_cast< size_t >(xstate.range(0));
+
+    __publisher_t xpub;
+    size_t xsum = 0;
+    for (size_t xiter = 0; xiter < xfanout; ++xiter)
+        xpub.subscribe(1, [&xsum](size_t xvalue) { xsum += xvalue; });
+
+    const size_t xmsg_count = (XMSG_BATCH / xfanout) + 1;
+
+    for (auto _ : xstate)
+    {
+        for (size_t xiter = 0; xiter < xmsg_count; ++xiter)
+            xpub.publish(1, xiter);
+        xpub.dispatch();
+    }
+
+    benchmark::DoNotOptimize(xsum);
+    xstate.SetItemsProcessed(xstate.iterations() * xmsg_count * xfanout);
+}
+
+BENCHMARK_TEMPLATE(BM_dispatch_fanout, xpub_hash_t)->RangeMultiplier(10)->Range(1, 1000);
+BENCHMARK_TEMPLATE(BM_dispatch_fanout, xpub_flat_t)->RangeMultiplier(10)->Range(1, 1000);
+
+/**********************************************************/
+/**
+ * @brief 在已有 range(0) 个订阅者的消息键上，反复 订阅/注销 一个订阅者。
+ */
+template< typename __publisher_t >
+static void BM_subscribe_churn(benchmark::State & xstate)
+{
+    __publisher_t xpub;
+    for (int64_t xiter = 0; xiter < xstate.range(0); ++xiter)
+        xpub.subscribe(1, [](size_t) { });
+
+    for (auto _ : xstate)
+    {
+        auto xsub_key = xpub.subscribe(1, [](size_t) { });
+        xpub.unsubscribe(xsub_key);
+    }
+
+    xstate.SetItemsProcessed(xstate.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_subscribe_churn, xpub_hash_t)->Arg(0)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_subscribe_churn, xpub_flat_t)->Arg(0)->Arg(100)->Arg(1000);
+
+/**********************************************************/
+/**
+ * @brief 投递过程中注销订阅者的开销：range(0) 个订阅者在收到消息后注销自身，
+ *        每次迭代都重新订阅并投递一条消息。
+ */
+template< typename __publisher_t >
+static void BM_unsubscribe_in_dispatch(benchmark::State & xstate)
+{
+    using x_subkey_t = typename __publisher_t::x_subkey_t;
+
+    const size_t xfanout = static_cast< size_t >(xstate.range(0));
+
+    __publisher_t xpub;
+    std::vector< x_subkey_t > xkeys(xfanout);
+
+    for (auto _ : xstate)
+    {
+        xstate.PauseTiming();
+        for (size_t xiter = 0; xiter < xfanout; ++xiter)
+        {
+            xkeys[xiter] = xpub.subscribe(1, [&xpub, &xkeys, xiter](size_t)
+            {
+                xpub.unsubscribe(xkeys[xiter]);
+            });
+        }
+        xpub.publish(1, 0);
+        xstate.ResumeTiming();
+
+        xpub.dispatch();
+    }
+
+    xstate.SetItemsProcessed(xstate.iterations() * xfanout);
+}
+
+BENCHMARK_TEMPLATE(BM_unsubscribe_in_dispatch, xpub_hash_t)->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK_TEMPLATE(BM_unsubscribe_in_dispatch, xpub_flat_t)->Arg(1)->Arg(10)->Arg(100);
+
+/**********************************************************/
+/**
+ * @brief 多消息键的查找开销：共 range(0) 个消息键（每个一个订阅者），
+ *        依次向所有消息键发布消息并投递。
+ */
+template< typename __publisher_t >
+static void BM_multi_key(benchmark::State & xstate)
+{
+    const int xkeys = static_cast< int >(xstate.range(0));
+
+    __publisher_t xpub;
+    size_t xsum = 0;
+    for (int xkey = 0; xkey < xkeys; ++xkey)
+        xpub.subscribe(xkey * 7919, [&xsum](size_t xvalue) { xsum += xvalue; });
+
+    size_t xmsg_count = 0;
+    for (auto _ : xstate)
+    {
+        for (size_t xiter = 0; xiter < XMSG_BATCH; ++xiter)
+            xpub.publish(static_cast< int >((xmsg_count + xiter) % xkeys) * 7919, xiter);
+        xpub.dispatch();
+        xmsg_count += XMSG_BATCH;
+    }
+
+    benchmark::DoNotOptimize(xsum);
+    xstate.SetItemsProcessed(xstate.iterations() * XMSG_BATCH);
+}
+
+BENCHMARK_TEMPLATE(BM_multi_key, xpub_hash_t)->RangeMultiplier(10)->Range(1, 10000);
+BENCHMARK_TEMPLATE(BM_multi_key, xpub_flat_t)->RangeMultiplier(10)->Range(1, 10000);
+
+using xpub_static_t = xmsg_publisher_t< xmsg_ctxt_t,
+                                        std::queue< xmsg_ctxt_t >,
+                                        xmsg_subset_flat_t,
+                                        xmsg_submap_static_t< 64 >::x_submap_t >;
+
+/**********************************************************/
+/**
+ * @brief 在 range(0) 个 从 0 开始连续编号的消息键（如 静态主题）上
+ *        轮流 publish() + dispatch() 的吞吐量。
+ */
+template< typename __publisher_t >
+static void BM_static_keys(benchmark::State & xstate)
+{
+    const int xkeys = static_cast< int >(xstate.range(0));
+
+    __publisher_t xpub;
+    size_t xsum = 0;
+    for (int xkey = 0; xkey < xkeys; ++xkey)
+        xpub.subscribe(xkey, [&xsum](size_t xvalue) { xsum += xvalue; });
+
+    size_t xmsg_count = 0;
+    for (auto _ : xstate)
+    {
+        for (size_t xiter = 0; xiter < XMSG_BATCH; ++xiter)
+            xpub.publish(static_cast< int >((xmsg_count + xiter) % xkeys), xiter);
+        xpub.dispatch();
+        xmsg_count += XMSG_BATCH;
+    }
+
+    benchmark::DoNotOptimize(xsum);
+    xstate.SetItemsProcessed(xstate.iterations() * XMSG_BATCH);
+}
+
+BENCHMARK_TEMPLATE(BM_static_keys, xpub_hash_t  )->Arg(4)->Arg(64);
+BENCHMARK_TEMPLATE(BM_static_keys, xpub_flat_t  )->Arg(4)->Arg(64);
+BENCHMARK_TEMPLATE(BM_static_keys, xpub_static_t)->Arg(4)->Arg(64);
+
+/**********************************************************/
+/**
+ * @brief 同一份 range(1) 字节的参数发布到 range(0) 个消息键并投递：
+ *        __shared 为 false 时，每次发布都深拷贝参数；
+ *        否则使用 xmsg_shared_args_t（XREFCNT_SINGLE），每次只增加引用计数。
+ */
+template< bool __shared >
+static void BM_publish_payload(benchmark::State & xstate)
+{
+    using x_args_t = xmsg_args_t< std::string >;
+    using x_ctxt_t = typename std::conditional<
+                        __shared,
+                        xmsg_context_t< xmsg_mkey_t< int >,
+                                        xmsg_shared_args_t< x_args_t, XREFCNT_SINGLE > >,
+                        xmsg_context_t< xmsg_mkey_t< int >, x_args_t > >::type;
+
+    const int xkeys = static_cast< int >(xstate.range(0));
+
+    xmsg_publisher_t< x_ctxt_t > xpub;
+    size_t xsum = 0;
+    for (int xkey = 0; xkey < xkeys; ++xkey)
+        xpub.subscribe(xkey, [&xsum](const std::string & xtext) { xsum += xtext.size(); });
+
+    const typename x_ctxt_t::x_payload_t xpayload(
+        std::string(static_cast< size_t >(xstate.range(1)), 'p'));
+
+    for (auto _ : xstate)
+    {
+        for (int xkey = 0; xkey < xkeys; ++xkey)
+            xpub.publish(xkey, xpayload);
+        xpub.dispatch();
+    }
+
+    benchmark::DoNotOptimize(xsum);
+    xstate.SetItemsProcessed(xstate.iterations() * xkeys);
+}
+
+BENCHMARK_TEMPLATE(BM_publish_payload, false)->ArgsProduct({ { 1, 16, 256 }, { 64, 4096 } });
+BENCHMARK_TEMPLATE(BM_publish_payload, true )->ArgsProduct({ { 1, 16, 256 }, { 64, 4096 } });
+
+/**********************************************************/
+/**
+ * @brief 消息参数中包含 字符串 与 数组（每条消息各 range(0) 字节/个）时的
+ *        publish() + dispatch() 吞吐量：__arena 为 false 时从堆中分配，
+ *        否则使用 xmsg_arena_queue_t 从内存区中分配。
+ */
+template< bool __arena >
+static void BM_publish_arena(benchmark::State & xstate)
+{
+    using x_string_t = typename std::conditional<
+                            __arena, xmsg_arena_string_t, std::string >::type;
+    using x_vector_t = typename std::conditional<
+                            __arena, xmsg_arena_vector_t< int >, std::vector< int > >::type;
+    using x_ctxt_t   = xmsg_context_t< xmsg_mkey_t< int >, xmsg_args_t< x_string_t, x_vector_t > >;
+    using x_queue_t  = typename std::conditional<
+                            __arena, xmsg_arena_queue_t< x_ctxt_t >, std::queue< x_ctxt_t > >::type;
+
+    xmsg_publisher_t< x_ctxt_t, x_queue_t > xpub;
+    size_t xsum = 0;
+    xpub.subscribe(1, [&xsum](const x_string_t & xtext, const x_vector_t & xvec)
+    {
+        xsum += xtext.size() + xvec.size();
+    });
+
+    const size_t xsize = static_cast< size_t >(xstate.range(0));
+    const std::string xtext(xsize, 't');
+
+    for (auto _ : xstate)
+    {
+        for (size_t xiter = 0; xiter < XMSG_BATCH; ++xiter)
+            xpub.publish(1, xtext.c_str(), xsize);
+        xpub.dispatch_batch();
+    }
+
+    benchmark::DoNotOptimize(xsum);
+    xstate.SetItemsProcessed(xstate.iterations() * XMSG_BATCH);
+}
+
+BENCHMARK_TEMPLATE(BM_publish_arena, false)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_publish_arena, true )->Arg(64)->Arg(1024);
+
+/**********************************************************/
+/**
+ * @brief 三种参数类型的消息交替发布（每次迭代各 XMSG_BATCH / 3 条）：
+ *        __hetero 为 false 时，每种参数类型各使用一个 xmsg_publisher_t
+ *        （各自的消息队列，各自 dispatch()）；否则使用 xmsg_hetero_publisher_t
+ *        （同一个字节流队列，一次 dispatch()）。
+ */
+struct xshape_int_t  : xmsg_topic_t< int, 0, size_t > { };
+struct xshape_text_t : xmsg_topic_t< int, 1, std::string > { };
+struct xshape_pair_t : xmsg_topic_t< int, 2, int, double > { };
+
+template< bool __hetero >
+static void BM_multi_shape(benchmark::State & xstate);
+
+template<>
+void BM_multi_shape< false >(benchmark::State & xstate)
+{
+    xmsg_publisher_t< xmsg_context_t< xmsg_mkey_t< int >, xmsg_args_t< size_t > > >      xpub_int;
+    xmsg_publisher_t< xmsg_context_t< xmsg_mkey_t< int >, xmsg_args_t< std::string > > > xpub_text;
+    xmsg_publisher_t< xmsg_context_t< xmsg_mkey_t< int >, xmsg_args_t< int, double > > > xpub_pair;
+
+    size_t xsum = 0;
+    xpub_int.subscribe(0, [&xsum](size_t xvalue) { xsum += xvalue; });
+    xpub_text.subscribe(0, [&xsum](const std::string & xtext) { xsum += xtext.size(); });
+    xpub_pair.subscribe(0, [&xsum](int xvalue, double) { xsum += xvalue; });
+
+    const std::string xtext("shape");
+    for (auto _ : xstate)
+    {
+        for (size_t xiter = 0; xiter < XMSG_BATCH / 3; ++xiter)
+        {
+            xpub_int.publish(0, xiter);
+            xpub_text.publish(0, xtext);
+            xpub_pair.publish(0, static_cast< int >(xiter), 0.5);
+        }
+        xpub_int.dispatch();
+        xpub_text.dispatch();
+        xpub_pair.dispatch();
+    }
+
+    benchmark::DoNotOptimize(xsum);
+    xstate.SetItemsProcessed(xstate.iterations() * (XMSG_BATCH / 3 * 3));
+}
+
+template<>
+void BM_multi_shape< true >(benchmark::State & xstate)
+{
+    xmsg_hetero_publisher_t< xshape_int_t, xshape_text_t, xshape_pair_t > xpub;
+
+    size_t xsum = 0;
+    xpub.subscribe< xshape_int_t >([&xsum](size_t xvalue) { xsum += xvalue; });
+    xpub.subscribe< xshape_text_t >([&xsum](const std::string & xtext) { xsum += xtext.size(); });
+    xpub.subscribe< xshape_pair_t >([&xsum](int xvalue, double) { xsum += xvalue; });
+
+    const std::string xtext("shape");
+    for (auto _ : xstate)
+    {
+        for (size_t xiter = 0; xiter < XMSG_BATCH / 3; ++xiter)
+        {
+            xpub.publish< xshape_int_t >(xiter);
+            xpub.publish< xshape_text_t >(xtext);
+            xpub.publish< xshape_pair_t >(static_cast< int >(xiter), 0.5);
+        }
+        xpub.dispatch();
+    }
+
+    benchmark::DoNotOptimize(xsum);
+    xstate.SetItemsProcessed(xstate.iterations() * (XMSG_BATCH / 3 * 3));
+}
+
+BENCHMARK_TEMPLATE(BM_multi_shape, false);
+BENCHMARK_TEMPLATE(BM_multi_shape, true );
+
+/**********************************************************/
+/**
+ * @brief xmsg_codec_t 的批量编码：每次迭代将 XMSG_BATCH 条消息
+ *        （字符串 与 数组 各 range(0) 字节/个）编码到同一个缓冲区。
+ */
+using xcodec_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< std::string, std::vector< double >, uint64_t > >;
+using xcodec_t      = xmsg_codec_t< xcodec_ctxt_t >;
+
+static void BM_codec_encode_batch(benchmark::State & xstate)
+{
+    const size_t xsize = static_cast< size_t >(xstate.range(0));
+
+    std::vector< xcodec_ctxt_t > xmsgs;
+    for (size_t xiter = 0; xiter < XMSG_BATCH; ++xiter)
+    {
+        xmsgs.emplace_back(static_cast< int >(xiter),
+                           std::string(xsize, 'c'),
+                           std::vector< double >(xsize, 0.5),
+                           static_cast< uint64_t >(xiter));
+    }
+
+    std::vector< char > xbuffer;
+    for (auto _ : xstate)
+    {
+        xbuffer.clear();
+        xcodec_t::encode(xbuffer, xmsgs.begin(), xmsgs.end());
+        benchmark::DoNotOptimize(xbuffer.data());
+    }
+
+    xstate.SetItemsProcessed(xstate.iterations() * XMSG_BATCH);
+    xstate.SetBytesProcessed(xstate.iterations() * static_cast< int64_t >(xbuffer.size()));
+}
+
+BENCHMARK(BM_codec_encode_batch)->Arg(16)->Arg(256);
+
+/**********************************************************/
+/**
+ * @brief 读取批量编码的消息：__view 为 true 时使用 x_view_t 在缓冲区中原地读取，
+ *        否则 decode() 为消息对象（复制字符串与数组）后再读取。
+ */
+template< bool __view >
+static void BM_codec_read(benchmark::State & xstate)
+{
+    const size_t xsize = static_cast< size_t >(xstate.range(0));
+
+    std::vector< xcodec_ctxt_t > xmsgs;
+    for (size_t xiter = 0; xiter < XMSG_BATCH; ++xiter)
+    {
+        xmsgs.emplace_back(static_cast< int >(xiter),
+                           std::string(xsize, 'c'),
+                           std::vector< double >(xsize, 0.5),
+                           static_cast< uint64_t >(xiter));
+    }
+
+    std::vector< char > xbuffer;
+    xcodec_t::encode(xbuffer, xmsgs.begin(), xmsgs.end());
+
+    for (auto _ : xstate)
+    {
+        double xsum = 0.0;
+        xcodec_t::for_each(xbuffer.data(), xbuffer.size(),
+            [&xsum](const xcodec_t::x_view_t & xview)
+            {
+                if (__view)
+                {
+                    xsum += xview.get< 0 >().size() + xview.get< 1 >()[0] + xview.get< 2 >();
+                }
+                else
+                {
+                    xcodec_ctxt_t xctxt = xcodec_t::decode(xview.data());
+                    xsum += std::get< 0 >(xctxt.args()).size() +
+                            std::get< 1 >(xctxt.args())[0] +
+                            std::get< 2 >(xctxt.args());
+                }
+            });
+        benchmark::DoNotOptimize(xsum);
+    }
+
+    xstate.SetItemsProcessed(xstate.iterations() * XMSG_BATCH);
+}
+
+BENCHMARK_TEMPLATE(BM_codec_read, false)->Arg(16)->Arg(256);
+BENCHMARK_TEMPLATE(BM_codec_read, true )->Arg(16)->Arg(256);
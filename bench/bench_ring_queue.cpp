@@ -0,0 +1,179 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file bench_ring_queue.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 有界环形队列 xmsg_ring_queue_t 的测试程序：
+ *          1. 单线程 突发发布/投递：std::queue 对比 xmsg_ring_queue_t ；
+ *          2. 多生产者并发发布（XOVERFLOW_BLOCK）：xmsg_mpsc_queue_t 对比 xmsg_ring_queue_t 。
+ *          用法：bench_ring_queue [最大生产者线程数] [每个线程的消息数]
+ * </pre>
+ */
+
+#include "../xmsg_pubsub.h"
+#include "../xmsg_mpsc_queue.h"
+#include "../xmsg_ring_queue.h"
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< size_t > >;
+
+/** 环形队列的容量 */
+static constexpr size_t XRING_CAPACITY = 4096;
+
+using xring_queue_t = xmsg_ring_queue_t< xmsg_ctxt_t, XRING_CAPACITY, XOVERFLOW_BLOCK >;
+
+/**********************************************************/
+/**
+ * @brief 单线程中每轮突发发布 xburst 个消息后再全部投递，
+ *        返回每秒 发布+投递 的消息数量。
+ */
+template< typename __publisher_t >
+double run_burst(size_t xmsg_count, size_t xburst)
+{
+    __publisher_t xpub;
+    size_t xsum = 0;
+    xpub.subscribe(1, [&xsum](size_t xvalue) { xsum += xvalue; });
+
+    std::chrono::steady_clock::time_point xtm_beg =
+        std::chrono::steady_clock::now();
+
+    for (size_t xiter = 0; xiter < xmsg_count; )
+    {
+        for (size_t xnum = 0; (xnum < xburst) && (xiter < xmsg_count); ++xnum)
+            xpub.publish(1, xiter++);
+        xpub.dispatch_batch();
+    }
+
+    std::chrono::duration< double > xtm_cost =
+        std::chrono::steady_clock::now() - xtm_beg;
+
+    if (xsum != (xmsg_count * (xmsg_count - 1) / 2))
+        std::printf("checksum mismatch!\n");
+
+    return xmsg_count / xtm_cost.count();
+}
+
+/**********************************************************/
+/**
+ * @brief 使用 xproducers 个生产者线程并发发布消息，
+ *        单个投递线程执行 dispatch_batch()，返回每秒投递的消息数量。
+ */
+template< typename __publisher_t >
+double run_producers(size_t xproducers, size_t xmsg_count)
+{
+    __publisher_t xpub;
+    size_t xsum = 0;
+    xpub.subscribe(1, [&xsum](size_t xvalue) { xsum += xvalue; });
+
+    const size_t xmsg_total = xproducers * xmsg_count;
+    size_t xmsg_dispatched = 0;
+
+    std::chrono::steady_clock::time_point xtm_beg =
+        std::chrono::steady_clock::now();
+
+    std::vector< std::thread > xthreads;
+    for (size_t xiter = 0; xiter < xproducers; ++xiter)
+    {
+        xthreads.push_back(std::thread(
+            [&xpub, xmsg_count](void)
+            {
+                for (size_t xiter = 0; xiter < xmsg_count; ++xiter)
+                    xpub.publish(1, xiter);
+            }));
+    }
+
+    while (xmsg_dispatched < xmsg_total)
+    {
+        size_t xcount = xpub.dispatch_batch();
+        if (0 == xcount)
+            std::this_thread::yield();
+        xmsg_dispatched += xcount;
+    }
+
+    for (std::thread & xthread : xthreads)
+        xthread.join();
+
+    std::chrono::duration< double > xtm_cost =
+        std::chrono::steady_clock::now() - xtm_beg;
+
+    if (xsum != xproducers * (xmsg_count * (xmsg_count - 1) / 2))
+        std::printf("checksum mismatch!\n");
+
+    return xmsg_total / xtm_cost.count();
+}
+
+int main(int argc, char * argv[])
+{
+    size_t xmax_producers = std::thread::hardware_concurrency();
+    if (xmax_producers < 4)
+        xmax_producers = 4;
+    size_t xmsg_count = 200000;
+
+    if (argc > 1) xmax_producers = std::strtoul(argv[1], nullptr, 10);
+    if (argc > 2) xmsg_count     = std::strtoul(argv[2], nullptr, 10);
+
+    using xpub_queue_t = xmsg_publisher_t< xmsg_ctxt_t >;
+    using xpub_mpsc_t  = xmsg_publisher_t< xmsg_ctxt_t, xmsg_mpsc_queue_t< xmsg_ctxt_t > >;
+    using xpub_ring_t  = xmsg_publisher_t< xmsg_ctxt_t, xring_queue_t >;
+
+    std::printf("%-10s %18s %18s %8s\n",
+                "burst", "std::queue(msg/s)", "ring_queue(msg/s)", "ratio");
+
+    const size_t xburst_list[] = { 16, 256, XRING_CAPACITY };
+    for (size_t xburst : xburst_list)
+    {
+        double xqueue = run_burst< xpub_queue_t >(xmsg_count * 10, xburst);
+        double xring  = run_burst< xpub_ring_t  >(xmsg_count * 10, xburst);
+
+        std::printf("%-10zu %18.0f %18.0f %8.2f\n",
+                    xburst, xqueue, xring, xring / xqueue);
+    }
+
+    std::printf("\n%-10s %18s %18s %8s\n",
+                "producers", "mpsc_queue(msg/s)", "ring_queue(msg/s)", "ratio");
+
+    for (size_t xproducers = 1; xproducers <= xmax_producers; ++xproducers)
+    {
+        double xmpsc = run_producers< xpub_mpsc_t >(xproducers, xmsg_count);
+        double xring = run_producers< xpub_ring_t >(xproducers, xmsg_count);
+
+        std::printf("%-10zu %18.0f %18.0f %8.2f\n",
+                    xproducers, xmpsc, xring, xring / xmpsc);
+    }
+
+    return 0;
+}
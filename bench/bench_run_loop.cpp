@@ -0,0 +1,134 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+/**
+ * @file bench_run_loop.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 发布 -> 处理 的单条消息延迟测试程序：
+ *          xmsg_run_loop_t（事件唤醒）对比 main.cpp 中的 sleep_for 轮询。
+ *          用法：bench_run_loop [消息数] [消息间隔(微秒)] [轮询周期(微秒)]
+ * </pre>
+ */
+
+#include "../xmsg_pubsub.h"
+#include "../xmsg_run_loop.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xclock_t     = std::chrono::steady_clock;
+using xmsg_ctxt_t  = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< xclock_t::time_point > >;
+using xpublisher_t = xmsg_publisher_t< xmsg_ctxt_t, xmsg_notify_queue_t< xmsg_ctxt_t > >;
+
+/**********************************************************/
+/**
+ * @brief 在 xpub 上发布 xmsg_count 条带时间戳的消息（间隔 xgap），
+ *        由 xdispatch 在投递线程中完成投递，统计 发布 -> 处理 的延迟。
+ */
+template< typename __dispatch_t >
+void run_bench(const char * xname,
+               size_t xmsg_count,
+               std::chrono::microseconds xgap,
+               __dispatch_t && xdispatch)
+{
+    xpublisher_t xpub;
+    std::vector< double > xlatency;
+    xlatency.reserve(xmsg_count);
+
+    xpub.subscribe(1, [&xlatency](xclock_t::time_point xtm_pub)
+    {
+        std::chrono::duration< double, std::micro > xcost =
+            xclock_t::now() - xtm_pub;
+        xlatency.push_back(xcost.count());
+    });
+
+    std::atomic< bool > xdone(false);
+    std::thread xthread([&](void) { xdispatch(xpub, xdone); });
+
+    for (size_t xiter = 0; xiter < xmsg_count; ++xiter)
+    {
+        xpub.publish(1, xclock_t::now());
+        std::this_thread::sleep_for(xgap);
+    }
+
+    xdone.store(true);
+    xthread.join();
+
+    std::sort(xlatency.begin(), xlatency.end());
+    if (xlatency.empty())
+        return;
+
+    std::printf("%-12s %12.1f %12.1f %12.1f\n",
+                xname,
+                xlatency[xlatency.size() / 2],
+                xlatency[xlatency.size() * 99 / 100],
+                xlatency.back());
+}
+
+int main(int argc, char * argv[])
+{
+    size_t xmsg_count = 2000;
+    size_t xgap_us    = 200;
+    size_t xpoll_us   = 1000;
+
+    if (argc > 1) xmsg_count = std::strtoul(argv[1], nullptr, 10);
+    if (argc > 2) xgap_us    = std::strtoul(argv[2], nullptr, 10);
+    if (argc > 3) xpoll_us   = std::strtoul(argv[3], nullptr, 10);
+
+    std::printf("%-12s %12s %12s %12s\n",
+                "dispatcher", "p50(us)", "p99(us)", "max(us)");
+
+    run_bench("sleep_poll", xmsg_count, std::chrono::microseconds(xgap_us),
+        [xpoll_us](xpublisher_t & xpub, std::atomic< bool > & xdone)
+        {
+            while (!xdone.load())
+            {
+                if (0 == xpub.dispatch())
+                    std::this_thread::sleep_for(
+                        std::chrono::microseconds(xpoll_us));
+            }
+            xpub.dispatch();
+        });
+
+    run_bench("run_loop", xmsg_count, std::chrono::microseconds(xgap_us),
+        [](xpublisher_t & xpub, std::atomic< bool > & xdone)
+        {
+            xmsg_run_loop_t< xpublisher_t > xloop(xpub);
+            while (!xdone.load())
+                xloop.run_for(std::chrono::milliseconds(10));
+            xloop.poll();
+        });
+
+    return 0;
+}
@@ -0,0 +1,255 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file bench_sharded.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 多生产者发布、消息处理较重时的吞吐量测试程序：
+ *          单个 xmsg_publisher_t + xmsg_run_loop_t 对比 xmsg_sharded_publisher_t（N 个分片），
+ *          以及两个热点消息落在同一分片时，rebalance() 前后的倾斜度与吞吐量。
+ *          用法：bench_sharded [最大分片数] [生产者线程数] [每个线程的消息数] [处理耗时(循环次数)]
+ * </pre>
+ */
+
+#include "../xmsg_pubsub.h"
+#include "../xmsg_run_loop.h"
+#include "../xmsg_sharded_publisher.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t  = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< uint64_t > >;
+using xpublisher_t = xmsg_publisher_t< xmsg_ctxt_t, xmsg_notify_queue_t< xmsg_ctxt_t > >;
+using xsharded_t   = xmsg_sharded_publisher_t< xpublisher_t >;
+using xclock_t     = std::chrono::steady_clock;
+
+/** 消息键的数量 */
+static const int XKEY_COUNT = 64;
+
+/**
+ * @struct xsink_t
+ * @brief 消息处理结果的累加值（每个消息键独占一个缓存行，
+ *        同一消息键的消息不会被并发处理）。
+ */
+struct alignas(64) xsink_t
+{
+    uint64_t xvalue;
+};
+
+static xsink_t g_xsink[XKEY_COUNT];
+
+/**********************************************************/
+/**
+ * @brief 模拟消息处理的耗时（结果累加到消息键的 g_xsink 中，避免被编译器优化掉）。
+ */
+static inline void handle(int xkey, uint64_t xvalue, size_t xwork)
+{
+    uint64_t xacc = xvalue;
+    for (size_t xiter = 0; xiter < xwork; ++xiter)
+        xacc = xacc * 6364136223846793005ULL + 1442695040888963407ULL;
+    g_xsink[xkey].xvalue += xacc;
+}
+
+/**********************************************************/
+/**
+ * @brief 使用 xproducers 个生产者线程，按 xkey_of(线程, 序号) 选择消息键发布消息，
+ *        xflush() 返回时所有消息均已处理；返回每秒处理的消息数量。
+ */
+template< typename __publish_t, typename __flush_t >
+double run_producers(size_t xproducers,
+                     size_t xmsg_count,
+                     __publish_t && xpublish,
+                     __flush_t && xflush)
+{
+    xclock_t::time_point xtm_beg = xclock_t::now();
+
+    std::vector< std::thread > xthreads;
+    for (size_t xthread = 0; xthread < xproducers; ++xthread)
+    {
+        xthreads.push_back(std::thread(
+            [&xpublish, xthread, xmsg_count](void)
+            {
+                for (size_t xiter = 0; xiter < xmsg_count; ++xiter)
+                    xpublish(xthread, xiter);
+            }));
+    }
+
+    for (std::thread & xthread : xthreads)
+        xthread.join();
+    xflush();
+
+    std::chrono::duration< double > xtm_cost = xclock_t::now() - xtm_beg;
+    return (xproducers * xmsg_count) / xtm_cost.count();
+}
+
+/**********************************************************/
+/**
+ * @brief 单个发布者，由一个 xmsg_run_loop_t 投递线程处理所有消息。
+ */
+double bench_single(size_t xproducers, size_t xmsg_count, size_t xwork)
+{
+    xpublisher_t xpub;
+    std::atomic< size_t > xhandled(0);
+    for (int xkey = 0; xkey < XKEY_COUNT; ++xkey)
+    {
+        xpub.subscribe(xkey, [&xhandled, xkey, xwork](uint64_t xvalue)
+        {
+            handle(xkey, xvalue, xwork);
+            xhandled.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+
+    xmsg_run_loop_t< xpublisher_t > xloop(xpub);
+    xloop.start();
+
+    const size_t xtotal = xproducers * xmsg_count;
+    double xrate = run_producers(xproducers, xmsg_count,
+        [&xpub](size_t xthread, size_t xiter)
+        {
+            xpub.publish(static_cast< int >((xthread * 7 + xiter) % XKEY_COUNT), xiter);
+        },
+        [&xhandled, xtotal](void)
+        {
+            while (xhandled.load(std::memory_order_relaxed) < xtotal)
+                std::this_thread::yield();
+        });
+
+    xloop.stop();
+    return xrate;
+}
+
+/**********************************************************/
+/**
+ * @brief xshards 个分片，消息键均匀分布。
+ */
+double bench_sharded(size_t xshards, size_t xproducers, size_t xmsg_count, size_t xwork)
+{
+    xsharded_t xpub(xshards);
+    for (int xkey = 0; xkey < XKEY_COUNT; ++xkey)
+        xpub.subscribe(xkey, [xkey, xwork](uint64_t xvalue) { handle(xkey, xvalue, xwork); });
+    xpub.start(true);
+
+    double xrate = run_producers(xproducers, xmsg_count,
+        [&xpub](size_t xthread, size_t xiter)
+        {
+            xpub.publish(static_cast< int >((xthread * 7 + xiter) % XKEY_COUNT), xiter);
+        },
+        [&xpub](void) { xpub.flush(); });
+
+    xpub.stop();
+    return xrate;
+}
+
+/**********************************************************/
+/**
+ * @brief 两个热点消息（各占 45% 的消息）落在同一个主分片，
+ *        xrebalance 为 true 时，先将其中一个迁移到另一个分片。
+ */
+void bench_hot_keys(size_t xshards, size_t xproducers, size_t xmsg_count, size_t xwork, bool xrebalance)
+{
+    xsharded_t xpub(xshards);
+    for (int xkey = 0; xkey < XKEY_COUNT; ++xkey)
+        xpub.subscribe(xkey, [xkey, xwork](uint64_t xvalue) { handle(xkey, xvalue, xwork); });
+    xpub.start(true);
+
+    // 热点消息：0 与 xshards（主分片均为 0）
+    const int xhot_a = 0;
+    const int xhot_b = static_cast< int >(xshards);
+    if (xrebalance)
+        xpub.rebalance(xhot_b, 1);
+
+    double xrate = run_producers(xproducers, xmsg_count,
+        [&xpub, xhot_a, xhot_b](size_t xthread, size_t xiter)
+        {
+            const size_t xslot = (xthread * 7 + xiter) % 20;
+            const int xkey = (xslot < 9)  ? xhot_a :
+                             (xslot < 18) ? xhot_b :
+                             static_cast< int >((xthread + xiter) % XKEY_COUNT);
+            xpub.publish(xkey, xiter);
+        },
+        [&xpub](void) { xpub.flush(); });
+
+    xmsg_sharded_stats_t xstats = xpub.stats();
+    xpub.stop();
+
+    std::printf("%-12s %16.0f %8.2f %8zu", xrebalance ? "rebalanced" : "skewed",
+                xrate, xstats.xskew, xstats.xhottest);
+    for (const xmsg_shard_stats_t & xshard : xstats.xshards)
+        std::printf(" %10llu", static_cast< unsigned long long >(xshard.xload));
+    std::printf("\n");
+}
+
+int main(int argc, char * argv[])
+{
+    size_t xmax_shards = std::thread::hardware_concurrency();
+    if (xmax_shards < 4)
+        xmax_shards = 4;
+    size_t xproducers = 4;
+    size_t xmsg_count = 100000;
+    size_t xwork      = 200;
+
+    if (argc > 1) xmax_shards = std::strtoul(argv[1], nullptr, 10);
+    if (argc > 2) xproducers  = std::strtoul(argv[2], nullptr, 10);
+    if (argc > 3) xmsg_count  = std::strtoul(argv[3], nullptr, 10);
+    if (argc > 4) xwork       = std::strtoul(argv[4], nullptr, 10);
+
+    std::printf("cpus: %u, producers: %zu, messages: %zu, work: %zu\n\n",
+                std::thread::hardware_concurrency(), xproducers,
+                xproducers * xmsg_count, xwork);
+
+    std::printf("%-12s %16s %8s\n", "publisher", "msg/s", "speedup");
+    const double xsingle = bench_single(xproducers, xmsg_count, xwork);
+    std::printf("%-12s %16.0f %8.2f\n", "single", xsingle, 1.0);
+
+    for (size_t xshards = 1; xshards <= xmax_shards; xshards *= 2)
+    {
+        char xname[32];
+        std::snprintf(xname, sizeof(xname), "sharded(%zu)", xshards);
+        const double xrate = bench_sharded(xshards, xproducers, xmsg_count, xwork);
+        std::printf("%-12s %16.0f %8.2f\n", xname, xrate, xrate / xsingle);
+    }
+
+    std::printf("\n%-12s %16s %8s %8s %s\n",
+                "hot keys", "msg/s", "skew", "hottest", "  load per shard");
+    bench_hot_keys(xmax_shards, xproducers, xmsg_count, xwork, false);
+    bench_hot_keys(xmax_shards, xproducers, xmsg_count, xwork, true);
+
+    uint64_t xchecksum = 0;
+    for (const xsink_t & xsink : g_xsink)
+        xchecksum += xsink.xvalue;
+    std::printf("\nchecksum: %016llx\n", static_cast< unsigned long long >(xchecksum));
+
+    return 0;
+}
@@ -0,0 +1,301 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file bench_shm_transport.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 跨进程消息传输的测试程序（子进程发布，父进程投递）：
+ *          xmsg_shm_publisher_t/xmsg_shm_receiver_t（共享内存 + futex）
+ *          对比 Unix 域套接字（socketpair + SOCK_SEQPACKET，编码方式相同）。
+ *          用法：bench_shm_transport [吞吐测试的消息数] [延迟测试的消息数] [消息间隔(微秒)]
+ * </pre>
+ */
+
+#include "../xmsg_pubsub.h"
+#include "../xmsg_shm_transport.h"
+
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t  = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< uint64_t, double > >;
+using xpublisher_t = xmsg_publisher_t< xmsg_ctxt_t >;
+using xcodec_t     = xmsg_shm_codec_t< xmsg_ctxt_t >;
+
+/**********************************************************/
+/**
+ * @brief 单调时钟的当前时间（纳秒，各进程之间可比较）。
+ */
+static inline uint64_t now_ns(void)
+{
+    return static_cast< uint64_t >(
+        std::chrono::duration_cast< std::chrono::nanoseconds >(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @class xshm_channel_t
+ * @brief 共享内存环形缓冲区通道。
+ */
+class xshm_channel_t
+{
+public:
+    explicit xshm_channel_t(xpublisher_t & xpub)
+        : m_xreceiver(xpub)
+    {
+        m_xreceiver.ring().create(nullptr, 1024 * 1024);
+    }
+
+    static const char * name(void) { return "shm_ring"; }
+
+    void on_child(void)
+    {
+        m_xsender.ring().attach(m_xreceiver.ring().fd());
+    }
+
+    void on_parent(void)
+    {
+
+    }
+
+    void send(uint64_t xvalue, double xprice)
+    {
+        while (!m_xsender.publish(1, xvalue, xprice))
+            std::this_thread::yield();
+    }
+
+    size_t receive(void)
+    {
+        size_t xcount = 0;
+        while (0 == (xcount = m_xreceiver.receive()))
+            m_xreceiver.wait_for(std::chrono::nanoseconds(-1));
+        return xcount;
+    }
+
+private:
+    xmsg_shm_receiver_t< xpublisher_t > m_xreceiver;
+    xmsg_shm_publisher_t< xmsg_ctxt_t > m_xsender;
+};
+
+/**
+ * @class xuds_channel_t
+ * @brief Unix 域套接字通道（每条消息一次 send()，接收端阻塞 recv() 后批量非阻塞读取）。
+ */
+class xuds_channel_t
+{
+public:
+    explicit xuds_channel_t(xpublisher_t & xpub)
+        : m_xpub(xpub)
+    {
+        if (0 != ::socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, m_xfds))
+        {
+            std::perror("socketpair()");
+            std::exit(1);
+        }
+    }
+
+    ~xuds_channel_t(void)
+    {
+        if (m_xfds[0] >= 0) ::close(m_xfds[0]);
+        if (m_xfds[1] >= 0) ::close(m_xfds[1]);
+    }
+
+    static const char * name(void) { return "uds_seqpacket"; }
+
+    void on_child(void)
+    {
+        ::close(m_xfds[0]);
+        m_xfds[0] = -1;
+    }
+
+    void on_parent(void)
+    {
+        ::close(m_xfds[1]);
+        m_xfds[1] = -1;
+    }
+
+    void send(uint64_t xvalue, double xprice)
+    {
+        char xbuf[xcodec_t::XSIZE];
+        xcodec_t::store(xbuf, 1, xmsg_ctxt_t::x_args_t(xvalue, xprice));
+        while ((::send(m_xfds[1], xbuf, sizeof(xbuf), 0) < 0) && (EINTR == errno))
+        {
+        }
+    }
+
+    size_t receive(void)
+    {
+        char   xbuf[xcodec_t::XSIZE];
+        size_t xcount = 0;
+        int    xflags = 0;
+
+        while (xcount < 256)
+        {
+            ssize_t xbytes = ::recv(m_xfds[0], xbuf, sizeof(xbuf), xflags);
+            if (xbytes < 0)
+            {
+                if (EINTR == errno)
+                    continue;
+                break;
+            }
+
+            if (0 == xbytes)
+                break;
+
+            m_xpub.publish(xcodec_t::load(xbuf));
+            xcount += 1;
+            xflags  = MSG_DONTWAIT;
+        }
+
+        return xcount;
+    }
+
+private:
+    xpublisher_t & m_xpub;
+    int            m_xfds[2];
+};
+
+/**********************************************************/
+/**
+ * @brief 子进程以 xgap_us 的间隔发布 xmsg_count 条消息（xgap_us 为 0 时连续发布），
+ *        父进程接收并投递；xon_msg 为订阅者的处理操作。
+ * 
+ * @return double : 耗时（秒）。
+ */
+template< typename __channel_t, typename __handler_t >
+double run_transport(size_t xmsg_count, size_t xgap_us, __handler_t && xon_msg)
+{
+    xpublisher_t xpub;
+    xpub.subscribe(1, std::forward< __handler_t >(xon_msg));
+
+    __channel_t xchannel(xpub);
+
+    const auto xtm_beg = std::chrono::steady_clock::now();
+
+    pid_t xpid = ::fork();
+    if (xpid < 0)
+    {
+        std::perror("fork()");
+        std::exit(1);
+    }
+
+    if (0 == xpid)
+    {
+        xchannel.on_child();
+        for (size_t xiter = 0; xiter < xmsg_count; ++xiter)
+        {
+            xchannel.send(now_ns(), static_cast< double >(xiter));
+            if (0 != xgap_us)
+                ::usleep(static_cast< useconds_t >(xgap_us));
+        }
+        ::_exit(0);
+    }
+
+    xchannel.on_parent();
+
+    size_t xreceived = 0;
+    while (xreceived < xmsg_count)
+    {
+        size_t xcount = xchannel.receive();
+        if (0 == xcount)
+            break;
+        xreceived += xcount;
+        xpub.dispatch();
+    }
+
+    const std::chrono::duration< double > xtm_cost =
+        std::chrono::steady_clock::now() - xtm_beg;
+
+    ::waitpid(xpid, nullptr, 0);
+
+    if (xreceived != xmsg_count)
+        std::printf("%s: %zu of %zu messages received!\n",
+                    __channel_t::name(), xreceived, xmsg_count);
+
+    return xtm_cost.count();
+}
+
+/**********************************************************/
+/**
+ * @brief 测试 xchannel 的吞吐量 与 单条消息的延迟。
+ */
+template< typename __channel_t >
+void run_bench(size_t xmsg_count, size_t xlat_count, size_t xgap_us)
+{
+    double xsum = 0.0;
+    double xcost = run_transport< __channel_t >(
+        xmsg_count, 0, [&xsum](uint64_t, double xprice) { xsum += xprice; });
+
+    std::vector< double > xlatency;
+    xlatency.reserve(xlat_count);
+    run_transport< __channel_t >(
+        xlat_count, xgap_us,
+        [&xlatency](uint64_t xtm_pub, double)
+        {
+            xlatency.push_back((now_ns() - xtm_pub) / 1000.0);
+        });
+
+    std::sort(xlatency.begin(), xlatency.end());
+    if (xlatency.empty())
+        xlatency.push_back(0.0);
+
+    std::printf("%-14s %16.0f %10.1f %10.1f %10.1f\n",
+                __channel_t::name(),
+                xmsg_count / xcost,
+                xlatency[xlatency.size() / 2],
+                xlatency[xlatency.size() * 99 / 100],
+                xlatency.back());
+}
+
+int main(int argc, char * argv[])
+{
+    size_t xmsg_count = 2000000;
+    size_t xlat_count = 2000;
+    size_t xgap_us    = 100;
+
+    if (argc > 1) xmsg_count = std::strtoul(argv[1], nullptr, 10);
+    if (argc > 2) xlat_count = std::strtoul(argv[2], nullptr, 10);
+    if (argc > 3) xgap_us    = std::strtoul(argv[3], nullptr, 10);
+
+    std::printf("%-14s %16s %10s %10s %10s\n",
+                "transport", "throughput(msg/s)", "p50(us)", "p99(us)", "max(us)");
+
+    run_bench< xuds_channel_t >(xmsg_count, xlat_count, xgap_us);
+    run_bench< xshm_channel_t >(xmsg_count, xlat_count, xgap_us);
+
+    return 0;
+}
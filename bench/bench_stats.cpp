@@ -0,0 +1,126 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file bench_stats.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 统计功能（XMSG_ENABLE_STATS）的开销测试程序：
+ *          分别以 -DXMSG_ENABLE_STATS=0 与 -DXMSG_ENABLE_STATS=1 编译，
+ *          对比 publish()+dispatch() 的吞吐量；启用时同时输出统计快照。
+ *          用法：bench_stats [消息数量] [消息键数量]
+ * </pre>
+ */
+
+#include "../xmsg_pubsub.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< size_t > >;
+
+using xpublisher_t = xmsg_publisher_t< xmsg_ctxt_t >;
+
+/**********************************************************/
+/**
+ * @brief 每批发布 1000 个消息（轮流使用 xkeys 个消息键）后投递，
+ *        返回每秒 发布并投递 的消息数量。
+ */
+double run_bench(xpublisher_t & xpub, size_t xmsg_count, size_t xkeys)
+{
+    const size_t XBATCH_SIZE = 1000;
+
+    std::chrono::steady_clock::time_point xtm_beg =
+        std::chrono::steady_clock::now();
+
+    for (size_t xiter = 0; xiter < xmsg_count; )
+    {
+        for (size_t xnum = 0; (xnum < XBATCH_SIZE) && (xiter < xmsg_count); ++xnum, ++xiter)
+            xpub.publish(static_cast< int >(xiter % xkeys), xiter);
+        xpub.dispatch();
+    }
+
+    std::chrono::duration< double > xtm_cost =
+        std::chrono::steady_clock::now() - xtm_beg;
+
+    return xmsg_count / xtm_cost.count();
+}
+
+int main(int argc, char * argv[])
+{
+    size_t xmsg_count = 2000000;
+    size_t xkeys      = 16;
+
+    if (argc > 1) xmsg_count = std::strtoul(argv[1], nullptr, 10);
+    if (argc > 2) xkeys      = std::strtoul(argv[2], nullptr, 10);
+    if (0 == xkeys) xkeys = 1;
+
+    xpublisher_t xpub;
+    size_t xsum = 0;
+
+    xpublisher_t::x_subkey_t xsub_key;
+    for (size_t xiter = 0; xiter < xkeys; ++xiter)
+    {
+        xsub_key = xpub.subscribe(static_cast< int >(xiter),
+                                  [&xsum](size_t xvalue) { xsum += xvalue; });
+    }
+
+    double xrate = run_bench(xpub, xmsg_count, xkeys);
+
+    std::printf("XMSG_ENABLE_STATS = %d, keys = %zu : %.0f msg/s\n",
+                XMSG_ENABLE_STATS, xkeys, xrate);
+
+#if XMSG_ENABLE_STATS
+    xpublisher_t::x_stats_t xstats = xpub.stats();
+    xmsg_histogram_snapshot_t xhstats = xpublisher_t::handler_stats(xsub_key);
+
+    std::printf("published = %llu, dropped = %llu, dispatched = %llu, invoked = %llu, keys = %zu\n",
+                static_cast< unsigned long long >(xstats.xtotal.xpublished),
+                static_cast< unsigned long long >(xstats.xtotal.xdropped),
+                static_cast< unsigned long long >(xstats.xtotal.xdispatched),
+                static_cast< unsigned long long >(xstats.xtotal.xinvoked),
+                xstats.xkeys.size());
+    std::printf("residency(ns): mean = %.0f, p50 = %llu, p99 = %llu, max = %llu\n",
+                xstats.xresidency.mean(),
+                static_cast< unsigned long long >(xstats.xresidency.percentile(0.50)),
+                static_cast< unsigned long long >(xstats.xresidency.percentile(0.99)),
+                static_cast< unsigned long long >(xstats.xresidency.xmax));
+    std::printf("handler(ns)  : mean = %.0f, p50 = %llu, p99 = %llu, count = %llu\n",
+                xhstats.mean(),
+                static_cast< unsigned long long >(xhstats.percentile(0.50)),
+                static_cast< unsigned long long >(xhstats.percentile(0.99)),
+                static_cast< unsigned long long >(xhstats.xcount));
+#endif // XMSG_ENABLE_STATS
+
+    if (0 == xsum)
+        std::printf("checksum mismatch!\n");
+
+    return 0;
+}
@@ -0,0 +1,174 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file bench_subscribe.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 订阅/取消订阅 反复交替（会话频繁创建与销毁）的测试程序，
+ *          统计每次 订阅+取消订阅 的耗时 与 堆内存分配次数。
+ *          用法：bench_subscribe [轮数] [每轮的订阅者数量]
+ * </pre>
+ */
+
+// 输出内存池的分配计数
+#define XMSG_SLAB_STATS 1
+
+#include "../xmsg_pubsub.h"
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/** 全局的堆内存分配计数 */
+static std::atomic_size_t g_heap_alloc(0);
+
+void * operator new(size_t xsize)
+{
+    g_heap_alloc.fetch_add(1, std::memory_order_relaxed);
+    void * xptr = std::malloc((0 == xsize) ? 1 : xsize);
+    if (nullptr == xptr)
+        throw std::bad_alloc();
+    return xptr;
+}
+
+void operator delete(void * xptr) noexcept
+{
+    std::free(xptr);
+}
+
+void operator delete(void * xptr, size_t) noexcept
+{
+    std::free(xptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< std::string > >;
+
+/**
+ * @struct xsession_t
+ * @brief 模拟的会话对象。
+ */
+struct xsession_t
+{
+    size_t xrecv = 0;
+
+    void on_message(const std::string & xstr)
+    {
+        xrecv += xstr.size();
+    }
+};
+
+/**********************************************************/
+/**
+ * @brief 每轮订阅 xsubers 个订阅者，然后全部取消订阅，
+ *        输出每次 订阅+取消订阅 的耗时与堆内存分配次数。
+ */
+template< typename __publisher_t >
+void run_bench(const char * xname, size_t xrounds, size_t xsubers)
+{
+    using x_subkey_t = typename __publisher_t::x_subkey_t;
+
+    __publisher_t xpub;
+    xsession_t    xsession;
+
+    std::vector< x_subkey_t > xskeys;
+    xskeys.reserve(xsubers);
+
+    // 预热：使映射表、内存池等达到稳定状态
+    for (size_t xiter = 0; xiter < xsubers; ++xiter)
+        xskeys.push_back(xpub.subscribe(static_cast< int >(xiter % 16),
+                                        &xsession_t::on_message, &xsession));
+    for (x_subkey_t & xskey : xskeys)
+        xpub.unsubscribe(xskey);
+    xskeys.clear();
+
+    size_t xalloc_beg = g_heap_alloc.load();
+    std::chrono::steady_clock::time_point xtm_beg =
+        std::chrono::steady_clock::now();
+
+    for (size_t xround = 0; xround < xrounds; ++xround)
+    {
+        for (size_t xiter = 0; xiter < xsubers; ++xiter)
+        {
+            xskeys.push_back(
+                xpub.subscribe(static_cast< int >(xiter % 16),
+                               [&xsession, xiter](const std::string & xstr)
+                               {
+                                   xsession.xrecv += xstr.size() + xiter;
+                               }));
+        }
+
+        for (x_subkey_t & xskey : xskeys)
+            xpub.unsubscribe(xskey);
+        xskeys.clear();
+    }
+
+    std::chrono::duration< double, std::nano > xtm_cost =
+        std::chrono::steady_clock::now() - xtm_beg;
+    size_t xalloc_count = g_heap_alloc.load() - xalloc_beg;
+
+    const double xcycles = static_cast< double >(xrounds * xsubers);
+    std::printf("%-6s %14.1f %18.3f\n",
+                xname, xtm_cost.count() / xcycles, xalloc_count / xcycles);
+}
+
+int main(int argc, char * argv[])
+{
+    size_t xrounds = 2000;
+    size_t xsubers = 256;
+
+    if (argc > 1) xrounds = std::strtoul(argv[1], nullptr, 10);
+    if (argc > 2) xsubers = std::strtoul(argv[2], nullptr, 10);
+
+    using xpub_hash_t = xmsg_publisher_t<
+                                xmsg_ctxt_t,
+                                std::queue< xmsg_ctxt_t >,
+                                xmsg_subset_hash_t >;
+    using xpub_flat_t = xmsg_publisher_t<
+                                xmsg_ctxt_t,
+                                std::queue< xmsg_ctxt_t >,
+                                xmsg_subset_flat_t >;
+
+    std::printf("%-6s %14s %18s\n", "subset", "ns/cycle", "heap allocs/cycle");
+    run_bench< xpub_hash_t >("hash", xrounds, xsubers);
+    run_bench< xpub_flat_t >("flat", xrounds, xsubers);
+
+    xmsg_slab_stat_t & xstat = xmsg_slab_stat();
+    std::printf("slab: heap_alloc=%zu heap_free=%zu slab_alloc=%zu slab_free=%zu\n",
+                xstat.xheap_alloc.load(), xstat.xheap_free.load(),
+                xstat.xslab_alloc.load(), xstat.xslab_free.load());
+
+    return 0;
+}
@@ -0,0 +1,135 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file bench_topic.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 字符串主题的投递测试程序：
+ *          xmsg_submap_hash_t（精确查找）对比 xmsg_submap_topic_t
+ *          （相同的精确订阅，再加上若干通配模式的订阅，匹配结果已缓存）。
+ *          用法：bench_topic [主题数量] [通配模式数量] [消息数量]
+ * </pre>
+ */
+
+#include "../xmsg_pubsub.h"
+#include "../xmsg_submap_topic.h"
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< std::string >,
+                        xmsg_args_t< size_t > >;
+
+/**
+ * @struct xresult_t
+ * @brief 测试结果。
+ */
+struct xresult_t
+{
+    double xmsg_rate; ///< 每秒投递的消息数量
+    size_t xinvokes;  ///< 订阅者的调用次数
+};
+
+/**********************************************************/
+/**
+ * @brief 每个具体主题各订阅一个订阅者，再订阅 xpatterns 个通配模式，
+ *        轮流向各个主题发布消息后投递。
+ */
+template< typename __publisher_t >
+xresult_t run_bench(const std::vector< std::string > & xtopics,
+                    size_t xpatterns,
+                    size_t xmsg_count)
+{
+    __publisher_t xpub;
+    xresult_t xresult = { 0.0, 0 };
+
+    for (const std::string & xtopic : xtopics)
+        xpub.subscribe(xtopic, [&xresult](size_t) { xresult.xinvokes += 1; });
+
+    for (size_t xiter = 0; xiter < xpatterns; ++xiter)
+    {
+        xpub.subscribe("orders.venue" + std::to_string(xiter) + ".*",
+                       [&xresult](size_t) { xresult.xinvokes += 1; });
+    }
+
+    for (size_t xiter = 0; xiter < xmsg_count; ++xiter)
+        xpub.publish(xtopics[xiter % xtopics.size()], xiter);
+
+    std::chrono::steady_clock::time_point xtm_beg =
+        std::chrono::steady_clock::now();
+
+    xpub.dispatch();
+
+    std::chrono::duration< double > xtm_cost =
+        std::chrono::steady_clock::now() - xtm_beg;
+
+    xresult.xmsg_rate = xmsg_count / xtm_cost.count();
+    return xresult;
+}
+
+int main(int argc, char * argv[])
+{
+    size_t xtopic_count = 1000;
+    size_t xpatterns    = 50;
+    size_t xmsg_count   = 2000000;
+
+    if (argc > 1) xtopic_count = std::strtoul(argv[1], nullptr, 10);
+    if (argc > 2) xpatterns    = std::strtoul(argv[2], nullptr, 10);
+    if (argc > 3) xmsg_count   = std::strtoul(argv[3], nullptr, 10);
+
+    std::vector< std::string > xtopics;
+    for (size_t xiter = 0; xiter < xtopic_count; ++xiter)
+    {
+        xtopics.push_back("orders.venue" + std::to_string(xiter % 100) +
+                          ".symbol" + std::to_string(xiter));
+    }
+
+    using xpub_hash_t  = xmsg_publisher_t< xmsg_ctxt_t,
+                                           std::queue< xmsg_ctxt_t >,
+                                           xmsg_subset_hash_t,
+                                           xmsg_submap_hash_t >;
+    using xpub_topic_t = xmsg_publisher_t< xmsg_ctxt_t,
+                                           std::queue< xmsg_ctxt_t >,
+                                           xmsg_subset_hash_t,
+                                           xmsg_submap_topic_t >;
+
+    xresult_t xhash  = run_bench< xpub_hash_t  >(xtopics, 0, xmsg_count);
+    xresult_t xexact = run_bench< xpub_topic_t >(xtopics, 0, xmsg_count);
+    xresult_t xtopic = run_bench< xpub_topic_t >(xtopics, xpatterns, xmsg_count);
+
+    std::printf("%-24s %18s %12s\n", "submap", "msg/s", "invokes");
+    std::printf("%-24s %18.0f %12zu\n", "hash (exact)", xhash.xmsg_rate, xhash.xinvokes);
+    std::printf("%-24s %18.0f %12zu\n", "topic (no pattern)", xexact.xmsg_rate, xexact.xinvokes);
+    std::printf("%-24s %18.0f %12zu\n", "topic (patterns)", xtopic.xmsg_rate, xtopic.xinvokes);
+
+    return 0;
+}
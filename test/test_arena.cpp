@@ -0,0 +1,240 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file test_arena.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 内存区 xmsg_arena_t 与 xmsg_arena_queue_t 的测试。
+ * </pre>
+ */
+
+#include "xmsg_pubsub.h"
+#include "xmsg_arena.h"
+#include "xmsg_mpsc_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< int, xmsg_arena_string_t, xmsg_arena_vector_t< int > > >;
+
+using xpublisher_t = xmsg_publisher_t< xmsg_ctxt_t, xmsg_arena_queue_t< xmsg_ctxt_t > >;
+
+/** 超过 SSO 长度的字符串（确保会分配内存） */
+static const char * const XLONG_TEXT =
+    "a message text long enough to defeat the small string optimization";
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(ArenaTest, AllocateAndRewind)
+{
+    xmsg_arena_t xarena(1024);
+
+    void * xmem1 = xarena.allocate(100, 8);
+    void * xmem2 = xarena.allocate(3, 1);
+    void * xmem3 = xarena.allocate(16, 16);
+    EXPECT_EQ(0u, reinterpret_cast< uintptr_t >(xmem3) % 16);
+    EXPECT_EQ(3u, xarena.live());
+    EXPECT_EQ(1024u, xarena.capacity());
+
+    // 超出内存段大小的分配
+    void * xmem4 = xarena.allocate(5000, 8);
+    EXPECT_EQ(1024u + 5008u, xarena.capacity());
+
+    xarena.deallocate(xmem1, 100);
+    xarena.deallocate(xmem2, 3);
+    xarena.deallocate(xmem3, 16);
+    EXPECT_EQ(1u, xarena.live());
+    EXPECT_FALSE(xarena.rewind());
+    xarena.deallocate(xmem4, 5000);
+    EXPECT_EQ(0u, xarena.live());
+    EXPECT_TRUE(xarena.rewind());
+    EXPECT_EQ(1u, xarena.rewinds());
+
+    // 回绕后复用第一个内存段
+    EXPECT_EQ(xmem1, xarena.allocate(100, 8));
+    xarena.deallocate(xmem1, 100);
+}
+
+TEST(ArenaTest, DispatchRecyclesArena)
+{
+    xpublisher_t xpub;
+    std::vector< std::string > xtexts;
+    int xsum = 0;
+
+    xpub.subscribe(1, [&](int xvalue, const xmsg_arena_string_t & xtext, const xmsg_arena_vector_t< int > & xvec)
+    {
+        xsum += xvalue + static_cast< int >(xvec.size());
+        xtexts.emplace_back(xtext.c_str());
+    });
+
+    for (int xround = 0; xround < 10; ++xround)
+    {
+        for (int xiter = 0; xiter < 100; ++xiter)
+        {
+            xpub.publish(1, xiter, XLONG_TEXT, xmsg_arena_vector_t< int >(4, xiter));
+        }
+
+        EXPECT_EQ(200u, xpub.msg_queue().arena(0).live() + xpub.msg_queue().arena(1).live());
+        EXPECT_EQ(100u, xpub.dispatch());
+        EXPECT_EQ(0u, xpub.msg_queue().arena(0).live());
+        EXPECT_EQ(0u, xpub.msg_queue().arena(1).live());
+    }
+
+    // 稳定运行后不再申请新的内存段（两个内存区交替使用）
+    EXPECT_EQ(static_cast< size_t >(xmsg_arena_t::XCHUNK_SIZE), xpub.msg_queue().arena(0).capacity());
+    EXPECT_EQ(static_cast< size_t >(xmsg_arena_t::XCHUNK_SIZE), xpub.msg_queue().arena(1).capacity());
+    EXPECT_EQ(9u, xpub.msg_queue().arena(0).rewinds() + xpub.msg_queue().arena(1).rewinds());
+
+    ASSERT_EQ(1000u, xtexts.size());
+    EXPECT_EQ(std::string(XLONG_TEXT), xtexts.back());
+    EXPECT_EQ(10 * (4950 + 400), xsum);
+}
+
+TEST(ArenaTest, SustainedBacklogStaysBounded)
+{
+    xpublisher_t xpub;
+    int xcount = 0;
+
+    xpub.subscribe(1, [&xcount](int, const xmsg_arena_string_t &, const xmsg_arena_vector_t< int > &) { ++xcount; });
+
+    // 队列始终保持约 100 条积压的消息，逐条投递：内存区仍可交替回绕
+    for (int xiter = 0; xiter < 100; ++xiter)
+        xpub.publish(1, xiter, XLONG_TEXT, xmsg_arena_vector_t< int >(4, xiter));
+
+    for (int xiter = 0; xiter < 20000; ++xiter)
+    {
+        xpub.publish(1, xiter, XLONG_TEXT, xmsg_arena_vector_t< int >(4, xiter));
+        EXPECT_EQ(1u, xpub.dispatch(1));
+    }
+
+    EXPECT_EQ(100u, xpub.size());
+    EXPECT_EQ(20000, xcount);
+    EXPECT_GT(xpub.msg_queue().arena(0).rewinds(), 0u);
+    EXPECT_GT(xpub.msg_queue().arena(1).rewinds(), 0u);
+    EXPECT_EQ(static_cast< size_t >(xmsg_arena_t::XCHUNK_SIZE), xpub.msg_queue().arena(0).capacity());
+    EXPECT_EQ(static_cast< size_t >(xmsg_arena_t::XCHUNK_SIZE), xpub.msg_queue().arena(1).capacity());
+
+    xpub.dispatch();
+}
+
+TEST(ArenaTest, DoubleBufferedBatch)
+{
+    xpublisher_t xpub;
+    int xcount = 0;
+
+    // 投递过程中继续发布消息：新消息写入另一个内存区
+    xpub.subscribe(1, [&](int xvalue, const xmsg_arena_string_t &, const xmsg_arena_vector_t< int > &)
+    {
+        ++xcount;
+        if (xvalue < 3)
+            xpub.publish(1, xvalue + 10, XLONG_TEXT, xmsg_arena_vector_t< int >());
+    });
+
+    for (int xiter = 0; xiter < 5; ++xiter)
+        xpub.publish(1, xiter, XLONG_TEXT, xmsg_arena_vector_t< int >());
+
+    EXPECT_EQ(5u, xpub.dispatch_batch());
+    EXPECT_EQ(0u, xpub.msg_queue().arena(0).live());
+    EXPECT_EQ(3u, xpub.msg_queue().arena(1).live());
+    EXPECT_EQ(1u, xpub.msg_queue().arena(1).rewinds());
+
+    // 批次未投递完时放回队列：内存区仍在使用，不会回绕
+    EXPECT_EQ(2u, xpub.dispatch_batch(2));
+    EXPECT_EQ(1u, xpub.msg_queue().arena(1).live());
+    EXPECT_EQ(1u, xpub.dispatch_batch());
+    EXPECT_EQ(0u, xpub.msg_queue().arena(1).live());
+    EXPECT_EQ(8, xcount);
+}
+
+TEST(ArenaTest, RehomeCopiedAndMovedContexts)
+{
+    xpublisher_t xpub;
+    std::string xlast;
+    xpub.subscribe(1, [&](int, const xmsg_arena_string_t & xtext, const xmsg_arena_vector_t< int > &)
+    {
+        // 拷贝出来的参数使用堆内存
+        xmsg_arena_string_t xcopy(xtext);
+        EXPECT_EQ(nullptr, xcopy.get_allocator().arena());
+        xlast = xcopy.c_str();
+    });
+
+    const xmsg_ctxt_t xmsg_ctxt(1, 1, xmsg_arena_string_t(XLONG_TEXT), xmsg_arena_vector_t< int >(8));
+    xpub.publish(xmsg_ctxt);
+    xpub.publish(xmsg_ctxt_t(1, 2, xmsg_arena_string_t(XLONG_TEXT), xmsg_arena_vector_t< int >(8)));
+    EXPECT_EQ(4u, xpub.msg_queue().arena(0).live());
+
+    xpub.dispatch();
+    EXPECT_EQ(std::string(XLONG_TEXT), xlast);
+    EXPECT_EQ(0u, xpub.msg_queue().arena(0).live());
+}
+
+TEST(ArenaTest, ProducerWritesWhileConsumerDrains)
+{
+    using x_mpsc_publisher_t = xmsg_publisher_t<
+                                xmsg_ctxt_t,
+                                xmsg_arena_queue_t< xmsg_ctxt_t, xmsg_mpsc_queue_t< xmsg_ctxt_t > > >;
+
+    const int XMSG_COUNT = 100000;
+
+    x_mpsc_publisher_t xpub;
+    int  xnext   = 0;
+    bool xintact = true;
+    xpub.subscribe(1, [&](int xvalue, const xmsg_arena_string_t & xtext, const xmsg_arena_vector_t< int > & xvec)
+    {
+        // 生产者写入另一个内存区的同时，本批次的参数保持完整
+        xintact = xintact && (xvalue == xnext) && (xtext == XLONG_TEXT) &&
+                  (2 == xvec.size()) && (xvalue == xvec[1]);
+        xnext += 1;
+    });
+
+    // 生产者线程独占内存区的分配与切换，消费者线程按批次投递
+    std::thread xproducer([&xpub](void)
+    {
+        for (int xiter = 0; xiter < XMSG_COUNT; ++xiter)
+            xpub.publish(1, xiter, XLONG_TEXT, xmsg_arena_vector_t< int >(2, xiter));
+    });
+
+    while (xnext < XMSG_COUNT)
+    {
+        if (0 == xpub.dispatch_batch())
+            std::this_thread::yield();
+    }
+
+    xproducer.join();
+
+    EXPECT_TRUE(xintact);
+    EXPECT_EQ(XMSG_COUNT, xnext);
+    EXPECT_EQ(0u, xpub.msg_queue().arena(0).live());
+    EXPECT_EQ(0u, xpub.msg_queue().arena(1).live());
+    EXPECT_GT(xpub.msg_queue().arena(0).rewinds() + xpub.msg_queue().arena(1).rewinds(), 0u);
+}
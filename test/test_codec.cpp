@@ -0,0 +1,250 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/**
+ * @file test_codec.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 消息对象的二进制编解码 xmsg_codec_t 的测试。
+ * </pre>
+ */
+
+#include "xmsg_pubsub.h"
+#include "xmsg_codec.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xfixed_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< char, double, uint16_t > >;
+using xfixed_codec_t = xmsg_codec_t< xfixed_ctxt_t >;
+
+using xblob_ctxt_t  = xmsg_context_t<
+                        xmsg_mkey_t< std::string >,
+                        xmsg_args_t< std::string, std::vector< double >, int > >;
+using xblob_codec_t = xmsg_codec_t< xblob_ctxt_t >;
+
+/** 模拟编码后超过 UINT32_MAX 字节的字段（不会实际写出） */
+struct xhuge_t
+{
+
+};
+
+template<>
+struct xmsg_codec_field_t< xhuge_t > : xmsg_codec_field_t< uint8_t >
+{
+    static inline size_t extra(const xhuge_t &)
+    {
+        return static_cast< size_t >(UINT32_MAX);
+    }
+
+    static inline void store(char *, size_t, size_t &, const xhuge_t &)
+    {
+
+    }
+};
+
+using xhuge_ctxt_t  = xmsg_context_t< xmsg_mkey_t< int >, xmsg_args_t< xhuge_t > >;
+using xhuge_codec_t = xmsg_codec_t< xhuge_ctxt_t >;
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(CodecTest, FixedLayoutIsAlignedAndReadInPlace)
+{
+    // 记录头 8 字节，int@8，char@12，double@16，uint16_t@24，定长区 32 字节
+    EXPECT_EQ(8u,  static_cast< size_t >(xfixed_codec_t::x_offset_t< 0 >::value));
+    EXPECT_EQ(12u, static_cast< size_t >(xfixed_codec_t::x_offset_t< 1 >::value));
+    EXPECT_EQ(16u, static_cast< size_t >(xfixed_codec_t::x_offset_t< 2 >::value));
+    EXPECT_EQ(24u, static_cast< size_t >(xfixed_codec_t::x_offset_t< 3 >::value));
+    EXPECT_EQ(32u, static_cast< size_t >(xfixed_codec_t::XFIXED));
+
+    xfixed_ctxt_t xctxt(7, 'x', 3.25, static_cast< uint16_t >(65535));
+    EXPECT_EQ(32u, xfixed_codec_t::encoded_size(xctxt));
+
+    std::vector< char > xbuffer;
+    EXPECT_EQ(32u, xfixed_codec_t::encode(xbuffer, xctxt));
+    ASSERT_EQ(32u, xbuffer.size());
+    EXPECT_EQ(32u, xfixed_codec_t::verify(xbuffer.data(), xbuffer.size()));
+
+    xfixed_codec_t::x_view_t xview = xfixed_codec_t::view(xbuffer.data());
+    EXPECT_EQ(32u, xview.size());
+    EXPECT_EQ(7, xview.mkey());
+    EXPECT_EQ('x', xview.get< 0 >());
+    EXPECT_EQ(3.25, xview.get< 1 >());
+    EXPECT_EQ(65535, xview.get< 2 >());
+
+    // 原地读取：返回的引用指向缓冲区
+    const double & xref = xview.get< 1 >();
+    EXPECT_EQ(xbuffer.data() + 16, reinterpret_cast< const char * >(&xref));
+
+    char xsmall[16];
+    EXPECT_EQ(0u, xfixed_codec_t::encode(xsmall, sizeof(xsmall), xctxt));
+}
+
+TEST(CodecTest, StringsAndVectorsRoundTrip)
+{
+    xblob_ctxt_t xctxt(std::string("quote/AAPL"),
+                       std::string("hello, world"),
+                       std::vector< double >{ 1.5, 2.5, 3.5 },
+                       42);
+
+    // 定长区：记录头 8 + 3 个槽位 24 + int 4 -> 40 ；变长区：16 + 16 + 24
+    EXPECT_EQ(40u, static_cast< size_t >(xblob_codec_t::XFIXED));
+    EXPECT_EQ(96u, xblob_codec_t::encoded_size(xctxt));
+
+    std::vector< char > xbuffer;
+    ASSERT_EQ(96u, xblob_codec_t::encode(xbuffer, xctxt));
+    ASSERT_EQ(96u, xblob_codec_t::verify(xbuffer.data(), xbuffer.size()));
+
+    xblob_codec_t::x_view_t xview = xblob_codec_t::view(xbuffer.data());
+    EXPECT_EQ("quote/AAPL", std::string(xview.mkey().begin(), xview.mkey().end()));
+    EXPECT_EQ("hello, world", std::string(xview.get< 0 >().data(), xview.get< 0 >().size()));
+    ASSERT_EQ(3u, xview.get< 1 >().size());
+    EXPECT_EQ(2.5, xview.get< 1 >()[1]);
+    EXPECT_EQ(0u, reinterpret_cast< uintptr_t >(xview.get< 1 >().data()) & 7u);
+    EXPECT_EQ(42, xview.get< 2 >());
+
+    xblob_ctxt_t xdecoded = xblob_codec_t::decode(xbuffer.data());
+    EXPECT_EQ(xctxt.mkey(), xdecoded.mkey());
+    EXPECT_TRUE(xctxt.args() == xdecoded.args());
+
+    // 空的字符串与数组
+    xblob_ctxt_t xempty(std::string(), std::string(), std::vector< double >(), 0);
+    std::vector< char > xbuffer2;
+    EXPECT_EQ(40u, xblob_codec_t::encode(xbuffer2, xempty));
+    EXPECT_TRUE(xblob_codec_t::view(xbuffer2.data()).get< 1 >().empty());
+    EXPECT_TRUE(xempty.args() == xblob_codec_t::decode(xbuffer2.data()).args());
+}
+
+TEST(CodecTest, EncodingIsDeterministic)
+{
+    xblob_ctxt_t xctxt(std::string("k"), std::string("abc"), std::vector< double >{ 1.0 }, 1);
+
+    std::vector< char > xbuffer1(256, '\x5A');
+    std::vector< char > xbuffer2;
+    xbuffer1.clear();
+    xblob_codec_t::encode(xbuffer1, xctxt);
+    xblob_codec_t::encode(xbuffer2, xctxt);
+    EXPECT_EQ(xbuffer1, xbuffer2);
+}
+
+TEST(CodecTest, BatchEncodeAndForEach)
+{
+    std::vector< xblob_ctxt_t > xmsgs;
+    for (int xiter = 0; xiter < 100; ++xiter)
+    {
+        xmsgs.emplace_back(std::to_string(xiter % 3),
+                           std::string(static_cast< size_t >(xiter), 'a'),
+                           std::vector< double >(static_cast< size_t >(xiter % 5), 0.5),
+                           xiter);
+    }
+
+    std::vector< char > xbuffer;
+    const size_t xbytes = xblob_codec_t::encode(xbuffer, xmsgs.begin(), xmsgs.end());
+    EXPECT_EQ(xbuffer.size(), xbytes);
+
+    // 解码后发布到本地的发布者
+    xmsg_publisher_t< xblob_ctxt_t > xpub;
+    int xsum = 0;
+    xpub.subscribe(std::string("1"),
+                   [&xsum](const std::string & xtext, const std::vector< double > &, int xvalue)
+                   {
+                       EXPECT_EQ(static_cast< size_t >(xvalue), xtext.size());
+                       xsum += xvalue;
+                   });
+
+    size_t xcount = 0;
+    EXPECT_EQ(xbytes, xblob_codec_t::for_each(xbuffer.data(), xbuffer.size(),
+        [&](const xblob_codec_t::x_view_t & xview)
+        {
+            EXPECT_EQ(static_cast< int >(xcount), xview.get< 2 >());
+            xpub.publish(xblob_codec_t::decode(xview.data()));
+            xcount += 1;
+        }));
+    EXPECT_EQ(100u, xcount);
+    EXPECT_EQ(100u, xpub.dispatch());
+
+    int xexpected = 0;
+    for (int xiter = 1; xiter < 100; xiter += 3)
+        xexpected += xiter;
+    EXPECT_EQ(xexpected, xsum);
+
+    // 不完整的末尾记录：遍历在其之前停止
+    xcount = 0;
+    const size_t xtruncated = xbuffer.size() - 8;
+    EXPECT_LT(xblob_codec_t::for_each(xbuffer.data(), xtruncated,
+                                      [&xcount](const xblob_codec_t::x_view_t &) { ++xcount; }),
+              xtruncated);
+    EXPECT_EQ(99u, xcount);
+}
+
+TEST(CodecTest, VerifyRejectsInvalidRecords)
+{
+    xblob_ctxt_t xctxt(std::string("key"), std::string("text"), std::vector< double >{ 1.0 }, 1);
+    std::vector< char > xbuffer;
+    const size_t xsize = xblob_codec_t::encode(xbuffer, xctxt);
+
+    // 字段布局不一致（消息类型不同）
+    EXPECT_NE(static_cast< uint32_t >(xfixed_codec_t::XSIGN),
+              static_cast< uint32_t >(xblob_codec_t::XSIGN));
+    EXPECT_EQ(0u, xfixed_codec_t::verify(xbuffer.data(), xbuffer.size()));
+
+    // 不完整
+    EXPECT_EQ(0u, xblob_codec_t::verify(xbuffer.data(), xsize - 8));
+    EXPECT_EQ(0u, xblob_codec_t::verify(xbuffer.data(), 4));
+
+    // 槽位越界
+    std::vector< char > xcorrupt = xbuffer;
+    xmsg_codec_slot_t xslot = { 0, 1000 };
+    std::memcpy(xcorrupt.data() + xblob_codec_t::x_offset_t< 1 >::value, &xslot, sizeof(xslot));
+    EXPECT_EQ(0u, xblob_codec_t::verify(xcorrupt.data(), xcorrupt.size()));
+
+    xslot.xoffset = 12;
+    xslot.xlength = 1;
+    std::memcpy(xcorrupt.data() + xblob_codec_t::x_offset_t< 1 >::value, &xslot, sizeof(xslot));
+    EXPECT_EQ(0u, xblob_codec_t::verify(xcorrupt.data(), xcorrupt.size()));
+
+    EXPECT_EQ(xsize, xblob_codec_t::verify(xbuffer.data(), xbuffer.size()));
+}
+
+TEST(CodecTest, OversizedRecordIsRejected)
+{
+    std::vector< char > xbuffer(8, '\0');
+    xhuge_ctxt_t xctxt(1, xhuge_t());
+    EXPECT_GT(xhuge_codec_t::encoded_size(xctxt), static_cast< size_t >(UINT32_MAX));
+
+    EXPECT_EQ(0u, xhuge_codec_t::encode(xbuffer, xctxt));
+    EXPECT_EQ(8u, xbuffer.size());
+
+    std::vector< xhuge_ctxt_t > xmsgs(2, xctxt);
+    EXPECT_EQ(0u, xhuge_codec_t::encode(xbuffer, xmsgs.begin(), xmsgs.end()));
+    EXPECT_EQ(8u, xbuffer.size());
+}
@@ -0,0 +1,406 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/**
+ * @file test_concurrent_publisher.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 支持并发订阅的发布者 xmsg_concurrent_publisher_t
+ *          （xmsg_epoch_t 与 xmsg_cow_registry_t）的测试。
+ * </pre>
+ */
+
+#include "xmsg_pubsub.h"
+#include "xmsg_run_loop.h"
+#include "xmsg_concurrent_publisher.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t  = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< int > >;
+using xpublisher_t = xmsg_concurrent_publisher_t< xmsg_ctxt_t >;
+
+/**
+ * @class xcounter_suber_t
+ * @brief 用户自定义的订阅者类。
+ */
+class xcounter_suber_t : public xmsg_subscriber_t< 1, xmsg_ctxt_t >
+{
+public:
+    virtual void translate(const xmsg_ctxt_t & xmsg_ctxt) override
+    {
+        m_xcount += 1;
+        m_xsum   += std::get< 0 >(xmsg_ctxt.args());
+    }
+
+    int m_xcount = 0;
+    int m_xsum   = 0;
+};
+
+/**
+ * @struct xtracked_t
+ * @brief 记录析构次数的对象。
+ */
+struct xtracked_t
+{
+    explicit xtracked_t(std::atomic< int > & xdeleted) : m_xdeleted(xdeleted) { }
+    ~xtracked_t(void) { ++m_xdeleted; }
+
+    std::atomic< int > & m_xdeleted;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(EpochTest, GuardDefersReclaim)
+{
+    xmsg_epoch_t xepoch;
+    std::atomic< int > xdeleted(0);
+    std::atomic< bool > xentered(false);
+    std::atomic< bool > xleave(false);
+
+    std::thread xreader(
+        [&](void)
+        {
+            xmsg_epoch_t::x_guard_t xguard(xepoch);
+            xentered = true;
+            while (!xleave)
+                std::this_thread::yield();
+        });
+    while (!xentered)
+        std::this_thread::yield();
+
+    // 读者仍在临界区内，旧对象不能释放
+    xepoch.retire(new xtracked_t(xdeleted));
+    EXPECT_EQ(0u, xepoch.reclaim());
+    EXPECT_EQ(1u, xepoch.retired());
+    EXPECT_EQ(0, xdeleted.load());
+
+    xleave = true;
+    xreader.join();
+
+    EXPECT_EQ(1u, xepoch.reclaim());
+    EXPECT_EQ(0u, xepoch.retired());
+    EXPECT_EQ(1, xdeleted.load());
+
+    // 退役之后才进入的读者，不影响回收
+    xepoch.retire(new xtracked_t(xdeleted));
+    xepoch.reclaim();
+    {
+        xmsg_epoch_t::x_guard_t xguard(xepoch);
+        EXPECT_EQ(0u, xepoch.retired());
+        EXPECT_EQ(2, xdeleted.load());
+    }
+}
+
+TEST(EpochTest, SynchronizeWaitsForReaders)
+{
+    xmsg_epoch_t xepoch;
+    std::atomic< int > xdeleted(0);
+    std::atomic< bool > xentered(false);
+    std::atomic< bool > xleave(false);
+    std::atomic< bool > xsynced(false);
+
+    std::thread xreader(
+        [&](void)
+        {
+            xmsg_epoch_t::x_guard_t xguard(xepoch);
+            xentered = true;
+            while (!xleave)
+                std::this_thread::yield();
+        });
+    while (!xentered)
+        std::this_thread::yield();
+
+    xepoch.retire(new xtracked_t(xdeleted));
+    std::thread xwriter([&](void) { xepoch.synchronize(); xsynced = true; });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(xsynced.load());
+    EXPECT_EQ(0, xdeleted.load());
+
+    xleave = true;
+    xreader.join();
+    xwriter.join();
+    EXPECT_TRUE(xsynced.load());
+    EXPECT_EQ(1, xdeleted.load());
+}
+
+TEST(ConcurrentPublisherTest, PublishDispatchInOrder)
+{
+    xpublisher_t xpub;
+    std::vector< int > xvec_a;
+    std::vector< int > xvec_b;
+
+    xpub.subscribe(1, [&xvec_a](int xvalue) { xvec_a.push_back(xvalue); });
+    xpub.subscribe(2, [&xvec_b](int xvalue) { xvec_b.push_back(xvalue); });
+
+    for (int xiter = 0; xiter < 5; ++xiter)
+    {
+        EXPECT_TRUE(xpub.publish(1 + (xiter % 2), xiter));
+    }
+    EXPECT_TRUE(xpub.publish(xmsg_ctxt_t(3, 100))); // 没有订阅者
+
+    EXPECT_EQ(6u, xpub.size());
+    EXPECT_EQ(2u, xpub.dispatch(2));
+    EXPECT_EQ(4u, xpub.dispatch_batch());
+    EXPECT_TRUE(xpub.empty());
+
+    EXPECT_EQ((std::vector< int >{ 0, 2, 4 }), xvec_a);
+    EXPECT_EQ((std::vector< int >{ 1, 3 }), xvec_b);
+}
+
+TEST(ConcurrentPublisherTest, UnsubscribeAndUserSubscriber)
+{
+    xpublisher_t xpub;
+    xcounter_suber_t xsuber;
+    int xcount = 0;
+
+    xpublisher_t::x_subscriber_t * xsub_ptr = &xsuber;
+    EXPECT_TRUE(xpub.subscribe(2, xsub_ptr).is_valid());
+    EXPECT_FALSE(xpub.subscribe(2, xsub_ptr).is_valid()); // 重复订阅
+
+    xpublisher_t::x_subkey_t xsub_key = xpub.subscribe(2, [&xcount](int) { ++xcount; });
+    EXPECT_EQ(2u, xpub.subscribers(2));
+
+    xpub.publish(2, 5);
+    xpub.dispatch();
+    EXPECT_EQ(1, xsuber.m_xcount);
+    EXPECT_EQ(5, xsuber.m_xsum);
+    EXPECT_EQ(1, xcount);
+
+    // 没有读者时，写操作之后旧版本立即被释放
+    xpub.unsubscribe(xsub_key);
+    EXPECT_FALSE(xsub_key.is_valid());
+    EXPECT_EQ(0u, xpub.registry().retired());
+
+    xpub.unsubscribe(2, xsub_ptr);
+    EXPECT_EQ(0u, xpub.subscribers(2));
+    EXPECT_EQ(0u, xpub.registry().keys());
+
+    xpub.publish(2, 5);
+    xpub.dispatch();
+    EXPECT_EQ(1, xsuber.m_xcount);
+    EXPECT_EQ(1, xcount);
+
+    xpub.subscribe(3, [&xcount](int) { ++xcount; });
+    xpub.subscribe(3, [&xcount](int) { ++xcount; });
+    xpub.unsubscribe(3);
+    xpub.publish(3, 0);
+    xpub.dispatch();
+    EXPECT_EQ(1, xcount);
+}
+
+TEST(ConcurrentPublisherTest, ChangesApplyFromNextMessage)
+{
+    xpublisher_t xpub;
+    std::vector< int > xorder;
+
+    // 第一个订阅者取消第二个订阅者，并加入第三个订阅者：
+    // 当前消息仍按快照投递给第二个订阅者，下一条消息才生效
+    xpublisher_t::x_subkey_t xkey_b;
+    xpublisher_t::x_subkey_t xkey_a =
+        xpub.subscribe(1,
+                       [&](int xvalue)
+                       {
+                           xorder.push_back(10 + xvalue);
+                           if (0 == xvalue)
+                           {
+                               xpub.unsubscribe(xkey_b);
+                               xpub.subscribe(1, [&xorder](int xvalue) { xorder.push_back(30 + xvalue); });
+                               EXPECT_GT(xpub.registry().retired(), 0u);
+                           }
+                       });
+    xkey_b = xpub.subscribe(1, [&xorder](int xvalue) { xorder.push_back(20 + xvalue); });
+    ASSERT_TRUE(xkey_a.is_valid());
+
+    xpub.publish(1, 0);
+    xpub.publish(1, 1);
+    xpub.dispatch();
+
+    EXPECT_EQ((std::vector< int >{ 10, 20, 11, 31 }), xorder);
+
+    // 投递结束后，下一次写操作即可回收旧版本
+    xpub.unsubscribe(xkey_a);
+    EXPECT_EQ(0u, xpub.registry().retired());
+}
+
+TEST(ConcurrentPublisherTest, RegistryGrows)
+{
+    xpublisher_t xpub;
+    const int xkeys = 1000;
+    std::vector< int > xcounts(xkeys, 0);
+
+    for (int xkey = 0; xkey < xkeys; ++xkey)
+        xpub.subscribe(xkey, [&xcounts, xkey](int xvalue) { xcounts[xkey] += xvalue; });
+
+    EXPECT_EQ(static_cast< size_t >(xkeys), xpub.registry().keys());
+    EXPECT_GE(xpub.registry().buckets() * 2, static_cast< size_t >(xkeys));
+
+    for (int xkey = 0; xkey < xkeys; ++xkey)
+        xpub.publish(xkey, xkey + 1);
+    EXPECT_EQ(static_cast< size_t >(xkeys), xpub.dispatch());
+
+    for (int xkey = 0; xkey < xkeys; ++xkey)
+        EXPECT_EQ(xkey + 1, xcounts[xkey]);
+
+    for (int xkey = 0; xkey < xkeys; xkey += 2)
+        xpub.unsubscribe(xkey);
+    EXPECT_EQ(static_cast< size_t >(xkeys / 2), xpub.registry().keys());
+    EXPECT_EQ(0u, xpub.subscribers(0));
+    EXPECT_EQ(1u, xpub.subscribers(1));
+}
+
+TEST(ConcurrentPublisherTest, SubscribeWhileDispatching)
+{
+    using xnotify_publisher_t =
+        xmsg_concurrent_publisher_t< xmsg_ctxt_t, xmsg_notify_queue_t< xmsg_ctxt_t > >;
+
+    xnotify_publisher_t xpub;
+    std::atomic< int > xstable(0);
+    std::atomic< int > xchurn(0);
+    xpub.subscribe(0, [&xstable](int) { ++xstable; });
+
+    xmsg_run_loop_t< xnotify_publisher_t > xloop(xpub);
+    xloop.start();
+
+    // 会话线程不断地订阅/取消订阅，投递线程同时投递消息
+    std::atomic< bool > xdone(false);
+    std::vector< std::thread > xsessions;
+    for (int xthread = 0; xthread < 3; ++xthread)
+    {
+        xsessions.push_back(std::thread(
+            [&](void)
+            {
+                while (!xdone)
+                {
+                    std::vector< xnotify_publisher_t::x_subkey_t > xkeys;
+                    for (int xiter = 0; xiter < 8; ++xiter)
+                        xkeys.push_back(xpub.subscribe(xiter % 4, [&xchurn](int) { ++xchurn; }));
+                    for (const xnotify_publisher_t::x_subkey_t & xkey : xkeys)
+                        xpub.unsubscribe(xkey);
+                }
+            }));
+    }
+
+    const int xcount = 20000;
+    for (int xiter = 0; xiter < xcount; ++xiter)
+        xpub.publish(xiter % 4, xiter);
+
+    const auto xdeadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while ((xstable < xcount / 4) && (std::chrono::steady_clock::now() < xdeadline))
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    xdone = true;
+    for (std::thread & xthread : xsessions)
+        xthread.join();
+    xloop.stop();
+
+    EXPECT_EQ(xcount / 4, xstable.load());
+    EXPECT_EQ(1u, xpub.subscribers(0));
+    for (int xkey = 1; xkey < 4; ++xkey)
+        EXPECT_EQ(0u, xpub.subscribers(xkey));
+
+    xpub.synchronize();
+    EXPECT_EQ(0u, xpub.registry().retired());
+}
+
+TEST(ConcurrentPublisherTest, SubscribeDuringSynchronize)
+{
+    xpublisher_t xpub;
+    std::atomic< bool > xsyncing(false);
+    std::atomic< bool > xsynced(false);
+    int xcount = 0;
+    std::thread xwriter;
+
+    // 订阅者的消息处理接口中订阅时，另一线程正在 synchronize() 等待该读者
+    xpub.subscribe(1,
+                   [&](int)
+                   {
+                       xwriter = std::thread(
+                           [&](void)
+                           {
+                               xsyncing = true;
+                               xpub.synchronize();
+                               xsynced = true;
+                           });
+                       while (!xsyncing)
+                           std::this_thread::yield();
+                       std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+                       xpub.subscribe(2, [&xcount](int) { ++xcount; });
+                       EXPECT_FALSE(xsynced.load());
+                   });
+
+    xpub.publish(1, 0);
+    xpub.publish(2, 0);
+    EXPECT_EQ(2u, xpub.dispatch());
+    xwriter.join();
+
+    EXPECT_TRUE(xsynced.load());
+    EXPECT_EQ(1, xcount);
+}
+
+TEST(ConcurrentPublisherTest, SynchronizeUnderSustainedLoad)
+{
+    xpublisher_t xpub;
+    std::atomic< bool > xsynced(false);
+    size_t xpending = 0;
+    std::thread xwriter;
+
+    // 一次 dispatch() 投递大量消息期间，synchronize() 也能完成（不必等到 dispatch() 返回）
+    const int xcount = 100000;
+    xpub.subscribe(1,
+                   [&](int xvalue)
+                   {
+                       if (0 == xvalue)
+                       {
+                           xwriter = std::thread([&](void) { xpub.synchronize(); xsynced = true; });
+                       }
+                       else if (!xsynced && (0 == xpending))
+                       {
+                           std::this_thread::yield();
+                       }
+                       else if (xsynced && (0 == xpending))
+                       {
+                           xpending = xpub.size();
+                       }
+                   });
+
+    for (int xiter = 0; xiter < xcount; ++xiter)
+        xpub.publish(1, xiter);
+    EXPECT_EQ(static_cast< size_t >(xcount), xpub.dispatch());
+    xwriter.join();
+
+    EXPECT_GT(xpending, 0u);
+}
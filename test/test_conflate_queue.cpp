@@ -0,0 +1,178 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file test_conflate_queue.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 合并队列 xmsg_conflate_queue_t 的测试（每个消息键只保留最新值）。
+ * </pre>
+ */
+
+#include "xmsg_pubsub.h"
+#include "xmsg_conflate_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @struct xint_key_t / xstr_key_t
+ * @brief 作为 typed test 参数的消息键类型（整数键 与 需要堆内存的字符串键）。
+ */
+struct xint_key_t
+{
+    using type = int;
+    static type make(int xindex) { return xindex; }
+};
+
+struct xstr_key_t
+{
+    using type = std::string;
+    static type make(int xindex)
+    {
+        return std::string("key-long-enough-to-heap-allocate-") + char('a' + xindex);
+    }
+};
+
+/**
+ * @struct xcounted_index_t
+ * @brief 记录元素数量最高水位的索引表（用于观察索引表是否随投递而回收）。
+ */
+template< typename __key_t, typename __value_t, typename __hash_t, typename __equal_t >
+struct xcounted_index_t : std::unordered_map< __key_t, __value_t, __hash_t, __equal_t >
+{
+    using x_super_t = std::unordered_map< __key_t, __value_t, __hash_t, __equal_t >;
+
+    static size_t & high_water(void)
+    {
+        static size_t xhigh = 0;
+        return xhigh;
+    }
+
+    __value_t & operator [] (const __key_t & xkey)
+    {
+        __value_t & xvalue = x_super_t::operator[](xkey);
+        high_water() = std::max(high_water(), x_super_t::size());
+        return xvalue;
+    }
+};
+
+template< typename __key_t >
+class ConflateQueueTest : public ::testing::Test
+{
+};
+
+using xkey_types_t = ::testing::Types< xint_key_t, xstr_key_t >;
+TYPED_TEST_SUITE(ConflateQueueTest, xkey_types_t);
+
+////////////////////////////////////////////////////////////////////////////////
+
+TYPED_TEST(ConflateQueueTest, KeepsLatestValuePerKey)
+{
+    using x_key_t  = typename TypeParam::type;
+    using x_ctxt_t = xmsg_context_t< xmsg_mkey_t< x_key_t >,
+                                     xmsg_args_t< size_t, std::string > >;
+
+    xmsg_publisher_t< x_ctxt_t, xmsg_conflate_queue_t< x_ctxt_t > > xpub;
+    std::vector< std::pair< x_key_t, size_t > > xvec;
+
+    for (int xkey = 0; xkey < 4; ++xkey)
+    {
+        xpub.subscribe(TypeParam::make(xkey), [&, xkey](size_t xvalue, const std::string &)
+        {
+            xvec.emplace_back(TypeParam::make(xkey), xvalue);
+            if (100 == xvalue)
+                xpub.publish(TypeParam::make(xkey), 200, std::string("again"));
+        });
+    }
+
+    for (size_t xiter = 0; xiter < 10; ++xiter)
+        for (int xkey = 0; xkey < 4; ++xkey)
+            xpub.publish(TypeParam::make(xkey), xiter * 10 + xkey, std::string(40, 'x'));
+
+    EXPECT_EQ(4u, xpub.size());
+    EXPECT_EQ(36u, xpub.msg_queue().merges());
+
+    EXPECT_EQ(2u, xpub.dispatch_batch(2));
+    EXPECT_EQ(2u, xpub.size());
+
+    // 键 2 仍在队列中：被覆盖（保持原有位置）；键 0 已投递：重新入队
+    xpub.publish(TypeParam::make(0), 100, std::string("a"));
+    xpub.publish(TypeParam::make(2), 7, std::string("b"));
+    EXPECT_EQ(3u, xpub.size());
+
+    EXPECT_EQ(3u, xpub.dispatch_batch());
+    ASSERT_EQ(5u, xvec.size());
+    EXPECT_EQ(90u, xvec[0].second);
+    EXPECT_EQ(91u, xvec[1].second);
+    EXPECT_EQ(7u, xvec[2].second);
+    EXPECT_EQ(93u, xvec[3].second);
+    EXPECT_EQ(100u, xvec[4].second);
+
+    EXPECT_EQ(1u, xpub.dispatch());
+    EXPECT_EQ(200u, xvec.back().second);
+
+    for (size_t xiter = 0; xiter < 3; ++xiter)
+    {
+        xpub.publish(TypeParam::make(1), xiter, std::string());
+        xpub.dispatch();
+    }
+
+    EXPECT_EQ(2u, xvec.back().second);
+    EXPECT_TRUE(xpub.empty());
+}
+
+TEST(ConflateQueueTest, IndexShrinksWithStandingBacklog)
+{
+    using x_ctxt_t  = xmsg_context_t< xmsg_mkey_t< std::string >, xmsg_args_t< int > >;
+    using x_queue_t = xmsg_conflate_queue_t< x_ctxt_t, xcounted_index_t >;
+
+    xmsg_publisher_t< x_ctxt_t, x_queue_t > xpub;
+    int xsum = 0;
+    for (int xkey = 0; xkey < 1000; ++xkey)
+        xpub.subscribe(std::to_string(xkey), [&xsum](int xvalue) { xsum += xvalue; });
+
+    // 队列始终有积压（从不为空），每个键只发布一次
+    xpub.publish(std::string("0"), 0);
+    for (int xkey = 1; xkey < 1000; ++xkey)
+    {
+        xpub.publish(std::to_string(xkey), xkey);
+        EXPECT_EQ(1u, xpub.dispatch(1));
+    }
+
+    EXPECT_EQ(1u, xpub.dispatch());
+    EXPECT_EQ(999 * 1000 / 2, xsum);
+    using x_index_t = xcounted_index_t< std::string, size_t,
+                                        xmsg_mkey_t< std::string >::x_hash_t,
+                                        xmsg_mkey_t< std::string >::x_equal_t >;
+    EXPECT_EQ(2u, x_index_t::high_water());
+}
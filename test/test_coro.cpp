@@ -0,0 +1,242 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file test_coro.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : C++20 协程支持（xmsg_co_task_t / xmsg_co_executor_t / xmsg_co_stream_t）的测试。
+ * </pre>
+ */
+
+#include "xmsg_pubsub.h"
+#include "xmsg_coro.h"
+#include "xmsg_run_loop.h"
+
+#include <gtest/gtest.h>
+
+#if XMSG_HAS_COROUTINE
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t  = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< int, std::string > >;
+using xpublisher_t = xmsg_publisher_t< xmsg_ctxt_t >;
+using xexecutor_t  = xmsg_co_executor_t< xpublisher_t >;
+using xstream_t    = xmsg_co_stream_t< xpublisher_t >;
+
+/**
+ * @struct xresume_from_t
+ * @brief 模拟异步 I/O：在另一个线程中完成操作后，经由执行器恢复协程。
+ */
+struct xresume_from_t
+{
+    xexecutor_t & xexec;
+    std::thread & xthread;
+
+    bool await_ready(void) const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> xhandle)
+    {
+        xthread = std::thread([this, xhandle](void) { xexec.post(xhandle); });
+    }
+
+    void await_resume(void) const noexcept { }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(CoroTest, HandlerSuspendsWithoutBlockingDispatch)
+{
+    xpublisher_t xpub;
+    xexecutor_t  xexec(xpub);
+    std::vector< std::string > xtrace;
+
+    xpub.subscribe(1,
+        [&xexec, &xtrace](int xvalue, std::string xtext) -> xmsg_co_task_t
+        {
+            xtrace.push_back("beg" + std::to_string(xvalue));
+            co_await xexec.schedule();
+            xtrace.push_back(xtext);
+        });
+
+    xpub.publish(1, 1, std::string("one"));
+    xpub.publish(1, 2, std::string("two"));
+
+    // 两个处理协程都在第一次挂起时返回，不阻塞后续消息的投递
+    EXPECT_EQ(xexec.dispatch(), 2u);
+    EXPECT_EQ(xtrace, (std::vector< std::string >{ "beg1", "beg2" }));
+    EXPECT_FALSE(xexec.empty());
+
+    // 按值传递的参数在挂起之后依然有效
+    EXPECT_EQ(xexec.dispatch(), 2u);
+    EXPECT_EQ(xtrace, (std::vector< std::string >{ "beg1", "beg2", "one", "two" }));
+    EXPECT_TRUE(xexec.empty());
+}
+
+TEST(CoroTest, ResumesOnDispatcherThread)
+{
+    xpublisher_t xpub;
+    xexecutor_t  xexec(xpub);
+    std::thread  xio_thread;
+    std::thread::id xresumed_on;
+    bool xdone = false;
+
+    xpub.subscribe(1,
+        [&](int, std::string) -> xmsg_co_task_t
+        {
+            co_await xresume_from_t{ xexec, xio_thread };
+            xresumed_on = std::this_thread::get_id();
+            xdone = true;
+        });
+
+    xpub.publish(1, 1, std::string());
+    EXPECT_EQ(xexec.dispatch(), 1u);
+
+    while (!xdone)
+    {
+        xexec.dispatch();
+        std::this_thread::yield();
+    }
+
+    xio_thread.join();
+    EXPECT_EQ(xresumed_on, std::this_thread::get_id());
+}
+
+TEST(CoroTest, StreamNextMessage)
+{
+    xpublisher_t xpub;
+    std::vector< int > xvalues;
+    bool xfinished = false;
+
+    auto xconsumer = [&](xstream_t & xstream) -> xmsg_co_task_t
+    {
+        while (std::optional< xstream_t::x_args_t > xargs = co_await xstream.next_message())
+        {
+            xvalues.push_back(std::get< 0 >(*xargs));
+        }
+        xfinished = true;
+    };
+
+    xstream_t xstream(xpub, 7);
+
+    // 消费者协程开始等待之前发布的消息被缓存
+    xpub.publish(7, 1, std::string());
+    xpub.publish(8, 100, std::string());
+    xpub.dispatch();
+    EXPECT_EQ(xstream.size(), 1u);
+
+    xconsumer(xstream);
+    EXPECT_EQ(xvalues, (std::vector< int >{ 1 }));
+    EXPECT_EQ(xstream.size(), 0u);
+
+    xpub.publish(7, 2, std::string());
+    xpub.publish(7, 3, std::string());
+    xpub.dispatch();
+    EXPECT_EQ(xvalues, (std::vector< int >{ 1, 2, 3 }));
+    EXPECT_FALSE(xfinished);
+
+    xstream.close();
+    EXPECT_TRUE(xfinished);
+
+    xpub.publish(7, 4, std::string());
+    xpub.dispatch();
+    EXPECT_EQ(xvalues, (std::vector< int >{ 1, 2, 3 }));
+}
+
+TEST(CoroTest, StreamOwnedByConsumer)
+{
+    xpublisher_t xpub;
+    std::vector< std::string > xtexts;
+
+    // 消息流为消费者协程的局部对象：协程在消息处理接口内恢复、结束，
+    // 并随之销毁消息流（取消订阅）
+    auto xconsumer = [&](xpublisher_t & xpub, size_t xcount) -> xmsg_co_task_t
+    {
+        xstream_t xstream(xpub, 1);
+        for (size_t xiter = 0; xiter < xcount; ++xiter)
+        {
+            std::optional< xstream_t::x_args_t > xargs = co_await xstream.next_message();
+            xtexts.push_back(std::get< 1 >(*xargs));
+        }
+    };
+
+    xconsumer(xpub, 2);
+
+    xpub.publish(1, 0, std::string("a"));
+    xpub.publish(1, 0, std::string("b"));
+    xpub.publish(1, 0, std::string("c"));
+    EXPECT_EQ(xpub.dispatch(), 3u);
+    EXPECT_EQ(xtexts, (std::vector< std::string >{ "a", "b" }));
+}
+
+TEST(CoroTest, RunLoopResumesPostedCoroutines)
+{
+    using xnotify_pub_t = xmsg_publisher_t< xmsg_ctxt_t, xmsg_notify_queue_t< xmsg_ctxt_t > >;
+    using xnotify_exec_t = xmsg_co_executor_t< xnotify_pub_t >;
+
+    xnotify_pub_t  xpub;
+    xnotify_exec_t xexec(xpub);
+    xmsg_run_loop_t< xnotify_exec_t > xloop(xexec);
+
+    std::atomic< int > xstage(0);
+    std::thread::id xloop_id;
+    std::thread::id xresumed_on;
+
+    xpub.subscribe(1,
+        [&](int, std::string) -> xmsg_co_task_t
+        {
+            xloop_id = std::this_thread::get_id();
+            xstage.store(1);
+            co_await xexec.schedule();
+            xresumed_on = std::this_thread::get_id();
+            xstage.store(2);
+        });
+
+    xloop.start();
+    xpub.publish(1, 0, std::string());
+
+    while (xstage.load() < 2)
+        std::this_thread::yield();
+
+    xloop.stop();
+    EXPECT_EQ(xresumed_on, xloop_id);
+}
+
+#else // !XMSG_HAS_COROUTINE
+
+TEST(CoroTest, Unsupported)
+{
+    GTEST_SKIP() << "C++20 coroutines are not available.";
+}
+
+#endif // XMSG_HAS_COROUTINE
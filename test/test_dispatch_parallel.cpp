@@ -0,0 +1,239 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file test_dispatch_parallel.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 并行投递 dispatch_parallel() 与 xmsg_dispatch_pool_t 的测试。
+ * </pre>
+ */
+
+#include "xmsg_pubsub.h"
+#include "xmsg_mpsc_queue.h"
+#include "xmsg_dispatch_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< size_t, std::string > >;
+
+template< typename __msg_queue_t, template< typename > class __subset_t >
+struct xpublisher_tag_t
+{
+    using x_publisher_t = xmsg_publisher_t< xmsg_ctxt_t, __msg_queue_t, __subset_t >;
+};
+
+template< typename __tag_t >
+class DispatchParallelTest : public ::testing::Test
+{
+};
+
+using xpublisher_types_t = ::testing::Types<
+    xpublisher_tag_t< std::queue< xmsg_ctxt_t >,        xmsg_subset_hash_t >,
+    xpublisher_tag_t< std::queue< xmsg_ctxt_t >,        xmsg_subset_flat_t >,
+    xpublisher_tag_t< xmsg_mpsc_queue_t< xmsg_ctxt_t >, xmsg_subset_flat_t > >;
+TYPED_TEST_SUITE(DispatchParallelTest, xpublisher_types_t);
+
+////////////////////////////////////////////////////////////////////////////////
+
+TYPED_TEST(DispatchParallelTest, PerKeyOrderAndSubscriptionChanges)
+{
+    using x_publisher_t = typename TypeParam::x_publisher_t;
+
+    x_publisher_t        xpub;
+    xmsg_dispatch_pool_t xpool(4);
+
+    const int    XKEY_COUNT = 64;
+    const size_t XMSG_COUNT = 2000;
+
+    std::vector< size_t > xnext(XKEY_COUNT, 0);
+    std::vector< size_t > xcount(XKEY_COUNT, 0);
+    std::atomic< int > xerrors(0);
+
+    for (int xkey = 0; xkey < XKEY_COUNT; ++xkey)
+    {
+        xpub.subscribe(xkey, [&, xkey](size_t xvalue, const std::string & xtext)
+        {
+            // 同一个消息键的消息始终由同一个线程按发布顺序投递
+            if ((xvalue != xnext[xkey]) || (10 != xtext.size()))
+                ++xerrors;
+            xnext[xkey] = xvalue + 1;
+            xcount[xkey] += 1;
+        });
+    }
+
+    // 在投递过程中注销自身，并订阅新的消息键
+    std::atomic< int > xself_calls(0);
+    std::atomic< int > xextra(0);
+    typename x_publisher_t::x_subkey_t xself;
+    xself = xpub.subscribe(0, [&](size_t, const std::string &)
+    {
+        ++xself_calls;
+        xpub.unsubscribe(xself);
+        xpub.subscribe(1, [&](size_t, const std::string &) { ++xextra; });
+    });
+
+    for (size_t xiter = 0; xiter < XMSG_COUNT; ++xiter)
+        for (int xkey = 0; xkey < XKEY_COUNT; ++xkey)
+            xpub.publish(xkey, xiter, std::string(10, 'x'));
+
+    size_t xtotal = xpub.dispatch_parallel(xpool, 1000);
+    EXPECT_EQ(1000u, xtotal);
+    while (!xpub.empty())
+        xtotal += xpub.dispatch_parallel(xpool);
+
+    EXPECT_EQ(XMSG_COUNT * XKEY_COUNT, xtotal);
+    EXPECT_EQ(0, xerrors.load());
+    for (int xkey = 0; xkey < XKEY_COUNT; ++xkey)
+        EXPECT_EQ(XMSG_COUNT, xcount[xkey]);
+    EXPECT_EQ(1, xself_calls.load());
+    EXPECT_GT(xextra.load(), 0);
+}
+
+TYPED_TEST(DispatchParallelTest, SubscribeThenUnsubscribeInHandler)
+{
+    using x_publisher_t = typename TypeParam::x_publisher_t;
+
+    x_publisher_t        xpub;
+    xmsg_dispatch_pool_t xpool(4);
+
+    // 处理接口中订阅后立即取消：无论消息键是否属于当前分区，
+    // 延迟执行的订阅操作都不能在本轮投递结束后重新生效
+    std::atomic< int > xcalls(0);
+    std::atomic< int > xleaked(0);
+    xpub.subscribe(0, [&](size_t, const std::string &)
+    {
+        if (1 != ++xcalls)
+            return;
+
+        for (int xkey = 0; xkey < 16; ++xkey)
+        {
+            typename x_publisher_t::x_subkey_t xsub_key =
+                xpub.subscribe(xkey, [&](size_t, const std::string &) { ++xleaked; });
+            xpub.unsubscribe(xsub_key);
+        }
+    });
+
+    for (int xkey = 0; xkey < 16; ++xkey)
+        xpub.publish(xkey, size_t(0), std::string());
+    EXPECT_EQ(16u, xpub.dispatch_parallel(xpool));
+
+    for (int xkey = 0; xkey < 16; ++xkey)
+        xpub.publish(xkey, size_t(1), std::string());
+    EXPECT_EQ(16u, xpub.dispatch_parallel(xpool));
+
+    EXPECT_EQ(2, xcalls.load());
+    EXPECT_EQ(0, xleaked.load());
+}
+
+TYPED_TEST(DispatchParallelTest, HandlerExceptionIsRethrown)
+{
+    using x_publisher_t = typename TypeParam::x_publisher_t;
+
+    x_publisher_t        xpub;
+    xmsg_dispatch_pool_t xpool(4);
+
+    std::atomic< int > xcalls(0);
+    for (int xkey = 0; xkey < 16; ++xkey)
+    {
+        xpub.subscribe(xkey, [&, xkey](size_t xvalue, const std::string &)
+        {
+            ++xcalls;
+            if ((3 == xkey) && (0 == xvalue))
+            {
+                // 延迟的订阅操作在异常抛出后照常执行
+                xpub.subscribe(100, [&](size_t, const std::string &) { ++xcalls; });
+                throw std::runtime_error("handler");
+            }
+        });
+    }
+
+    for (int xkey = 0; xkey < 16; ++xkey)
+        xpub.publish(xkey, size_t(0), std::string());
+    EXPECT_THROW(xpub.dispatch_parallel(xpool), std::runtime_error);
+    EXPECT_TRUE(xpub.empty());
+
+    // 发布者与线程池仍可正常使用
+    xcalls = 0;
+    for (int xkey = 0; xkey < 16; ++xkey)
+        xpub.publish(xkey, size_t(1), std::string());
+    xpub.publish(100, size_t(1), std::string());
+    EXPECT_EQ(17u, xpub.dispatch_parallel(xpool));
+    EXPECT_EQ(17, xcalls.load());
+}
+
+TEST(DispatchPoolTest, RunCoversAllIndices)
+{
+    for (size_t xthreads : { 1, 3 })
+    {
+        xmsg_dispatch_pool_t xpool(xthreads);
+        std::vector< std::atomic< int > > xhits(100);
+        for (std::atomic< int > & xhit : xhits)
+            xhit = 0;
+
+        xpool.run(xhits.size(), [&xhits](size_t xindex) { xhits[xindex] += 1; });
+        for (std::atomic< int > & xhit : xhits)
+            EXPECT_EQ(1, xhit.load());
+    }
+}
+
+TEST(DispatchPoolTest, RunRethrowsAfterAllThreadsFinish)
+{
+    for (size_t xthreads : { 1, 3 })
+    {
+        xmsg_dispatch_pool_t xpool(xthreads);
+
+        // 调用线程与工作线程都可能领取到抛出异常的分区
+        for (int xround = 0; xround < 50; ++xround)
+        {
+            std::atomic< int > xdone(0);
+            EXPECT_THROW(xpool.run(64, [&xdone](size_t xindex)
+                         {
+                             if (0 == (xindex % 8))
+                                 throw std::runtime_error("task");
+                             ++xdone;
+                         }),
+                         std::runtime_error);
+            EXPECT_LT(xdone.load(), 64);
+        }
+
+        std::vector< std::atomic< int > > xhits(100);
+        for (std::atomic< int > & xhit : xhits)
+            xhit = 0;
+
+        xpool.run(xhits.size(), [&xhits](size_t xindex) { xhits[xindex] += 1; });
+        for (std::atomic< int > & xhit : xhits)
+            EXPECT_EQ(1, xhit.load());
+    }
+}
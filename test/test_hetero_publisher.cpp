@@ -0,0 +1,237 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file test_hetero_publisher.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 多参数类型发布者 xmsg_hetero_publisher_t 与 字节流队列 xmsg_byte_queue_t 的测试。
+ * </pre>
+ */
+
+#include "xmsg_pubsub.h"
+#include "xmsg_hetero_publisher.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @struct xcounted_t
+ * @brief 统计 构造/析构 次数的参数类型。
+ */
+struct xcounted_t
+{
+    static int xlive;
+
+    int xvalue;
+
+    explicit xcounted_t(int xvalue) : xvalue(xvalue) { ++xlive; }
+    xcounted_t(const xcounted_t & xobject) : xvalue(xobject.xvalue) { ++xlive; }
+    ~xcounted_t(void) { --xlive; }
+};
+
+int xcounted_t::xlive = 0;
+
+/**
+ * @struct xaligned_t
+ * @brief 对齐要求为 16 字节的参数类型。
+ */
+struct alignas(16) xaligned_t
+{
+    double xvalue[2];
+};
+
+struct xtopic_text_t    : xmsg_topic_t< int, 0, std::string > { };
+struct xtopic_point_t   : xmsg_topic_t< int, 1, int, int > { };
+struct xtopic_counted_t : xmsg_topic_t< int, 2, xcounted_t > { };
+struct xtopic_aligned_t : xmsg_topic_t< int, 3, char, xaligned_t > { };
+struct xtopic_large_t   : xmsg_topic_t< int, 4, std::array< char, 100000 > > { };
+
+using xpublisher_t = xmsg_hetero_publisher_t<
+                        xtopic_text_t,
+                        xtopic_point_t,
+                        xtopic_counted_t,
+                        xtopic_aligned_t,
+                        xtopic_large_t >;
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(HeteroPublisherTest, DispatchesAllTopicsInPublishOrder)
+{
+    xpublisher_t xpub;
+    std::vector< std::string > xtrace;
+
+    xpub.subscribe< xtopic_text_t >(
+        [&xtrace](const std::string & xtext) { xtrace.push_back("text:" + xtext); });
+    xpub.subscribe< xtopic_point_t >(
+        [&xtrace](int xx, int xy)
+        {
+            xtrace.push_back("point:" + std::to_string(xx) + "," + std::to_string(xy));
+        });
+
+    xpub.publish< xtopic_text_t >("a");
+    xpub.publish< xtopic_point_t >(1, 2);
+    xpub.publish< xtopic_text_t >(std::string("b"));
+    xpub.publish< xtopic_point_t >(3, 4);
+    xpub.publish< xtopic_counted_t >(xcounted_t(0)); // 无订阅者
+    EXPECT_EQ(xpub.size(), 5u);
+
+    EXPECT_EQ(xpub.dispatch(), 5u);
+    EXPECT_TRUE(xpub.empty());
+    EXPECT_EQ(xtrace, (std::vector< std::string >{ "text:a", "point:1,2", "text:b", "point:3,4" }));
+    EXPECT_EQ(xcounted_t::xlive, 0);
+}
+
+TEST(HeteroPublisherTest, MaxCountAndPublishDuringDispatch)
+{
+    xpublisher_t xpub;
+    std::vector< int > xtrace;
+
+    xpub.subscribe< xtopic_point_t >(
+        [&](int xx, int)
+        {
+            xtrace.push_back(xx);
+            if (xx < 3)
+                xpub.publish< xtopic_point_t >(xx + 10, 0);
+        });
+
+    xpub.publish< xtopic_point_t >(1, 0);
+    xpub.publish< xtopic_point_t >(2, 0);
+
+    EXPECT_EQ(xpub.dispatch(1), 1u);
+    EXPECT_EQ(xtrace, (std::vector< int >{ 1 }));
+
+    EXPECT_EQ(xpub.dispatch(), 3u);
+    EXPECT_EQ(xtrace, (std::vector< int >{ 1, 2, 11, 12 }));
+}
+
+TEST(HeteroPublisherTest, UnsubscribeByKeyAndByTopic)
+{
+    xpublisher_t xpub;
+    int xcount = 0;
+
+    xpublisher_t::x_topic_t< xtopic_text_t >::x_subkey_t xsub_key =
+        xpub.subscribe< xtopic_text_t >([&xcount](const std::string &) { xcount += 1; });
+    xpub.subscribe< xtopic_point_t >([&xcount](int, int) { xcount += 100; });
+
+    xpub.publish< xtopic_text_t >("x");
+    xpub.publish< xtopic_point_t >(0, 0);
+    xpub.dispatch();
+    EXPECT_EQ(xcount, 101);
+
+    xpub.unsubscribe< xtopic_text_t >(xsub_key);
+    xpub.unsubscribe< xtopic_point_t >();
+    EXPECT_FALSE(xsub_key.is_valid());
+
+    xpub.publish< xtopic_text_t >("x");
+    xpub.publish< xtopic_point_t >(0, 0);
+    xpub.dispatch();
+    EXPECT_EQ(xcount, 101);
+}
+
+TEST(HeteroPublisherTest, AlignmentAndLargeRecords)
+{
+    xpublisher_t xpub;
+    size_t xmisaligned = 0;
+    size_t xlarge_sum  = 0;
+
+    xpub.subscribe< xtopic_aligned_t >(
+        [&xmisaligned](char, const xaligned_t & xvalue)
+        {
+            if (0 != (reinterpret_cast< size_t >(&xvalue) % alignof(xaligned_t)))
+                xmisaligned += 1;
+        });
+    xpub.subscribe< xtopic_large_t >(
+        [&xlarge_sum](const std::array< char, 100000 > & xdata) { xlarge_sum += xdata[99999]; });
+
+    std::array< char, 100000 > xdata;
+    xdata.fill(1);
+
+    for (int xround = 0; xround < 3; ++xround)
+    {
+        for (int xiter = 0; xiter < 1000; ++xiter)
+        {
+            xpub.publish< xtopic_text_t >(std::string(static_cast< size_t >(xiter % 7), 't'));
+            xpub.publish< xtopic_aligned_t >('c', xaligned_t{ { 1.0, 2.0 } });
+        }
+        xpub.publish< xtopic_large_t >(xdata);
+        xpub.dispatch();
+    }
+
+    EXPECT_EQ(xmisaligned, 0u);
+    EXPECT_EQ(xlarge_sum, 3u);
+
+    // 超大的记录读取完毕即释放，常规大小的内存块则被重复使用
+    const size_t xchunks = xpub.msg_queue().chunks();
+    for (int xiter = 0; xiter < 1000; ++xiter)
+        xpub.publish< xtopic_aligned_t >('c', xaligned_t{ { 1.0, 2.0 } });
+    xpub.dispatch();
+    EXPECT_LE(xpub.msg_queue().chunks(), xchunks);
+}
+
+TEST(HeteroPublisherTest, HandlerExceptionReleasesMessage)
+{
+    xpublisher_t xpub;
+    int xcount = 0;
+
+    xpub.subscribe< xtopic_counted_t >(
+        [&xcount](const xcounted_t & xvalue)
+        {
+            xcount += 1;
+            if (0 == xvalue.xvalue)
+                throw std::runtime_error("handler failed");
+        });
+
+    xpub.publish< xtopic_counted_t >(xcounted_t(0));
+    xpub.publish< xtopic_counted_t >(xcounted_t(1));
+    EXPECT_EQ(xcounted_t::xlive, 2);
+
+    EXPECT_THROW(xpub.dispatch(), std::runtime_error);
+    EXPECT_EQ(xcounted_t::xlive, 1);
+    EXPECT_EQ(xpub.size(), 1u);
+
+    EXPECT_EQ(xpub.dispatch(), 1u);
+    EXPECT_EQ(xcount, 2);
+    EXPECT_EQ(xcounted_t::xlive, 0);
+}
+
+TEST(HeteroPublisherTest, DestroysPendingMessages)
+{
+    {
+        xpublisher_t xpub;
+        for (int xiter = 0; xiter < 10000; ++xiter)
+            xpub.publish< xtopic_counted_t >(xcounted_t(xiter));
+        EXPECT_EQ(xcounted_t::xlive, 10000);
+        EXPECT_GT(xpub.msg_queue().chunks(), 1u);
+    }
+
+    EXPECT_EQ(xcounted_t::xlive, 0);
+}
@@ -0,0 +1,462 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/**
+ * @file test_journal.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 消息日志 xmsg_journal_t 与 日志阶段 xmsg_journal_stage_t 的测试。
+ * </pre>
+ */
+
+#include "xmsg_pubsub.h"
+#include "xmsg_journal.h"
+#include "xmsg_ring_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <system_error>
+#include <cstdlib>
+
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t  = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< uint64_t, std::string > >;
+using xpublisher_t = xmsg_publisher_t< xmsg_ctxt_t >;
+using xjournal_t   = xmsg_journal_t< xmsg_ctxt_t >;
+using xstage_t     = xmsg_journal_stage_t< xpublisher_t >;
+
+/**
+ * @struct xhuge_t
+ * @brief 编码后超过 UINT32_MAX 字节的字段（不实际写入数据）。
+ */
+struct xhuge_t
+{
+
+};
+
+template<>
+struct xmsg_codec_field_t< xhuge_t > : xmsg_codec_field_t< uint8_t >
+{
+    static inline size_t extra(const xhuge_t &)
+    {
+        return static_cast< size_t >(UINT32_MAX);
+    }
+
+    static inline void store(char *, size_t, size_t &, const xhuge_t &)
+    {
+
+    }
+};
+
+using xhuge_ctxt_t = xmsg_context_t< xmsg_mkey_t< int >, xmsg_args_t< xhuge_t > >;
+
+/**
+ * @class xtemp_dir_t
+ * @brief 测试用的临时目录（析构时删除目录及其中的文件）。
+ */
+class xtemp_dir_t
+{
+public:
+    xtemp_dir_t(void)
+    {
+        const char * xtmp = std::getenv("TMPDIR");
+        std::string xtemplate = std::string((nullptr != xtmp) ? xtmp : "/tmp") + "/xmsg_journal_XXXXXX";
+        std::vector< char > xbuf(xtemplate.begin(), xtemplate.end());
+        xbuf.push_back('\0');
+        if (nullptr != ::mkdtemp(xbuf.data()))
+            m_xpath = xbuf.data();
+    }
+
+    ~xtemp_dir_t(void)
+    {
+        for (const std::string & xname : files())
+            ::unlink((m_xpath + "/" + xname).c_str());
+        ::rmdir(m_xpath.c_str());
+    }
+
+    const std::string & path(void) const { return m_xpath; }
+
+    std::vector< std::string > files(void) const
+    {
+        std::vector< std::string > xnames;
+        DIR * xdir = ::opendir(m_xpath.c_str());
+        if (nullptr == xdir)
+            return xnames;
+
+        while (struct dirent * xent = ::readdir(xdir))
+        {
+            if ('.' != xent->d_name[0])
+                xnames.push_back(xent->d_name);
+        }
+        ::closedir(xdir);
+        std::sort(xnames.begin(), xnames.end());
+        return xnames;
+    }
+
+private:
+    std::string m_xpath;
+};
+
+static std::string make_text(uint64_t xvalue)
+{
+    return std::string(static_cast< size_t >(xvalue % 97), static_cast< char >('a' + xvalue % 26));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(JournalTest, AppendCommitAndReopen)
+{
+    xtemp_dir_t xdir;
+    ASSERT_FALSE(xdir.path().empty());
+
+    {
+        xjournal_t xjournal;
+        xjournal.open(xdir.path(), 4096);
+        for (uint64_t xiter = 0; xiter < 1000; ++xiter)
+            EXPECT_EQ(xiter, xjournal.append(xmsg_ctxt_t(static_cast< int >(xiter % 4), xiter, make_text(xiter))));
+
+        EXPECT_EQ(0u, xjournal.committed());
+        EXPECT_TRUE(xjournal.commit());
+        EXPECT_EQ(1000u, xjournal.committed());
+        EXPECT_GT(xjournal.segments(), 1u);
+    }
+
+    xjournal_t xjournal;
+    xjournal.open(xdir.path(), 4096);
+    EXPECT_EQ(1000u, xjournal.next_offset());
+    EXPECT_EQ(1000u, xjournal.committed());
+    EXPECT_EQ(250u, xjournal.count(3));
+
+    uint64_t xexpected = 0;
+    EXPECT_EQ(1000u, xjournal.replay(0, UINT64_MAX,
+        [&xexpected](uint64_t xoffset, const xjournal_t::x_view_t & xview)
+        {
+            EXPECT_EQ(xexpected, xoffset);
+            EXPECT_EQ(static_cast< int >(xoffset % 4), xview.mkey());
+            EXPECT_EQ(xoffset, xview.get< 0 >());
+            EXPECT_EQ(make_text(xoffset), std::string(xview.get< 1 >().begin(), xview.get< 1 >().end()));
+            xexpected += 1;
+            return true;
+        }));
+    EXPECT_EQ(1000u, xexpected);
+
+    // 继续追加到已有的日志之后
+    EXPECT_EQ(1000u, xjournal.append(xmsg_ctxt_t(0, static_cast< uint64_t >(1000), std::string("tail"))));
+}
+
+TEST(JournalTest, SegmentsArePreallocated)
+{
+    xtemp_dir_t xdir;
+    ASSERT_FALSE(xdir.path().empty());
+
+    xjournal_t xjournal;
+    xjournal.open(xdir.path(), 64 * 1024);
+    xjournal.append(xmsg_ctxt_t(1, static_cast< uint64_t >(1), std::string("x")));
+
+    // 分段文件的磁盘空间在创建时即已分配（不是稀疏文件）
+    std::vector< std::string > xnames = xdir.files();
+    ASSERT_EQ(1u, xnames.size());
+
+    struct stat xstat;
+    ASSERT_EQ(0, ::stat((xdir.path() + "/" + xnames[0]).c_str(), &xstat));
+    EXPECT_EQ(64 * 1024, xstat.st_size);
+    EXPECT_GE(static_cast< off_t >(xstat.st_blocks) * 512, xstat.st_size);
+}
+
+TEST(JournalTest, ReplayByKeyAndRange)
+{
+    xtemp_dir_t xdir;
+    xjournal_t xjournal;
+    xjournal.open(xdir.path(), 8192);
+
+    for (uint64_t xiter = 0; xiter < 300; ++xiter)
+        xjournal.append(xmsg_ctxt_t(static_cast< int >(xiter % 3), xiter, make_text(xiter)));
+
+    std::vector< uint64_t > xoffsets;
+    EXPECT_EQ(40u, xjournal.replay(2, 100, 220,
+        [&xoffsets](uint64_t xoffset, const xjournal_t::x_view_t & xview)
+        {
+            EXPECT_EQ(2, xview.mkey());
+            xoffsets.push_back(xoffset);
+            return true;
+        }));
+    ASSERT_EQ(40u, xoffsets.size());
+    EXPECT_EQ(101u, xoffsets.front());
+    EXPECT_EQ(218u, xoffsets.back());
+
+    // 处理操作返回 false 时停止
+    size_t xcount = 0;
+    EXPECT_EQ(4u, xjournal.replay(1, 0, UINT64_MAX,
+        [&xcount](uint64_t, const xjournal_t::x_view_t &) { return (++xcount < 5); }));
+    EXPECT_EQ(0u, xjournal.replay(7, 0, UINT64_MAX,
+        [](uint64_t, const xjournal_t::x_view_t &) { return true; }));
+
+    // 顺序回放的起始位置位于中间的分段文件
+    uint64_t xfirst = UINT64_MAX;
+    EXPECT_EQ(300u, xjournal.replay(250, UINT64_MAX,
+        [&xfirst](uint64_t xoffset, const xjournal_t::x_view_t &)
+        {
+            xfirst = std::min(xfirst, xoffset);
+            return true;
+        }));
+    EXPECT_EQ(250u, xfirst);
+}
+
+TEST(JournalTest, CorruptedEntryTruncatesJournal)
+{
+    xtemp_dir_t xdir;
+
+    {
+        xjournal_t xjournal;
+        xjournal.open(xdir.path(), 4096);
+        for (uint64_t xiter = 0; xiter < 200; ++xiter)
+            xjournal.append(xmsg_ctxt_t(1, xiter, make_text(xiter)));
+    }
+
+    std::vector< std::string > xfiles = xdir.files();
+    ASSERT_GE(xfiles.size(), 3u);
+
+    // 破坏第二个分段文件中第一条日志项的负载
+    const std::string xpath = xdir.path() + "/" + xfiles[1];
+    FILE * xfile = std::fopen(xpath.c_str(), "r+b");
+    ASSERT_NE(nullptr, xfile);
+    std::fseek(xfile, 16 + 24, SEEK_SET);
+    std::fputc(0x7F, xfile);
+    std::fclose(xfile);
+
+    const uint64_t xbase = std::strtoull(xfiles[1].c_str(), nullptr, 10);
+
+    xjournal_t xjournal;
+    xjournal.open(xdir.path(), 4096);
+    EXPECT_EQ(xbase, xjournal.next_offset());
+    EXPECT_EQ(1u, xjournal.segments());
+    EXPECT_EQ(1u, xdir.files().size());
+
+    // 在截断之处继续追加
+    EXPECT_EQ(xbase, xjournal.append(xmsg_ctxt_t(1, xbase, std::string("again"))));
+    xjournal.close();
+
+    xjournal.open(xdir.path(), 4096);
+    EXPECT_EQ(xbase + 1, xjournal.next_offset());
+}
+
+TEST(JournalStageTest, SubscribeFromReplaysThenGoesLive)
+{
+    xtemp_dir_t xdir;
+    xjournal_t xjournal;
+    xjournal.open(xdir.path());
+
+    xpublisher_t xpub;
+    xstage_t     xstage(xpub, xjournal);
+
+    for (uint64_t xiter = 0; xiter < 10; ++xiter)
+        EXPECT_TRUE(xstage.publish(static_cast< int >(xiter % 2), xiter, make_text(xiter)));
+    EXPECT_EQ(10u, xstage.dispatch());
+    EXPECT_EQ(10u, xjournal.committed());
+
+    // 已入队未投递的消息：随后实时投递，不回放
+    for (uint64_t xiter = 10; xiter < 14; ++xiter)
+        xstage.publish(static_cast< int >(xiter % 2), xiter, make_text(xiter));
+
+    std::vector< uint64_t > xvalues;
+    xstage.subscribe_from(1, 0, [&xvalues](uint64_t xvalue, const std::string & xtext)
+    {
+        EXPECT_EQ(make_text(xvalue), xtext);
+        xvalues.push_back(xvalue);
+    });
+    EXPECT_EQ((std::vector< uint64_t >{ 1, 3, 5, 7, 9 }), xvalues);
+
+    EXPECT_EQ(4u, xstage.dispatch());
+    EXPECT_EQ((std::vector< uint64_t >{ 1, 3, 5, 7, 9, 11, 13 }), xvalues);
+
+    // 从指定的偏移量开始
+    std::vector< uint64_t > xlate;
+    xstage.subscribe_from(0, 6, [&xlate](uint64_t xvalue, const std::string &) { xlate.push_back(xvalue); });
+    EXPECT_EQ((std::vector< uint64_t >{ 6, 8, 10, 12 }), xlate);
+}
+
+TEST(JournalStageTest, SubscribeFromAfterRestart)
+{
+    xtemp_dir_t xdir;
+
+    {
+        xjournal_t   xjournal;
+        xpublisher_t xpub;
+        xstage_t     xstage(xpub, xjournal);
+        xjournal.open(xdir.path(), 4096);
+
+        for (uint64_t xiter = 0; xiter < 500; ++xiter)
+            xstage.publish(7, xiter, make_text(xiter));
+        xstage.dispatch();
+    }
+
+    xjournal_t   xjournal;
+    xpublisher_t xpub;
+    xstage_t     xstage(xpub, xjournal);
+    xjournal.open(xdir.path(), 4096);
+
+    uint64_t xsum   = 0;
+    size_t   xcount = 0;
+    xstage.subscribe_from(7, 100, [&](uint64_t xvalue, const std::string &)
+    {
+        xsum += xvalue;
+        xcount += 1;
+    });
+    EXPECT_EQ(400u, xcount);
+    EXPECT_EQ((100u + 499u) * 400u / 2u, xsum);
+
+    xstage.publish(7, static_cast< uint64_t >(500), std::string());
+    xstage.dispatch();
+    EXPECT_EQ(401u, xcount);
+}
+
+TEST(JournalStageTest, UnsubscribeDuringReplayStops)
+{
+    xtemp_dir_t xdir;
+    xjournal_t xjournal;
+    xjournal.open(xdir.path());
+
+    xpublisher_t xpub;
+    xstage_t     xstage(xpub, xjournal);
+    for (uint64_t xiter = 0; xiter < 10; ++xiter)
+        xstage.publish(1, xiter, std::string());
+    xstage.dispatch();
+
+    size_t xcount = 0;
+    xstage.subscribe_from(1, 0, [&](uint64_t xvalue, const std::string &)
+    {
+        xcount += 1;
+        if (2 == xvalue)
+            xpub.unsubscribe(1);
+    });
+    EXPECT_EQ(3u, xcount);
+
+    xstage.publish(1, static_cast< uint64_t >(10), std::string());
+    xstage.dispatch();
+    EXPECT_EQ(3u, xcount);
+}
+
+TEST(JournalStageTest, OversizedRecordIsNotPublished)
+{
+    using xhuge_publisher_t = xmsg_publisher_t< xhuge_ctxt_t >;
+    using xhuge_journal_t   = xmsg_journal_t< xhuge_ctxt_t >;
+
+    xtemp_dir_t xdir;
+    xhuge_journal_t xjournal;
+    xjournal.open(xdir.path());
+
+    xhuge_publisher_t xpub;
+    xmsg_journal_stage_t< xhuge_publisher_t > xstage(xpub, xjournal);
+
+    // 追加日志失败时，消息不入队
+    EXPECT_THROW(xstage.publish(1, xhuge_t()), std::system_error);
+    EXPECT_TRUE(xpub.empty());
+    EXPECT_EQ(0u, xjournal.next_offset());
+}
+
+TEST(JournalStageTest, RejectedPublishIsReverted)
+{
+    using xring_publisher_t = xmsg_publisher_t<
+                                xmsg_ctxt_t,
+                                xmsg_ring_queue_t< xmsg_ctxt_t, 4, XOVERFLOW_REJECT > >;
+
+    xtemp_dir_t xdir;
+
+    {
+        xjournal_t        xjournal;
+        xring_publisher_t xpub;
+        xmsg_journal_stage_t< xring_publisher_t > xstage(xpub, xjournal);
+        xjournal.open(xdir.path());
+
+        for (uint64_t xiter = 0; xiter < 4; ++xiter)
+            EXPECT_TRUE(xstage.publish(1, xiter, make_text(xiter)));
+        EXPECT_FALSE(xstage.publish(2, static_cast< uint64_t >(100), make_text(100)));
+        EXPECT_EQ(4u, xjournal.next_offset());
+
+        std::vector< uint64_t > xvalues;
+        xstage.subscribe_from(2, 0, [&xvalues](uint64_t xvalue, const std::string &) { xvalues.push_back(xvalue); });
+        EXPECT_EQ(4u, xstage.dispatch());
+        EXPECT_TRUE(xvalues.empty());
+
+        // 被撤销的偏移量由下一条消息使用
+        EXPECT_TRUE(xstage.publish(1, static_cast< uint64_t >(4), make_text(4)));
+        EXPECT_EQ(1u, xstage.dispatch());
+        EXPECT_EQ(5u, xjournal.committed());
+    }
+
+    xjournal_t xjournal;
+    xjournal.open(xdir.path());
+    EXPECT_EQ(5u, xjournal.next_offset());
+
+    std::vector< uint64_t > xvalues;
+    EXPECT_EQ(5u, xjournal.replay(1, 0, UINT64_MAX,
+        [&xvalues](uint64_t, const xjournal_t::x_view_t & xview)
+        {
+            xvalues.push_back(xview.get< 0 >());
+            return true;
+        }));
+    EXPECT_EQ(0u, xjournal.replay(2, 0, UINT64_MAX,
+        [](uint64_t, const xjournal_t::x_view_t &) { return true; }));
+    EXPECT_EQ((std::vector< uint64_t >{ 0, 1, 2, 3, 4 }), xvalues);
+}
+
+TEST(JournalStageTest, ThrowingHandlerKeepsStageConsistent)
+{
+    xtemp_dir_t xdir;
+    xjournal_t xjournal;
+    xjournal.open(xdir.path());
+
+    xpublisher_t xpub;
+    xstage_t     xstage(xpub, xjournal);
+
+    xpub.subscribe(1, [](uint64_t xvalue, const std::string &)
+    {
+        if (2 == xvalue)
+            throw std::runtime_error("handler");
+    });
+
+    for (uint64_t xiter = 0; xiter < 5; ++xiter)
+        xstage.publish(1, xiter, std::string());
+    EXPECT_THROW(xstage.dispatch(), std::runtime_error);
+
+    // 0 ~ 2 已出队（已投递），3、4 仍在队列中：回放 0 ~ 2，随后实时投递 3、4
+    std::vector< uint64_t > xvalues;
+    xstage.subscribe_from(1, 0, [&xvalues](uint64_t xvalue, const std::string &) { xvalues.push_back(xvalue); });
+    EXPECT_EQ((std::vector< uint64_t >{ 0, 1, 2 }), xvalues);
+
+    EXPECT_EQ(2u, xstage.dispatch());
+    EXPECT_EQ((std::vector< uint64_t >{ 0, 1, 2, 3, 4 }), xvalues);
+}
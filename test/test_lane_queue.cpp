@@ -0,0 +1,128 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file test_lane_queue.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 多优先级通道队列 xmsg_lane_queue_t 的测试。
+ * </pre>
+ */
+
+#include "xmsg_pubsub.h"
+#include "xmsg_lane_queue.h"
+#include "xmsg_ring_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< int > >;
+
+TEST(LaneQueueTest, StrictPriority)
+{
+    xmsg_publisher_t< xmsg_ctxt_t, xmsg_lane_queue_t< xmsg_ctxt_t, 3 > > xpub;
+    std::vector< int > xvec;
+    xpub.subscribe(1, [&xvec](int xvalue) { xvec.push_back(xvalue); });
+
+    xpub.publish(1, 10);
+    xpub.publish(1, 11);
+    xpub.publish(xmsg_prio_t(1), 1, 5);
+    xpub.publish(xmsg_prio_t(0), 1, 0);
+    xpub.publish(xmsg_prio_t(9), 1, 12); // 超出范围，按最低优先级处理
+
+    EXPECT_EQ(1u, xpub.msg_queue().lane_size(0));
+    EXPECT_EQ(1u, xpub.msg_queue().lane_size(1));
+    EXPECT_EQ(3u, xpub.msg_queue().lane_size(2));
+
+    EXPECT_EQ(5u, xpub.dispatch());
+    EXPECT_EQ((std::vector< int >{ 0, 5, 10, 11, 12 }), xvec);
+}
+
+TEST(LaneQueueTest, WeightedRoundRobin)
+{
+    xmsg_publisher_t< xmsg_ctxt_t, xmsg_lane_queue_t< xmsg_ctxt_t, 2, XLANE_WEIGHTED > > xpub;
+    std::vector< int > xvec;
+    xpub.subscribe(1, [&xvec](int xvalue) { xvec.push_back(xvalue); });
+
+    for (int xiter = 0; xiter < 6; ++xiter)
+        xpub.publish(xmsg_prio_t(0), 1, xiter);
+    for (int xiter = 0; xiter < 3; ++xiter)
+        xpub.publish(1, 100 + xiter);
+
+    // 默认权重 2:1
+    xpub.dispatch();
+    EXPECT_EQ((std::vector< int >{ 0, 1, 100, 2, 3, 101, 4, 5, 102 }), xvec);
+
+    // 修改权重：新的权重从下一轮开始生效
+    xvec.clear();
+    xpub.msg_queue().set_weight(0, 1);
+    for (int xiter = 0; xiter < 3; ++xiter)
+    {
+        xpub.publish(xmsg_prio_t(0), 1, xiter);
+        xpub.publish(1, 100 + xiter);
+    }
+
+    xpub.dispatch();
+    EXPECT_EQ((std::vector< int >{ 0, 1, 100, 2, 101, 102 }), xvec);
+}
+
+TEST(LaneQueueTest, HighPriorityPreemptsBatch)
+{
+    xmsg_publisher_t< xmsg_ctxt_t, xmsg_lane_queue_t< xmsg_ctxt_t, 2 > > xpub;
+    std::vector< int > xvec;
+    xpub.subscribe(1, [&](int xvalue)
+    {
+        xvec.push_back(xvalue);
+        if (100 == xvalue)
+            xpub.publish(xmsg_prio_t(0), 1, 1);
+    });
+
+    xpub.publish(1, 100);
+    xpub.publish(1, 101);
+    xpub.publish(1, 102);
+
+    EXPECT_EQ(3u, xpub.dispatch_batch());
+    EXPECT_EQ((std::vector< int >{ 100, 1, 101 }), xvec);
+    EXPECT_EQ(1u, xpub.dispatch());
+}
+
+TEST(LaneQueueTest, BoundedLanesReportRejects)
+{
+    using x_lane_t = xmsg_ring_queue_t< xmsg_ctxt_t, 4, XOVERFLOW_REJECT >;
+    xmsg_publisher_t< xmsg_ctxt_t, xmsg_lane_queue_t< xmsg_ctxt_t, 2, XLANE_STRICT, x_lane_t > > xpub;
+    xpub.subscribe(1, [](int) { });
+
+    int xaccepted = 0;
+    for (int xiter = 0; xiter < 6; ++xiter)
+        xaccepted += xpub.publish(xmsg_prio_t(0), 1, xiter) ? 1 : 0;
+
+    EXPECT_EQ(4, xaccepted);
+    EXPECT_EQ(4u, xpub.dispatch());
+}
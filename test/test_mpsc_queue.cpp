@@ -0,0 +1,140 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file test_mpsc_queue.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 多生产者/单消费者队列 xmsg_mpsc_queue_t 的测试。
+ * </pre>
+ */
+
+#include "xmsg_pubsub.h"
+#include "xmsg_mpsc_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< size_t > >;
+
+TEST(MpscQueueTest, FifoOrder)
+{
+    xmsg_mpsc_queue_t< int > xqueue;
+    EXPECT_TRUE(xqueue.empty());
+
+    for (int xiter = 0; xiter < 10; ++xiter)
+        xqueue.push(xiter);
+    EXPECT_EQ(10u, xqueue.size());
+
+    for (int xiter = 0; xiter < 10; ++xiter)
+    {
+        ASSERT_FALSE(xqueue.empty());
+        EXPECT_EQ(xiter, xqueue.front());
+        xqueue.pop();
+    }
+
+    EXPECT_TRUE(xqueue.empty());
+}
+
+TEST(MpscQueueTest, DetachAndRestore)
+{
+    xmsg_mpsc_queue_t< int > xqueue;
+    xmsg_mpsc_queue_t< int > xbatch;
+
+    for (int xiter = 0; xiter < 4; ++xiter)
+        xqueue.push(xiter);
+
+    xqueue.detach(xbatch);
+    EXPECT_TRUE(xqueue.empty());
+    EXPECT_EQ(4u, xbatch.size());
+
+    xqueue.push(100); // 摘取之后发布的元素
+    xbatch.pop();
+
+    xqueue.restore(xbatch);
+    EXPECT_TRUE(xbatch.empty());
+
+    std::vector< int > xvec;
+    while (!xqueue.empty())
+    {
+        xvec.push_back(xqueue.front());
+        xqueue.pop();
+    }
+
+    EXPECT_EQ((std::vector< int >{ 1, 2, 3, 100 }), xvec);
+}
+
+TEST(MpscQueueTest, ConcurrentProducers)
+{
+    xmsg_publisher_t< xmsg_ctxt_t, xmsg_mpsc_queue_t< xmsg_ctxt_t > > xpub;
+
+    const size_t XPRODUCERS = 4;
+    const size_t XMSG_COUNT = 20000;
+
+    std::vector< size_t > xlast(XPRODUCERS, 0);
+    size_t xtotal = 0;
+    bool   xorder = true;
+
+    for (size_t xiter = 0; xiter < XPRODUCERS; ++xiter)
+    {
+        xpub.subscribe(static_cast< int >(xiter), [&, xiter](size_t xvalue)
+        {
+            // 同一个生产者的消息保持发布顺序
+            if (xvalue != xlast[xiter])
+                xorder = false;
+            xlast[xiter] = xvalue + 1;
+            xtotal += 1;
+        });
+    }
+
+    std::vector< std::thread > xthreads;
+    for (size_t xiter = 0; xiter < XPRODUCERS; ++xiter)
+    {
+        xthreads.push_back(std::thread([&xpub, xiter, XMSG_COUNT](void)
+        {
+            for (size_t xseq = 0; xseq < XMSG_COUNT; ++xseq)
+                xpub.publish(static_cast< int >(xiter), xseq);
+        }));
+    }
+
+    while (xtotal < XPRODUCERS * XMSG_COUNT)
+    {
+        if (0 == xpub.dispatch_batch())
+            std::this_thread::yield();
+    }
+
+    for (std::thread & xthread : xthreads)
+        xthread.join();
+
+    EXPECT_TRUE(xorder);
+    EXPECT_EQ(XPRODUCERS * XMSG_COUNT, xtotal);
+    EXPECT_TRUE(xpub.empty());
+}
@@ -0,0 +1,206 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file test_payload.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 以引用计数共享的消息参数 xmsg_payload_t/xmsg_shared_args_t 的测试。
+ * </pre>
+ */
+
+#include "xmsg_pubsub.h"
+#include "xmsg_payload.h"
+#include "xmsg_mpsc_queue.h"
+#include "xmsg_dispatch_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @struct xcopy_counter_t
+ * @brief 记录拷贝次数的消息参数类型。
+ */
+struct xcopy_counter_t
+{
+    static std::atomic< int > xcopies;
+
+    std::string xtext;
+
+    explicit xcopy_counter_t(const std::string & xtext) : xtext(xtext) { }
+    xcopy_counter_t(const xcopy_counter_t & xobject) : xtext(xobject.xtext) { ++xcopies; }
+    xcopy_counter_t(xcopy_counter_t && xobject) = default;
+};
+
+std::atomic< int > xcopy_counter_t::xcopies(0);
+
+template< xmsg_refcnt_t __refcnt >
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_shared_args_t< xmsg_args_t< int, xcopy_counter_t >, __refcnt > >;
+
+template< typename __refcnt_t >
+class PayloadTest : public ::testing::Test
+{
+protected:
+    void SetUp(void) override { xcopy_counter_t::xcopies = 0; }
+};
+
+using xrefcnt_types_t =
+    ::testing::Types< std::integral_constant< xmsg_refcnt_t, XREFCNT_ATOMIC >,
+                      std::integral_constant< xmsg_refcnt_t, XREFCNT_SINGLE > >;
+TYPED_TEST_SUITE(PayloadTest, xrefcnt_types_t);
+
+////////////////////////////////////////////////////////////////////////////////
+
+TYPED_TEST(PayloadTest, FanOutSharesOneBuffer)
+{
+    using x_ctxt_t = xmsg_ctxt_t< TypeParam::value >;
+
+    xmsg_publisher_t< x_ctxt_t > xpub;
+    std::vector< const xcopy_counter_t * > xseen;
+
+    for (int xkey = 0; xkey < 8; ++xkey)
+    {
+        xpub.subscribe(xkey, [&xseen](int, const xcopy_counter_t & xvalue)
+        {
+            xseen.push_back(&xvalue);
+        });
+    }
+
+    typename x_ctxt_t::x_payload_t xpayload(7, xcopy_counter_t(std::string(4096, 'p')));
+    EXPECT_EQ(1u, xpayload.use_count());
+
+    for (int xkey = 0; xkey < 8; ++xkey)
+        EXPECT_TRUE(xpub.publish(xkey, xpayload));
+    EXPECT_EQ(9u, xpayload.use_count());
+
+    EXPECT_EQ(8u, xpub.dispatch());
+    EXPECT_EQ(1u, xpayload.use_count());
+
+    ASSERT_EQ(8u, xseen.size());
+    for (const xcopy_counter_t * xvalue : xseen)
+        EXPECT_EQ(&std::get< 1 >(xpayload.get()), xvalue);
+
+    EXPECT_EQ(0, xcopy_counter_t::xcopies.load());
+}
+
+TYPED_TEST(PayloadTest, RepublishContext)
+{
+    using x_ctxt_t = xmsg_ctxt_t< TypeParam::value >;
+
+    xmsg_publisher_t< x_ctxt_t > xpub;
+    int xcount = 0;
+    xpub.subscribe(1, [&xcount](int xvalue, const xcopy_counter_t & xtext)
+    {
+        EXPECT_EQ(3, xvalue);
+        EXPECT_EQ(std::string("abc"), xtext.xtext);
+        ++xcount;
+    });
+
+    const x_ctxt_t xmsg_ctxt(1, 3, xcopy_counter_t("abc"));
+    for (int xiter = 0; xiter < 4; ++xiter)
+        xpub.publish(xmsg_ctxt);
+    xpub.publish(1, xmsg_ctxt.payload());
+    EXPECT_EQ(6u, xmsg_ctxt.payload().use_count());
+
+    xpub.dispatch();
+    EXPECT_EQ(5, xcount);
+    EXPECT_EQ(1u, xmsg_ctxt.payload().use_count());
+    EXPECT_EQ(0, xcopy_counter_t::xcopies.load());
+}
+
+TYPED_TEST(PayloadTest, ConstructFromArgsOrTuple)
+{
+    using x_ctxt_t = xmsg_ctxt_t< TypeParam::value >;
+    using x_args_t = typename x_ctxt_t::x_args_t;
+
+    xmsg_publisher_t< x_ctxt_t > xpub;
+    std::vector< int > xvec;
+    xpub.subscribe(1, [&xvec](int xvalue, const xcopy_counter_t &) { xvec.push_back(xvalue); });
+
+    xpub.publish(1, 1, xcopy_counter_t("a"));
+    xpub.publish(x_ctxt_t(1, x_args_t(2, xcopy_counter_t("b"))));
+    xpub.dispatch_batch();
+    EXPECT_EQ((std::vector< int >{ 1, 2 }), xvec);
+
+    typename x_ctxt_t::x_payload_t xempty;
+    EXPECT_FALSE(xempty);
+    EXPECT_EQ(0u, xempty.use_count());
+
+    typename x_ctxt_t::x_payload_t xother(3, xcopy_counter_t("c"));
+    xempty = xother;
+    EXPECT_EQ(2u, xother.use_count());
+    xempty = std::move(xother);
+    EXPECT_EQ(1u, xempty.use_count());
+    EXPECT_FALSE(xother);
+}
+
+TEST(PayloadTest, PlainArgsStayMutable)
+{
+    using x_ctxt_t = xmsg_context_t< xmsg_mkey_t< int >, xmsg_args_t< int > >;
+    static_assert(std::is_same< x_ctxt_t::x_payload_t, x_ctxt_t::x_args_t >::value,
+                  "plain args are stored in place");
+
+    x_ctxt_t xmsg_ctxt(1, 2);
+    std::get< 0 >(xmsg_ctxt.args()) = 5;
+    EXPECT_EQ(5, std::get< 0 >(xmsg_ctxt.payload()));
+}
+
+TEST(PayloadTest, AtomicPayloadAcrossThreads)
+{
+    using x_ctxt_t = xmsg_ctxt_t< XREFCNT_ATOMIC >;
+
+    xmsg_dispatch_pool_t xpool(3);
+    xmsg_publisher_t< x_ctxt_t, xmsg_mpsc_queue_t< x_ctxt_t > > xpub;
+
+    std::atomic< int > xcount(0);
+    for (int xkey = 0; xkey < 16; ++xkey)
+        xpub.subscribe(xkey, [&xcount](int, const xcopy_counter_t &) { ++xcount; });
+
+    typename x_ctxt_t::x_payload_t xpayload(1, xcopy_counter_t(std::string(256, 'z')));
+
+    std::thread xproducer([&xpub, xpayload](void)
+    {
+        for (int xiter = 0; xiter < 20000; ++xiter)
+            xpub.publish(xiter % 16, xpayload);
+    });
+
+    while (xcount < 20000)
+    {
+        if (0 == xpub.dispatch_parallel(xpool))
+            std::this_thread::yield();
+    }
+    xproducer.join();
+
+    EXPECT_EQ(1u, xpayload.use_count());
+    EXPECT_EQ(0, xcopy_counter_t::xcopies.load());
+}
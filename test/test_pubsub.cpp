@@ -0,0 +1,357 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file test_pubsub.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : xmsg_publisher_t 的基本功能测试：订阅/取消订阅、发布/投递、
+ *          批量投递、投递过程中的订阅变更（xmsg_subset_hash_t/xmsg_subset_flat_t）。
+ * </pre>
+ */
+
+#include "xmsg_pubsub.h"
+#include "xmsg_mpsc_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< int > >;
+
+using xmsg_sctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< std::string > >;
+
+/**
+ * @struct xsubset_hash_t / xsubset_flat_t
+ * @brief 作为 typed test 参数的订阅者集合类型。
+ */
+struct xsubset_hash_t
+{
+    template< typename __ctxt_t, typename __queue_t = std::queue< __ctxt_t > >
+    using x_publisher_t = xmsg_publisher_t< __ctxt_t, __queue_t, xmsg_subset_hash_t >;
+};
+
+struct xsubset_flat_t
+{
+    template< typename __ctxt_t, typename __queue_t = std::queue< __ctxt_t > >
+    using x_publisher_t = xmsg_publisher_t< __ctxt_t, __queue_t, xmsg_subset_flat_t >;
+};
+
+template< typename __subset_t >
+class PubSubTest : public ::testing::Test
+{
+};
+
+using xsubset_types_t = ::testing::Types< xsubset_hash_t, xsubset_flat_t >;
+TYPED_TEST_SUITE(PubSubTest, xsubset_types_t);
+
+/**
+ * @class xcounter_suber_t
+ * @brief 用户自定义的订阅者类。
+ */
+class xcounter_suber_t : public xmsg_subscriber_t< 1, xmsg_ctxt_t >
+{
+public:
+    virtual void translate(const xmsg_ctxt_t & xmsg_ctxt) override
+    {
+        m_xcount += 1;
+        m_xsum   += std::get< 0 >(xmsg_ctxt.args());
+    }
+
+    int m_xcount = 0;
+    int m_xsum   = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+TYPED_TEST(PubSubTest, PublishDispatchInOrder)
+{
+    typename TypeParam::template x_publisher_t< xmsg_ctxt_t > xpub;
+    std::vector< int > xvec_a;
+    std::vector< int > xvec_b;
+
+    xpub.subscribe(1, [&xvec_a](int xvalue) { xvec_a.push_back(xvalue); });
+    xpub.subscribe(2, [&xvec_b](int xvalue) { xvec_b.push_back(xvalue); });
+
+    for (int xiter = 0; xiter < 5; ++xiter)
+    {
+        EXPECT_TRUE(xpub.publish(1 + (xiter % 2), xiter));
+    }
+    EXPECT_TRUE(xpub.publish(3, 100)); // 没有订阅者
+
+    EXPECT_EQ(6u, xpub.size());
+    EXPECT_EQ(6u, xpub.dispatch());
+    EXPECT_TRUE(xpub.empty());
+
+    EXPECT_EQ((std::vector< int >{ 0, 2, 4 }), xvec_a);
+    EXPECT_EQ((std::vector< int >{ 1, 3 }), xvec_b);
+}
+
+TYPED_TEST(PubSubTest, DispatchMaxCount)
+{
+    typename TypeParam::template x_publisher_t< xmsg_ctxt_t > xpub;
+    int xsum = 0;
+    xpub.subscribe(1, [&xsum](int xvalue) { xsum += xvalue; });
+
+    for (int xiter = 1; xiter <= 10; ++xiter)
+        xpub.publish(1, xiter);
+
+    EXPECT_EQ(3u, xpub.dispatch(3));
+    EXPECT_EQ(6, xsum);
+    EXPECT_EQ(7u, xpub.size());
+    EXPECT_EQ(7u, xpub.dispatch());
+    EXPECT_EQ(55, xsum);
+}
+
+TYPED_TEST(PubSubTest, UserSubscriber)
+{
+    using x_publisher_t = typename TypeParam::template x_publisher_t< xmsg_ctxt_t >;
+    x_publisher_t    xpub;
+    xcounter_suber_t xsuber;
+
+    typename x_publisher_t::x_subscriber_t * xsub_ptr = &xsuber;
+    EXPECT_TRUE(xpub.subscribe(2, xsub_ptr).is_valid());
+    EXPECT_FALSE(xpub.subscribe(2, xsub_ptr).is_valid()); // 重复订阅
+
+    xpub.publish(2, 5);
+    xpub.dispatch();
+    EXPECT_EQ(1, xsuber.m_xcount);
+    EXPECT_EQ(5, xsuber.m_xsum);
+
+    xpub.unsubscribe(2, xsub_ptr);
+    xpub.publish(2, 5);
+    xpub.dispatch();
+    EXPECT_EQ(1, xsuber.m_xcount);
+}
+
+TYPED_TEST(PubSubTest, MemberFunctionSubscriber)
+{
+    struct xhandler_t
+    {
+        void on_msg(int xbias, int xvalue) { m_xsum += xbias + xvalue; }
+        int m_xsum = 0;
+    } xhandler;
+
+    typename TypeParam::template x_publisher_t< xmsg_ctxt_t > xpub;
+    xpub.subscribe(1, &xhandler_t::on_msg, &xhandler, 100);
+    xpub.publish(1, 1);
+    xpub.publish(1, 2);
+    xpub.dispatch();
+
+    EXPECT_EQ(203, xhandler.m_xsum);
+}
+
+TYPED_TEST(PubSubTest, UnsubscribeByKeyAndByMkey)
+{
+    using x_publisher_t = typename TypeParam::template x_publisher_t< xmsg_ctxt_t >;
+    x_publisher_t xpub;
+    int xcount_a = 0;
+    int xcount_b = 0;
+
+    typename x_publisher_t::x_subkey_t xkey_a =
+        xpub.subscribe(1, [&xcount_a](int) { ++xcount_a; });
+    xpub.subscribe(1, [&xcount_b](int) { ++xcount_b; });
+
+    xpub.publish(1, 0);
+    xpub.dispatch();
+    EXPECT_EQ(1, xcount_a);
+    EXPECT_EQ(1, xcount_b);
+
+    xpub.unsubscribe(xkey_a);
+    EXPECT_FALSE(xkey_a.is_valid());
+    xpub.publish(1, 0);
+    xpub.dispatch();
+    EXPECT_EQ(1, xcount_a);
+    EXPECT_EQ(2, xcount_b);
+
+    xpub.unsubscribe(1);
+    xpub.publish(1, 0);
+    xpub.dispatch();
+    EXPECT_EQ(2, xcount_b);
+}
+
+TYPED_TEST(PubSubTest, UnsubscribeDuringDispatch)
+{
+    using x_publisher_t = typename TypeParam::template x_publisher_t< xmsg_ctxt_t >;
+    x_publisher_t xpub;
+    std::vector< std::string > xvec;
+
+    typename x_publisher_t::x_subkey_t xkey_a;
+    typename x_publisher_t::x_subkey_t xkey_b;
+    typename x_publisher_t::x_subkey_t xkey_c;
+    typename x_publisher_t::x_subkey_t xkey_d;
+
+    // a 取消自身；b 取消 c 并加入 d；c 取消 b
+    xkey_a = xpub.subscribe(1, [&](int xvalue)
+             {
+                 xvec.push_back("a" + std::to_string(xvalue));
+                 xpub.unsubscribe(xkey_a);
+             });
+    xkey_b = xpub.subscribe(1, [&](int xvalue)
+             {
+                 xvec.push_back("b" + std::to_string(xvalue));
+                 xpub.unsubscribe(xkey_c);
+                 if (!xkey_d)
+                 {
+                     xkey_d = xpub.subscribe(1, [&](int xvalue)
+                              {
+                                  xvec.push_back("d" + std::to_string(xvalue));
+                              });
+                 }
+             });
+    xkey_c = xpub.subscribe(1, [&](int xvalue)
+             {
+                 xvec.push_back("c" + std::to_string(xvalue));
+                 xpub.unsubscribe(xkey_b);
+             });
+
+    xpub.publish(1, 1);
+    xpub.publish(1, 2);
+    EXPECT_EQ(2u, xpub.dispatch());
+
+    EXPECT_FALSE(xkey_a.is_valid());
+    EXPECT_EQ(1, std::count(xvec.begin(), xvec.end(), std::string("a1")));
+    EXPECT_EQ(0, std::count(xvec.begin(), xvec.end(), std::string("a2")));
+
+    // b 与 c 中先被调用的一方取消了另一方
+    EXPECT_NE(xkey_b.is_valid(), xkey_c.is_valid());
+}
+
+TYPED_TEST(PubSubTest, DispatchBatchWithRestore)
+{
+    using x_publisher_t =
+        typename TypeParam::template x_publisher_t< xmsg_sctxt_t, xmsg_mpsc_queue_t< xmsg_sctxt_t > >;
+    x_publisher_t xpub;
+    std::vector< std::string > xvec;
+
+    typename x_publisher_t::x_subkey_t xkey_2;
+    xpub.subscribe(1, [&](const std::string & xvalue)
+    {
+        xvec.push_back("1:" + xvalue);
+        if ("c" == xvalue)
+            xpub.publish(1, std::string("late"));
+    });
+    xkey_2 = xpub.subscribe(2, [&](const std::string & xvalue)
+    {
+        xvec.push_back("2:" + xvalue);
+        xpub.unsubscribe(xkey_2);
+    });
+
+    xpub.publish(1, std::string("a"));
+    xpub.publish(1, std::string("b"));
+    xpub.publish(2, std::string("x"));
+    xpub.publish(2, std::string("y"));
+    xpub.publish(1, std::string("c"));
+    xpub.publish(3, std::string("z"));
+    xpub.publish(1, std::string("d"));
+
+    EXPECT_EQ(4u, xpub.dispatch_batch(4));
+    EXPECT_EQ(3u, xpub.size());
+    EXPECT_EQ(3u, xpub.dispatch_batch());
+    EXPECT_EQ(1u, xpub.dispatch_batch()); // 投递过程中发布的消息
+    EXPECT_EQ(0u, xpub.dispatch_batch());
+
+    EXPECT_EQ((std::vector< std::string >{ "1:a", "1:b", "2:x", "1:c", "1:d", "1:late" }), xvec);
+    EXPECT_FALSE(xkey_2.is_valid());
+}
+
+TEST(PubSubTest, EmplacePublishAvoidsTemporaries)
+{
+    static int s_copies = 0;
+
+    struct xpayload_t
+    {
+        xpayload_t(void) { }
+        explicit xpayload_t(int) { }
+        xpayload_t(const xpayload_t &) { ++s_copies; }
+        xpayload_t(xpayload_t &&) { }
+        xpayload_t & operator=(const xpayload_t &) { ++s_copies; return *this; }
+        xpayload_t & operator=(xpayload_t &&) { return *this; }
+    };
+
+    using x_ctxt_t = xmsg_context_t< xmsg_mkey_t< int >, xmsg_args_t< xpayload_t > >;
+
+    xmsg_publisher_t< x_ctxt_t > xpub;
+    int xcount = 0;
+    xpub.subscribe(1, [&xcount](const xpayload_t &) { ++xcount; });
+
+    s_copies = 0;
+    EXPECT_TRUE(xpub.emplace_publish(1, 5));
+    EXPECT_EQ(0, s_copies);
+
+    xpub.dispatch_batch();
+    EXPECT_EQ(1, xcount);
+    EXPECT_EQ(0, s_copies);
+}
+
+TEST(SlabPoolTest, UsableAfterThreadCacheDestroyed)
+{
+    // 该块大小仅在本测试中使用，便于观察全局的空闲链表
+    using x_pool_t = xmsg_slab_pool_t< 4000 >;
+
+    struct xholder_t
+    {
+        void * xblock = nullptr;
+
+        ~xholder_t(void)
+        {
+            // 线程本地缓存此时已经析构
+            x_pool_t::free(x_pool_t::alloc());
+            x_pool_t::free(xblock);
+        }
+    };
+
+    void * xblock = nullptr;
+    std::thread xthread([&xblock](void)
+    {
+        // 先于本地缓存构造，则后于本地缓存析构
+        static thread_local xholder_t xholder;
+        xholder.xblock = x_pool_t::alloc();
+        xblock = xholder.xblock;
+    });
+    xthread.join();
+
+    // 线程退出后，所有内存块（包括析构流程中回收的）都回到全局的空闲链表
+    std::vector< void * > xblocks;
+    bool xfound = false;
+    for (int xiter = 0; xiter < 64; ++xiter)
+    {
+        xblocks.push_back(x_pool_t::alloc());
+        xfound = xfound || (xblock == xblocks.back());
+    }
+    for (void * xptr : xblocks)
+        x_pool_t::free(xptr);
+
+    EXPECT_TRUE(xfound);
+}
@@ -0,0 +1,272 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file test_ring_queue.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 有界环形队列 xmsg_ring_queue_t 的测试（各种溢出策略）。
+ * </pre>
+ */
+
+#include "xmsg_pubsub.h"
+#include "xmsg_ring_queue.h"
+#include "xmsg_dispatch_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <chrono>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< size_t, std::string > >;
+
+template< xmsg_overflow_t __overflow >
+using xpublisher_t = xmsg_publisher_t<
+                        xmsg_ctxt_t,
+                        xmsg_ring_queue_t< xmsg_ctxt_t, 8, __overflow > >;
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(RingQueueTest, RejectWhenFull)
+{
+    xpublisher_t< XOVERFLOW_REJECT > xpub;
+    std::vector< size_t > xvec;
+    xpub.subscribe(1, [&xvec](size_t xvalue, const std::string &) { xvec.push_back(xvalue); });
+
+    for (size_t xiter = 0; xiter < 10; ++xiter)
+    {
+        EXPECT_EQ(xiter < 8, xpub.publish(1, xiter, std::string(40, 'a')));
+    }
+
+    EXPECT_EQ(2u, xpub.msg_queue().drops());
+    EXPECT_EQ(8u, xpub.msg_queue().high_water());
+    EXPECT_EQ(8u, xpub.size());
+
+    EXPECT_EQ(3u, xpub.dispatch(3));
+    EXPECT_EQ(2u, xpub.dispatch_batch(2));
+    EXPECT_EQ(3u, xpub.dispatch());
+
+    ASSERT_EQ(8u, xvec.size());
+    for (size_t xiter = 0; xiter < xvec.size(); ++xiter)
+        EXPECT_EQ(xiter, xvec[xiter]);
+
+    xmsg_dispatch_pool_t xpool(2);
+    EXPECT_TRUE(xpub.publish(xmsg_ctxt_t(1, 99, std::string("x"))));
+    EXPECT_TRUE(xpub.publish(1, 100, std::string("y")));
+    EXPECT_EQ(2u, xpub.dispatch_parallel(xpool));
+    EXPECT_EQ(100u, xvec.back());
+}
+
+TEST(RingQueueTest, DropNewest)
+{
+    xpublisher_t< XOVERFLOW_DROP_NEWEST > xpub;
+    std::vector< size_t > xvec;
+    xpub.subscribe(1, [&xvec](size_t xvalue, const std::string &) { xvec.push_back(xvalue); });
+
+    for (size_t xiter = 0; xiter < 10; ++xiter)
+        xpub.publish(1, xiter, std::string(40, 'a'));
+
+    EXPECT_EQ(2u, xpub.msg_queue().drops());
+    xpub.dispatch_batch();
+    ASSERT_EQ(8u, xvec.size());
+    EXPECT_EQ(7u, xvec.back());
+}
+
+TEST(RingQueueTest, DropOldest)
+{
+    xpublisher_t< XOVERFLOW_DROP_OLDEST > xpub;
+    std::vector< size_t > xvec;
+    xpub.subscribe(1, [&xvec](size_t xvalue, const std::string &) { xvec.push_back(xvalue); });
+
+    for (size_t xiter = 0; xiter < 10; ++xiter)
+        EXPECT_TRUE(xpub.publish(1, xiter, std::string(40, 'a')));
+
+    EXPECT_EQ(2u, xpub.msg_queue().drops());
+    xpub.dispatch_batch();
+    ASSERT_EQ(8u, xvec.size());
+    EXPECT_EQ(2u, xvec.front());
+    EXPECT_EQ(9u, xvec.back());
+}
+
+TEST(RingQueueTest, BlockWithConcurrentProducers)
+{
+    xpublisher_t< XOVERFLOW_BLOCK > xpub;
+    size_t xsum   = 0;
+    size_t xcount = 0;
+    xpub.subscribe(1, [&](size_t xvalue, const std::string &) { xsum += xvalue; ++xcount; });
+
+    const size_t XMSG_COUNT = 20000;
+    std::vector< std::thread > xthreads;
+    for (int xiter = 0; xiter < 3; ++xiter)
+    {
+        xthreads.push_back(std::thread([&xpub, XMSG_COUNT](void)
+        {
+            for (size_t xseq = 0; xseq < XMSG_COUNT; ++xseq)
+                xpub.publish(1, xseq, std::string("s"));
+        }));
+    }
+
+    while (xcount < 3 * XMSG_COUNT)
+    {
+        if (0 == xpub.dispatch_batch())
+            std::this_thread::yield();
+    }
+
+    for (std::thread & xthread : xthreads)
+        xthread.join();
+
+    EXPECT_EQ(3 * (XMSG_COUNT * (XMSG_COUNT - 1) / 2), xsum);
+    EXPECT_EQ(0u, xpub.msg_queue().drops());
+    EXPECT_LE(xpub.msg_queue().high_water(), 8u);
+}
+
+TEST(RingQueueTest, DropOldestWithConcurrentProducer)
+{
+    xpublisher_t< XOVERFLOW_DROP_OLDEST > xpub;
+    std::atomic< bool > xdone(false);
+    size_t xcount = 0;
+    size_t xlast  = 0;
+    bool   xorder = true;
+
+    xpub.subscribe(1, [&](size_t xvalue, const std::string & xtext)
+    {
+        if ((xcount > 0) && (xvalue <= xlast))
+            xorder = false;
+        if (30 != xtext.size())
+            xorder = false;
+        xlast   = xvalue;
+        xcount += 1;
+    });
+
+    const size_t XMSG_COUNT = 100000;
+    std::thread xproducer([&](void)
+    {
+        for (size_t xseq = 0; xseq < XMSG_COUNT; ++xseq)
+            xpub.publish(1, xseq, std::string(30, 'q'));
+        xdone = true;
+    });
+
+    while (!xdone || !xpub.empty())
+        xpub.dispatch();
+    xproducer.join();
+
+    EXPECT_TRUE(xorder);
+    EXPECT_EQ(XMSG_COUNT, xcount + xpub.msg_queue().drops());
+}
+
+TEST(RingQueueTest, EmptyDoesNotTakeFront)
+{
+    xmsg_ring_queue_t< int, 4, XOVERFLOW_DROP_OLDEST > xqueue;
+    const xmsg_ring_queue_t< int, 4, XOVERFLOW_DROP_OLDEST > & xcqueue = xqueue;
+
+    EXPECT_TRUE(xcqueue.empty());
+    xqueue.push(1);
+    EXPECT_FALSE(xcqueue.empty());
+    EXPECT_EQ(1u, xcqueue.size());
+
+    EXPECT_EQ(1, xqueue.front());
+    xqueue.pop();
+    EXPECT_TRUE(xcqueue.empty());
+}
+
+TEST(RingQueueTest, DropOldestBatchExcludesLaterMessages)
+{
+    using x_queue_t = xmsg_ring_queue_t< int, 4, XOVERFLOW_DROP_OLDEST >;
+    x_queue_t xqueue;
+    for (int xiter = 1; xiter <= 4; ++xiter)
+        xqueue.push(xiter);
+
+    x_queue_t::x_batch_t xbatch;
+    xqueue.detach(xbatch);
+
+    // 摘取之后发布的消息挤掉了批次中的 1 、2
+    xqueue.push(5);
+    xqueue.push(6);
+    EXPECT_EQ(2u, xqueue.drops());
+
+    std::vector< int > xvec;
+    while (!xbatch.empty())
+    {
+        xvec.push_back(xbatch.front());
+        xbatch.pop();
+    }
+    xqueue.restore(xbatch);
+    EXPECT_EQ((std::vector< int >{ 3, 4 }), xvec);
+
+    xqueue.detach(xbatch);
+    xvec.clear();
+    while (!xbatch.empty())
+    {
+        xvec.push_back(xbatch.front());
+        xbatch.pop();
+    }
+    xqueue.restore(xbatch);
+    EXPECT_EQ((std::vector< int >{ 5, 6 }), xvec);
+}
+
+TEST(RingQueueTest, BlockedProducersAreWokenByPop)
+{
+    xmsg_ring_queue_t< size_t, 2, XOVERFLOW_BLOCK > xqueue;
+
+    const size_t XMSG_COUNT = 200;
+    std::vector< std::thread > xthreads;
+    for (int xiter = 0; xiter < 4; ++xiter)
+    {
+        xthreads.push_back(std::thread([&xqueue, XMSG_COUNT](void)
+        {
+            for (size_t xseq = 0; xseq < XMSG_COUNT; ++xseq)
+                xqueue.push(xseq);
+        }));
+    }
+
+    // 消费者较慢，生产者会进入等待状态，须由 pop() 唤醒
+    size_t xsum = 0;
+    for (size_t xcount = 0; xcount < 4 * XMSG_COUNT; )
+    {
+        if (xqueue.empty())
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            continue;
+        }
+
+        xsum += xqueue.front();
+        xqueue.pop();
+        xcount += 1;
+    }
+
+    for (std::thread & xthread : xthreads)
+        xthread.join();
+
+    EXPECT_EQ(4 * (XMSG_COUNT * (XMSG_COUNT - 1) / 2), xsum);
+    EXPECT_TRUE(xqueue.empty());
+    EXPECT_EQ(0u, xqueue.drops());
+}
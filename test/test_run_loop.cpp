@@ -0,0 +1,268 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file test_run_loop.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 事件驱动的消息投递循环 xmsg_run_loop_t 的测试。
+ * </pre>
+ */
+
+#include "xmsg_pubsub.h"
+#include "xmsg_run_loop.h"
+#include "xmsg_ring_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif // defined(__linux__)
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t  = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< int > >;
+using xpublisher_t = xmsg_publisher_t< xmsg_ctxt_t, xmsg_notify_queue_t< xmsg_ctxt_t > >;
+using xrun_loop_t  = xmsg_run_loop_t< xpublisher_t >;
+
+/**
+ * @class xjoiner_t
+ * @brief 析构时 join() 线程（断言失败提前返回时，不会因线程仍可 join 而终止进程）。
+ */
+class xjoiner_t
+{
+public:
+    explicit xjoiner_t(std::thread & xthread) : m_xthread(xthread) { }
+    ~xjoiner_t(void) { if (m_xthread.joinable()) m_xthread.join(); }
+
+    xjoiner_t(const xjoiner_t & xobject) = delete;
+    xjoiner_t & operator=(const xjoiner_t & xobject) = delete;
+
+private:
+    std::thread & m_xthread;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(RunLoopTest, WakesOnPublishFromOtherThread)
+{
+    xpublisher_t xpub;
+    std::atomic< int > xcount(0);
+    std::atomic< int > xsum(0);
+    xpub.subscribe(1, [&](int xvalue) { xsum += xvalue; ++xcount; });
+
+    xrun_loop_t xloop(xpub);
+    xloop.start();
+
+    // 分多次突发发布，中间留出空闲时间，让投递线程进入阻塞等待
+    for (int xburst = 0; xburst < 5; ++xburst)
+    {
+        for (int xiter = 0; xiter < 100; ++xiter)
+            xpub.publish(1, xiter);
+
+        const auto xdeadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while ((xcount < 100 * (xburst + 1)) && (std::chrono::steady_clock::now() < xdeadline))
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        ASSERT_EQ(100 * (xburst + 1), xcount.load());
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    xloop.stop();
+    EXPECT_EQ(5 * 4950, xsum.load());
+    EXPECT_GE(xloop.parks(), 1u);
+    EXPECT_GE(xloop.spin(), xrun_loop_t::XSPIN_MIN);
+}
+
+TEST(RunLoopTest, RunForTimesOut)
+{
+    xpublisher_t xpub;
+    xrun_loop_t xloop(xpub);
+
+    const auto xbeg = std::chrono::steady_clock::now();
+    EXPECT_EQ(0u, xloop.run_for(std::chrono::milliseconds(30)));
+    const auto xcost = std::chrono::steady_clock::now() - xbeg;
+
+    EXPECT_GE(xcost, std::chrono::milliseconds(30));
+    EXPECT_LT(xcost, std::chrono::seconds(2));
+    EXPECT_FALSE(xloop.stopped());
+}
+
+TEST(RunLoopTest, RunForTimesOutUnderLoad)
+{
+    xpublisher_t xpub;
+    xrun_loop_t xloop(xpub);
+    std::atomic< bool > xquit(false);
+    xpub.subscribe(1, [](int)
+    {
+        const auto xend = std::chrono::steady_clock::now() + std::chrono::microseconds(1);
+        while (std::chrono::steady_clock::now() < xend) { }
+    });
+
+    // 生产者持续发布，使队列始终不为空
+    std::thread xproducer([&](void)
+    {
+        while (!xquit.load(std::memory_order_relaxed))
+            xpub.publish(1, 0);
+    });
+    xjoiner_t xjoiner(xproducer);
+
+    while (xpub.empty())
+        std::this_thread::yield();
+
+    const auto xbeg = std::chrono::steady_clock::now();
+    const size_t xcount = xloop.run_for(std::chrono::milliseconds(10));
+    const auto xcost = std::chrono::steady_clock::now() - xbeg;
+
+    xquit = true;
+    EXPECT_GT(xcount, 0u);
+    EXPECT_GE(xcost, std::chrono::milliseconds(10));
+    EXPECT_LT(xcost, std::chrono::milliseconds(200));
+}
+
+TEST(RunLoopTest, StopFromHandlerDrainsQueued)
+{
+    xpublisher_t xpub;
+    xrun_loop_t xloop(xpub);
+    std::vector< int > xvec;
+
+    xpub.subscribe(1, [&](int xvalue)
+    {
+        xvec.push_back(xvalue);
+        if (2 == xvalue)
+        {
+            xloop.stop();
+            xpub.publish(1, 99);
+        }
+    });
+
+    for (int xiter = 0; xiter < 5; ++xiter)
+        xpub.publish(1, xiter);
+
+    EXPECT_EQ(6u, xloop.run());
+    EXPECT_EQ((std::vector< int >{ 0, 1, 2, 3, 4, 99 }), xvec);
+    EXPECT_TRUE(xloop.stopped());
+
+    // 停止之后，须 restart() 才能再次运行
+    xpub.publish(1, 7);
+    EXPECT_EQ(1u, xloop.run());
+    xloop.restart();
+    EXPECT_FALSE(xloop.stopped());
+    EXPECT_EQ(0u, xloop.run_for(std::chrono::milliseconds(1)));
+}
+
+TEST(RunLoopTest, StopFromOtherThreadWakesParkedLoop)
+{
+    xpublisher_t xpub;
+    xrun_loop_t xloop(xpub);
+
+    std::thread xstopper([&xloop](void)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        xloop.stop();
+    });
+
+    EXPECT_EQ(0u, xloop.run());
+    xstopper.join();
+}
+
+TEST(RunLoopTest, BoundedInnerQueue)
+{
+    using x_queue_t = xmsg_notify_queue_t< xmsg_ctxt_t,
+                                           xmsg_ring_queue_t< xmsg_ctxt_t, 4, XOVERFLOW_REJECT > >;
+    xmsg_publisher_t< xmsg_ctxt_t, x_queue_t > xpub;
+    int xcount = 0;
+    xpub.subscribe(1, [&xcount](int) { ++xcount; });
+
+    int xaccepted = 0;
+    for (int xiter = 0; xiter < 6; ++xiter)
+        xaccepted += xpub.publish(1, xiter) ? 1 : 0;
+
+    EXPECT_EQ(4, xaccepted);
+    EXPECT_EQ(2u, xpub.msg_queue().queue().drops());
+
+    xmsg_run_loop_t< decltype(xpub) > xloop(xpub);
+    EXPECT_EQ(4u, xloop.run_for(std::chrono::milliseconds(1)));
+    EXPECT_EQ(4, xcount);
+}
+
+#if defined(__linux__)
+
+TEST(RunLoopTest, EpollIntegration)
+{
+    xpublisher_t xpub;
+    xrun_loop_t xloop(xpub);
+    std::atomic< int > xcount(0);
+    xpub.subscribe(1, [&xcount](int) { ++xcount; });
+
+    const int xepfd = ::epoll_create1(EPOLL_CLOEXEC);
+    ASSERT_GE(xepfd, 0);
+    ASSERT_GE(xloop.fd(), 0);
+
+    struct epoll_event xevent = {};
+    xevent.events = EPOLLIN;
+    ASSERT_EQ(0, ::epoll_ctl(xepfd, EPOLL_CTL_ADD, xloop.fd(), &xevent));
+
+    // 队列中已有消息时，arm() 返回 false ，不应阻塞
+    xpub.publish(1, 1);
+    EXPECT_FALSE(xloop.arm());
+    EXPECT_EQ(1u, xloop.poll());
+
+    // arm() 之后才发布消息（由 xarmed 通知生产者线程）
+    std::promise< void > xarmed;
+    std::shared_future< void > xarmed_future = xarmed.get_future().share();
+    std::thread xproducer([&xpub, xarmed_future](void)
+    {
+        xarmed_future.wait();
+        xpub.publish(1, 2);
+    });
+    xjoiner_t xjoiner(xproducer);
+
+    const bool xarmed_ok = xloop.arm();
+    xarmed.set_value();
+    ASSERT_TRUE(xarmed_ok);
+
+    struct epoll_event xready = {};
+    EXPECT_EQ(1, ::epoll_wait(xepfd, &xready, 1, 5000));
+    EXPECT_EQ(1u, xloop.poll());
+    xproducer.join();
+
+    // poll() 清除了唤醒信号：没有新消息时不再可读
+    EXPECT_EQ(0, ::epoll_wait(xepfd, &xready, 1, 0));
+    EXPECT_EQ(2, xcount.load());
+
+    ::close(xepfd);
+}
+
+#endif // defined(__linux__)
@@ -0,0 +1,356 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/**
+ * @file test_sharded_publisher.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 按消息键分片的发布者 xmsg_sharded_publisher_t 的测试。
+ * </pre>
+ */
+
+#include "xmsg_pubsub.h"
+#include "xmsg_run_loop.h"
+#include "xmsg_sharded_publisher.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t  = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< int > >;
+using xpublisher_t = xmsg_publisher_t< xmsg_ctxt_t, xmsg_notify_queue_t< xmsg_ctxt_t > >;
+using xsharded_t   = xmsg_sharded_publisher_t< xpublisher_t >;
+
+/**
+ * @class xcounter_suber_t
+ * @brief 用户自定义的订阅者类。
+ */
+class xcounter_suber_t : public xmsg_subscriber_t< 1, xmsg_ctxt_t >
+{
+public:
+    virtual void translate(const xmsg_ctxt_t & xmsg_ctxt) override
+    {
+        m_xcount += 1;
+        m_xsum   += std::get< 0 >(xmsg_ctxt.args());
+    }
+
+    int m_xcount = 0;
+    int m_xsum   = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(ShardedPublisherTest, RoutesByKeyAndKeepsOrder)
+{
+    const int xkeys = 8;
+    xsharded_t xpub(4);
+    ASSERT_EQ(4u, xpub.shards());
+
+    std::vector< std::vector< int > >     xvalues(xkeys);
+    std::vector< std::thread::id >        xthreads(xkeys);
+    std::vector< std::atomic< int > >     xmismatch(xkeys);
+    for (int xkey = 0; xkey < xkeys; ++xkey)
+    {
+        xmismatch[xkey] = 0;
+        xpub.subscribe(xkey,
+                       [&, xkey](int xvalue)
+                       {
+                           if (xvalues[xkey].empty())
+                               xthreads[xkey] = std::this_thread::get_id();
+                           else if (xthreads[xkey] != std::this_thread::get_id())
+                               ++xmismatch[xkey];
+                           xvalues[xkey].push_back(xvalue);
+                       });
+    }
+
+    xpub.start();
+    for (int xiter = 0; xiter < 4000; ++xiter)
+    {
+        EXPECT_TRUE(xpub.publish(xiter % xkeys, xiter));
+    }
+    xpub.flush();
+
+    for (int xkey = 0; xkey < xkeys; ++xkey)
+    {
+        EXPECT_EQ(static_cast< size_t >(xkey % 4), xpub.home_of(xkey));
+        EXPECT_EQ(xpub.home_of(xkey), xpub.owner_of(xkey));
+        EXPECT_EQ(0, xmismatch[xkey].load());
+
+        ASSERT_EQ(500u, xvalues[xkey].size());
+        for (size_t xiter = 0; xiter < xvalues[xkey].size(); ++xiter)
+        {
+            EXPECT_EQ(static_cast< int >(xiter) * xkeys + xkey, xvalues[xkey][xiter]);
+        }
+    }
+
+    // 不同主分片的消息在不同的投递线程中投递
+    EXPECT_NE(xthreads[0], xthreads[1]);
+    EXPECT_EQ(xthreads[0], xthreads[4]);
+
+    xpub.stop();
+}
+
+TEST(ShardedPublisherTest, RebalanceKeepsOrderUnderLoad)
+{
+    xsharded_t xpub(4);
+    std::vector< int > xvalues;
+    xpub.subscribe(1, [&xvalues](int xvalue) { xvalues.push_back(xvalue); });
+    xpub.start();
+
+    const int xcount = 200000;
+    std::thread xproducer(
+        [&xpub, xcount](void)
+        {
+            for (int xiter = 0; xiter < xcount; ++xiter)
+            {
+                xpub.publish(1, xiter);
+                xpub.publish(5, xiter); // 同一主分片的其他消息
+            }
+        });
+
+    const size_t xtargets[] = { 2, 3, 0, 1, 3 };
+    for (size_t xtarget : xtargets)
+    {
+        EXPECT_TRUE(xpub.rebalance(1, xtarget));
+        EXPECT_EQ(xtarget, xpub.owner_of(1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    EXPECT_FALSE(xpub.rebalance(1, 3));
+
+    xproducer.join();
+    xpub.flush();
+
+    ASSERT_EQ(static_cast< size_t >(xcount), xvalues.size());
+    for (int xiter = 0; xiter < xcount; ++xiter)
+    {
+        ASSERT_EQ(xiter, xvalues[xiter]);
+    }
+
+    xmsg_sharded_stats_t xstats = xpub.stats();
+    EXPECT_EQ(static_cast< uint64_t >(2 * xcount), xstats.xshards[1].xpublished);
+    EXPECT_EQ(xstats.xshards[1].xforwarded,
+              xstats.xshards[0].xinbound + xstats.xshards[2].xinbound + xstats.xshards[3].xinbound);
+    EXPECT_EQ(1u, xstats.xshards[3].xkeys);
+    EXPECT_EQ(0u, xstats.xshards[1].xkeys);
+
+    xpub.stop();
+}
+
+TEST(ShardedPublisherTest, SkewStats)
+{
+    // 未 start() 时，flush() 在当前线程中投递
+    xsharded_t xpub(2);
+    int xcount_0 = 0;
+    int xcount_1 = 0;
+    xpub.subscribe(0, [&xcount_0](int) { ++xcount_0; });
+    xpub.subscribe(1, [&xcount_1](int) { ++xcount_1; });
+
+    for (int xiter = 0; xiter < 90; ++xiter)
+        xpub.publish(0, xiter);
+    for (int xiter = 0; xiter < 10; ++xiter)
+        xpub.publish(1, xiter);
+    xpub.flush();
+    EXPECT_EQ(90, xcount_0);
+    EXPECT_EQ(10, xcount_1);
+
+    xmsg_sharded_stats_t xstats = xpub.stats();
+    ASSERT_EQ(2u, xstats.xshards.size());
+    EXPECT_EQ(100u, xstats.xtotal);
+    EXPECT_EQ(0u, xstats.xhottest);
+    EXPECT_DOUBLE_EQ(1.8, xstats.xskew);
+    EXPECT_EQ(1u, xstats.xshards[0].xkeys);
+    EXPECT_EQ(-1, xstats.xshards[0].xcpu);
+
+    // 迁移热点消息后，负载转移到目标分片
+    EXPECT_TRUE(xpub.rebalance(0, 1));
+    for (int xiter = 0; xiter < 100; ++xiter)
+        xpub.publish(0, xiter);
+    xpub.flush();
+    EXPECT_EQ(190, xcount_0);
+
+    xstats = xpub.stats();
+    EXPECT_EQ(190u, xstats.xshards[0].xpublished);
+    EXPECT_EQ(100u, xstats.xshards[0].xforwarded);
+    EXPECT_EQ(90u,  xstats.xshards[0].xload);
+    EXPECT_EQ(100u, xstats.xshards[1].xinbound);
+    EXPECT_EQ(110u, xstats.xshards[1].xload);
+    EXPECT_EQ(1u,   xstats.xhottest);
+    EXPECT_EQ(0u,   xstats.xshards[0].xkeys);
+    EXPECT_EQ(2u,   xstats.xshards[1].xkeys);
+}
+
+TEST(ShardedPublisherTest, UnsubscribeAfterMigration)
+{
+    xsharded_t xpub(3);
+    std::atomic< int > xcount_a(0);
+    std::atomic< int > xcount_b(0);
+    std::atomic< int > xcount_self(0);
+
+    xsharded_t::x_subkey_t xkey_a = xpub.subscribe(5, [&xcount_a](int) { ++xcount_a; });
+    xpub.subscribe(5, [&xcount_b](int) { ++xcount_b; });
+
+    // 在消息处理接口中自我取消订阅（当前分片负责的消息类型）
+    xsharded_t::x_subkey_t xkey_self;
+    xkey_self = xpub.subscribe(5,
+                               [&](int)
+                               {
+                                   ++xcount_self;
+                                   xpub.unsubscribe(xkey_self);
+                               });
+
+    xpub.start();
+    ASSERT_TRUE(xpub.rebalance(5, 0));
+
+    xpub.publish(5, 1);
+    xpub.publish(5, 2);
+    xpub.flush();
+    EXPECT_EQ(2, xcount_a.load());
+    EXPECT_EQ(2, xcount_b.load());
+    EXPECT_EQ(1, xcount_self.load());
+    EXPECT_FALSE(xkey_self.is_valid());
+
+    // 迁移之后，原有的 x_subkey_t 仍然有效
+    EXPECT_TRUE(xkey_a.is_valid());
+    xpub.unsubscribe(xkey_a);
+    EXPECT_FALSE(xkey_a.is_valid());
+
+    xpub.publish(5, 3);
+    xpub.flush();
+    EXPECT_EQ(2, xcount_a.load());
+    EXPECT_EQ(3, xcount_b.load());
+
+    // 迁回主分片
+    ASSERT_TRUE(xpub.rebalance(5, xpub.home_of(5)));
+    xpub.publish(5, 4);
+    xpub.flush();
+    EXPECT_EQ(4, xcount_b.load());
+
+    xpub.unsubscribe(5);
+    xpub.publish(5, 5);
+    xpub.flush();
+    EXPECT_EQ(4, xcount_b.load());
+    EXPECT_EQ(0u, xpub.stats().xshards[xpub.home_of(5)].xkeys);
+
+    xpub.stop();
+}
+
+TEST(ShardedPublisherTest, UserSubscriberMigrates)
+{
+    xsharded_t xpub(2);
+    xcounter_suber_t xsuber;
+
+    xsharded_t::x_subscriber_t * xsub_ptr = &xsuber;
+    EXPECT_TRUE(xpub.subscribe(3, xsub_ptr).is_valid());
+    xpub.start();
+
+    xpub.publish(3, 5);
+    xpub.flush();
+    ASSERT_TRUE(xpub.rebalance(3, 0));
+    xpub.publish(3, 7);
+    xpub.stop();
+
+    EXPECT_EQ(2, xsuber.m_xcount);
+    EXPECT_EQ(12, xsuber.m_xsum);
+}
+
+TEST(ShardedPublisherTest, CrossShardSubscribeFromHandler)
+{
+    xsharded_t xpub(2);
+    ASSERT_NE(xpub.home_of(0), xpub.home_of(1));
+
+    // 消息键 0 的处理接口中，订阅/取消订阅 由另一个分片负责的消息键 1
+    std::atomic< int > xcount(0);
+    std::thread::id xthread_0;
+    std::thread::id xthread_1;
+    xsharded_t::x_subkey_t xsub_key;
+    xpub.subscribe(0,
+                   [&](int xvalue)
+                   {
+                       xthread_0 = std::this_thread::get_id();
+                       if (0 == xvalue)
+                       {
+                           xsub_key = xpub.subscribe(1,
+                                                     [&](int)
+                                                     {
+                                                         xthread_1 = std::this_thread::get_id();
+                                                         ++xcount;
+                                                     });
+                       }
+                       else
+                       {
+                           xpub.unsubscribe(xsub_key);
+                       }
+                   });
+    xpub.start();
+
+    xpub.publish(0, 0);
+    xpub.flush();
+    xpub.publish(1, 10);
+    xpub.flush();
+    EXPECT_EQ(1, xcount.load());
+    EXPECT_NE(xthread_0, xthread_1);
+
+    xpub.publish(0, 1);
+    xpub.flush();
+    xpub.publish(1, 11);
+    xpub.flush();
+    EXPECT_EQ(1, xcount.load());
+    EXPECT_EQ(0u, xpub.stats().xshards[xpub.home_of(1)].xkeys);
+
+    xpub.stop();
+}
+
+TEST(ShardedPublisherTest, StopDeliversPendingAndRestarts)
+{
+    xsharded_t xpub(2);
+    std::atomic< int > xcount(0);
+    xpub.subscribe(0, [&xcount](int) { ++xcount; });
+    xpub.subscribe(1, [&xcount](int) { ++xcount; });
+
+    xpub.start(true);
+    EXPECT_TRUE(xpub.started());
+#if defined(__linux__)
+    EXPECT_GE(xpub.stats().xshards[1].xcpu, 0);
+#endif // defined(__linux__)
+
+    for (int xiter = 0; xiter < 1000; ++xiter)
+        xpub.publish(xiter % 2, xiter);
+    xpub.stop();
+    EXPECT_FALSE(xpub.started());
+    EXPECT_EQ(1000, xcount.load());
+
+    xpub.publish(1, 0);
+    xpub.start();
+    xpub.stop();
+    EXPECT_EQ(1001, xcount.load());
+}
@@ -0,0 +1,261 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/**
+ * @file test_shm_transport.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 共享内存跨进程传输 xmsg_shm_ring_t/xmsg_shm_publisher_t/xmsg_shm_receiver_t 的测试。
+ * </pre>
+ */
+
+#include "xmsg_pubsub.h"
+#include "xmsg_shm_transport.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct xquote_t
+{
+    int    xid;
+    double xprice;
+};
+
+using xmsg_ctxt_t  = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< xquote_t, uint64_t > >;
+using xpublisher_t = xmsg_publisher_t< xmsg_ctxt_t >;
+using xshm_pub_t   = xmsg_shm_publisher_t< xmsg_ctxt_t >;
+using xshm_recv_t  = xmsg_shm_receiver_t< xpublisher_t >;
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(ShmRingTest, WriteReadAcrossWrap)
+{
+    xmsg_shm_ring_t xring;
+    xring.create(nullptr, 4096);
+    ASSERT_TRUE(xring.is_open());
+    EXPECT_EQ(4096u, xring.capacity());
+    EXPECT_TRUE(xring.empty());
+
+    // 不同长度的记录反复写入/读取，总量远超容量，覆盖环尾的填充记录
+    size_t xwritten = 0;
+    size_t xread    = 0;
+    for (size_t xiter = 0; xiter < 2000; ++xiter)
+    {
+        const size_t xsize = 1 + (xiter * 37) % 300;
+        ASSERT_TRUE(xring.write(xsize, [xiter, xsize](void * xdst)
+        {
+            std::memset(xdst, static_cast< int >(xiter & 0xFF), xsize);
+        }));
+        xwritten += 1;
+
+        if (0 == (xiter % 5))
+        {
+            xring.read([&xread](const void * xdata, size_t xsize)
+            {
+                const unsigned char * xbytes = static_cast< const unsigned char * >(xdata);
+                EXPECT_EQ(1 + (xread * 37) % 300, xsize);
+                EXPECT_EQ(xread & 0xFF, xbytes[0]);
+                EXPECT_EQ(xread & 0xFF, xbytes[xsize - 1]);
+                xread += 1;
+            });
+        }
+    }
+
+    xring.read([&xread](const void *, size_t) { xread += 1; });
+    EXPECT_EQ(xwritten, xread);
+    EXPECT_TRUE(xring.empty());
+    EXPECT_EQ(0u, xring.size());
+}
+
+TEST(ShmRingTest, FullRingRejectsWrite)
+{
+    xmsg_shm_ring_t xring;
+    xring.create(nullptr, 4096);
+
+    auto xfill = [](void * xdst) { std::memset(xdst, 0, 56); };
+
+    // 每条记录 64 字节（8 字节记录头 + 56 字节负载）
+    size_t xcount = 0;
+    while (xring.write(56, xfill))
+        xcount += 1;
+    EXPECT_EQ(4096u / 64u, xcount);
+    EXPECT_FALSE(xring.write(4096, xfill));
+
+    EXPECT_EQ(1u, xring.read([](const void *, size_t) { }, 1));
+    EXPECT_TRUE(xring.write(56, xfill));
+    EXPECT_FALSE(xring.write(56, xfill));
+}
+
+TEST(ShmRingTest, WaitForTimesOutAndWakes)
+{
+    xmsg_shm_ring_t xring;
+    xring.create(nullptr, 4096);
+
+    const auto xbeg = std::chrono::steady_clock::now();
+    EXPECT_FALSE(xring.wait_for(std::chrono::milliseconds(20)));
+    EXPECT_GE(std::chrono::steady_clock::now() - xbeg, std::chrono::milliseconds(15));
+
+    std::thread xwriter([&xring](void)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        xring.write(8, [](void * xdst) { std::memset(xdst, 1, 8); });
+    });
+
+    EXPECT_TRUE(xring.wait_for(std::chrono::seconds(5)));
+    xwriter.join();
+    EXPECT_FALSE(xring.empty());
+}
+
+TEST(ShmRingTest, AttachRejectsForeignMemory)
+{
+    int xfd = ::memfd_create("xmsg_test_foreign", MFD_CLOEXEC);
+    ASSERT_GE(xfd, 0);
+    ASSERT_EQ(0, ::ftruncate(xfd, 64 * 1024));
+
+    xmsg_shm_ring_t xring;
+    EXPECT_THROW(xring.attach(xfd), std::system_error);
+    EXPECT_FALSE(xring.is_open());
+    ::close(xfd);
+
+    EXPECT_THROW(xring.open("/xmsg_test_not_exist"), std::system_error);
+}
+
+TEST(ShmTransportTest, NamedRingFeedsLocalPublisher)
+{
+    const std::string xname = "/xmsg_test_" + std::to_string(::getpid());
+
+    xpublisher_t xpub;
+    xshm_recv_t  xrecv(xpub);
+    xrecv.ring().create(xname.c_str(), 64 * 1024);
+
+    xshm_pub_t xshm_pub;
+    xshm_pub.ring().open(xname.c_str());
+    xmsg_shm_ring_t::unlink(xname.c_str());
+
+    std::vector< int > xids;
+    double   xprice = 0.0;
+    uint64_t xseq   = 0;
+    xpub.subscribe(7, [&](const xquote_t & xquote, uint64_t xvalue)
+    {
+        xids.push_back(xquote.xid);
+        xprice += xquote.xprice;
+        xseq   += xvalue;
+    });
+
+    for (int xiter = 0; xiter < 10; ++xiter)
+    {
+        EXPECT_TRUE(xshm_pub.publish(7, xquote_t{ xiter, 0.5 }, static_cast< uint64_t >(xiter)));
+        EXPECT_TRUE(xshm_pub.publish(8, xquote_t{ -1, 100.0 }, static_cast< uint64_t >(0)));
+    }
+
+    EXPECT_EQ(20u, xrecv.receive());
+    EXPECT_EQ(0u, xrecv.receive());
+    EXPECT_EQ(20u, xpub.dispatch());
+
+    ASSERT_EQ(10u, xids.size());
+    for (int xiter = 0; xiter < 10; ++xiter)
+        EXPECT_EQ(xiter, xids[xiter]);
+    EXPECT_DOUBLE_EQ(5.0, xprice);
+    EXPECT_EQ(45u, xseq);
+    EXPECT_EQ(0u, xrecv.dropped());
+}
+
+TEST(ShmTransportTest, MismatchedRecordsAreDropped)
+{
+    using xother_ctxt_t = xmsg_context_t< xmsg_mkey_t< int >, xmsg_args_t< int > >;
+
+    xpublisher_t xpub;
+    xshm_recv_t  xrecv(xpub);
+    xrecv.ring().create(nullptr, 4096);
+
+    xmsg_shm_publisher_t< xother_ctxt_t > xshm_pub;
+    xshm_pub.ring().attach(xrecv.ring().fd());
+    EXPECT_TRUE(xshm_pub.publish(1, 2));
+
+    EXPECT_EQ(1u, xrecv.receive());
+    EXPECT_EQ(1u, xrecv.dropped());
+    EXPECT_TRUE(xpub.empty());
+}
+
+TEST(ShmTransportTest, ForkedProcessPublishes)
+{
+    const uint64_t XCOUNT = 100000;
+
+    xpublisher_t xpub;
+    xshm_recv_t  xrecv(xpub);
+    xrecv.ring().create(nullptr, 16 * 1024);
+
+    uint64_t xcount = 0;
+    uint64_t xsum   = 0;
+    bool     xorder = true;
+    xpub.subscribe(1, [&](const xquote_t & xquote, uint64_t xvalue)
+    {
+        xorder = xorder && (xvalue == xcount) && (xquote.xid == static_cast< int >(xvalue));
+        xcount += 1;
+        xsum   += xvalue;
+    });
+
+    pid_t xpid = ::fork();
+    ASSERT_GE(xpid, 0);
+    if (0 == xpid)
+    {
+        // 子进程：环形缓冲区满时让出 CPU 后重试
+        xshm_pub_t xshm_pub;
+        xshm_pub.ring().attach(xrecv.ring().fd());
+        for (uint64_t xiter = 0; xiter < XCOUNT; ++xiter)
+        {
+            while (!xshm_pub.publish(1, xquote_t{ static_cast< int >(xiter), 1.0 }, xiter))
+                std::this_thread::yield();
+        }
+        ::_exit(0);
+    }
+
+    const auto xdeadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while ((xcount < XCOUNT) && (std::chrono::steady_clock::now() < xdeadline))
+    {
+        if (0 == xrecv.receive())
+            xrecv.wait_for(std::chrono::milliseconds(100));
+        xpub.dispatch();
+    }
+
+    int xstatus = -1;
+    ASSERT_EQ(xpid, ::waitpid(xpid, &xstatus, 0));
+    EXPECT_TRUE(WIFEXITED(xstatus) && (0 == WEXITSTATUS(xstatus)));
+
+    EXPECT_EQ(XCOUNT, xcount);
+    EXPECT_EQ(XCOUNT * (XCOUNT - 1) / 2, xsum);
+    EXPECT_TRUE(xorder);
+}
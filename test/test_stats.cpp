@@ -0,0 +1,275 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file test_stats.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 发布/投递统计（XMSG_ENABLE_STATS）的测试。
+ * </pre>
+ */
+
+#define XMSG_ENABLE_STATS 1
+
+// 对每次调用计时，以便核对消息处理耗时的记录次数
+#define XMSG_STATS_SAMPLE 1
+
+#include "xmsg_pubsub.h"
+#include "xmsg_ring_queue.h"
+#include "xmsg_submap_topic.h"
+#include "xmsg_mpsc_queue.h"
+#include "xmsg_dispatch_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< int > >;
+
+/**********************************************************/
+/**
+ * @brief 从统计快照中取出指定消息键的计数器。
+ */
+template< typename __publisher_t >
+xmsg_stats_counters_t key_stats(const __publisher_t & xpub, int xkey)
+{
+    for (auto & xiter : xpub.stats().xkeys)
+    {
+        if (xiter.first == xkey)
+            return xiter.second;
+    }
+
+    return xmsg_stats_counters_t();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(StatsTest, AbiTaggedByStatsMacro)
+{
+    // 启用统计的类型位于 xmsg_abi_stats 内联命名空间中，与未启用时的类型不同
+    static_assert(std::is_same< xmsg_ctxt_t,
+                                xmsg_abi_stats::xmsg_context_t<
+                                    xmsg_mkey_t< int >,
+                                    xmsg_args_t< int > > >::value,
+                  "The stats build must be tagged by xmsg_abi_stats!");
+    SUCCEED();
+}
+
+TEST(StatsTest, HistogramBuckets)
+{
+    for (uint64_t xvalue : { 0ull, 1ull, 7ull, 8ull, 9ull, 15ull, 16ull, 100ull,
+                             1000000ull, (1ull << 39), (1ull << 40), ~0ull })
+    {
+        size_t xindex = xmsg_histogram_t::bucket_index(xvalue);
+        ASSERT_LT(xindex, xmsg_histogram_t::XBUCKETS);
+        if (xvalue < (1ull << 40))
+        {
+            EXPECT_LE(xmsg_histogram_t::bucket_lower(xindex), xvalue);
+            EXPECT_GE(xmsg_histogram_t::bucket_upper(xindex), xvalue);
+        }
+    }
+
+    for (size_t xindex = 0; xindex + 1 < xmsg_histogram_t::XBUCKETS; ++xindex)
+    {
+        EXPECT_EQ(xmsg_histogram_t::bucket_upper(xindex) + 1,
+                  xmsg_histogram_t::bucket_lower(xindex + 1));
+    }
+
+    xmsg_histogram_t xhist;
+    for (uint64_t xvalue = 1; xvalue <= 1000; ++xvalue)
+        xhist.record(xvalue);
+
+    xmsg_histogram_snapshot_t xsnap = xhist.snapshot();
+    EXPECT_EQ(1000u, xsnap.xcount);
+    EXPECT_EQ(1000u, xsnap.xmax);
+    EXPECT_GE(xsnap.percentile(0.5), 500u);
+    EXPECT_LE(xsnap.percentile(0.5), 500u * 9 / 8 + 1);
+    EXPECT_EQ(1000u, xsnap.percentile(1.0));
+}
+
+TEST(StatsTest, CountersPerKey)
+{
+    xmsg_publisher_t< xmsg_ctxt_t > xpub;
+    int xcount = 0;
+
+    auto xsub_key = xpub.subscribe(1, [&](int) { ++xcount; });
+    xpub.subscribe(1, [&](int) { ++xcount; });
+
+    xpub.publish(1, 1);
+    xpub.publish(1, 2);
+    xpub.publish(2, 3);
+    xpub.dispatch();
+
+    auto xstats = xpub.stats();
+    EXPECT_EQ(3u, xstats.xtotal.xpublished);
+    EXPECT_EQ(3u, xstats.xtotal.xdispatched);
+    EXPECT_EQ(4u, xstats.xtotal.xinvoked);
+    EXPECT_EQ(0u, xstats.xtotal.xdropped);
+    EXPECT_EQ(4u, key_stats(xpub, 1).xinvoked);
+    EXPECT_EQ(1u, key_stats(xpub, 2).xdispatched);
+    EXPECT_EQ(3u, xstats.xresidency.xcount);
+    EXPECT_EQ(2u, decltype(xpub)::handler_stats(xsub_key).xcount);
+}
+
+TEST(StatsTest, ResidencyStartsAtPublish)
+{
+    xmsg_publisher_t< xmsg_ctxt_t > xpub;
+    xpub.subscribe(1, [](int) { });
+
+    // 构造消息之后、发布之前的耗时，不计入驻留耗时
+    const xmsg_ctxt_t xmsg_lvalue(1, 1);
+    xmsg_ctxt_t xmsg_rvalue(1, 2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    xpub.publish(xmsg_lvalue);
+    xpub.publish(std::move(xmsg_rvalue));
+    xpub.dispatch();
+
+    auto xstats = xpub.stats();
+    EXPECT_EQ(2u, xstats.xresidency.xcount);
+    EXPECT_LT(xstats.xresidency.xmax, 10u * 1000 * 1000);
+}
+
+TEST(StatsTest, HandlerTimeOutsideDispatch)
+{
+    using xsuber_t = xmsg_subscriber_t< XSUBER_BASE_TYPE, xmsg_ctxt_t >;
+
+    xmsg_publisher_t< xmsg_ctxt_t > xpub;
+    xpub.subscribe(1, [](int) { });
+    xpub.publish(1, 1);
+    xpub.dispatch();
+
+    // 不经过发布者直接调用（如 日志回放），耗时不能包含两次调用之间的间隔
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    xsuber_t xsuber;
+    xsuber.invoke(xmsg_ctxt_t(1, 2));
+
+    xmsg_histogram_snapshot_t xsnap = xsuber.handler_stats();
+    EXPECT_EQ(1u, xsnap.xcount);
+    EXPECT_LT(xsnap.xmax, 10u * 1000 * 1000);
+}
+
+TEST(StatsTest, HandlerStatsMergeThreads)
+{
+    using xsuber_t = xmsg_subscriber_t< XSUBER_BASE_TYPE, xmsg_ctxt_t >;
+
+    // 各个线程写入各自的条带，快照时合并
+    xsuber_t xsuber;
+    std::vector< std::thread > xthreads;
+    for (int xiter = 0; xiter < 4; ++xiter)
+    {
+        xthreads.emplace_back([&xsuber](void)
+        {
+            const xmsg_ctxt_t xmsg_ctxt(1, 1);
+            for (int xcount = 0; xcount < 1000; ++xcount)
+                xsuber.invoke(xmsg_ctxt);
+        });
+    }
+
+    for (std::thread & xthread : xthreads)
+        xthread.join();
+
+    EXPECT_EQ(4000u, xsuber.handler_stats().xcount);
+}
+
+TEST(StatsTest, SelfUnsubscribe)
+{
+    xmsg_publisher_t< xmsg_ctxt_t > xpub_hash;
+    decltype(xpub_hash)::x_subkey_t xkey_hash;
+    xkey_hash = xpub_hash.subscribe(1, [&](int) { xpub_hash.unsubscribe(xkey_hash); });
+    xpub_hash.publish(1, 1);
+    xpub_hash.publish(1, 1);
+    xpub_hash.dispatch();
+    EXPECT_EQ(1u, xpub_hash.stats().xtotal.xinvoked);
+
+    xmsg_publisher_t< xmsg_ctxt_t, std::queue< xmsg_ctxt_t >, xmsg_subset_flat_t > xpub_flat;
+    decltype(xpub_flat)::x_subkey_t xkey_flat;
+    xkey_flat = xpub_flat.subscribe(1, [&](int) { xpub_flat.unsubscribe(xkey_flat); });
+    xpub_flat.publish(1, 1);
+    xpub_flat.dispatch_batch();
+    EXPECT_EQ(1u, xpub_flat.stats().xtotal.xinvoked);
+}
+
+TEST(StatsTest, DroppedMessages)
+{
+    xmsg_publisher_t< xmsg_ctxt_t, xmsg_ring_queue_t< xmsg_ctxt_t, 4, XOVERFLOW_REJECT > > xpub;
+    for (int xiter = 0; xiter < 6; ++xiter)
+        xpub.publish(7, xiter);
+
+    EXPECT_EQ(2u, key_stats(xpub, 7).xdropped);
+    EXPECT_EQ(4u, key_stats(xpub, 7).xpublished);
+}
+
+TEST(StatsTest, TopicMatchCountsEveryInvocation)
+{
+    using x_ctxt_t = xmsg_context_t< xmsg_mkey_t< std::string >, xmsg_args_t< int > >;
+    xmsg_publisher_t< x_ctxt_t, std::queue< x_ctxt_t >,
+                      xmsg_subset_hash_t, xmsg_submap_topic_t > xpub;
+
+    xpub.subscribe("a.*", [](int) { });
+    xpub.subscribe("a.b", [](int) { });
+    xpub.publish("a.b", 1);
+    xpub.dispatch();
+
+    auto xstats = xpub.stats();
+    EXPECT_EQ(2u, xstats.xtotal.xinvoked);
+    EXPECT_EQ(1u, xstats.xtotal.xdispatched);
+}
+
+TEST(StatsTest, ConcurrentPublishAndParallelDispatch)
+{
+    xmsg_dispatch_pool_t xpool(3);
+    xmsg_publisher_t< xmsg_ctxt_t, xmsg_mpsc_queue_t< xmsg_ctxt_t > > xpub;
+    for (int xkey = 0; xkey < 16; ++xkey)
+        xpub.subscribe(xkey, [](int) { });
+
+    std::thread xproducer([&xpub](void)
+    {
+        for (int xiter = 0; xiter < 10000; ++xiter)
+            xpub.publish(xiter % 16, xiter);
+    });
+
+    size_t xdispatched = 0;
+    while (xdispatched < 10000)
+    {
+        xdispatched += xpub.dispatch_parallel(xpool);
+        xpub.stats(); // 投递过程中读取快照
+    }
+    xproducer.join();
+
+    auto xstats = xpub.stats();
+    EXPECT_EQ(10000u, xstats.xtotal.xdispatched);
+    EXPECT_EQ(10000u, xstats.xtotal.xinvoked);
+    EXPECT_EQ(16u, xstats.xkeys.size());
+    EXPECT_LE(xstats.xresidency.percentile(0.5), xstats.xresidency.xmax);
+}
@@ -0,0 +1,130 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file test_submap.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 消息订阅者映射表（xmsg_submap_flat_t/xmsg_submap_auto_t）的测试。
+ * </pre>
+ */
+
+#include "xmsg_pubsub.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @struct xmod_hash_t / xmod_equal_t
+ * @brief 按个位数字比较的 哈希/相等 仿函数（用于验证自定义的键比较）。
+ */
+struct xmod_hash_t
+{
+    size_t operator()(int xkey) const { return std::hash< int >()(xkey % 10); }
+};
+
+struct xmod_equal_t
+{
+    bool operator()(int xlkey, int xrkey) const { return (xlkey % 10) == (xrkey % 10); }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(SubmapFlatTest, MatchesStdMapUnderRandomOperations)
+{
+    xmsg_submap_flat_t< int, std::string > xmap;
+    std::map< int, std::string >           xref;
+    std::mt19937 xrng(1);
+
+    for (int xiter = 0; xiter < 200000; ++xiter)
+    {
+        // 键值为 1024 的倍数，使 std::hash 的低位全部相同
+        int xkey = static_cast< int >(xrng() % 5000) * 1024;
+
+        switch (xrng() % 3)
+        {
+        case 0:
+            xmap[xkey] = std::to_string(xiter);
+            xref[xkey] = std::to_string(xiter);
+            break;
+
+        case 1:
+            ASSERT_EQ(xref.erase(xkey), xmap.erase(xkey));
+            break;
+
+        default:
+            {
+                auto itmap = xmap.find(xkey);
+                auto itref = xref.find(xkey);
+                ASSERT_EQ(itref == xref.end(), itmap == xmap.end());
+                if (itref != xref.end())
+                {
+                    ASSERT_EQ(xkey, itmap->first);
+                    ASSERT_EQ(itref->second, itmap->second);
+                }
+            }
+            break;
+        }
+
+        ASSERT_EQ(xref.size(), xmap.size());
+    }
+
+    xmap.erase(xmap.find(xref.begin()->first));
+    xref.erase(xref.begin());
+    EXPECT_EQ(xref.size(), xmap.size());
+}
+
+TEST(SubmapAutoTest, SelectsByKeyType)
+{
+    static_assert(std::is_same< xmsg_submap_auto_t< int, int >,
+                                xmsg_submap_flat_t< int, int > >::value,
+                  "integral keys use the flat map");
+    static_assert(std::is_same< xmsg_submap_auto_t< std::string, int >,
+                                std::unordered_map< std::string, int > >::value,
+                  "other keys use std::unordered_map");
+}
+
+TEST(SubmapFlatTest, PublisherHonorsCustomHashAndEqual)
+{
+    using x_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< int, xmod_equal_t, xmod_hash_t >,
+                        xmsg_args_t< int > >;
+
+    xmsg_publisher_t< x_ctxt_t > xpub;
+    int xcount = 0;
+    xpub.subscribe(3, [&xcount](int) { ++xcount; });
+
+    xpub.publish(13, 0);
+    xpub.publish(23, 0);
+    xpub.publish(4, 0);
+    xpub.dispatch();
+
+    EXPECT_EQ(2, xcount);
+}
@@ -0,0 +1,179 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file test_submap_static.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 静态主题（xmsg_topic_t）与 槽位数组映射表（xmsg_submap_array_t）的测试。
+ * </pre>
+ */
+
+#include "xmsg_pubsub.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+enum xtopic_id_t
+{
+    XTOPIC_ORDER = 0,
+    XTOPIC_TRADE = 1,
+    XTOPIC_COUNT = 8,
+};
+
+using xmsg_ctxt_t  = xmsg_context_t<
+                        xmsg_mkey_t< int >,
+                        xmsg_args_t< int, std::string > >;
+using xpublisher_t = xmsg_publisher_t<
+                        xmsg_ctxt_t,
+                        std::queue< xmsg_ctxt_t >,
+                        xmsg_subset_flat_t,
+                        xmsg_submap_static_t< XTOPIC_COUNT >::x_submap_t >;
+
+struct xtopic_order_t : xmsg_topic_t< int, XTOPIC_ORDER, int, std::string > { };
+struct xtopic_trade_t : xmsg_topic_t< int, XTOPIC_TRADE, int, std::string > { };
+
+using xsubmap_t = xmsg_submap_static_t< 4 >::x_submap_t< int, std::string >;
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(SubmapArrayTest, SlotsAndFallback)
+{
+    xsubmap_t xmap;
+    EXPECT_EQ(xmsg_submap_slots_t< xsubmap_t >::value, 4u);
+    EXPECT_EQ((xmsg_submap_slots_t< xmsg_submap_auto_t< int, std::string > >::value), 0u);
+
+    EXPECT_TRUE(xmap.find(1) == xmap.end());
+
+    xmap[1]   = "one";
+    xmap[100] = "hundred";
+    xmap[-1]  = "minus";
+    EXPECT_EQ(xmap.size(), 3u);
+
+    xsubmap_t::iterator itfind = xmap.find(1);
+    ASSERT_TRUE(itfind != xmap.end());
+    EXPECT_EQ(itfind->first, 1);
+    EXPECT_EQ(itfind->second, "one");
+
+    ASSERT_TRUE(xmap.find(100) != xmap.end());
+    EXPECT_EQ(xmap.find(100)->second, "hundred");
+    ASSERT_TRUE(xmap.find(-1) != xmap.end());
+    EXPECT_EQ(xmap.find(-1)->second, "minus");
+
+    // 槽位中元素的地址保持不变
+    std::string * xvalue = &xmap[1];
+    xmap[2] = "two";
+    EXPECT_EQ(xvalue, &xmap.find(1)->second);
+
+    // 删除时值被重置
+    xmap.erase(xmap.find(1));
+    EXPECT_TRUE(xmap.find(1) == xmap.end());
+    EXPECT_EQ(xmap[1], "");
+    EXPECT_EQ(xmap.erase(3), 0u);
+    EXPECT_EQ(xmap.erase(100), 1u);
+    EXPECT_EQ(xmap.size(), 3u);
+}
+
+TEST(StaticTopicTest, PublishSubscribeByTopic)
+{
+    xpublisher_t xpub;
+    std::vector< std::string > xtrace;
+
+    xpub.subscribe< xtopic_order_t >(
+        [&xtrace](int xid, const std::string & xtext)
+        {
+            xtrace.push_back("order" + std::to_string(xid) + xtext);
+        });
+    xpub.subscribe< xtopic_trade_t >(
+        [&xtrace](int xid, const std::string & xtext)
+        {
+            xtrace.push_back("trade" + std::to_string(xid) + xtext);
+        });
+    xpub.subscribe(1000,
+        [&xtrace](int xid, const std::string & xtext)
+        {
+            xtrace.push_back("dyn" + std::to_string(xid) + xtext);
+        });
+
+    // 静态主题 与 运行期的键 混合发布，按发布顺序投递
+    xpub.publish< xtopic_order_t >(1, "a");
+    xpub.publish(1000, 2, std::string("b"));
+    xpub.publish< xtopic_trade_t >(3, "c");
+    xpub.publish(XTOPIC_ORDER, 4, std::string("d"));
+    EXPECT_EQ(xpub.dispatch_batch(), 4u);
+
+    EXPECT_EQ(xtrace, (std::vector< std::string >{ "order1a", "dyn2b", "trade3c", "order4d" }));
+}
+
+TEST(StaticTopicTest, UnsubscribeTopicResetsSlot)
+{
+    xpublisher_t xpub;
+    int xfirst  = 0;
+    int xsecond = 0;
+
+    xpub.subscribe< xtopic_order_t >([&xfirst](int, const std::string &) { xfirst += 1; });
+    xpub.subscribe< xtopic_order_t >([&xfirst](int, const std::string &) { xfirst += 1; });
+
+    xpub.publish< xtopic_order_t >(0, "");
+    xpub.dispatch();
+    EXPECT_EQ(xfirst, 2);
+
+    xpub.unsubscribe< xtopic_order_t >();
+    xpub.publish< xtopic_order_t >(0, "");
+    xpub.dispatch();
+    EXPECT_EQ(xfirst, 2);
+
+    // 槽位被重置后再次订阅，只投递给新的订阅者
+    xpub.subscribe< xtopic_order_t >([&xsecond](int, const std::string &) { xsecond += 1; });
+    xpub.publish< xtopic_order_t >(0, "");
+    xpub.dispatch();
+    EXPECT_EQ(xfirst, 2);
+    EXPECT_EQ(xsecond, 1);
+}
+
+TEST(StaticTopicTest, SelfUnsubscribeDuringDispatch)
+{
+    xpublisher_t xpub;
+    xpublisher_t::x_subkey_t xsub_key;
+    int xcount = 0;
+
+    xsub_key = xpub.subscribe< xtopic_trade_t >(
+        [&](int, const std::string &)
+        {
+            xcount += 1;
+            xpub.unsubscribe(xsub_key);
+        });
+
+    xpub.publish< xtopic_trade_t >(0, "");
+    xpub.publish< xtopic_trade_t >(0, "");
+    xpub.dispatch();
+
+    EXPECT_EQ(xcount, 1);
+    EXPECT_FALSE(xsub_key.is_valid());
+}
@@ -0,0 +1,172 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file test_submap_topic.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * author ：Gaaagaa
+ * date   : 2026-10-18
+ * info   : 通配符主题订阅映射表 xmsg_submap_topic_t 的测试。
+ * </pre>
+ */
+
+#include "xmsg_submap_topic.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xmsg_ctxt_t = xmsg_context_t<
+                        xmsg_mkey_t< std::string >,
+                        xmsg_args_t< int > >;
+
+template< template< typename > class __subset_t >
+struct xsubset_tag_t
+{
+    using x_publisher_t = xmsg_publisher_t< xmsg_ctxt_t,
+                                            std::queue< xmsg_ctxt_t >,
+                                            __subset_t,
+                                            xmsg_submap_topic_t >;
+};
+
+template< typename __tag_t >
+class SubmapTopicTest : public ::testing::Test
+{
+protected:
+    using x_publisher_t = typename __tag_t::x_publisher_t;
+
+    typename x_publisher_t::x_subkey_t sub(const std::string & xpattern)
+    {
+        return m_xpub.subscribe(xpattern, [this, xpattern](int) { m_xhits[xpattern]++; });
+    }
+
+    void publish(const char * xtopic)
+    {
+        m_xhits.clear();
+        m_xpub.publish(std::string(xtopic), 1);
+        m_xpub.dispatch();
+    }
+
+    x_publisher_t                m_xpub;
+    std::map< std::string, int > m_xhits;
+};
+
+using xsubset_types_t = ::testing::Types< xsubset_tag_t< xmsg_subset_hash_t >,
+                                          xsubset_tag_t< xmsg_subset_flat_t > >;
+TYPED_TEST_SUITE(SubmapTopicTest, xsubset_types_t);
+
+////////////////////////////////////////////////////////////////////////////////
+
+TYPED_TEST(SubmapTopicTest, WildcardMatching)
+{
+    this->sub("orders.venueX.new");
+    this->sub("orders.*.new");
+    this->sub("orders.#");
+    this->sub("#");
+    this->sub("orders.venueX.*");
+    this->sub("*.venueY.#");
+
+    this->publish("orders.venueX.new");
+    EXPECT_EQ(5u, this->m_xhits.size());
+    EXPECT_EQ(0u, this->m_xhits.count("*.venueY.#"));
+
+    this->publish("orders.venueY.new");
+    EXPECT_EQ(4u, this->m_xhits.size());
+    EXPECT_EQ(1, this->m_xhits["orders.*.new"]);
+    EXPECT_EQ(1, this->m_xhits["*.venueY.#"]);
+
+    this->publish("orders");
+    EXPECT_EQ(2u, this->m_xhits.size());
+    EXPECT_EQ(1, this->m_xhits["orders.#"]);
+    EXPECT_EQ(1, this->m_xhits["#"]);
+
+    this->publish("x.venueY");
+    EXPECT_EQ(2u, this->m_xhits.size());
+    EXPECT_EQ(1, this->m_xhits["*.venueY.#"]);
+
+    // 第二次命中来自匹配缓存，结果须一致
+    this->publish("orders.venueX.new");
+    EXPECT_EQ(5u, this->m_xhits.size());
+}
+
+TYPED_TEST(SubmapTopicTest, UnsubscribeDuringDispatch)
+{
+    this->sub("orders.venueX.new");
+    this->sub("orders.#");
+
+    typename TestFixture::x_publisher_t::x_subkey_t xself;
+    int xself_hits = 0;
+    xself = this->m_xpub.subscribe(std::string("orders.*.cancel"), [&](int)
+    {
+        ++xself_hits;
+        this->m_xpub.unsubscribe(xself);
+        this->m_xpub.unsubscribe(std::string("orders.#"));
+    });
+
+    this->m_xpub.publish(std::string("orders.a.cancel"), 1);
+    this->m_xpub.publish(std::string("orders.a.cancel"), 2);
+    this->m_xpub.dispatch_batch();
+    EXPECT_EQ(1, xself_hits);
+
+    // 模式订阅被注销后，缓存的匹配结果也必须失效
+    this->publish("orders.venueX.new");
+    EXPECT_EQ(1u, this->m_xhits.size());
+    EXPECT_EQ(0u, this->m_xhits.count("orders.#"));
+}
+
+TYPED_TEST(SubmapTopicTest, ResubscribeInCallback)
+{
+    int xold = 0;
+    int xnew = 0;
+    this->m_xpub.subscribe(std::string("z.*"), [&](int xvalue)
+    {
+        if (1 == xvalue)
+        {
+            this->m_xpub.unsubscribe(std::string("z.1"));
+            this->m_xpub.subscribe(std::string("z.1"), [&](int) { ++xnew; });
+        }
+    });
+    this->m_xpub.subscribe(std::string("z.1"), [&](int) { ++xold; });
+
+    this->m_xpub.publish(std::string("z.1"), 1);
+    this->m_xpub.dispatch();
+    this->m_xpub.publish(std::string("z.1"), 2);
+    this->m_xpub.dispatch();
+
+    EXPECT_EQ(1, xold);
+    EXPECT_EQ(1, xnew);
+}
+
+TYPED_TEST(SubmapTopicTest, ExactTopicsOnly)
+{
+    int xcount = 0;
+    this->m_xpub.subscribe(std::string("a.b"), [&](int) { ++xcount; });
+    this->m_xpub.publish(std::string("a.b"), 1);
+    this->m_xpub.publish(std::string("a.c"), 1);
+    this->m_xpub.dispatch();
+    EXPECT_EQ(1, xcount);
+}
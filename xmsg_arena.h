@@ -0,0 +1,591 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file xmsg_arena.h
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * @author  ：Gaaagaa
+ * @date    : 2026-10-18
+ * @version : 1.0.0.0
+ * @brief   : 消息参数使用的单调递增内存区（arena），以及使用该内存区的消息队列。
+ */
+
+#ifndef __XMSG_ARENA_H__
+#define __XMSG_ARENA_H__
+
+#include "xmsg_pubsub.h"
+
+#include <atomic>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_arena_t
+
+/**
+ * @class xmsg_arena_t
+ * @brief 单调递增（只分配、不单独回收）的内存区。
+ * @note
+ * 1. 内存从若干个内存段（chunk）中顺序切分，deallocate() 只累计回收的分配数量；
+ *    所有分配都已回收时（如 一轮投递结束，队列中的消息全部析构），
+ *    rewind() 将整个内存区回绕到第一个内存段重新切分，已申请的内存段
+ *    全部保留复用，因此稳定运行后不再访问堆；
+ * 2. allocate() 与 rewind() 须在同一个线程（所有者线程）中调用，
+ *    deallocate() 则可在任意线程中调用（回收计数为原子变量）：
+ *    rewind() 观察到全部回收时，其他线程对这些内存的访问均已结束。
+ */
+class xmsg_arena_t
+{
+    // common data types
+private:
+    /**
+     * @struct x_chunk_t
+     * @brief 内存段的头部（数据紧随其后）。
+     */
+    struct x_chunk_t
+    {
+        x_chunk_t * xnext; ///< 下一个内存段
+        size_t      xsize; ///< 数据区的字节数
+    };
+
+    /** 内存段数据区的起始偏移量（按 std::max_align_t 对齐） */
+    static constexpr size_t XHEAD_SIZE =
+        (sizeof(x_chunk_t) + alignof(std::max_align_t) - 1) /
+            alignof(std::max_align_t) * alignof(std::max_align_t);
+
+public:
+    /** 默认的内存段大小（数据区的字节数） */
+    static constexpr size_t XCHUNK_SIZE = 64 * 1024;
+
+    // constructor/destructor
+public:
+    explicit xmsg_arena_t(size_t xchunk_size = XCHUNK_SIZE)
+        : m_xchunk_size(xchunk_size)
+        , m_xhead(nullptr)
+        , m_xchunk(nullptr)
+        , m_xoffset(0)
+        , m_xallocs(0)
+        , m_xfrees(0)
+        , m_xcapacity(0)
+        , m_xrewinds(0)
+    {
+
+    }
+
+    ~xmsg_arena_t(void)
+    {
+        assert(0 == live());
+
+        while (nullptr != m_xhead)
+        {
+            x_chunk_t * xnext = m_xhead->xnext;
+            ::operator delete(m_xhead);
+            m_xhead = xnext;
+        }
+    }
+
+    xmsg_arena_t(xmsg_arena_t && xobject) = delete;
+    xmsg_arena_t & operator=(xmsg_arena_t && xobject) = delete;
+    xmsg_arena_t(const xmsg_arena_t & xobject) = delete;
+    xmsg_arena_t & operator=(const xmsg_arena_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 分配 xsize 字节、按 xalign 对齐的内存。
+     */
+    void * allocate(size_t xsize, size_t xalign)
+    {
+        assert((0 != xalign) && (0 == (xalign & (xalign - 1))));
+
+        for (;;)
+        {
+            if (nullptr != m_xchunk)
+            {
+                char * xdata = chunk_data(m_xchunk);
+                size_t xbeg  = (m_xoffset + xalign - 1) & ~(xalign - 1);
+                if ((xbeg <= m_xchunk->xsize) && (xsize <= m_xchunk->xsize - xbeg))
+                {
+                    m_xoffset = xbeg + xsize;
+                    m_xallocs += 1;
+                    return xdata + xbeg;
+                }
+            }
+
+            next_chunk(xsize + xalign);
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 回收 allocate() 分配的内存（只累计回收的分配数量，可在任意线程中调用）。
+     */
+    void deallocate(void * xmem_ptr, size_t xsize)
+    {
+        (void)xmem_ptr;
+        (void)xsize;
+
+        m_xfrees.fetch_add(1, std::memory_order_release);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 所有分配都已回收时，回绕到第一个内存段（所有者线程调用）。
+     * 
+     * @return bool : 是否已回绕（仍有存活的分配时返回 false）。
+     */
+    bool rewind(void)
+    {
+        if (m_xallocs != m_xfrees.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        m_xallocs   = 0;
+        m_xfrees.store(0, std::memory_order_relaxed);
+        m_xchunk    = m_xhead;
+        m_xoffset   = 0;
+        m_xrewinds += 1;
+        return true;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 存活（尚未回收）的分配数量（所有者线程调用）。
+     */
+    inline size_t live(void) const
+    {
+        return (m_xallocs - m_xfrees.load(std::memory_order_acquire));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 已从堆中申请的内存段总字节数。
+     */
+    inline size_t capacity(void) const { return m_xcapacity; }
+
+    /**********************************************************/
+    /**
+     * @brief 内存区整体回绕（复用）的次数。
+     */
+    inline size_t rewinds(void) const { return m_xrewinds; }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 内存段的数据区。
+     */
+    static inline char * chunk_data(x_chunk_t * xchunk)
+    {
+        return reinterpret_cast< char * >(xchunk) + XHEAD_SIZE;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 切换到下一个内存段（复用已有的，或者从堆中申请新的，
+     *        数据区至少 xsize 字节）。
+     */
+    void next_chunk(size_t xsize)
+    {
+        x_chunk_t * xnext = (nullptr != m_xchunk) ? m_xchunk->xnext : m_xhead;
+
+        // 复用的内存段不足 xsize 字节时（超大的分配），在其之前插入新的内存段
+        if ((nullptr == xnext) || (xnext->xsize < xsize))
+        {
+            const size_t xchunk_size = (std::max)(m_xchunk_size, xsize);
+
+            x_chunk_t * xchunk = static_cast< x_chunk_t * >(
+                                    ::operator new(XHEAD_SIZE + xchunk_size));
+            xchunk->xnext = xnext;
+            xchunk->xsize = xchunk_size;
+            m_xcapacity  += xchunk_size;
+
+            if (nullptr != m_xchunk)
+                m_xchunk->xnext = xchunk;
+            else
+                m_xhead = xchunk;
+
+            xnext = xchunk;
+        }
+
+        m_xchunk  = xnext;
+        m_xoffset = 0;
+    }
+
+    // data members
+private:
+    const size_t          m_xchunk_size; ///< 新申请内存段的数据区字节数
+    x_chunk_t *           m_xhead;       ///< 内存段链表
+    x_chunk_t *           m_xchunk;      ///< 当前切分的内存段
+    size_t                m_xoffset;     ///< 当前内存段中已切分的字节数
+    size_t                m_xallocs;     ///< 回绕之后的分配数量（所有者线程）
+    std::atomic< size_t > m_xfrees;      ///< 回绕之后的回收数量（任意线程）
+    size_t                m_xcapacity;   ///< 已申请的内存段总字节数
+    size_t                m_xrewinds;    ///< 回绕次数
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_arena_allocator_t
+
+/**
+ * @class xmsg_arena_allocator_t< __value_t >
+ * @brief 使用 xmsg_arena_t 的内存分配器（符合 C++11 的 Allocator 要求）。
+ * @note
+ * 1. 未关联内存区时（默认构造），直接从堆中分配；
+ * 2. 容器拷贝构造时（select_on_container_copy_construction()）返回未关联
+ *    内存区的分配器：订阅者在消息处理接口中拷贝出来的参数
+ *    使用堆内存，可以在消息析构之后继续使用。
+ *
+ * @param [in ] __value_t : 分配的对象类型。
+ */
+template< typename __value_t >
+class xmsg_arena_allocator_t
+{
+    template< typename __other_t >
+    friend class xmsg_arena_allocator_t;
+
+    // common data types
+public:
+    typedef __value_t value_type;
+
+    typedef std::false_type propagate_on_container_copy_assignment;
+    typedef std::true_type  propagate_on_container_move_assignment;
+    typedef std::true_type  propagate_on_container_swap;
+
+    template< typename __other_t >
+    struct rebind
+    {
+        typedef xmsg_arena_allocator_t< __other_t > other;
+    };
+
+    // constructor/destructor
+public:
+    xmsg_arena_allocator_t(void) noexcept
+        : m_xarena(nullptr)
+    {
+
+    }
+
+    explicit xmsg_arena_allocator_t(xmsg_arena_t * xarena) noexcept
+        : m_xarena(xarena)
+    {
+
+    }
+
+    template< typename __other_t >
+    xmsg_arena_allocator_t(const xmsg_arena_allocator_t< __other_t > & xobject) noexcept
+        : m_xarena(xobject.m_xarena)
+    {
+
+    }
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 分配 xcount 个对象的内存。
+     */
+    value_type * allocate(size_t xcount)
+    {
+        if (nullptr == m_xarena)
+        {
+            return static_cast< value_type * >(
+                        ::operator new(xcount * sizeof(value_type)));
+        }
+
+        return static_cast< value_type * >(
+                    m_xarena->allocate(xcount * sizeof(value_type),
+                                       alignof(value_type)));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 释放 allocate() 分配的内存。
+     */
+    void deallocate(value_type * xvalue_ptr, size_t xcount)
+    {
+        if (nullptr == m_xarena)
+        {
+            ::operator delete(xvalue_ptr);
+            return;
+        }
+
+        m_xarena->deallocate(xvalue_ptr, xcount * sizeof(value_type));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 容器拷贝构造时使用的分配器（堆内存）。
+     */
+    xmsg_arena_allocator_t select_on_container_copy_construction(void) const
+    {
+        return xmsg_arena_allocator_t();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 关联的内存区（nullptr 表示使用堆内存）。
+     */
+    inline xmsg_arena_t * arena(void) const { return m_xarena; }
+
+    template< typename __other_t >
+    inline bool operator == (const xmsg_arena_allocator_t< __other_t > & xobject) const
+    {
+        return (m_xarena == xobject.m_xarena);
+    }
+
+    template< typename __other_t >
+    inline bool operator != (const xmsg_arena_allocator_t< __other_t > & xobject) const
+    {
+        return (m_xarena != xobject.m_xarena);
+    }
+
+    // data members
+private:
+    xmsg_arena_t * m_xarena; ///< 关联的内存区
+};
+
+/** 使用 xmsg_arena_t 的字符串类型（用作消息参数） */
+using xmsg_arena_string_t = std::basic_string< char,
+                                               std::char_traits< char >,
+                                               xmsg_arena_allocator_t< char > >;
+
+/** 使用 xmsg_arena_t 的数组类型（用作消息参数） */
+template< typename __value_t >
+using xmsg_arena_vector_t = std::vector< __value_t, xmsg_arena_allocator_t< __value_t > >;
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_arena_queue_t
+
+/**
+ * @class xmsg_arena_queue_t< __value_t, __queue_t >
+ * @brief 从 xmsg_arena_t 中分配消息参数存储空间的消息队列。
+ * @note
+ * 1. 接口与 std::queue 保持一致，可直接作为 xmsg_publisher_t 的
+ *    __msg_queue_t 模板参数使用；入队的消息对象使用分配器构造
+ *    （xmsg_context_t 的 uses-allocator 构造函数），消息参数中的
+ *    xmsg_arena_string_t、xmsg_arena_vector_t 等类型从内存区中分配，
+ *    其他参数类型不受影响；
+ * 2. 双缓冲：生产者端（publish()）只从当前的写入内存区中分配，并独占
+ *    内存区的切换与回绕；消费者端（dispatch()）只在消息析构时累计回收数量。
+ *    消费者每越过一个批次边界（pop() 或 dispatch_batch() 的 detach()），
+ *    就递增批次编号；生产者发现批次编号变化、且另一个内存区中的消息已全部
+ *    析构时，将其回绕并切换为写入内存区（交接），原写入内存区则留给消费者
+ *    继续排空。因此生产者可在上一批次排空的同时持续写入，即使队列始终
+ *    不为空（持续积压），内存占用也不会无限增长；
+ * 3. __queue_t 为 std::queue 时，publish() 与 dispatch() 须在同一个线程中调用；
+ *    为 xmsg_mpsc_queue_t 时，可由 一个 生产者线程调用 publish() ，
+ *    另一个消费者线程调用 dispatch()（内存区的分配只能有一个生产者）；
+ *    消息（及其参数）可在任意线程中析构；
+ * 4. 订阅者不能保存消息参数的引用或指针（其内存在投递之后即被复用），
+ *    需要保存时应拷贝（拷贝出来的参数使用堆内存）。
+ *
+ * @param [in ] __value_t      : 队列元素类型（xmsg_context_t）。
+ * @param [in ] __queue_t      : 实际存储元素的队列类型（std::queue 或 xmsg_mpsc_queue_t）。
+ * @param [in ] __chunk_size   : 内存区的内存段大小。
+ */
+template< typename __value_t,
+          typename __queue_t = std::queue< __value_t >,
+          size_t __chunk_size = xmsg_arena_t::XCHUNK_SIZE >
+class xmsg_arena_queue_t
+{
+    // common data types
+public:
+    typedef __value_t           value_type;
+    typedef size_t              size_type;
+    typedef __value_t &         reference;
+    typedef const __value_t &   const_reference;
+
+    /** 供 xmsg_publisher_t::dispatch_batch() 使用的批次类型 */
+    typedef typename xmsg_queue_traits_t< __queue_t >::x_batch_t x_batch_t;
+
+    /** 消息参数使用的分配器类型 */
+    typedef xmsg_arena_allocator_t< char > x_alloc_t;
+
+    // constructor/destructor
+public:
+    xmsg_arena_queue_t(void)
+        : m_xarena0(__chunk_size)
+        , m_xarena1(__chunk_size)
+        , m_xactive(&m_xarena0)
+        , m_xepoch(0)
+        , m_xseen(0)
+        , m_xqueue()
+    {
+
+    }
+
+    ~xmsg_arena_queue_t(void)
+    {
+
+    }
+
+    xmsg_arena_queue_t(xmsg_arena_queue_t && xobject) = delete;
+    xmsg_arena_queue_t & operator=(xmsg_arena_queue_t && xobject) = delete;
+    xmsg_arena_queue_t(const xmsg_arena_queue_t & xobject) = delete;
+    xmsg_arena_queue_t & operator=(const xmsg_arena_queue_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 返回队列中的元素数量。
+     */
+    inline size_type size(void) const { return m_xqueue.size(); }
+
+    /**********************************************************/
+    /**
+     * @brief 判断队列是否为空。
+     */
+    inline bool empty(void) const { return m_xqueue.empty(); }
+
+    /**********************************************************/
+    /**
+     * @brief 将元素（使用内存区重新构造）压入队列。
+     */
+    void push(const value_type & xvalue)
+    {
+        handoff();
+        m_xqueue.emplace(std::allocator_arg, allocator(), xvalue);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将元素（使用内存区重新构造）压入队列。
+     */
+    void push(value_type && xvalue)
+    {
+        handoff();
+        m_xqueue.emplace(std::allocator_arg, allocator(), std::move(xvalue));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 在队列中直接构造元素（消息参数从内存区中分配）。
+     */
+    template< typename... __args_t >
+    void emplace(__args_t &&... xargs)
+    {
+        handoff();
+        m_xqueue.emplace(std::allocator_arg, allocator(), std::forward< __args_t >(xargs)...);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 返回队首元素。
+     */
+    inline reference front(void) { return m_xqueue.front(); }
+
+    /**********************************************************/
+    /**
+     * @brief 弹出队首元素（消费者端，越过一个批次边界）。
+     */
+    inline void pop(void)
+    {
+        m_xqueue.pop();
+        next_epoch();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将队列中的所有元素摘取到（空的）xbatch 中（消费者端，越过一个批次边界）。
+     */
+    void detach(x_batch_t & xbatch)
+    {
+        assert(xbatch.empty());
+        xmsg_queue_traits_t< __queue_t >::detach(m_xqueue, xbatch);
+        next_epoch();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将 xbatch 中剩余的元素按原有顺序放回到本队列的最前面（消费者端）。
+     */
+    void restore(x_batch_t & xbatch)
+    {
+        xmsg_queue_traits_t< __queue_t >::restore(m_xqueue, xbatch);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 当前接收新消息的内存区分配器（生产者端）。
+     */
+    inline x_alloc_t allocator(void) { return x_alloc_t(m_xactive); }
+
+    /**********************************************************/
+    /**
+     * @brief 内存区（下标 0 或 1），用于统计显示（生产者线程调用）。
+     */
+    inline const xmsg_arena_t & arena(size_t xindex) const
+    {
+        assert(xindex < 2);
+        return (0 == xindex) ? m_xarena0 : m_xarena1;
+    }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 消费者越过一个批次边界：递增批次编号（只有消费者写入）。
+     */
+    inline void next_epoch(void)
+    {
+        m_xepoch.store(m_xepoch.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_relaxed);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 生产者端：消费者越过批次边界之后，若另一个内存区中的消息
+     *        已全部析构，则将其回绕并切换为接收新消息的内存区。
+     */
+    inline void handoff(void)
+    {
+        const size_t xepoch = m_xepoch.load(std::memory_order_relaxed);
+        if (xepoch == m_xseen)
+        {
+            return;
+        }
+
+        xmsg_arena_t * xidle = (&m_xarena0 == m_xactive) ? &m_xarena1 : &m_xarena0;
+        if (xidle->rewind())
+        {
+            m_xactive = xidle;
+            m_xseen   = xepoch;
+        }
+    }
+
+    // data members
+private:
+    xmsg_arena_t          m_xarena0; ///< 交替工作的两个内存区
+    xmsg_arena_t          m_xarena1; ///< 交替工作的两个内存区
+    xmsg_arena_t *        m_xactive; ///< 当前接收新消息的内存区（生产者端）
+    std::atomic< size_t > m_xepoch;  ///< 消费者越过的批次边界数量
+    size_t                m_xseen;   ///< 上次切换内存区时的批次编号（生产者端）
+    __queue_t             m_xqueue;  ///< 实际存储元素的队列（须先于内存区析构）
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __XMSG_ARENA_H__
@@ -0,0 +1,689 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/**
+ * @file xmsg_codec.h
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * @author  ：Gaaagaa
+ * @date    : 2026-10-18
+ * @version : 1.0.0.0
+ * @brief   : 消息对象（xmsg_context_t）的二进制编解码（定长布局、对齐、可原地读取）。
+ */
+
+#ifndef __XMSG_CODEC_H__
+#define __XMSG_CODEC_H__
+
+#include "xmsg_pubsub.h"
+
+#include <tuple>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <type_traits>
+
+////////////////////////////////////////////////////////////////////////////////
+// 编码格式
+// 
+// 1. 每个消息对象编码为一条记录，记录的起始地址与长度均按 8 字节对齐：
+//    [ 记录头 ][ 定长区：消息键、各个参数 ][ 变长区：字符串/数组的元素 ]
+// 2. 记录头为 8 字节：记录的总字节数 + 字段布局的签名（由各字段的类型计算得出，
+//    用于校验 编码端 与 解码端 的消息类型是否一致）；
+// 3. 定长区中每个字段的偏移量在编译期确定（按字段类型自身的对齐要求排列）：
+//    可平凡复制的类型直接存放其对象表示，可在缓冲区中原地读取（无需反序列化）；
+//    std::string 与 std::vector< T >（T 可平凡复制）存放 8 字节的槽位
+//    （元素在记录中的偏移量 + 元素数量），元素存放在变长区（8 字节对齐）；
+// 4. 多条记录首尾相接即为批量编码的结果（无额外的批次头），
+//    可直接写入文件 或 网络连接，读取端按记录头中的总字节数依次遍历；
+// 5. 编码使用本机字节序，仅用于相同架构的主机之间；
+// 6. 记录头、字段之间 以及 变长区的对齐填充均清零，但可平凡复制的字段
+//    是按对象表示整体复制的，其类型内部的填充字节（如 struct { char; int; }）
+//    保持原值。因此只有各字段类型均不含内部填充时（算术类型、枚举、
+//    std::string 、std::vector< 算术类型 > 等），相同的消息对象才编码为相同的字节。
+// 
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_codec_field_t
+
+/**********************************************************/
+/**
+ * @brief 将 xsize 向上对齐到 xalign（2 的幂）的整数倍。
+ */
+constexpr inline size_t xmsg_codec_align(size_t xsize, size_t xalign)
+{
+    return (xsize + xalign - 1) & ~(xalign - 1);
+}
+
+/**
+ * @struct xmsg_codec_header_t
+ * @brief 编码记录的记录头。
+ */
+struct xmsg_codec_header_t
+{
+    uint32_t xsize;  ///< 记录的总字节数（含记录头，8 字节对齐）
+    uint32_t xsign;  ///< 字段布局的签名
+};
+
+/**
+ * @struct xmsg_codec_slot_t
+ * @brief 变长字段（字符串/数组）在定长区中的槽位。
+ */
+struct xmsg_codec_slot_t
+{
+    uint32_t xoffset; ///< 元素在记录中的偏移量
+    uint32_t xlength; ///< 元素数量
+};
+
+/**
+ * @struct xmsg_codec_span_t< __elem_t >
+ * @brief 原地读取变长字段时返回的只读视图（指向编码缓冲区中的元素）。
+ */
+template< typename __elem_t >
+struct xmsg_codec_span_t
+{
+    const __elem_t * xdata; ///< 首个元素的地址
+    size_t           xsize; ///< 元素数量
+
+    inline const __elem_t * data(void) const { return xdata; }
+    inline size_t size(void) const { return xsize; }
+    inline bool empty(void) const { return (0 == xsize); }
+    inline const __elem_t * begin(void) const { return xdata; }
+    inline const __elem_t * end(void) const { return xdata + xsize; }
+    inline const __elem_t & operator[](size_t xindex) const { return xdata[xindex]; }
+};
+
+/**
+ * @struct xmsg_codec_field_t< __value_t >
+ * @brief 字段类型的编解码操作：默认支持可平凡复制的类型（直接存放于定长区）。
+ * @note
+ * 自定义的字段类型可特化本模板，须提供：x_view_t 、XFIXED 、XALIGN 、XSIGN 常量，
+ * 以及 extra()、store()、view()、load()、check() 接口（参看 xmsg_codec_blob_t）。
+ */
+template< typename __value_t >
+struct xmsg_codec_field_t
+{
+    static_assert(std::is_trivially_copyable< __value_t >::value,
+                  "The field type must be trivially copyable, std::string or std::vector!");
+    static_assert(alignof(__value_t) <= 8, "The field alignment must not exceed 8 bytes!");
+
+    /** 原地读取时的返回类型 */
+    using x_view_t = const __value_t &;
+
+    /** 在定长区中占用的字节数 */
+    static constexpr size_t   XFIXED = sizeof(__value_t);
+    /** 在定长区中的对齐字节数 */
+    static constexpr size_t   XALIGN = alignof(__value_t);
+    /** 字段布局的签名因子 */
+    static constexpr uint32_t XSIGN  = static_cast< uint32_t >(
+                                    (sizeof(__value_t) << 8) | (alignof(__value_t) << 4) | 1);
+
+    /**********************************************************/
+    /**
+     * @brief 在变长区中占用的字节数。
+     */
+    static inline size_t extra(const __value_t &)
+    {
+        return 0;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将字段编码到记录 xbase 的 xoffset 处（xextra 为变长区的写入位置）。
+     */
+    static inline void store(char * xbase, size_t xoffset, size_t &, const __value_t & xvalue)
+    {
+        std::memcpy(xbase + xoffset, &xvalue, sizeof(__value_t));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 原地读取记录 xbase 的 xoffset 处的字段。
+     */
+    static inline x_view_t view(const char * xbase, size_t xoffset)
+    {
+        return *reinterpret_cast< const __value_t * >(xbase + xoffset);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 解码（复制）记录 xbase 的 xoffset 处的字段。
+     */
+    static inline __value_t load(const char * xbase, size_t xoffset)
+    {
+        return view(xbase, xoffset);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 校验字段的内容是否位于记录之内（xsize 为记录的总字节数）。
+     */
+    static inline bool check(const char *, size_t, size_t)
+    {
+        return true;
+    }
+};
+
+/**
+ * @struct xmsg_codec_blob_t< __elem_t, __value_t >
+ * @brief 变长字段（连续存放的元素序列，如 std::string 、std::vector< T >）的编解码操作。
+ */
+template< typename __elem_t, typename __value_t >
+struct xmsg_codec_blob_t
+{
+    static_assert(std::is_trivially_copyable< __elem_t >::value,
+                  "The element type must be trivially copyable!");
+    static_assert(alignof(__elem_t) <= 8, "The element alignment must not exceed 8 bytes!");
+
+    using x_view_t = xmsg_codec_span_t< __elem_t >;
+
+    static constexpr size_t   XFIXED = sizeof(xmsg_codec_slot_t);
+    static constexpr size_t   XALIGN = alignof(xmsg_codec_slot_t);
+    static constexpr uint32_t XSIGN  = static_cast< uint32_t >(
+                                    (sizeof(__elem_t) << 8) | (alignof(__elem_t) << 4) | 2);
+
+    static inline size_t extra(const __value_t & xvalue)
+    {
+        return xmsg_codec_align(xvalue.size() * sizeof(__elem_t), 8);
+    }
+
+    static inline void store(char * xbase, size_t xoffset, size_t & xextra, const __value_t & xvalue)
+    {
+        xmsg_codec_slot_t xslot;
+        xslot.xoffset = static_cast< uint32_t >(xextra);
+        xslot.xlength = static_cast< uint32_t >(xvalue.size());
+        std::memcpy(xbase + xoffset, &xslot, sizeof(xmsg_codec_slot_t));
+
+        const size_t xbytes = xvalue.size() * sizeof(__elem_t);
+        const size_t xalign = extra(xvalue);
+        if (0 != xbytes)
+        {
+            std::memcpy(xbase + xextra, &xvalue[0], xbytes);
+        }
+
+        // 对齐填充清零（不写出未初始化的字节）
+        std::memset(xbase + xextra + xbytes, 0, xalign - xbytes);
+        xextra += xalign;
+    }
+
+    static inline x_view_t view(const char * xbase, size_t xoffset)
+    {
+        const xmsg_codec_slot_t * xslot =
+            reinterpret_cast< const xmsg_codec_slot_t * >(xbase + xoffset);
+        x_view_t xview;
+        xview.xdata = reinterpret_cast< const __elem_t * >(xbase + xslot->xoffset);
+        xview.xsize = xslot->xlength;
+        return xview;
+    }
+
+    static inline __value_t load(const char * xbase, size_t xoffset)
+    {
+        x_view_t xview = view(xbase, xoffset);
+        return __value_t(xview.begin(), xview.end());
+    }
+
+    static inline bool check(const char * xbase, size_t xoffset, size_t xsize)
+    {
+        const xmsg_codec_slot_t * xslot =
+            reinterpret_cast< const xmsg_codec_slot_t * >(xbase + xoffset);
+        return ((0 == (xslot->xoffset & 7)) &&
+                (xslot->xoffset <= xsize) &&
+                (static_cast< uint64_t >(xslot->xlength) * sizeof(__elem_t) <=
+                 xsize - xslot->xoffset));
+    }
+};
+
+template< typename __char_t, typename __traits_t, typename __alloc_t >
+struct xmsg_codec_field_t< std::basic_string< __char_t, __traits_t, __alloc_t > >
+    : xmsg_codec_blob_t< __char_t, std::basic_string< __char_t, __traits_t, __alloc_t > >
+{
+
+};
+
+template< typename __elem_t, typename __alloc_t >
+struct xmsg_codec_field_t< std::vector< __elem_t, __alloc_t > >
+    : xmsg_codec_blob_t< __elem_t, std::vector< __elem_t, __alloc_t > >
+{
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_codec_layout_t
+
+/**
+ * @struct xmsg_codec_layout_t< __fields_t >
+ * @brief 编译期计算记录定长区的布局（__fields_t 为 std::tuple< 消息键, 参数... >）。
+ */
+template< typename __fields_t >
+struct xmsg_codec_layout_t
+{
+    static constexpr size_t XFIELDS = std::tuple_size< __fields_t >::value;
+
+    template< size_t __index >
+    using x_field_t = xmsg_codec_field_t<
+                        typename std::tuple_element< __index, __fields_t >::type >;
+
+    /** 第 __index 个字段在记录中的偏移量 */
+    template< size_t __index, typename = void >
+    struct x_offset_t
+    {
+        static constexpr size_t value = xmsg_codec_align(
+                x_offset_t< __index - 1 >::value + x_field_t< __index - 1 >::XFIXED,
+                x_field_t< __index >::XALIGN);
+    };
+
+    template< typename __void_t >
+    struct x_offset_t< 0, __void_t >
+    {
+        static constexpr size_t value = xmsg_codec_align(
+                sizeof(xmsg_codec_header_t), x_field_t< 0 >::XALIGN);
+    };
+
+    /** 字段布局的签名（FNV-1a） */
+    template< size_t __index, typename = void >
+    struct x_sign_t
+    {
+        static constexpr uint32_t value = static_cast< uint32_t >(
+                (x_sign_t< __index - 1 >::value ^ x_field_t< __index - 1 >::XSIGN) * 16777619u);
+    };
+
+    template< typename __void_t >
+    struct x_sign_t< 0, __void_t >
+    {
+        static constexpr uint32_t value = 2166136261u;
+    };
+
+    /** 定长区（含记录头）的字节数 */
+    static constexpr size_t   XFIXED = xmsg_codec_align(
+                x_offset_t< XFIELDS - 1 >::value + x_field_t< XFIELDS - 1 >::XFIXED, 8);
+    /** 字段布局的签名 */
+    static constexpr uint32_t XSIGN  = x_sign_t< XFIELDS >::value;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_codec_t
+
+/**
+ * @class xmsg_codec_t< __msg_context_t >
+ * @brief 消息对象（消息键 + 参数列表）的二进制编解码。
+ * @note
+ * 1. 编码格式参看本文件开头的说明；消息键 与 各个参数 须为可平凡复制的类型、
+ *    std::string 或 std::vector< T >（T 可平凡复制），否则编译失败；
+ * 2. view() 返回的 x_view_t 直接在缓冲区中读取各个字段（要求缓冲区 8 字节对齐，
+ *    operator new 分配的内存 与 std::vector< char > 的数据区均满足此要求）；
+ * 3. 来自外部（文件、网络）的数据应先调用 verify() 校验，再 view()/decode()。
+ * 
+ * @param [in ] __msg_context_t : 消息类型（xmsg_context_t）。
+ */
+template< typename __msg_context_t >
+class xmsg_codec_t
+{
+    // common data types
+public:
+    using x_msgctxt_t = __msg_context_t;
+    using x_mkey_t    = typename x_msgctxt_t::x_mkey_t;
+    using x_args_t    = typename x_msgctxt_t::x_args_t;
+
+private:
+    template< typename __tuple_t >
+    struct x_fields_of_t;
+
+    template< typename... __types_t >
+    struct x_fields_of_t< std::tuple< __types_t... > >
+    {
+        typedef std::tuple< x_mkey_t, __types_t... > type;
+    };
+
+public:
+    /** 各个字段的类型：std::tuple< 消息键, 参数... > */
+    using x_fields_t = typename x_fields_of_t< x_args_t >::type;
+    using x_layout_t = xmsg_codec_layout_t< x_fields_t >;
+    using x_index_t  = typename xbuild_index_sequence_t<
+                                    std::tuple_size< x_args_t >::value >::type;
+
+    /** 记录的对齐字节数 */
+    static constexpr size_t   XALIGN = 8;
+    /** 定长区（含记录头）的字节数，即记录的最小字节数 */
+    static constexpr size_t   XFIXED = x_layout_t::XFIXED;
+    /** 字段布局的签名 */
+    static constexpr uint32_t XSIGN  = x_layout_t::XSIGN;
+
+    template< size_t __index >
+    using x_field_t  = typename x_layout_t::template x_field_t< __index >;
+
+    template< size_t __index >
+    using x_offset_t = typename x_layout_t::template x_offset_t< __index >;
+
+    /**
+     * @class x_view_t
+     * @brief 在编码缓冲区中原地读取记录的各个字段（不复制数据）。
+     */
+    class x_view_t
+    {
+    public:
+        explicit x_view_t(const void * xrecord)
+            : m_xbase(static_cast< const char * >(xrecord))
+        {
+            assert(0 == (reinterpret_cast< uintptr_t >(xrecord) & (XALIGN - 1)));
+        }
+
+        /**********************************************************/
+        /**
+         * @brief 记录的总字节数。
+         */
+        inline size_t size(void) const
+        {
+            return reinterpret_cast< const xmsg_codec_header_t * >(m_xbase)->xsize;
+        }
+
+        /**********************************************************/
+        /**
+         * @brief 记录的首地址。
+         */
+        inline const void * data(void) const
+        {
+            return m_xbase;
+        }
+
+        /**********************************************************/
+        /**
+         * @brief 消息键。
+         */
+        inline typename x_field_t< 0 >::x_view_t mkey(void) const
+        {
+            return x_field_t< 0 >::view(m_xbase, x_offset_t< 0 >::value);
+        }
+
+        /**********************************************************/
+        /**
+         * @brief 第 __index 个消息参数。
+         */
+        template< size_t __index >
+        inline typename x_field_t< __index + 1 >::x_view_t get(void) const
+        {
+            return x_field_t< __index + 1 >::view(m_xbase, x_offset_t< __index + 1 >::value);
+        }
+
+    private:
+        const char * m_xbase; ///< 记录的首地址
+    };
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 消息对象编码后的字节数。
+     */
+    static size_t encoded_size(const x_msgctxt_t & xmsg_ctxt)
+    {
+        return XFIXED + x_field_t< 0 >::extra(xmsg_ctxt.mkey()) +
+               extra_args(xmsg_ctxt.args(), x_index_t());
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将消息对象编码到 xdst 中（xdst 须 8 字节对齐）。
+     * 
+     * @return size_t : 写入的字节数；xcapacity 不足时返回 0 。
+     */
+    static size_t encode(void * xdst, size_t xcapacity, const x_msgctxt_t & xmsg_ctxt)
+    {
+        const size_t xsize = encoded_size(xmsg_ctxt);
+        if ((xsize > xcapacity) || (xsize > UINT32_MAX))
+        {
+            return 0;
+        }
+
+        store(static_cast< char * >(xdst), xsize, xmsg_ctxt);
+        return xsize;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将消息对象编码后追加到 xbuffer 的末尾。
+     * 
+     * @return size_t : 追加的字节数；记录超过 UINT32_MAX 字节时返回 0（xbuffer 不变）。
+     */
+    static size_t encode(std::vector< char > & xbuffer, const x_msgctxt_t & xmsg_ctxt)
+    {
+        assert(0 == (xbuffer.size() & (XALIGN - 1)));
+
+        const size_t xsize = encoded_size(xmsg_ctxt);
+        if (xsize > UINT32_MAX)
+        {
+            return 0;
+        }
+
+        const size_t xoffset = xbuffer.size();
+        xbuffer.resize(xoffset + xsize);
+        store(xbuffer.data() + xoffset, xsize, xmsg_ctxt);
+        return xsize;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 批量编码：将 [xfirst, xlast) 的消息对象依次追加到 xbuffer 的末尾
+     *        （先计算总字节数，只扩容一次）。
+     * 
+     * @return size_t : 追加的字节数；任一记录超过 UINT32_MAX 字节时返回 0（xbuffer 不变）。
+     */
+    template< typename __iterator_t >
+    static size_t encode(std::vector< char > & xbuffer, __iterator_t xfirst, __iterator_t xlast)
+    {
+        assert(0 == (xbuffer.size() & (XALIGN - 1)));
+
+        size_t xtotal = 0;
+        for (__iterator_t xiter = xfirst; xiter != xlast; ++xiter)
+        {
+            const size_t xsize = encoded_size(*xiter);
+            if (xsize > UINT32_MAX)
+            {
+                return 0;
+            }
+
+            xtotal += xsize;
+        }
+
+        size_t xoffset = xbuffer.size();
+        xbuffer.resize(xoffset + xtotal);
+
+        for (__iterator_t xiter = xfirst; xiter != xlast; ++xiter)
+        {
+            const size_t xsize = encoded_size(*xiter);
+            store(xbuffer.data() + xoffset, xsize, *xiter);
+            xoffset += xsize;
+        }
+
+        return xtotal;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 校验 xsrc 起始的记录（xsize 为 xsrc 中可用的字节数）。
+     * 
+     * @return size_t : 记录的总字节数；记录不完整 或 无效时返回 0 。
+     */
+    static size_t verify(const void * xsrc, size_t xsize)
+    {
+        if ((xsize < XFIXED) || (0 != (reinterpret_cast< uintptr_t >(xsrc) & (XALIGN - 1))))
+        {
+            return 0;
+        }
+
+        const char * xbase = static_cast< const char * >(xsrc);
+        const xmsg_codec_header_t * xheader =
+            reinterpret_cast< const xmsg_codec_header_t * >(xbase);
+        if ((XSIGN != xheader->xsign) ||
+            (xheader->xsize < XFIXED) ||
+            (xheader->xsize > xsize) ||
+            (0 != (xheader->xsize & (XALIGN - 1))))
+        {
+            return 0;
+        }
+
+        if (!x_field_t< 0 >::check(xbase, x_offset_t< 0 >::value, xheader->xsize) ||
+            !check_args(xbase, xheader->xsize, x_index_t()))
+        {
+            return 0;
+        }
+
+        return xheader->xsize;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 原地读取 xsrc 起始的记录（不校验）。
+     */
+    static inline x_view_t view(const void * xsrc)
+    {
+        return x_view_t(xsrc);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 解码 xsrc 起始的记录（不校验），构建消息对象。
+     */
+    static x_msgctxt_t decode(const void * xsrc)
+    {
+        const char * xbase = static_cast< const char * >(xsrc);
+        return decode_args(xbase, x_index_t());
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 依次遍历 [xsrc, xsrc + xsize) 中批量编码的记录（逐条校验）。
+     * 
+     * @param [in ] xfunc : 记录的处理操作：void xfunc(const x_view_t & xview) 。
+     * 
+     * @return size_t : 遍历的字节数（遇到无效 或 不完整的记录时停止，
+     *                  返回值小于 xsize 时，剩余部分为不完整的记录 或 无效数据）。
+     */
+    template< typename __func_t >
+    static size_t for_each(const void * xsrc, size_t xsize, __func_t && xfunc)
+    {
+        const char * xbase   = static_cast< const char * >(xsrc);
+        size_t       xoffset = 0;
+
+        while (xoffset < xsize)
+        {
+            const size_t xrsize = verify(xbase + xoffset, xsize - xoffset);
+            if (0 == xrsize)
+                break;
+
+            xfunc(x_view_t(xbase + xoffset));
+            xoffset += xrsize;
+        }
+
+        return xoffset;
+    }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 将消息对象编码到 xbase 中（xsize 为 encoded_size() 的结果）。
+     */
+    static inline void store(char * xbase, size_t xsize, const x_msgctxt_t & xmsg_ctxt)
+    {
+        std::memset(xbase, 0, XFIXED);
+
+        xmsg_codec_header_t xheader;
+        xheader.xsize = static_cast< uint32_t >(xsize);
+        xheader.xsign = XSIGN;
+        std::memcpy(xbase, &xheader, sizeof(xmsg_codec_header_t));
+
+        size_t xextra = XFIXED;
+        x_field_t< 0 >::store(xbase, x_offset_t< 0 >::value, xextra, xmsg_ctxt.mkey());
+        store_args(xbase, xextra, xmsg_ctxt.args(), x_index_t());
+        assert(xextra == xsize);
+    }
+
+    template< size_t... __indexes >
+    static inline size_t extra_args(const x_args_t & xargs, xindex_sequence_t< __indexes... >)
+    {
+        size_t xextra = 0;
+        int xexpand[] =
+        {
+            0, (xextra += x_field_t< __indexes + 1 >::extra(std::get< __indexes >(xargs)), 0)...
+        };
+        (void)xexpand;
+        (void)xargs;
+        return xextra;
+    }
+
+    template< size_t... __indexes >
+    static inline void store_args(char * xbase,
+                                  size_t & xextra,
+                                  const x_args_t & xargs,
+                                  xindex_sequence_t< __indexes... >)
+    {
+        int xexpand[] =
+        {
+            0, (x_field_t< __indexes + 1 >::store(xbase,
+                                                  x_offset_t< __indexes + 1 >::value,
+                                                  xextra,
+                                                  std::get< __indexes >(xargs)), 0)...
+        };
+        (void)xexpand;
+        (void)xbase;
+        (void)xextra;
+        (void)xargs;
+    }
+
+    template< size_t... __indexes >
+    static inline bool check_args(const char * xbase,
+                                  size_t xsize,
+                                  xindex_sequence_t< __indexes... >)
+    {
+        bool xvalid = true;
+        int xexpand[] =
+        {
+            0, (xvalid = xvalid && x_field_t< __indexes + 1 >::check(
+                                        xbase, x_offset_t< __indexes + 1 >::value, xsize), 0)...
+        };
+        (void)xexpand;
+        (void)xbase;
+        (void)xsize;
+        return xvalid;
+    }
+
+    template< size_t... __indexes >
+    static inline x_msgctxt_t decode_args(const char * xbase, xindex_sequence_t< __indexes... >)
+    {
+        return x_msgctxt_t(x_field_t< 0 >::load(xbase, x_offset_t< 0 >::value),
+                           x_args_t(x_field_t< __indexes + 1 >::load(
+                                        xbase, x_offset_t< __indexes + 1 >::value)...));
+    }
+};
+
+template< typename __msg_context_t >
+constexpr size_t xmsg_codec_t< __msg_context_t >::XALIGN;
+template< typename __msg_context_t >
+constexpr size_t xmsg_codec_t< __msg_context_t >::XFIXED;
+template< typename __msg_context_t >
+constexpr uint32_t xmsg_codec_t< __msg_context_t >::XSIGN;
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __XMSG_CODEC_H__
@@ -0,0 +1,1067 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/**
+ * @file xmsg_concurrent_publisher.h
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * @author  ：Gaaagaa
+ * @date    : 2026-10-18
+ * @version : 1.0.0.0
+ * @brief   : 支持并发订阅的发布者：写时复制的订阅表（原子指针发布新版本，
+ *            基于纪元回收旧版本），投递线程无锁读取订阅表的快照。
+ */
+
+#ifndef __XMSG_CONCURRENT_PUBLISHER_H__
+#define __XMSG_CONCURRENT_PUBLISHER_H__
+
+#include "xmsg_pubsub.h"
+#include "xmsg_mpsc_queue.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/** xmsg_epoch_t 可同时进入读临界区的线程数量 */
+#ifndef XMSG_EPOCH_SLOTS
+#define XMSG_EPOCH_SLOTS 64
+#endif // XMSG_EPOCH_SLOTS
+
+/** 投递线程每进入一次读临界区，最多投递的消息数量 */
+#ifndef XMSG_EPOCH_CHUNK
+#define XMSG_EPOCH_CHUNK 64
+#endif // XMSG_EPOCH_CHUNK
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_epoch_t
+
+/**
+ * @class xmsg_epoch_t
+ * @brief 基于纪元的内存回收（EBR）：读者在 x_guard_t 的作用域内访问共享对象，
+ *        写者将摘除的旧对象 retire() 之后，待所有可能引用它的读者都离开时再释放。
+ * @note
+ * 1. 读者进入时，在一个空闲的槽位中记录当前的全局纪元（离开时清零），
+ *    不加锁，也不修改共享对象的引用计数；
+ * 2. retire() 以当前的全局纪元标记旧对象；reclaim() 先推进全局纪元，
+ *    再释放 纪元小于 所有活动读者纪元 的旧对象；
+ * 3. retire()/reclaim()/advance()/synchronize() 须由写者串行调用（由使用者加锁）；
+ *    x_guard_t 与 wait() 可在任意线程中并发使用（x_guard_t 可嵌套）；
+ *    等待读者时，可先在锁内 advance() ，再在锁外 wait() ，最后在锁内 reclaim() 。
+ */
+class xmsg_epoch_t
+{
+    // common data types
+public:
+    /**
+     * @class x_guard_t
+     * @brief 读临界区：作用域内读取的共享对象不会被释放。
+     */
+    class x_guard_t
+    {
+        // constructor/destructor
+    public:
+        explicit x_guard_t(xmsg_epoch_t & xepoch)
+            : m_xslot(xepoch.enter())
+        {
+            guard_depth() += 1;
+        }
+
+        ~x_guard_t(void)
+        {
+            guard_depth() -= 1;
+            m_xslot->store(0, std::memory_order_release);
+        }
+
+        x_guard_t(x_guard_t && xobject) = delete;
+        x_guard_t & operator=(x_guard_t && xobject) = delete;
+        x_guard_t(const x_guard_t & xobject) = delete;
+        x_guard_t & operator=(const x_guard_t & xobject) = delete;
+
+        // data members
+    private:
+        std::atomic< uint64_t > * m_xslot; ///< 占用的槽位
+    };
+
+private:
+    /** 缓存行大小（读者槽位各占一个缓存行，避免伪共享） */
+    static constexpr size_t XCACHE_LINE_SIZE = 64;
+
+    /**
+     * @struct x_slot_t
+     * @brief 读者槽位（记录读者进入时的全局纪元，0 表示空闲）。
+     */
+    struct x_slot_t
+    {
+        std::atomic< uint64_t > xepoch;
+        char xpad[XCACHE_LINE_SIZE - sizeof(std::atomic< uint64_t >)];
+    };
+
+    /**
+     * @struct x_retired_t
+     * @brief 待释放的旧对象。
+     */
+    struct x_retired_t
+    {
+        uint64_t xepoch;            ///< retire() 时的全局纪元
+        void   * xobject;           ///< 旧对象
+        void  (* xdelete)(void *);  ///< 释放旧对象的函数
+    };
+
+    // constructor/destructor
+public:
+    xmsg_epoch_t(void)
+        : m_xglobal(1)
+    {
+        for (x_slot_t & xslot : m_xslots)
+        {
+            xslot.xepoch.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ~xmsg_epoch_t(void)
+    {
+        for (const x_retired_t & xretired : m_xretired)
+        {
+            xretired.xdelete(xretired.xobject);
+        }
+    }
+
+    xmsg_epoch_t(xmsg_epoch_t && xobject) = delete;
+    xmsg_epoch_t & operator=(xmsg_epoch_t && xobject) = delete;
+    xmsg_epoch_t(const xmsg_epoch_t & xobject) = delete;
+    xmsg_epoch_t & operator=(const xmsg_epoch_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 登记已从共享结构中摘除的旧对象（写者调用）。
+     */
+    template< typename __object_t >
+    void retire(const __object_t * xobject)
+    {
+        if (nullptr == xobject)
+        {
+            return;
+        }
+
+        x_retired_t xretired;
+        xretired.xepoch  = m_xglobal.load(std::memory_order_relaxed);
+        xretired.xobject = const_cast< __object_t * >(xobject);
+        xretired.xdelete = [](void * xptr) { delete static_cast< __object_t * >(xptr); };
+        m_xretired.push_back(xretired);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 释放不再被任何读者引用的旧对象（写者调用），返回释放的数量。
+     */
+    size_t reclaim(void)
+    {
+        if (m_xretired.empty())
+        {
+            return 0;
+        }
+
+        // 推进全局纪元：此后进入的读者，都不可能读取到已摘除的旧对象
+        m_xglobal.fetch_add(1, std::memory_order_seq_cst);
+        const uint64_t xactive = min_active();
+
+        // 可释放的旧对象移至末尾（保持剩余对象的先后顺序），再一次性删除
+        std::vector< x_retired_t >::iterator itend =
+            std::stable_partition(m_xretired.begin(),
+                                  m_xretired.end(),
+                                  [xactive](const x_retired_t & xretired)
+                                  {
+                                      return (xretired.xepoch >= xactive);
+                                  });
+
+        const size_t xcount = static_cast< size_t >(m_xretired.end() - itend);
+        for (std::vector< x_retired_t >::iterator itret = itend;
+             itret != m_xretired.end();
+             ++itret)
+        {
+            itret->xdelete(itret->xobject);
+        }
+        m_xretired.erase(itend, m_xretired.end());
+
+        return xcount;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 推进全局纪元（写者调用），返回推进后的纪元（用作 wait() 的参数）。
+     */
+    uint64_t advance(void)
+    {
+        return (m_xglobal.fetch_add(1, std::memory_order_seq_cst) + 1);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 等待 纪元小于 xepoch 的读者全部离开（可在任意线程中调用，无须加锁）。
+     * @note 不能在读临界区内调用（否则永远等待自身）。
+     */
+    void wait(uint64_t xepoch) const
+    {
+        assert(0 == guard_depth());
+
+        while (min_active() < xepoch)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 等待当前所有活动的读者离开，然后释放所有的旧对象（写者调用）。
+     * @note 不能在读临界区内调用（否则永远等待自身）。
+     */
+    void synchronize(void)
+    {
+        wait(advance());
+        reclaim();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 待释放的旧对象数量。
+     */
+    inline size_t retired(void) const { return m_xretired.size(); }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 当前线程嵌套进入读临界区的层数（所有 xmsg_epoch_t 对象共用）。
+     */
+    static int & guard_depth(void)
+    {
+        static thread_local int xdepth = 0;
+        return xdepth;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 读者进入：占用一个空闲的槽位，并记录当前的全局纪元。
+     */
+    std::atomic< uint64_t > * enter(void)
+    {
+        for (;;)
+        {
+            for (x_slot_t & xslot : m_xslots)
+            {
+                uint64_t xidle  = 0;
+                uint64_t xepoch = m_xglobal.load(std::memory_order_seq_cst);
+                if ((0 == xslot.xepoch.load(std::memory_order_relaxed)) &&
+                    xslot.xepoch.compare_exchange_strong(xidle,
+                                                         xepoch,
+                                                         std::memory_order_seq_cst))
+                {
+                    // 与写者 reclaim() 中的栅栏配对：槽位的写入先于之后对共享对象的读取
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    return &xslot.xepoch;
+                }
+            }
+
+            std::this_thread::yield();
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 所有活动读者的最小纪元（没有活动的读者时，返回 UINT64_MAX）。
+     */
+    uint64_t min_active(void) const
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        uint64_t xmin = UINT64_MAX;
+        for (const x_slot_t & xslot : m_xslots)
+        {
+            const uint64_t xepoch = xslot.xepoch.load(std::memory_order_seq_cst);
+            if ((0 != xepoch) && (xepoch < xmin))
+            {
+                xmin = xepoch;
+            }
+        }
+
+        return xmin;
+    }
+
+    // data members
+private:
+    x_slot_t                   m_xslots[XMSG_EPOCH_SLOTS]; ///< 读者槽位
+    std::atomic< uint64_t >    m_xglobal;                  ///< 全局纪元
+    std::vector< x_retired_t > m_xretired;                 ///< 待释放的旧对象
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_cow_registry_t
+
+/**
+ * @class xmsg_cow_registry_t< __msg_context_t >
+ * @brief 写时复制的订阅表：消息类型 -> 订阅者集合。
+ * @note
+ * 1. 订阅表为 2 的幂个桶，每个桶 与 每个订阅者集合 都是不可变对象：
+ *    写操作复制被修改的集合及其所在的桶，再以原子指针发布新的桶；
+ *    消息类型的数量超过桶数的 2 倍时，以同样的方式发布扩容后的新表；
+ * 2. 读操作（find()）在 xmsg_epoch_t::x_guard_t 的作用域内进行，
+ *    只有两次原子读取，不加锁；读到的集合在作用域内保持不变；
+ * 3. 写操作之间使用互斥锁串行化，被替换的旧对象交由 xmsg_epoch_t 回收；
+ *    订阅者集合持有订阅者对象的 shared_ptr ，因此取消订阅之后，
+ *    正在读取旧集合的读者仍可安全地调用该订阅者。
+ * 
+ * @param [in ] __msg_context_t : 消息类型（xmsg_context_t）。
+ */
+template< typename __msg_context_t >
+class xmsg_cow_registry_t
+{
+    // common data types
+public:
+    using x_msgctxt_t    = __msg_context_t;
+    using x_mkey_t       = typename x_msgctxt_t::x_mkey_t;
+    using x_subscriber_t = xmsg_subscriber_t< XSUBER_BASE_TYPE, x_msgctxt_t >;
+    using x_subsptr_t    = std::shared_ptr< x_subscriber_t >;
+    using x_guard_t      = xmsg_epoch_t::x_guard_t;
+
+    /**
+     * @struct x_subset_t
+     * @brief 消息类型的订阅者集合（不可变对象）。
+     */
+    struct x_subset_t
+    {
+        x_mkey_t                   xmkey;   ///< 消息类型
+        std::vector< x_subsptr_t > xsubers; ///< 订阅者对象（按订阅的先后顺序）
+    };
+
+    /** 订阅表的初始桶数 */
+    static constexpr size_t XBUCKETS_MIN = 16;
+
+private:
+    using x_hash_t  = typename x_msgctxt_t::xmsg_mkey_t::x_hash_t;
+    using x_equal_t = typename x_msgctxt_t::xmsg_mkey_t::x_equal_t;
+
+    /**
+     * @struct x_bucket_t
+     * @brief 桶（不可变对象）。
+     */
+    struct x_bucket_t
+    {
+        std::vector< const x_subset_t * > xsets; ///< 哈希到该桶的订阅者集合
+    };
+
+    /**
+     * @struct x_table_t
+     * @brief 订阅表（桶数组）。
+     */
+    struct x_table_t
+    {
+        using x_slot_t = std::atomic< const x_bucket_t * >;
+
+        size_t                         xmask;    ///< 桶数 - 1
+        std::unique_ptr< x_slot_t[] >  xbuckets; ///< 桶数组
+
+        explicit x_table_t(size_t xcount)
+            : xmask(xcount - 1)
+            , xbuckets(new x_slot_t[xcount])
+        {
+            for (size_t xiter = 0; xiter < xcount; ++xiter)
+            {
+                xbuckets[xiter].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // constructor/destructor
+public:
+    xmsg_cow_registry_t(void)
+        : m_xtable(new x_table_t(XBUCKETS_MIN))
+        , m_xkeys(0)
+    {
+
+    }
+
+    ~xmsg_cow_registry_t(void)
+    {
+        const x_table_t * xtable = m_xtable.load(std::memory_order_relaxed);
+        for (size_t xiter = 0; xiter <= xtable->xmask; ++xiter)
+        {
+            const x_bucket_t * xbucket = xtable->xbuckets[xiter].load(std::memory_order_relaxed);
+            if (nullptr == xbucket)
+            {
+                continue;
+            }
+
+            for (const x_subset_t * xsub_set : xbucket->xsets)
+            {
+                delete xsub_set;
+            }
+            delete xbucket;
+        }
+
+        delete xtable;
+    }
+
+    xmsg_cow_registry_t(xmsg_cow_registry_t && xobject) = delete;
+    xmsg_cow_registry_t & operator=(xmsg_cow_registry_t && xobject) = delete;
+    xmsg_cow_registry_t(const xmsg_cow_registry_t & xobject) = delete;
+    xmsg_cow_registry_t & operator=(const xmsg_cow_registry_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 回收旧对象的 xmsg_epoch_t（用于构造读临界区 x_guard_t）。
+     */
+    inline xmsg_epoch_t & epoch(void) { return m_xepoch; }
+
+    /**********************************************************/
+    /**
+     * @brief 查找 xmkey 的订阅者集合（须在 x_guard_t 的作用域内调用）。
+     * @return const x_subset_t * : 没有订阅者时，返回 nullptr 。
+     */
+    const x_subset_t * find(const x_mkey_t & xmkey) const
+    {
+        const x_table_t * xtable = m_xtable.load(std::memory_order_acquire);
+        const x_bucket_t * xbucket =
+            xtable->xbuckets[m_xhash(xmkey) & xtable->xmask].load(std::memory_order_acquire);
+        if (nullptr == xbucket)
+        {
+            return nullptr;
+        }
+
+        for (const x_subset_t * xsub_set : xbucket->xsets)
+        {
+            if (m_xequal(xsub_set->xmkey, xmkey))
+            {
+                return xsub_set;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 加入订阅者对象；若其已在 xmkey 的订阅者集合中，则返回 false 。
+     */
+    bool insert(const x_mkey_t & xmkey, const x_subsptr_t & xsub_sptr)
+    {
+        assert(nullptr != xsub_sptr);
+
+        std::lock_guard< std::mutex > xlock(m_xwriter);
+
+        std::unique_ptr< x_subset_t > xsub_set(new x_subset_t);
+        const x_subset_t * xold_set = find(xmkey);
+        if (nullptr != xold_set)
+        {
+            for (const x_subsptr_t & xsuber : xold_set->xsubers)
+            {
+                if (xsuber.get() == xsub_sptr.get())
+                {
+                    return false;
+                }
+            }
+
+            *xsub_set = *xold_set;
+        }
+        else
+        {
+            xsub_set->xmkey = xmkey;
+        }
+
+        xsub_set->xsubers.push_back(xsub_sptr);
+        replace(xmkey, xold_set, xsub_set.release());
+        return true;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 从 xmkey 的订阅者集合中移除订阅者对象；若其不存在，则返回 false 。
+     */
+    bool erase(const x_mkey_t & xmkey, const x_subscriber_t * xsub_ptr)
+    {
+        std::lock_guard< std::mutex > xlock(m_xwriter);
+
+        const x_subset_t * xold_set = find(xmkey);
+        if (nullptr == xold_set)
+        {
+            return false;
+        }
+
+        std::unique_ptr< x_subset_t > xsub_set(new x_subset_t);
+        xsub_set->xmkey = xmkey;
+        for (const x_subsptr_t & xsuber : xold_set->xsubers)
+        {
+            if (xsuber.get() != xsub_ptr)
+            {
+                xsub_set->xsubers.push_back(xsuber);
+            }
+        }
+
+        if (xsub_set->xsubers.size() == xold_set->xsubers.size())
+        {
+            return false;
+        }
+
+        replace(xmkey, xold_set, xsub_set->xsubers.empty() ? nullptr : xsub_set.release());
+        return true;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 移除 xmkey 的所有订阅者对象；若其没有订阅者，则返回 false 。
+     */
+    bool erase(const x_mkey_t & xmkey)
+    {
+        std::lock_guard< std::mutex > xlock(m_xwriter);
+
+        const x_subset_t * xold_set = find(xmkey);
+        if (nullptr == xold_set)
+        {
+            return false;
+        }
+
+        replace(xmkey, xold_set, nullptr);
+        return true;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 等待当前所有活动的读者离开，并释放所有的旧对象。
+     * @note
+     * 1. 不能在读临界区内（如 订阅者的消息处理接口中）调用；
+     * 2. 等待读者期间不持有写锁：读者（如 订阅者的消息处理接口）
+     *    仍可在此期间订阅/取消订阅，不会与本接口相互等待。
+     */
+    void synchronize(void)
+    {
+        uint64_t xepoch = 0;
+        {
+            std::lock_guard< std::mutex > xlock(m_xwriter);
+            xepoch = m_xepoch.advance();
+        }
+
+        m_xepoch.wait(xepoch);
+
+        std::lock_guard< std::mutex > xlock(m_xwriter);
+        m_xepoch.reclaim();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 有订阅者的消息类型数量。
+     */
+    inline size_t keys(void) const { return m_xkeys.load(std::memory_order_relaxed); }
+
+    /**********************************************************/
+    /**
+     * @brief 订阅表的桶数。
+     */
+    size_t buckets(void) const
+    {
+        x_guard_t xguard(m_xepoch);
+        return (m_xtable.load(std::memory_order_acquire)->xmask + 1);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 待回收的旧对象数量。
+     */
+    size_t retired(void) const
+    {
+        std::lock_guard< std::mutex > xlock(m_xwriter);
+        return m_xepoch.retired();
+    }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 以 xnew_set 替换 xmkey 的订阅者集合 xold_set（两者均可为 nullptr），
+     *        发布新的桶，并回收旧的桶与集合（须已持有 m_xwriter）。
+     */
+    void replace(const x_mkey_t & xmkey,
+                 const x_subset_t * xold_set,
+                 const x_subset_t * xnew_set)
+    {
+        const x_table_t * xtable = m_xtable.load(std::memory_order_relaxed);
+        std::atomic< const x_bucket_t * > & xslot =
+            xtable->xbuckets[m_xhash(xmkey) & xtable->xmask];
+        const x_bucket_t * xold_bucket = xslot.load(std::memory_order_relaxed);
+
+        x_bucket_t * xnew_bucket = new x_bucket_t;
+        if (nullptr != xold_bucket)
+        {
+            xnew_bucket->xsets.reserve(xold_bucket->xsets.size() + 1);
+            for (const x_subset_t * xsub_set : xold_bucket->xsets)
+            {
+                if (xsub_set != xold_set)
+                {
+                    xnew_bucket->xsets.push_back(xsub_set);
+                }
+            }
+        }
+
+        if (nullptr != xnew_set)
+        {
+            xnew_bucket->xsets.push_back(xnew_set);
+        }
+
+        if (xnew_bucket->xsets.empty())
+        {
+            delete xnew_bucket;
+            xnew_bucket = nullptr;
+        }
+
+        xslot.store(xnew_bucket, std::memory_order_release);
+
+        m_xepoch.retire(xold_bucket);
+        m_xepoch.retire(xold_set);
+
+        if ((nullptr == xold_set) && (nullptr != xnew_set))
+            m_xkeys.fetch_add(1, std::memory_order_relaxed);
+        else if ((nullptr != xold_set) && (nullptr == xnew_set))
+            m_xkeys.fetch_sub(1, std::memory_order_relaxed);
+
+        if (m_xkeys.load(std::memory_order_relaxed) > 2 * (xtable->xmask + 1))
+        {
+            grow(xtable);
+        }
+
+        m_xepoch.reclaim();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 发布桶数加倍的新表（订阅者集合 由新表的桶直接引用）。
+     */
+    void grow(const x_table_t * xold_table)
+    {
+        const size_t xcount = 2 * (xold_table->xmask + 1);
+        std::unique_ptr< x_table_t > xnew_table(new x_table_t(xcount));
+
+        std::vector< std::unique_ptr< x_bucket_t > > xnew_buckets(xcount);
+        for (size_t xiter = 0; xiter <= xold_table->xmask; ++xiter)
+        {
+            const x_bucket_t * xbucket = xold_table->xbuckets[xiter].load(std::memory_order_relaxed);
+            if (nullptr == xbucket)
+            {
+                continue;
+            }
+
+            for (const x_subset_t * xsub_set : xbucket->xsets)
+            {
+                std::unique_ptr< x_bucket_t > & xnew_bucket =
+                    xnew_buckets[m_xhash(xsub_set->xmkey) & (xcount - 1)];
+                if (nullptr == xnew_bucket)
+                {
+                    xnew_bucket.reset(new x_bucket_t);
+                }
+                xnew_bucket->xsets.push_back(xsub_set);
+            }
+        }
+
+        for (size_t xiter = 0; xiter < xcount; ++xiter)
+        {
+            xnew_table->xbuckets[xiter].store(xnew_buckets[xiter].release(),
+                                              std::memory_order_relaxed);
+        }
+
+        m_xtable.store(xnew_table.release(), std::memory_order_release);
+
+        for (size_t xiter = 0; xiter <= xold_table->xmask; ++xiter)
+        {
+            m_xepoch.retire(xold_table->xbuckets[xiter].load(std::memory_order_relaxed));
+        }
+        m_xepoch.retire(xold_table);
+    }
+
+    // data members
+private:
+    mutable xmsg_epoch_t             m_xepoch;  ///< 回收旧对象
+    std::atomic< const x_table_t * > m_xtable;  ///< 当前的订阅表
+    std::atomic< size_t >            m_xkeys;   ///< 有订阅者的消息类型数量
+    mutable std::mutex               m_xwriter; ///< 串行化写操作
+    x_hash_t                         m_xhash;   ///< 消息键的哈希函数
+    x_equal_t                        m_xequal;  ///< 消息键的比较函数
+};
+
+template< typename __msg_context_t >
+constexpr size_t xmsg_cow_registry_t< __msg_context_t >::XBUCKETS_MIN;
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_concurrent_publisher_t
+
+/**
+ * @class xmsg_concurrent_publisher_t< __msg_context_t, __msg_queue_t >
+ * @brief 支持在任意线程中 subscribe()/unsubscribe() 的发布者
+ *        （订阅表为 xmsg_cow_registry_t）。
+ * @note
+ * 1. 接口与 xmsg_publisher_t 保持一致（x_subkey_t 也相同），dispatch() 与
+ *    dispatch_batch() 只能在同一个投递线程中调用（与消息队列的要求一致）；
+ *    消息队列使用 xmsg_notify_queue_t 时，可由 xmsg_run_loop_t 驱动；
+ * 2. 投递线程每投递 XMSG_EPOCH_CHUNK 条消息，进入（离开）一次读临界区，
+ *    每条消息只读取订阅表的当前快照，不加锁；会话线程的订阅操作不会阻塞
+ *    投递线程，持续的消息负载也不会使旧版本的回收（synchronize()）无限推迟；
+ * 3. 订阅变更对之后投递的消息生效：正在投递的消息，仍按其读取的快照
+ *    投递完该快照中的所有订阅者（即使其间已被取消订阅）；
+ * 4. unsubscribe() 返回时，投递线程可能仍在调用该订阅者；用户自定义的
+ *    订阅者对象（不由发布者持有），须在 synchronize() 之后才能销毁；
+ * 5. 不支持 XMSG_ENABLE_STATS 的发布者统计 与 dispatch_parallel() 。
+ * 
+ * @param [in ] __msg_context_t : 消息类型（xmsg_context_t）。
+ * @param [in ] __msg_queue_t   : 消息队列（默认为 xmsg_mpsc_queue_t）。
+ */
+template< typename __msg_context_t,
+          typename __msg_queue_t = xmsg_mpsc_queue_t< __msg_context_t > >
+class xmsg_concurrent_publisher_t
+{
+    // common data types
+public:
+    using x_msgctxt_t    = __msg_context_t;
+    using x_msgqueue_t   = __msg_queue_t;
+    using x_mkey_t       = typename x_msgctxt_t::x_mkey_t;
+    using x_registry_t   = xmsg_cow_registry_t< x_msgctxt_t >;
+    using x_factory_t    = xmsg_publisher_t< x_msgctxt_t >;
+    using x_subscriber_t = typename x_factory_t::x_subscriber_t;
+    using x_subsptr_t    = typename x_factory_t::x_subsptr_t;
+    using x_subwptr_t    = typename x_factory_t::x_subwptr_t;
+    using x_subkey_t     = typename x_factory_t::x_subkey_t;
+
+private:
+    using x_subset_t       = typename x_registry_t::x_subset_t;
+    using x_guard_t        = typename x_registry_t::x_guard_t;
+    using x_queue_traits_t = xmsg_queue_traits_t< x_msgqueue_t >;
+    using x_msgbatch_t     = typename x_queue_traits_t::x_batch_t;
+
+    // constructor/destructor
+public:
+    xmsg_concurrent_publisher_t(void)
+    {
+
+    }
+
+    ~xmsg_concurrent_publisher_t(void)
+    {
+
+    }
+
+    xmsg_concurrent_publisher_t(xmsg_concurrent_publisher_t && xobject) = delete;
+    xmsg_concurrent_publisher_t & operator=(xmsg_concurrent_publisher_t && xobject) = delete;
+    xmsg_concurrent_publisher_t(const xmsg_concurrent_publisher_t & xobject) = delete;
+    xmsg_concurrent_publisher_t & operator=(const xmsg_concurrent_publisher_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 订阅者对象 订阅指定的消息类型（可在任意线程中调用）。
+     * @note 该接口用于 用户重载的订阅者类，订阅者对象由外部自行管理。
+     */
+    x_subkey_t subscribe(const x_mkey_t & xmkey, x_subscriber_t * xsub_ptr)
+    {
+        assert(nullptr != xsub_ptr);
+        assert(xsub_ptr->sub_type() < XSUBER_BASE_TYPE);
+
+        return subscribe_shared(xmkey, x_subsptr_t(xsub_ptr, [](x_subscriber_t *) { }));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 使用 “类似函数类型” 的订阅者 订阅指定的消息类型（可在任意线程中调用）。
+     */
+    template< typename __mfunc_t, typename... __args_t >
+    x_subkey_t subscribe(const x_mkey_t & xmkey,
+                         __mfunc_t && xfunc,
+                         __args_t &&... xargs)
+    {
+        return subscribe_shared(xmkey,
+                                x_factory_t::make_subscriber(
+                                    std::forward< __mfunc_t >(xfunc),
+                                    std::forward< __args_t >(xargs)...));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 以共享所有权的方式，订阅 已存在的订阅者对象（可在任意线程中调用）。
+     */
+    x_subkey_t subscribe_shared(const x_mkey_t & xmkey, const x_subsptr_t & xsub_sptr)
+    {
+        if (m_xregistry.insert(xmkey, xsub_sptr))
+        {
+            return x_subkey_t(xmkey, xsub_sptr);
+        }
+
+        return x_subkey_t();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 订阅者对象 取消订阅指定的消息类型（可在任意线程中调用）。
+     */
+    void unsubscribe(const x_mkey_t & xmkey, x_subscriber_t * xsub_ptr)
+    {
+        m_xregistry.erase(xmkey, xsub_ptr);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 订阅者对象 取消订阅指定的消息类型（可在任意线程中调用）。
+     * 
+     * @param [in ] xsub_key : 其为 subscribe() 返回的订阅者索引键。
+     */
+    void unsubscribe(const x_subkey_t & xsub_key)
+    {
+        x_subsptr_t xsub_sptr = xsub_key.xwptr.lock();
+        if (nullptr != xsub_sptr)
+        {
+            m_xregistry.erase(xsub_key.xmkey, xsub_sptr.get());
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 取消 xmkey 下所有的订阅者对象（可在任意线程中调用）。
+     */
+    void unsubscribe(const x_mkey_t & xmkey)
+    {
+        m_xregistry.erase(xmkey);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 等待投递线程读完 调用之前的订阅表快照，并释放所有的旧版本。
+     * @note
+     * 返回后，已取消订阅的 用户自定义订阅者对象 可以安全地销毁；
+     * 不能在订阅者的消息处理接口中调用。
+     */
+    void synchronize(void)
+    {
+        m_xregistry.synchronize();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief xmkey 的订阅者数量（可在任意线程中调用）。
+     */
+    size_t subscribers(const x_mkey_t & xmkey)
+    {
+        x_guard_t xguard(m_xregistry.epoch());
+        const x_subset_t * xsub_set = m_xregistry.find(xmkey);
+        return (nullptr != xsub_set) ? xsub_set->xsubers.size() : 0;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 返回订阅表（用于读取其统计信息）。
+     */
+    inline const x_registry_t & registry(void) const { return m_xregistry; }
+
+    /**********************************************************/
+    /**
+     * @brief 返回当前待投递的消息数量。
+     */
+    inline size_t size(void) const
+    {
+        return m_xmsg_queue.size();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 判断消息队列是否为空。
+     */
+    inline bool empty(void) const
+    {
+        return m_xmsg_queue.empty();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 返回消息队列（用于读取队列的统计信息）。
+     */
+    inline const x_msgqueue_t & msg_queue(void) const
+    {
+        return m_xmsg_queue;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 返回消息队列（用于 xmsg_run_loop_t 获取 xmsg_notify_queue_t 的事件对象）。
+     */
+    inline x_msgqueue_t & msg_queue(void)
+    {
+        return m_xmsg_queue;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 发布消息（将消息加入到消息队列）。
+     * @return bool : 消息是否已入队。
+     */
+    bool publish(const x_msgctxt_t & xmsg_ctxt)
+    {
+        return x_queue_traits_t::push(m_xmsg_queue, xmsg_ctxt);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 发布消息（将消息加入到消息队列）。
+     * @return bool : 消息是否已入队。
+     */
+    bool publish(x_msgctxt_t && xmsg_ctxt)
+    {
+        return x_queue_traits_t::push(m_xmsg_queue, std::forward< x_msgctxt_t >(xmsg_ctxt));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 发布消息（将消息加入到消息队列）。
+     * @return bool : 消息是否已入队。
+     */
+    template< typename... __args_t >
+    bool publish(const x_mkey_t & xmkey, __args_t &&... xargs)
+    {
+        static_assert(
+            xmsg_args_check_t< x_msgctxt_t, __args_t... >::value,
+            "Incorrect the number of arguments!");
+
+        return x_queue_traits_t::emplace(m_xmsg_queue,
+                                         xmkey,
+                                         std::forward< __args_t >(xargs)...);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 投递消息，结果返回投递的消息数量。
+     */
+    size_t dispatch(size_t xmsg_maxcount = (size_t)-1)
+    {
+        size_t xmsg_count = 0;
+        x_msgctxt_t xmsg_ctxt;
+
+        while (!empty() && (xmsg_count < xmsg_maxcount))
+        {
+            // 分块进入读临界区，使 synchronize() 可在块之间完成
+            x_guard_t xguard(m_xregistry.epoch());
+
+            const size_t xmsg_limit = xmsg_count + std::min< size_t >(
+                XMSG_EPOCH_CHUNK, xmsg_maxcount - xmsg_count);
+            while (!empty() && (xmsg_count < xmsg_limit))
+            {
+                xmsg_ctxt = std::move(m_xmsg_queue.front());
+                m_xmsg_queue.pop();
+
+                deliver_guarded(xmsg_ctxt);
+                xmsg_count += 1;
+            }
+        }
+
+        return xmsg_count;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 批量投递消息（先摘取整个队列，再逐个投递），结果返回投递的消息数量。
+     * @note 投递过程中新发布的消息，留待下一次调用时再投递。
+     */
+    size_t dispatch_batch(size_t xmsg_maxcount = (size_t)-1)
+    {
+        size_t xmsg_count = 0;
+        if ((0 == xmsg_maxcount) || empty())
+        {
+            return xmsg_count;
+        }
+
+        x_msgbatch_t xmsg_batch;
+        x_queue_traits_t::detach(m_xmsg_queue, xmsg_batch);
+
+        while (!xmsg_batch.empty() && (xmsg_count < xmsg_maxcount))
+        {
+            x_guard_t xguard(m_xregistry.epoch());
+
+            const size_t xmsg_limit = xmsg_count + std::min< size_t >(
+                XMSG_EPOCH_CHUNK, xmsg_maxcount - xmsg_count);
+            while (!xmsg_batch.empty() && (xmsg_count < xmsg_limit))
+            {
+                deliver_guarded(xmsg_batch.front());
+                xmsg_batch.pop();
+                xmsg_count += 1;
+            }
+        }
+
+        if (!xmsg_batch.empty())
+        {
+            x_queue_traits_t::restore(m_xmsg_queue, xmsg_batch);
+        }
+
+        return xmsg_count;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 不经过消息队列，直接将消息投递给其订阅者（须在投递线程中调用）。
+     */
+    void deliver(const x_msgctxt_t & xmsg_ctxt)
+    {
+        x_guard_t xguard(m_xregistry.epoch());
+        deliver_guarded(xmsg_ctxt);
+    }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 按订阅表的当前快照投递消息（须在读临界区内调用）。
+     */
+    inline void deliver_guarded(const x_msgctxt_t & xmsg_ctxt)
+    {
+        const x_subset_t * xsub_set = m_xregistry.find(xmsg_ctxt.mkey());
+        if (nullptr == xsub_set)
+        {
+            return;
+        }
+
+        for (const x_subsptr_t & xsuber : xsub_set->xsubers)
+        {
+            xsuber->invoke(xmsg_ctxt);
+        }
+    }
+
+    // data members
+private:
+    x_registry_t m_xregistry;  ///< 写时复制的订阅表
+    x_msgqueue_t m_xmsg_queue; ///< 消息队列
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __XMSG_CONCURRENT_PUBLISHER_H__
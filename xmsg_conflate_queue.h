@@ -0,0 +1,268 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file xmsg_conflate_queue.h
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * @author  ：Gaaagaa
+ * @date    : 2026-10-18
+ * @version : 1.0.0.0
+ * @brief   : 按消息键合并（只保留最新值）的消息队列。
+ */
+
+#ifndef __XMSG_CONFLATE_QUEUE_H__
+#define __XMSG_CONFLATE_QUEUE_H__
+
+#include "xmsg_pubsub.h"
+
+#include <deque>
+#include <cassert>
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_conflate_queue_t
+
+/**
+ * @class xmsg_conflate_queue_t< __msg_context_t, __index_t >
+ * @brief 按消息键合并（conflation）的消息队列：同一个 mkey() 的消息，
+ *        在队列中至多只有一个待投递的消息，新消息直接覆盖旧消息。
+ * @note
+ * 1. 接口与 std::queue 保持一致，可直接作为 xmsg_publisher_t 的
+ *    __msg_queue_t 模板参数使用（与 std::queue 一样，须在同一线程中操作）；
+ * 2. 发布消息时，若队列中已有相同 mkey() 的待投递消息，则原位覆盖该消息
+ *    （保持其在队列中的位置），否则追加到队尾；适用于只关心最新值的主题
+ *    （如 行情快照），突发发布时，订阅者的调用次数与队列的内存占用
+ *    都只与 mkey() 的数量相关；
+ * 3. 配合 xmsg_publisher_t::dispatch_batch() 使用时，每轮投递中
+ *    每个 mkey() 至多投递一个消息（投递过程中新发布的消息留待下一轮）；
+ * 4. 待投递消息的索引表 为 mkey() 到 消息序号 的映射表，
+ *    默认使用 xmsg_submap_auto_t（与 xmsg_publisher_t 的订阅者映射表一致）；
+ *    弹出消息时即删除其索引，索引表的大小始终等于待投递的消息数量。
+ * 
+ * @param [in ] __msg_context_t : 消息类型（xmsg_context_t）。
+ * @param [in ] __index_t       : 待投递消息的索引表类型。
+ */
+template< typename __msg_context_t,
+          template< typename, typename, typename, typename >
+                    class __index_t = xmsg_submap_auto_t >
+class xmsg_conflate_queue_t
+{
+    // common data types
+public:
+    typedef __msg_context_t         value_type;
+    typedef size_t                  size_type;
+    typedef __msg_context_t &       reference;
+    typedef const __msg_context_t & const_reference;
+
+private:
+    using x_mkey_t  = typename value_type::x_mkey_t;
+    using x_index_t = __index_t<
+                            x_mkey_t,
+                            size_type,
+                            typename value_type::xmsg_mkey_t::x_hash_t,
+                            typename value_type::xmsg_mkey_t::x_equal_t >;
+
+    /**
+     * @struct x_entry_t
+     * @brief 队列中的待投递消息。
+     */
+    struct x_entry_t
+    {
+        value_type       xvalue; ///< 消息对象
+        const x_mkey_t * xmkey;  ///< 索引表中的消息键（消息对象被移走后，仍可据此删除索引）
+    };
+
+    // constructor/destructor
+public:
+    xmsg_conflate_queue_t(void)
+        : m_xindex(new x_index_t())
+        , m_xfront(0)
+        , m_xmerges(0)
+    {
+
+    }
+
+    ~xmsg_conflate_queue_t(void)
+    {
+
+    }
+
+    xmsg_conflate_queue_t(xmsg_conflate_queue_t && xobject) = delete;
+    xmsg_conflate_queue_t & operator=(xmsg_conflate_queue_t && xobject) = delete;
+    xmsg_conflate_queue_t(const xmsg_conflate_queue_t & xobject) = delete;
+    xmsg_conflate_queue_t & operator=(const xmsg_conflate_queue_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 返回队列中待投递的消息数量（即 待投递的 mkey() 数量）。
+     */
+    inline size_type size(void) const
+    {
+        return m_xqueue.size();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 判断队列是否为空。
+     */
+    inline bool empty(void) const
+    {
+        return m_xqueue.empty();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 被合并（覆盖）掉的消息数量。
+     */
+    inline size_type merges(void) const
+    {
+        return m_xmerges;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将消息压入队列（相同 mkey() 的待投递消息将被覆盖）。
+     */
+    void push(const value_type & xvalue)
+    {
+        value_type * xpending = find_pending(xvalue.mkey());
+        if (nullptr != xpending)
+        {
+            *xpending = xvalue;
+            m_xmerges += 1;
+        }
+        else
+        {
+            push_back(xvalue);
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将消息压入队列（相同 mkey() 的待投递消息将被覆盖）。
+     */
+    void push(value_type && xvalue)
+    {
+        value_type * xpending = find_pending(xvalue.mkey());
+        if (nullptr != xpending)
+        {
+            *xpending = std::forward< value_type >(xvalue);
+            m_xmerges += 1;
+        }
+        else
+        {
+            push_back(std::forward< value_type >(xvalue));
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 构造消息并压入队列（相同 mkey() 的待投递消息将被覆盖）。
+     * @note 须先构造出消息对象，才能取得其 mkey() 进行查找。
+     */
+    template< typename... __args_t >
+    void emplace(__args_t &&... xargs)
+    {
+        push(value_type(std::forward< __args_t >(xargs)...));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 返回队首消息。
+     */
+    inline reference front(void)
+    {
+        return m_xqueue.front().xvalue;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 弹出队首消息，同时删除其索引。
+     * @note
+     * 队首消息通常已被移走（其 mkey() 可能已失效），
+     * 所以使用索引表中保存的消息键（元素的地址在其删除前保持不变）来删除索引。
+     */
+    void pop(void)
+    {
+        typename x_index_t::iterator itpos = m_xindex->find(*m_xqueue.front().xmkey);
+        assert(itpos != m_xindex->end());
+        m_xindex->erase(itpos);
+
+        m_xqueue.pop_front();
+        m_xfront += 1;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 与 xobject 交换队列内容（供 xmsg_publisher_t::dispatch_batch() 使用）。
+     */
+    void swap(xmsg_conflate_queue_t & xobject)
+    {
+        std::swap(m_xindex, xobject.m_xindex);
+        m_xqueue.swap(xobject.m_xqueue);
+        std::swap(m_xfront, xobject.m_xfront);
+    }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 查找 xmkey 的待投递消息，不存在时返回 nullptr 。
+     */
+    inline value_type * find_pending(const x_mkey_t & xmkey)
+    {
+        typename x_index_t::iterator itpos = m_xindex->find(xmkey);
+        if (itpos == m_xindex->end())
+        {
+            return nullptr;
+        }
+
+        return &m_xqueue[itpos->second - m_xfront].xvalue;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将消息追加到队尾，并记录其序号。
+     */
+    template< typename __value_t >
+    inline void push_back(__value_t && xvalue)
+    {
+        m_xqueue.push_back(x_entry_t{ std::forward< __value_t >(xvalue), nullptr });
+
+        x_entry_t & xentry = m_xqueue.back();
+        (*m_xindex)[xentry.xvalue.mkey()] = m_xfront + m_xqueue.size() - 1;
+        xentry.xmkey = &m_xindex->find(xentry.xvalue.mkey())->first;
+    }
+
+    // data members
+private:
+    std::unique_ptr< x_index_t > m_xindex;  ///< 待投递消息的索引表（mkey() 到 消息序号）
+    std::deque< x_entry_t >      m_xqueue;  ///< 待投递的消息队列
+    size_type                    m_xfront;  ///< 队首消息的序号
+    size_type                    m_xmerges; ///< 被合并（覆盖）掉的消息数量
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __XMSG_CONFLATE_QUEUE_H__
@@ -0,0 +1,478 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file xmsg_coro.h
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * @author  ：Gaaagaa
+ * @date    : 2026-10-18
+ * @version : 1.0.0.0
+ * @brief   : C++20 协程支持：协程形式的订阅者 与 可等待（co_await）的消息流。
+ */
+
+#ifndef __XMSG_CORO_H__
+#define __XMSG_CORO_H__
+
+#include "xmsg_pubsub.h"
+#include "xmsg_mpsc_queue.h"
+
+/**
+ * @brief 是否支持 C++20 协程（可在包含本文件之前预定义为 0 以禁用）。
+ */
+#ifndef XMSG_HAS_COROUTINE
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define XMSG_HAS_COROUTINE 1
+#endif // __has_include(<coroutine>)
+#endif // defined(__cpp_impl_coroutine) && defined(__has_include)
+#endif // XMSG_HAS_COROUTINE
+
+#ifndef XMSG_HAS_COROUTINE
+#define XMSG_HAS_COROUTINE 0
+#endif // XMSG_HAS_COROUTINE
+
+#if XMSG_HAS_COROUTINE
+
+#include <coroutine>
+#include <optional>
+#include <deque>
+#include <exception>
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_co_frame_t
+
+/**
+ * @struct xmsg_co_frame_t
+ * @brief 协程帧的内存分配：按大小取整后使用 xmsg_slab_pool_t 的内存块，
+ *        超过 XMSG_SLAB_MAX_SIZE 的协程帧直接从堆中分配。
+ * @note
+ * 协程形式的订阅者每处理一条消息都会创建一个协程帧，
+ * 使用内存池可避免每条消息一次堆分配。
+ */
+struct xmsg_co_frame_t
+{
+    /**********************************************************/
+    /**
+     * @brief 分配协程帧。
+     */
+    static void * alloc(size_t xsize)
+    {
+        if (xsize <= 128) return xmsg_slab_pool_t<  128 >::alloc();
+        if (xsize <= 256) return xmsg_slab_pool_t<  256 >::alloc();
+        if (xsize <= 512) return xmsg_slab_pool_t<  512 >::alloc();
+        if ((xsize <= 1024) && (xsize <= XMSG_SLAB_MAX_SIZE))
+            return xmsg_slab_pool_t< 1024 >::alloc();
+        return ::operator new(xsize);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 释放协程帧（xsize 与分配时的大小相同）。
+     */
+    static void free(void * xframe, size_t xsize)
+    {
+        if (xsize <= 128) return xmsg_slab_pool_t<  128 >::free(xframe);
+        if (xsize <= 256) return xmsg_slab_pool_t<  256 >::free(xframe);
+        if (xsize <= 512) return xmsg_slab_pool_t<  512 >::free(xframe);
+        if ((xsize <= 1024) && (xsize <= XMSG_SLAB_MAX_SIZE))
+            return xmsg_slab_pool_t< 1024 >::free(xframe);
+        ::operator delete(xframe);
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_co_task_t
+
+/**
+ * @class xmsg_co_task_t
+ * @brief 协程形式的消息处理接口的返回类型（即发即弃）。
+ * @note
+ * 1. 返回 xmsg_co_task_t 的 lambda/函数 可直接作为 subscribe() 的
+ *    消息处理接口：dispatch() 调用它时，协程立即执行，直至第一次挂起
+ *    （co_await）便返回，dispatch() 继续投递后续的消息；
+ *    协程执行完毕后，协程帧自动释放；
+ * 2. 协程的参数必须按值传递：dispatch() 传入的是消息参数的 const 引用，
+ *    挂起之后该引用即失效；同理，lambda 的捕获对象 随订阅者对象 一起销毁，
+ *    协程挂起期间取消订阅时，不能再访问其捕获对象；
+ * 3. 协程中未捕获的异常没有调用者可以接收，将调用 std::terminate()。
+ */
+class xmsg_co_task_t
+{
+    // common data types
+public:
+    /**
+     * @struct promise_type
+     * @brief 协程的承诺对象。
+     */
+    struct promise_type
+    {
+        xmsg_co_task_t get_return_object(void) noexcept { return xmsg_co_task_t(); }
+        std::suspend_never initial_suspend(void) noexcept { return {}; }
+        std::suspend_never final_suspend(void) noexcept { return {}; }
+        void return_void(void) noexcept { }
+        void unhandled_exception(void) noexcept { std::terminate(); }
+
+        static void * operator new(size_t xsize)
+        {
+            return xmsg_co_frame_t::alloc(xsize);
+        }
+
+        static void operator delete(void * xframe, size_t xsize)
+        {
+            xmsg_co_frame_t::free(xframe, xsize);
+        }
+    };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_co_executor_t
+
+/**
+ * @class xmsg_co_executor_t< __publisher_t >
+ * @brief 在发布者的投递线程中恢复（resume）协程的执行器。
+ * @note
+ * 1. 执行器包装了发布者的投递接口：dispatch()/dispatch_batch() 先恢复
+ *    已就绪的协程，再投递消息队列中的消息，两者都在调用投递接口的线程中
+ *    执行，协程的恢复不会额外切换线程；
+ * 2. post() 可在任意线程中调用（如 异步 I/O 的完成回调），
+ *    被恢复的协程则总是在投递线程中继续执行；
+ *    co_await schedule() 则让出投递线程，在下一次投递时继续执行；
+ * 3. 执行器提供了 xmsg_run_loop_t 所需的接口（empty()/msg_queue()/dispatch_batch()），
+ *    可直接作为 xmsg_run_loop_t 的模板参数：若消息队列为 xmsg_notify_queue_t，
+ *    post() 同时会唤醒阻塞等待中的投递循环；
+ * 4. 执行器销毁时，仍未恢复的协程将被销毁（不再执行）。
+ *
+ * @param [in ] __publisher_t : 发布者类型（xmsg_publisher_t）。
+ */
+template< typename __publisher_t >
+class xmsg_co_executor_t
+{
+    // common data types
+public:
+    using x_publisher_t = __publisher_t;
+    using x_msgqueue_t  = typename x_publisher_t::x_msgqueue_t;
+    using x_handle_t    = std::coroutine_handle<>;
+
+    /**
+     * @struct x_schedule_t
+     * @brief co_await schedule() 使用的等待对象。
+     */
+    struct x_schedule_t
+    {
+        xmsg_co_executor_t & xexec;
+
+        bool await_ready(void) const noexcept { return false; }
+        void await_suspend(x_handle_t xhandle) { xexec.post(xhandle); }
+        void await_resume(void) const noexcept { }
+    };
+
+private:
+    using x_readyq_t = xmsg_mpsc_queue_t< x_handle_t >;
+
+    // constructor/destructor
+public:
+    explicit xmsg_co_executor_t(x_publisher_t & xpublisher)
+        : m_xpublisher(xpublisher)
+    {
+
+    }
+
+    ~xmsg_co_executor_t(void)
+    {
+        while (!m_xready.empty())
+        {
+            x_handle_t xhandle = m_xready.front();
+            m_xready.pop();
+            xhandle.destroy();
+        }
+    }
+
+    xmsg_co_executor_t(xmsg_co_executor_t && xobject) = delete;
+    xmsg_co_executor_t & operator=(xmsg_co_executor_t && xobject) = delete;
+    xmsg_co_executor_t(const xmsg_co_executor_t & xobject) = delete;
+    xmsg_co_executor_t & operator=(const xmsg_co_executor_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 返回所包装的发布者。
+     */
+    inline x_publisher_t & publisher(void) { return m_xpublisher; }
+
+    /**********************************************************/
+    /**
+     * @brief 返回发布者的消息队列（供 xmsg_run_loop_t 使用）。
+     */
+    inline x_msgqueue_t & msg_queue(void) { return m_xpublisher.msg_queue(); }
+
+    /**********************************************************/
+    /**
+     * @brief 将挂起的协程加入就绪队列，由投递线程恢复执行（可在任意线程中调用）。
+     */
+    void post(x_handle_t xhandle)
+    {
+        m_xready.push(xhandle);
+
+        if constexpr (requires { m_xpublisher.msg_queue().event().notify(); })
+        {
+            m_xpublisher.msg_queue().event().notify();
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 返回 co_await 的等待对象：挂起当前协程，在下一次投递时恢复执行。
+     */
+    inline x_schedule_t schedule(void) { return x_schedule_t{ *this }; }
+
+    /**********************************************************/
+    /**
+     * @brief 就绪队列 与 消息队列 是否都为空（仅在投递线程中调用时结果才是准确的）。
+     */
+    inline bool empty(void) const
+    {
+        return (m_xready.empty() && m_xpublisher.empty());
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 恢复执行本次调用之前已就绪的协程，返回恢复的协程数量。
+     * @note 被恢复的协程若再次 post()/schedule()，则在下一次调用时恢复。
+     */
+    size_t resume(void)
+    {
+        if (m_xready.empty())
+        {
+            return 0;
+        }
+
+        x_readyq_t xbatch;
+        m_xready.detach(xbatch);
+
+        size_t xcount = 0;
+        while (!xbatch.empty())
+        {
+            x_handle_t xhandle = xbatch.front();
+            xbatch.pop();
+            xhandle.resume();
+            xcount += 1;
+        }
+
+        return xcount;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 恢复已就绪的协程，再执行发布者的 dispatch()；
+     *        返回恢复的协程数量 与 投递的消息数量 之和。
+     */
+    size_t dispatch(size_t xmsg_maxcount = (size_t)-1)
+    {
+        const size_t xcount = resume();
+        return xcount + m_xpublisher.dispatch(xmsg_maxcount);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 恢复已就绪的协程，再执行发布者的 dispatch_batch()；
+     *        返回恢复的协程数量 与 投递的消息数量 之和。
+     */
+    size_t dispatch_batch(size_t xmsg_maxcount = (size_t)-1)
+    {
+        const size_t xcount = resume();
+        return xcount + m_xpublisher.dispatch_batch(xmsg_maxcount);
+    }
+
+    // data members
+private:
+    x_publisher_t & m_xpublisher; ///< 发布者
+    x_readyq_t      m_xready;     ///< 已就绪（待恢复）的协程队列
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_co_stream_t
+
+/**
+ * @class xmsg_co_stream_t< __publisher_t >
+ * @brief 可等待（co_await）的消息流：由消费者协程逐条拉取指定消息类型的消息。
+ * @note
+ * 1. 构造时订阅 xmkey，之后投递的消息（参数元组的拷贝）缓存在消息流中；
+ *    co_await next_message() 返回 std::optional< x_args_t >，
+ *    消息流 close() 之后（且缓存已取完）返回 std::nullopt ；
+ * 2. 消费者协程在等待时，消息到达即在投递线程中（订阅者的消息处理接口内）
+ *    直接恢复执行，不经过任何队列，也不切换线程；消费者协程可在此时
+ *    结束并销毁消息流（与订阅者在消息处理接口中取消订阅的情况相同）；
+ * 3. 同一时刻只能有一个协程等待消息流；消息流只能在投递线程中使用，
+ *    且须在等待它的协程结束之后才能销毁。
+ *
+ * @param [in ] __publisher_t : 发布者类型（xmsg_publisher_t）。
+ */
+template< typename __publisher_t >
+class xmsg_co_stream_t
+{
+    // common data types
+public:
+    using x_publisher_t = __publisher_t;
+    using x_msgctxt_t   = typename x_publisher_t::x_msgctxt_t;
+    using x_mkey_t      = typename x_msgctxt_t::x_mkey_t;
+    using x_args_t      = typename x_msgctxt_t::x_args_t;
+    using x_subkey_t    = typename x_publisher_t::x_subkey_t;
+    using x_handle_t    = std::coroutine_handle<>;
+
+    /**
+     * @struct x_next_t
+     * @brief co_await next_message() 使用的等待对象。
+     */
+    struct x_next_t
+    {
+        xmsg_co_stream_t & xstream;
+
+        bool await_ready(void) const noexcept
+        {
+            return (!xstream.m_xbuffer.empty() || xstream.m_xclosed);
+        }
+
+        void await_suspend(x_handle_t xhandle) noexcept
+        {
+            assert(!xstream.m_xwaiter);
+            xstream.m_xwaiter = xhandle;
+        }
+
+        std::optional< x_args_t > await_resume(void)
+        {
+            if (xstream.m_xbuffer.empty())
+            {
+                return std::nullopt;
+            }
+
+            std::optional< x_args_t > xargs(std::move(xstream.m_xbuffer.front()));
+            xstream.m_xbuffer.pop_front();
+            return xargs;
+        }
+    };
+
+    // constructor/destructor
+public:
+    xmsg_co_stream_t(x_publisher_t & xpublisher, const x_mkey_t & xmkey)
+        : m_xpublisher(xpublisher)
+        , m_xmkey(xmkey)
+        , m_xclosed(false)
+    {
+        // 使用 “类似函数类型” 的订阅者（其生命期由发布者管理）：
+        // 等待中的协程在消息处理接口内恢复执行后，可能随即结束并销毁本消息流
+        m_xsubkey = m_xpublisher.subscribe(m_xmkey,
+            [this](const auto &... xargs)
+            {
+                m_xbuffer.emplace_back(xargs...);
+                wakeup();
+            });
+    }
+
+    ~xmsg_co_stream_t(void)
+    {
+        assert(!m_xwaiter);
+        if (!m_xclosed)
+        {
+            m_xpublisher.unsubscribe(m_xsubkey);
+        }
+    }
+
+    xmsg_co_stream_t(xmsg_co_stream_t && xobject) = delete;
+    xmsg_co_stream_t & operator=(xmsg_co_stream_t && xobject) = delete;
+    xmsg_co_stream_t(const xmsg_co_stream_t & xobject) = delete;
+    xmsg_co_stream_t & operator=(const xmsg_co_stream_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 返回 co_await 的等待对象：拉取下一条消息。
+     */
+    inline x_next_t next_message(void) { return x_next_t{ *this }; }
+
+    /**********************************************************/
+    /**
+     * @brief 取消订阅，并恢复等待中的协程（已缓存的消息仍可继续拉取）。
+     */
+    void close(void)
+    {
+        if (m_xclosed)
+        {
+            return;
+        }
+
+        m_xclosed = true;
+        m_xpublisher.unsubscribe(m_xsubkey);
+        wakeup();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 是否已 close()。
+     */
+    inline bool closed(void) const { return m_xclosed; }
+
+    /**********************************************************/
+    /**
+     * @brief 已缓存（尚未拉取）的消息数量。
+     */
+    inline size_t size(void) const { return m_xbuffer.size(); }
+
+    /**********************************************************/
+    /**
+     * @brief 消息流所订阅的消息类型。
+     */
+    inline const x_mkey_t & mkey(void) const { return m_xmkey; }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 恢复等待中的协程（若有）。
+     */
+    void wakeup(void)
+    {
+        if (m_xwaiter)
+        {
+            x_handle_t xhandle = m_xwaiter;
+            m_xwaiter = nullptr;
+            xhandle.resume();
+        }
+    }
+
+    // data members
+private:
+    x_publisher_t &        m_xpublisher; ///< 发布者
+    x_mkey_t               m_xmkey;      ///< 订阅的消息类型
+    x_subkey_t             m_xsubkey;    ///< 订阅的索引键
+    std::deque< x_args_t > m_xbuffer;    ///< 已缓存的消息
+    x_handle_t             m_xwaiter;    ///< 等待中的协程
+    bool                   m_xclosed;    ///< 是否已 close()
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // XMSG_HAS_COROUTINE
+
+#endif // __XMSG_CORO_H__
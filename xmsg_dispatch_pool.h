@@ -0,0 +1,283 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file xmsg_dispatch_pool.h
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * @author  ：Gaaagaa
+ * @date    : 2026-10-18
+ * @version : 1.0.0.0
+ * @brief   : 并行投递消息（xmsg_publisher_t::dispatch_parallel()）所使用的线程池。
+ */
+
+#ifndef __XMSG_DISPATCH_POOL_H__
+#define __XMSG_DISPATCH_POOL_H__
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <type_traits>
+#include <exception>
+#include <utility>
+#include <cstddef>
+#include <cassert>
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_dispatch_pool_t
+
+/**
+ * @class xmsg_dispatch_pool_t
+ * @brief 并行执行 “分区任务” 的固定线程池。
+ * @note
+ * 1. 每次 run() 调用执行一轮任务：将 [0, xcount) 范围内的分区下标
+ *    分发给各个工作线程（以及调用 run() 的线程自身），待全部分区
+ *    执行完成后 run() 才返回；
+ * 2. 各线程通过共享的原子计数器领取（窃取）下一个尚未执行的分区，
+ *    先完成的线程自动接手剩余的分区，从而平衡各线程的负载；
+ *    同一个分区只会由一个线程顺序执行；
+ * 3. run() 不可重入（不能在分区任务中再次调用 run()），
+ *    且同一时刻只能由一个线程调用；
+ * 4. 分区任务抛出异常时，各线程停止领取新的分区，run() 等待所有线程
+ *    结束当前轮次后，重新抛出（第一个）异常。
+ */
+class xmsg_dispatch_pool_t
+{
+    // common data types
+private:
+    /** 分区任务的调用接口类型 */
+    using x_task_t = void (*)(void *, size_t);
+
+    // constructor/destructor
+public:
+    /**
+     * @brief 构造函数。
+     * 
+     * @param [in ] xthreads : 参与执行的线程数量（包括调用 run() 的线程），
+     *                         为 0 时，取 std::thread::hardware_concurrency()。
+     */
+    explicit xmsg_dispatch_pool_t(size_t xthreads = 0)
+        : m_xstop(false)
+        , m_xround(0)
+        , m_xbusy(0)
+        , m_xtask(nullptr)
+        , m_xtask_ctx(nullptr)
+        , m_xtask_count(0)
+        , m_xnext(0)
+    {
+        if (0 == xthreads)
+        {
+            xthreads = std::thread::hardware_concurrency();
+        }
+
+        for (size_t xiter = 1; xiter < xthreads; ++xiter)
+        {
+            m_xworkers.push_back(std::thread(&xmsg_dispatch_pool_t::work_loop, this));
+        }
+    }
+
+    ~xmsg_dispatch_pool_t(void)
+    {
+        {
+            std::lock_guard< std::mutex > xlock(m_xmutex);
+            m_xstop = true;
+        }
+
+        m_xcond_work.notify_all();
+
+        for (std::thread & xthread : m_xworkers)
+        {
+            xthread.join();
+        }
+    }
+
+    xmsg_dispatch_pool_t(xmsg_dispatch_pool_t && xobject) = delete;
+    xmsg_dispatch_pool_t & operator=(xmsg_dispatch_pool_t && xobject) = delete;
+    xmsg_dispatch_pool_t(const xmsg_dispatch_pool_t & xobject) = delete;
+    xmsg_dispatch_pool_t & operator=(const xmsg_dispatch_pool_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 参与执行分区任务的线程数量（包括调用 run() 的线程）。
+     */
+    inline size_t size(void) const
+    {
+        return (m_xworkers.size() + 1);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 并行执行一轮分区任务：对 [0, xcount) 中的每个下标 i，
+     *        调用一次 xfunc(i) ，全部完成后返回。
+     */
+    template< typename __func_t >
+    void run(size_t xcount, __func_t && xfunc)
+    {
+        using x_func_t = typename std::remove_reference< __func_t >::type;
+
+        if (m_xworkers.empty() || (xcount <= 1))
+        {
+            for (size_t xiter = 0; xiter < xcount; ++xiter)
+            {
+                xfunc(xiter);
+            }
+
+            return;
+        }
+
+        {
+            std::lock_guard< std::mutex > xlock(m_xmutex);
+            assert(0 == m_xbusy);
+
+            m_xtask       = &task_thunk< x_func_t >;
+            m_xtask_ctx   = const_cast< void * >(
+                                static_cast< const void * >(&xfunc));
+            m_xtask_count = xcount;
+            m_xnext.store(0, std::memory_order_relaxed);
+            m_xbusy       = m_xworkers.size();
+            m_xround     += 1;
+        }
+
+        m_xcond_work.notify_all();
+
+        // 调用线程同样参与执行分区任务
+        execute();
+
+        std::exception_ptr xerror;
+        {
+            std::unique_lock< std::mutex > xlock(m_xmutex);
+            m_xcond_done.wait(xlock, [this](void) { return (0 == m_xbusy); });
+
+            m_xtask     = nullptr;
+            m_xtask_ctx = nullptr;
+            std::swap(xerror, m_xerror);
+        }
+
+        if (xerror)
+        {
+            std::rethrow_exception(xerror);
+        }
+    }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 分区任务的调用接口（每个任务类型各自生成）。
+     */
+    template< typename __func_t >
+    static void task_thunk(void * xctx, size_t xindex)
+    {
+        (*static_cast< __func_t * >(xctx))(xindex);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 逐个领取当前轮次中尚未执行的分区，直至全部领取完毕。
+     * @note
+     * 分区任务抛出的异常在此捕获并保存（只保存第一个），
+     * 同时令剩余的分区不再被领取，由 run() 在轮次结束后重新抛出。
+     */
+    void execute(void)
+    {
+        try
+        {
+            size_t xindex = m_xnext.fetch_add(1, std::memory_order_relaxed);
+            while (xindex < m_xtask_count)
+            {
+                m_xtask(m_xtask_ctx, xindex);
+                xindex = m_xnext.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        catch (...)
+        {
+            m_xnext.store(m_xtask_count, std::memory_order_relaxed);
+
+            std::lock_guard< std::mutex > xlock(m_xmutex);
+            if (!m_xerror)
+            {
+                m_xerror = std::current_exception();
+            }
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 工作线程的执行流程。
+     */
+    void work_loop(void)
+    {
+        size_t xround = 0;
+
+        for (;;)
+        {
+            {
+                std::unique_lock< std::mutex > xlock(m_xmutex);
+                m_xcond_work.wait(xlock,
+                    [this, xround](void)
+                    {
+                        return (m_xstop || (xround != m_xround));
+                    });
+
+                if (m_xstop)
+                {
+                    break;
+                }
+
+                xround = m_xround;
+            }
+
+            execute();
+
+            {
+                std::lock_guard< std::mutex > xlock(m_xmutex);
+                if (0 == --m_xbusy)
+                {
+                    m_xcond_done.notify_one();
+                }
+            }
+        }
+    }
+
+    // data members
+private:
+    std::vector< std::thread > m_xworkers;    ///< 工作线程
+    std::mutex                 m_xmutex;      ///< 同步 轮次状态 的互斥锁
+    std::condition_variable    m_xcond_work;  ///< 通知工作线程开始新的轮次
+    std::condition_variable    m_xcond_done;  ///< 通知调用线程当前轮次已完成
+    bool                       m_xstop;       ///< 线程池是否停止
+    size_t                     m_xround;      ///< 当前的轮次编号
+    size_t                     m_xbusy;       ///< 当前轮次中尚未完成的工作线程数量
+    x_task_t                   m_xtask;       ///< 当前轮次的分区任务
+    void                     * m_xtask_ctx;   ///< 当前轮次的分区任务对象
+    size_t                     m_xtask_count; ///< 当前轮次的分区数量
+    std::atomic< size_t >      m_xnext;       ///< 下一个待领取的分区下标
+    std::exception_ptr         m_xerror;      ///< 当前轮次中分区任务抛出的（第一个）异常
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __XMSG_DISPATCH_POOL_H__
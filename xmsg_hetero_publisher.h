@@ -0,0 +1,715 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file xmsg_hetero_publisher.h
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * @author  ：Gaaagaa
+ * @date    : 2026-10-18
+ * @version : 1.0.0.0
+ * @brief   : 支持多种消息参数类型（每个静态主题各自的参数类型）的发布者。
+ */
+
+#ifndef __XMSG_HETERO_PUBLISHER_H__
+#define __XMSG_HETERO_PUBLISHER_H__
+
+#include "xmsg_pubsub.h"
+
+#include <list>
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_byte_queue_t
+
+/**
+ * @brief xmsg_byte_queue_t 默认的内存块大小。
+ */
+#ifndef XMSG_BYTE_QUEUE_CHUNK
+#define XMSG_BYTE_QUEUE_CHUNK (64 * 1024)
+#endif // XMSG_BYTE_QUEUE_CHUNK
+
+/**
+ * @class xmsg_byte_queue_t< __chunk_size >
+ * @brief 以连续字节流存储 不同类型对象 的 FIFO 队列（每条记录带有类型标签）。
+ * @note
+ * 1. 每条记录由 8 字节的记录头（记录长度、类型标签、对象偏移）与 对象本身 组成，
+ *    依次紧密存放在内存块中（按 8 字节 以及 对象的对齐要求 对齐）；
+ *    内存块写满后，链接新的内存块，记录不会跨越内存块存放；
+ * 2. 对象直接在记录中构造（emplace），队列只管理内存，
+ *    对象的析构由使用者按类型标签执行（在 pop() 之前）；
+ * 3. 读取完毕的内存块回收到空闲链表中重复使用；队列清空时，
+ *    直接复位当前的内存块（不切换内存块，缓存更友好）；
+ *    超过 __chunk_size 的记录单独分配内存块，读取完毕后即释放；
+ * 4. 非线程安全：emplace() 与 front()/pop() 须在同一个线程中调用
+ *    （或由外部同步）。
+ * 
+ * @param [in ] __chunk_size : 内存块的大小。
+ */
+template< size_t __chunk_size = XMSG_BYTE_QUEUE_CHUNK >
+class xmsg_byte_queue_t
+{
+    // common data types
+public:
+    /**
+     * @struct x_record_t
+     * @brief 记录头。
+     */
+    struct x_record_t
+    {
+        uint32_t xsize;   ///< 记录的总长度（含记录头 与 对齐填充）
+        uint16_t xtag;    ///< 类型标签
+        uint16_t xoffset; ///< 对象相对于记录头的偏移
+    };
+
+    /** 内存块的大小 */
+    static constexpr size_t XCHUNK_SIZE = __chunk_size;
+
+    /** 记录的对齐大小 */
+    static constexpr size_t XALIGN = alignof(uint64_t);
+
+private:
+    /**
+     * @struct x_chunk_t
+     * @brief 内存块（块头之后即为数据区）。
+     */
+    struct x_chunk_t
+    {
+        x_chunk_t * xnext;     ///< 下一个内存块
+        size_t      xcapacity; ///< 数据区的容量
+        size_t      xused;     ///< 数据区已写入的字节数
+
+        inline char * data(void)
+        {
+            return reinterpret_cast< char * >(this) + XHEAD_SIZE;
+        }
+    };
+
+    /** 内存块的块头大小（按 std::max_align_t 对齐，保证数据区的对齐） */
+    static constexpr size_t XHEAD_SIZE =
+        (sizeof(x_chunk_t) + alignof(std::max_align_t) - 1) /
+            alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    static_assert(sizeof(x_record_t) == XALIGN, "sizeof(x_record_t) == XALIGN");
+
+    // constructor/destructor
+public:
+    xmsg_byte_queue_t(void)
+        : m_xhead(nullptr)
+        , m_xtail(nullptr)
+        , m_xfree(nullptr)
+        , m_xread(0)
+        , m_xcount(0)
+        , m_xchunks(0)
+    {
+
+    }
+
+    /**
+     * @brief 释放所有的内存块（仍在队列中的对象须已由使用者析构）。
+     */
+    ~xmsg_byte_queue_t(void)
+    {
+        free_list(m_xhead);
+        free_list(m_xfree);
+    }
+
+    xmsg_byte_queue_t(xmsg_byte_queue_t && xobject) = delete;
+    xmsg_byte_queue_t & operator=(xmsg_byte_queue_t && xobject) = delete;
+    xmsg_byte_queue_t(const xmsg_byte_queue_t & xobject) = delete;
+    xmsg_byte_queue_t & operator=(const xmsg_byte_queue_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 队列中的记录数量。
+     */
+    inline size_t size(void) const { return m_xcount; }
+
+    /**********************************************************/
+    /**
+     * @brief 判断队列是否为空。
+     */
+    inline bool empty(void) const { return (0 == m_xcount); }
+
+    /**********************************************************/
+    /**
+     * @brief 当前从堆中分配（未释放）的内存块数量（含空闲链表中的）。
+     */
+    inline size_t chunks(void) const { return m_xchunks; }
+
+    /**********************************************************/
+    /**
+     * @brief 在队尾追加一条类型标签为 xtag 的记录，并在其中构造 __object_t 对象。
+     * @note 对象的构造函数抛出异常时，队列保持不变。
+     */
+    template< typename __object_t, typename... __args_t >
+    __object_t * emplace(uint16_t xtag, __args_t &&... xargs)
+    {
+        static_assert(alignof(__object_t) <= alignof(std::max_align_t),
+                      "Over-aligned types are not supported!");
+
+        size_t xoffset = 0;
+        size_t xsize   = 0;
+        char * xrecord = reserve(sizeof(__object_t), alignof(__object_t), xoffset, xsize);
+
+        __object_t * xobject =
+            new (xrecord + xoffset) __object_t(std::forward< __args_t >(xargs)...);
+
+        x_record_t * xheader = reinterpret_cast< x_record_t * >(xrecord);
+        xheader->xsize   = static_cast< uint32_t >(xsize);
+        xheader->xtag    = xtag;
+        xheader->xoffset = static_cast< uint16_t >(xoffset);
+
+        m_xtail->xused += xsize;
+        m_xcount       += 1;
+
+        return xobject;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 返回队首的记录（队列不为空）。
+     */
+    x_record_t * front(void)
+    {
+        assert(!empty());
+
+        while (m_xread == m_xhead->xused)
+        {
+            x_chunk_t * xchunk = m_xhead;
+            m_xhead = xchunk->xnext;
+            m_xread = 0;
+            recycle(xchunk);
+        }
+
+        return reinterpret_cast< x_record_t * >(m_xhead->data() + m_xread);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 弹出队首的记录（其中的对象须已由使用者析构）。
+     */
+    void pop(void)
+    {
+        x_record_t * xrecord = front();
+
+        m_xread  += xrecord->xsize;
+        m_xcount -= 1;
+
+        if ((0 == m_xcount) && (m_xhead == m_xtail))
+        {
+            m_xhead->xused = 0;
+            m_xread = 0;
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 返回记录中的对象。
+     */
+    static inline void * object(x_record_t * xrecord)
+    {
+        return reinterpret_cast< char * >(xrecord) + xrecord->xoffset;
+    }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 在队尾预留一条记录的存储空间（尚未提交）。
+     * 
+     * @param [in ] xobject_size  : 对象的大小。
+     * @param [in ] xobject_align : 对象的对齐要求。
+     * @param [out] xoffset       : 对象相对于记录头的偏移。
+     * @param [out] xsize         : 记录的总长度。
+     * 
+     * @return char * : 记录头的地址。
+     */
+    char * reserve(size_t xobject_size, size_t xobject_align, size_t & xoffset, size_t & xsize)
+    {
+        xoffset = align_up(sizeof(x_record_t), xobject_align);
+        xsize   = align_up(xoffset + xobject_size, XALIGN);
+
+        // 记录的起始位置按 XALIGN 对齐，对象须按 xobject_align 对齐：
+        // 对象的对齐要求大于 XALIGN 时，记录头之前可能还需要填充
+        if ((nullptr != m_xtail) && (m_xtail->xcapacity - m_xtail->xused >= xsize))
+        {
+            char * xrecord = m_xtail->data() + m_xtail->xused;
+            const size_t xpad = pad_for(xrecord, xoffset, xobject_align);
+            if (m_xtail->xcapacity - m_xtail->xused >= xsize + xpad)
+            {
+                xoffset += xpad;
+                xsize   += xpad;
+                return xrecord;
+            }
+        }
+
+        assert(xsize + xobject_align <= UINT32_MAX);
+
+        x_chunk_t * xchunk = acquire((std::max)(XCHUNK_SIZE, xsize + xobject_align));
+        if (nullptr == m_xtail)
+        {
+            m_xhead = xchunk;
+        }
+        else
+        {
+            m_xtail->xnext = xchunk;
+        }
+        m_xtail = xchunk;
+
+        char * xrecord = xchunk->data();
+        const size_t xpad = pad_for(xrecord, xoffset, xobject_align);
+        xoffset += xpad;
+        xsize   += xpad;
+        return xrecord;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 对象须额外填充的字节数（使 xrecord + xoffset 按 xalign 对齐）。
+     */
+    static inline size_t pad_for(const char * xrecord, size_t xoffset, size_t xalign)
+    {
+        const size_t xaddr = reinterpret_cast< size_t >(xrecord) + xoffset;
+        return align_up(xaddr, xalign) - xaddr;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 按 xalign 向上取整。
+     */
+    static inline size_t align_up(size_t xvalue, size_t xalign)
+    {
+        return (xvalue + xalign - 1) / xalign * xalign;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 获取一个数据区容量至少为 xcapacity 的内存块。
+     */
+    x_chunk_t * acquire(size_t xcapacity)
+    {
+        x_chunk_t * xchunk = nullptr;
+        if ((XCHUNK_SIZE == xcapacity) && (nullptr != m_xfree))
+        {
+            xchunk  = m_xfree;
+            m_xfree = xchunk->xnext;
+        }
+        else
+        {
+            xchunk = static_cast< x_chunk_t * >(::operator new(XHEAD_SIZE + xcapacity));
+            xchunk->xcapacity = xcapacity;
+            m_xchunks += 1;
+        }
+
+        xchunk->xnext = nullptr;
+        xchunk->xused = 0;
+        return xchunk;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 回收读取完毕的内存块（超大的内存块直接释放）。
+     */
+    void recycle(x_chunk_t * xchunk)
+    {
+        if (XCHUNK_SIZE == xchunk->xcapacity)
+        {
+            xchunk->xnext = m_xfree;
+            m_xfree = xchunk;
+        }
+        else
+        {
+            ::operator delete(xchunk);
+            m_xchunks -= 1;
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 释放链表中的所有内存块。
+     */
+    void free_list(x_chunk_t * xchunk)
+    {
+        while (nullptr != xchunk)
+        {
+            x_chunk_t * xnext = xchunk->xnext;
+            ::operator delete(xchunk);
+            m_xchunks -= 1;
+            xchunk = xnext;
+        }
+    }
+
+    // data members
+private:
+    x_chunk_t * m_xhead;   ///< 读取端的内存块
+    x_chunk_t * m_xtail;   ///< 写入端的内存块
+    x_chunk_t * m_xfree;   ///< 空闲的内存块链表
+    size_t      m_xread;   ///< 读取端在其内存块中的偏移
+    size_t      m_xcount;  ///< 队列中的记录数量
+    size_t      m_xchunks; ///< 从堆中分配（未释放）的内存块数量
+};
+
+template< size_t __chunk_size >
+constexpr size_t xmsg_byte_queue_t< __chunk_size >::XCHUNK_SIZE;
+
+template< size_t __chunk_size >
+constexpr size_t xmsg_byte_queue_t< __chunk_size >::XALIGN;
+
+template< size_t __chunk_size >
+constexpr size_t xmsg_byte_queue_t< __chunk_size >::XHEAD_SIZE;
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_hetero_publisher_t
+
+/**
+ * @struct xmsg_topic_index_t< __topic_t, __topics_t... >
+ * @brief 主题 __topic_t 在主题列表 __topics_t... 中的索引号
+ *        （不在列表中时为 sizeof...(__topics_t)）。
+ */
+template< typename __topic_t, typename... __topics_t >
+struct xmsg_topic_index_t;
+
+template< typename __topic_t >
+struct xmsg_topic_index_t< __topic_t > : std::integral_constant< size_t, 0 >
+{
+};
+
+template< typename __topic_t, typename __first_t, typename... __rest_t >
+struct xmsg_topic_index_t< __topic_t, __first_t, __rest_t... >
+    : std::integral_constant< size_t,
+                std::is_same< __topic_t, __first_t >::value ?
+                    0 : 1 + xmsg_topic_index_t< __topic_t, __rest_t... >::value >
+{
+};
+
+/**
+ * @struct xmsg_topic_args_t< __topic_t >
+ * @brief 将主题的参数元组类型 转换为 xmsg_args_t 的参数列表声明。
+ */
+template< typename __args_t >
+struct xmsg_topic_args_of_t;
+
+template< typename... __args_t >
+struct xmsg_topic_args_of_t< std::tuple< __args_t... > >
+{
+    using type = xmsg_args_t< __args_t... >;
+};
+
+template< typename __topic_t >
+struct xmsg_topic_args_t : xmsg_topic_args_of_t< typename __topic_t::x_args_t >
+{
+};
+
+/**
+ * @class xmsg_hetero_publisher_t< __topics_t... >
+ * @brief 在同一个发布者中，发布/投递 参数类型各不相同的多个静态主题的消息。
+ * @note
+ * 1. 主题以 xmsg_topic_t 声明（其消息键值在此不使用），每个主题有各自的
+ *    参数类型，订阅者也只需与所订阅主题的参数类型匹配，均在编译期检查；
+ * 2. 所有主题的消息对象都直接构造在同一个 xmsg_byte_queue_t 字节流中
+ *    （记录的类型标签即为主题在 __topics_t... 中的索引号），发布时不会为
+ *    每条消息单独分配内存，也不需要 std::function/std::any 之类的类型擦除；
+ * 3. dispatch() 按全局的发布顺序投递所有主题的消息：按类型标签索引
+ *    编译期生成的函数表，以静态类型投递与析构消息对象；
+ * 4. 每个主题的订阅者由一个 xmsg_publisher_t 管理（registry< 主题 >()），
+ *    其订阅/取消订阅的规则（如 在消息处理接口中自我取消订阅）与之相同；
+ * 5. 非线程安全：publish() 与 dispatch() 须在同一个线程中调用
+ *    （消息处理接口中可以 publish()，但不能再调用 dispatch()）。
+ *
+ * @param [in ] __topics_t... : 主题列表（xmsg_topic_t 的派生类型）。
+ */
+template< typename... __topics_t >
+class xmsg_hetero_publisher_t
+{
+    static_assert(sizeof...(__topics_t) > 0, "At least one topic is required!");
+    static_assert(sizeof...(__topics_t) < 0xFFFF, "Too many topics!");
+
+    // common data types
+public:
+    /** 主题的数量 */
+    static constexpr size_t XTOPICS = sizeof...(__topics_t);
+
+    /**
+     * @struct x_topic_t< __topic_t >
+     * @brief 主题 __topic_t 的相关类型。
+     */
+    template< typename __topic_t >
+    struct x_topic_t
+    {
+        /** 主题在列表中的索引号（即消息记录的类型标签） */
+        static constexpr size_t XINDEX = xmsg_topic_index_t< __topic_t, __topics_t... >::value;
+
+        static_assert(XINDEX < XTOPICS, "The topic is not registered in the publisher!");
+
+        using x_msgctxt_t  = xmsg_context_t< xmsg_mkey_t< size_t >,
+                                             typename xmsg_topic_args_t< __topic_t >::type >;
+        using x_registry_t = xmsg_publisher_t< x_msgctxt_t,
+                                               std::queue< x_msgctxt_t, std::list< x_msgctxt_t > >,
+                                               xmsg_subset_flat_t,
+                                               xmsg_submap_static_t< 1 >::x_submap_t >;
+        using x_subkey_t   = typename x_registry_t::x_subkey_t;
+    };
+
+private:
+    using x_queue_t  = xmsg_byte_queue_t<>;
+    using x_record_t = typename x_queue_t::x_record_t;
+
+    /** 各个主题的订阅者管理对象 */
+    using x_registries_t = std::tuple< typename x_topic_t< __topics_t >::x_registry_t... >;
+
+    /** 订阅者管理对象中使用的消息键值（每个主题只有这一个键） */
+    static constexpr size_t XMKEY = 0;
+
+    /**
+     * @struct x_vtable_t
+     * @brief 按类型标签索引的函数表项：以静态类型 投递/析构 消息对象。
+     */
+    struct x_vtable_t
+    {
+        void (* xdeliver)(x_registries_t &, void *);
+        void (* xdestroy)(void *);
+    };
+
+    /**
+     * @struct x_release_t
+     * @brief 投递结束（包括消息处理接口抛出异常）时，析构并弹出队首的消息。
+     */
+    struct x_release_t
+    {
+        xmsg_hetero_publisher_t & xthis;
+        const x_vtable_t        & xentry;
+        void                    * xobject;
+
+        ~x_release_t(void)
+        {
+            xentry.xdestroy(xobject);
+            xthis.m_xqueue.pop();
+            xthis.m_xdispatching = false;
+        }
+    };
+
+    // constructor/destructor
+public:
+    xmsg_hetero_publisher_t(void)
+        : m_xdispatching(false)
+    {
+
+    }
+
+    ~xmsg_hetero_publisher_t(void)
+    {
+        const x_vtable_t * xvtable = vtable();
+        while (!m_xqueue.empty())
+        {
+            x_record_t * xrecord = m_xqueue.front();
+            xvtable[xrecord->xtag].xdestroy(x_queue_t::object(xrecord));
+            m_xqueue.pop();
+        }
+    }
+
+    xmsg_hetero_publisher_t(xmsg_hetero_publisher_t && xobject) = delete;
+    xmsg_hetero_publisher_t & operator=(xmsg_hetero_publisher_t && xobject) = delete;
+    xmsg_hetero_publisher_t(const xmsg_hetero_publisher_t & xobject) = delete;
+    xmsg_hetero_publisher_t & operator=(const xmsg_hetero_publisher_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 返回主题 __topic_t 的订阅者管理对象。
+     */
+    template< typename __topic_t >
+    inline typename x_topic_t< __topic_t >::x_registry_t & registry(void)
+    {
+        return std::get< x_topic_t< __topic_t >::XINDEX >(m_xregistries);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 使用 “类似函数类型” 的订阅者 订阅主题 __topic_t 。
+     * @note 消息处理接口的参数须与 __topic_t 的参数类型匹配。
+     */
+    template< typename __topic_t, typename __mfunc_t, typename... __args_t >
+    typename x_topic_t< __topic_t >::x_subkey_t
+        subscribe(__mfunc_t && xfunc, __args_t &&... xargs)
+    {
+        return registry< __topic_t >().subscribe(XMKEY,
+                                                 std::forward< __mfunc_t >(xfunc),
+                                                 std::forward< __args_t >(xargs)...);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 使用 subscribe< __topic_t >() 返回的 x_subkey_t 取消订阅。
+     */
+    template< typename __topic_t >
+    void unsubscribe(const typename x_topic_t< __topic_t >::x_subkey_t & xsub_key)
+    {
+        registry< __topic_t >().unsubscribe(xsub_key);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 取消主题 __topic_t 下所有的订阅者。
+     */
+    template< typename __topic_t >
+    void unsubscribe(void)
+    {
+        registry< __topic_t >().unsubscribe(XMKEY);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 发布主题 __topic_t 的消息（消息对象直接构造在字节流队列中）。
+     * @return bool : 消息是否已入队。
+     */
+    template< typename __topic_t, typename... __args_t >
+    bool publish(__args_t &&... xargs)
+    {
+        using x_msgctxt_t = typename x_topic_t< __topic_t >::x_msgctxt_t;
+
+        static_assert(
+            std::is_constructible< typename x_msgctxt_t::x_args_t, __args_t &&... >::value,
+            "The arguments do not match the parameters of the topic!");
+
+        m_xqueue.template emplace< x_msgctxt_t >(
+                    static_cast< uint16_t >(x_topic_t< __topic_t >::XINDEX),
+                    XMKEY,
+                    std::forward< __args_t >(xargs)...);
+        return true;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 判断消息队列是否为空。
+     */
+    inline bool empty(void) const { return m_xqueue.empty(); }
+
+    /**********************************************************/
+    /**
+     * @brief 返回当前待投递的消息数量。
+     */
+    inline size_t size(void) const { return m_xqueue.size(); }
+
+    /**********************************************************/
+    /**
+     * @brief 返回字节流队列（用于读取其内存块的统计信息）。
+     */
+    inline const x_queue_t & msg_queue(void) const { return m_xqueue; }
+
+    /**********************************************************/
+    /**
+     * @brief 按发布顺序投递所有主题的消息，结果返回投递的消息数量。
+     * @note 投递过程中（在消息处理接口中）新发布的消息，也在本次调用中投递。
+     */
+    size_t dispatch(size_t xmsg_maxcount = (size_t)-1)
+    {
+        assert(!m_xdispatching);
+
+        const x_vtable_t * xvtable = vtable();
+        size_t xmsg_count = 0;
+
+        while ((xmsg_count < xmsg_maxcount) && !m_xqueue.empty())
+        {
+            x_record_t * xrecord = m_xqueue.front();
+            void       * xobject = x_queue_t::object(xrecord);
+
+            m_xdispatching = true;
+            x_release_t xrelease{ *this, xvtable[xrecord->xtag], xobject };
+            xrelease.xentry.xdeliver(m_xregistries, xobject);
+
+            xmsg_count += 1;
+        }
+
+        return xmsg_count;
+    }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 将消息对象投递给 第 __index 个主题的订阅者。
+     */
+    template< size_t __index >
+    static void deliver_at(x_registries_t & xregistries, void * xobject)
+    {
+        using x_registry_t = typename std::tuple_element< __index, x_registries_t >::type;
+        using x_msgctxt_t  = typename x_registry_t::x_msgctxt_t;
+
+        std::get< __index >(xregistries).deliver(*static_cast< x_msgctxt_t * >(xobject));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 析构 第 __index 个主题的消息对象。
+     */
+    template< size_t __index >
+    static void destroy_at(void * xobject)
+    {
+        using x_registry_t = typename std::tuple_element< __index, x_registries_t >::type;
+        using x_msgctxt_t  = typename x_registry_t::x_msgctxt_t;
+
+        static_cast< x_msgctxt_t * >(xobject)->~x_msgctxt_t();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 按类型标签索引的函数表（编译期生成）。
+     */
+    static inline const x_vtable_t * vtable(void)
+    {
+        return vtable(typename xbuild_index_sequence_t< XTOPICS >::type());
+    }
+
+    template< size_t... __indexes >
+    static const x_vtable_t * vtable(xindex_sequence_t< __indexes... >)
+    {
+        static const x_vtable_t xvtable[] =
+        {
+            { &deliver_at< __indexes >, &destroy_at< __indexes > }...
+        };
+
+        return xvtable;
+    }
+
+    // data members
+private:
+    x_queue_t      m_xqueue;       ///< 所有主题共用的字节流消息队列
+    x_registries_t m_xregistries;  ///< 各个主题的订阅者管理对象
+    bool           m_xdispatching; ///< 是否正在投递（用于检查 dispatch() 的重入）
+};
+
+template< typename... __topics_t >
+constexpr size_t xmsg_hetero_publisher_t< __topics_t... >::XTOPICS;
+
+template< typename... __topics_t >
+constexpr size_t xmsg_hetero_publisher_t< __topics_t... >::XMKEY;
+
+template< typename... __topics_t >
+template< typename __topic_t >
+constexpr size_t xmsg_hetero_publisher_t< __topics_t... >::x_topic_t< __topic_t >::XINDEX;
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __XMSG_HETERO_PUBLISHER_H__
@@ -0,0 +1,946 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/**
+ * @file xmsg_journal.h
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * @author  ：Gaaagaa
+ * @date    : 2026-10-18
+ * @version : 1.0.0.0
+ * @brief   : 消息的持久化日志（只追加的内存映射分段文件），以及 迟到订阅者 的历史消息回放。
+ */
+
+#ifndef __XMSG_JOURNAL_H__
+#define __XMSG_JOURNAL_H__
+
+#if !defined(__linux__) && !defined(__unix__) && !defined(__APPLE__)
+#error "xmsg_journal.h requires a POSIX platform (mmap/msync)."
+#endif // POSIX
+
+#include "xmsg_pubsub.h"
+#include "xmsg_codec.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <unordered_map>
+#include <system_error>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <cerrno>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/** 日志分段文件的默认容量（字节数） */
+#ifndef XMSG_JOURNAL_SEGMENT
+#define XMSG_JOURNAL_SEGMENT (64 * 1024 * 1024)
+#endif // XMSG_JOURNAL_SEGMENT
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_journal_t
+
+/**
+ * @class xmsg_journal_t< __msg_context_t >
+ * @brief 只追加的消息日志：消息经 xmsg_codec_t 编码后，依次写入目录中的
+ *        内存映射分段文件，每条消息分配一个递增的偏移量（从 0 开始）。
+ * @note
+ * 1. 分段文件以其首条消息的偏移量命名（"%020llu.xjournal"），写满后创建新的分段；
+ *    每条日志项为 16 字节的项头（偏移量、记录字节数、校验值）+ 编码记录；
+ * 2. append() 只写入映射内存，commit() 以一次 msync(MS_SYNC) 将上次提交之后
+ *    追加的所有日志项落盘（组提交），committed() 之前的消息在进程崩溃 或
+ *    掉电后仍然完整；
+ * 3. open() 时依次扫描已有的分段文件并重建索引，遇到不完整 或 校验失败的日志项
+ *    即视为日志的末尾（之后的内容在后续写入时被覆盖）；
+ * 4. 内存中为每个消息键维护其日志项的位置（每条消息 16 字节），
+ *    replay(xmkey, ...) 只访问该消息键的日志项；
+ * 5. 非线程安全：append()/commit()/replay() 须在同一个线程中调用。
+ * 
+ * @param [in ] __msg_context_t : 消息类型（xmsg_context_t，须满足 xmsg_codec_t 的要求）。
+ */
+template< typename __msg_context_t >
+class xmsg_journal_t
+{
+    // common data types
+public:
+    using x_msgctxt_t = __msg_context_t;
+    using x_mkey_t    = typename x_msgctxt_t::x_mkey_t;
+    using x_codec_t   = xmsg_codec_t< x_msgctxt_t >;
+    using x_view_t    = typename x_codec_t::x_view_t;
+
+    /**
+     * @struct x_entry_t
+     * @brief 日志项的项头。
+     */
+    struct x_entry_t
+    {
+        uint64_t xoffset; ///< 消息的偏移量
+        uint32_t xsize;   ///< 编码记录的字节数
+        uint32_t xcheck;  ///< 编码记录的校验值
+    };
+
+    static_assert(sizeof(x_entry_t) == 16, "sizeof(x_entry_t) == 16");
+
+private:
+    /**
+     * @struct x_segment_t
+     * @brief 内存映射的分段文件。
+     */
+    struct x_segment_t
+    {
+        uint64_t xbase;     ///< 首条消息的偏移量
+        int      xfd;       ///< 文件描述符
+        char   * xaddr;     ///< 映射地址
+        size_t   xcapacity; ///< 映射的字节数
+        size_t   xused;     ///< 已写入的字节数
+    };
+
+    /**
+     * @struct x_locator_t
+     * @brief 日志项的位置（用于消息键的索引）。
+     */
+    struct x_locator_t
+    {
+        uint64_t xoffset;  ///< 消息的偏移量
+        uint32_t xsegment; ///< 所在分段的索引号
+        uint32_t xpos;     ///< 在分段中的字节位置
+    };
+
+    using x_locvec_t = std::vector< x_locator_t >;
+    using x_index_t  = std::unordered_map<
+                            x_mkey_t,
+                            x_locvec_t,
+                            typename x_msgctxt_t::xmsg_mkey_t::x_hash_t,
+                            typename x_msgctxt_t::xmsg_mkey_t::x_equal_t >;
+
+    // constructor/destructor
+public:
+    xmsg_journal_t(void)
+        : m_xsegment_size(XMSG_JOURNAL_SEGMENT)
+        , m_xnext(0)
+        , m_xcommitted(0)
+        , m_xsync_segment(0)
+        , m_xsync_pos(0)
+    {
+
+    }
+
+    ~xmsg_journal_t(void)
+    {
+        close();
+    }
+
+    xmsg_journal_t(xmsg_journal_t && xobject) = delete;
+    xmsg_journal_t & operator=(xmsg_journal_t && xobject) = delete;
+    xmsg_journal_t(const xmsg_journal_t & xobject) = delete;
+    xmsg_journal_t & operator=(const xmsg_journal_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 打开（不存在时创建）日志目录，并扫描已有的分段文件
+     *        （失败时抛出 std::system_error 异常）。
+     * 
+     * @param [in ] xdir     : 日志目录。
+     * @param [in ] xsegment : 新建分段文件的容量（字节数）。
+     */
+    void open(const std::string & xdir, size_t xsegment = XMSG_JOURNAL_SEGMENT)
+    {
+        close();
+
+        if ((0 != ::mkdir(xdir.c_str(), 0755)) && (EEXIST != errno))
+        {
+            throw std::system_error(errno, std::system_category(), "mkdir()");
+        }
+
+        m_xdir          = xdir;
+        m_xsegment_size = page_align(std::max< size_t >(xsegment, 4096));
+
+        std::vector< uint64_t > xbases = list_segments();
+        for (uint64_t xbase : xbases)
+        {
+            if (xbase != m_xnext)
+                break;
+
+            int xfd = ::open(segment_path(xbase).c_str(), O_RDWR | O_CLOEXEC);
+            if (xfd < 0)
+            {
+                int xerrno = errno;
+                close();
+                throw std::system_error(xerrno, std::system_category(), "open()");
+            }
+
+            struct stat xstat;
+            if ((0 != ::fstat(xfd, &xstat)) || (xstat.st_size < static_cast< off_t >(sizeof(x_entry_t))))
+            {
+                ::close(xfd);
+                break;
+            }
+
+            map_segment(xfd, xbase, static_cast< size_t >(xstat.st_size));
+            const size_t xsegment_count = m_xsegments.size();
+            scan_segment(xsegment_count - 1);
+
+            // 分段文件中没有完整的日志项：丢弃之（及其后的所有分段文件）
+            if (0 == m_xsegments.back().xused)
+            {
+                unmap_segment(m_xsegments.back());
+                m_xsegments.pop_back();
+                break;
+            }
+
+        }
+
+        // 删除未能接续的分段文件（位于日志末尾之后的残留数据）
+        for (uint64_t xbase : xbases)
+        {
+            if (m_xsegments.end() == std::find_if(m_xsegments.begin(), m_xsegments.end(),
+                                                  [xbase](const x_segment_t & xsegment)
+                                                  {
+                                                      return (xbase == xsegment.xbase);
+                                                  }))
+            {
+                ::unlink(segment_path(xbase).c_str());
+            }
+        }
+
+        m_xcommitted    = m_xnext;
+        m_xsync_segment = m_xsegments.empty() ? 0 : (m_xsegments.size() - 1);
+        m_xsync_pos     = m_xsegments.empty() ? 0 : m_xsegments.back().xused;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 提交已追加的日志项，并关闭所有的分段文件。
+     */
+    void close(void)
+    {
+        if (!m_xsegments.empty())
+        {
+            commit();
+        }
+
+        for (x_segment_t & xsegment : m_xsegments)
+        {
+            unmap_segment(xsegment);
+        }
+
+        m_xsegments.clear();
+        m_xindex.clear();
+        m_xdir.clear();
+        m_xnext         = 0;
+        m_xcommitted    = 0;
+        m_xsync_segment = 0;
+        m_xsync_pos     = 0;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 是否已打开日志目录。
+     */
+    inline bool is_open(void) const
+    {
+        return !m_xdir.empty();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 下一条追加消息的偏移量（即日志中的消息数量）。
+     */
+    inline uint64_t next_offset(void) const
+    {
+        return m_xnext;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 已提交（落盘）的消息的偏移量上界：[0, committed()) 已落盘。
+     */
+    inline uint64_t committed(void) const
+    {
+        return m_xcommitted;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 分段文件的数量。
+     */
+    inline size_t segments(void) const
+    {
+        return m_xsegments.size();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 消息键 xmkey 在日志中的消息数量。
+     */
+    size_t count(const x_mkey_t & xmkey) const
+    {
+        typename x_index_t::const_iterator xiter = m_xindex.find(xmkey);
+        return (xiter != m_xindex.end()) ? xiter->second.size() : 0;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 追加消息（只写入映射内存，须调用 commit() 落盘）。
+     * @note
+     * 编码记录超过 UINT32_MAX 字节（项头无法表示）时，
+     * 抛出 std::system_error 异常（EMSGSIZE），日志不变。
+     * 
+     * @return uint64_t : 消息的偏移量。
+     */
+    uint64_t append(const x_msgctxt_t & xmsg_ctxt)
+    {
+        assert(is_open());
+
+        const size_t xsize  = x_codec_t::encoded_size(xmsg_ctxt);
+        const size_t xbytes = sizeof(x_entry_t) + xsize;
+
+        if (xsize > UINT32_MAX)
+        {
+            throw std::system_error(EMSGSIZE, std::system_category(), "append()");
+        }
+
+        if (m_xsegments.empty() ||
+            (m_xsegments.back().xused + xbytes > m_xsegments.back().xcapacity))
+        {
+            create_segment(xbytes);
+        }
+
+        x_segment_t & xsegment = m_xsegments.back();
+        char * xdst = xsegment.xaddr + xsegment.xused;
+
+        const size_t xcoded = x_codec_t::encode(xdst + sizeof(x_entry_t), xsize, xmsg_ctxt);
+        assert(xcoded == xsize);
+        (void)xcoded;
+
+        x_entry_t xentry;
+        xentry.xoffset = m_xnext;
+        xentry.xsize   = static_cast< uint32_t >(xsize);
+        xentry.xcheck  = checksum(xdst + sizeof(x_entry_t), xsize, m_xnext);
+        std::memcpy(xdst, &xentry, sizeof(x_entry_t));
+
+        index_entry(xmsg_ctxt.mkey(), m_xsegments.size() - 1, xsegment.xused);
+        xsegment.xused += xbytes;
+        return m_xnext++;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 撤销最后追加的（尚未提交的）消息，xmkey 为该消息的消息键。
+     * @note
+     * 项头被改写为无效值，即便该页已被内核写回，open() 也不会再读到这条消息。
+     */
+    void revert(const x_mkey_t & xmkey)
+    {
+        assert(m_xnext > m_xcommitted);
+
+        typename x_index_t::iterator xiter = m_xindex.find(xmkey);
+        assert((xiter != m_xindex.end()) && (xiter->second.back().xoffset + 1 == m_xnext));
+
+        const x_locator_t xloc = xiter->second.back();
+        xiter->second.pop_back();
+        if (xiter->second.empty())
+        {
+            m_xindex.erase(xiter);
+        }
+
+        x_segment_t & xsegment = m_xsegments[xloc.xsegment];
+        std::memset(xsegment.xaddr + xloc.xpos, 0xFF, sizeof(x_entry_t));
+        xsegment.xused = xloc.xpos;
+        m_xnext -= 1;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 组提交：将上次提交之后追加的所有日志项落盘（msync）。
+     * 
+     * @return bool : 落盘操作是否成功。
+     */
+    bool commit(void)
+    {
+        if (m_xcommitted == m_xnext)
+        {
+            return true;
+        }
+
+        bool xok = true;
+        for (size_t xiter = m_xsync_segment; xiter < m_xsegments.size(); ++xiter)
+        {
+            const x_segment_t & xsegment = m_xsegments[xiter];
+            const size_t xbeg = (xiter == m_xsync_segment) ? (m_xsync_pos & ~(page_size() - 1)) : 0;
+            if (xsegment.xused > xbeg)
+            {
+                xok = (0 == ::msync(xsegment.xaddr + xbeg, xsegment.xused - xbeg, MS_SYNC)) && xok;
+            }
+        }
+
+        if (xok)
+        {
+            m_xsync_segment = m_xsegments.size() - 1;
+            m_xsync_pos     = m_xsegments.back().xused;
+            m_xcommitted    = m_xnext;
+        }
+
+        return xok;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 顺序回放偏移量位于 [xfrom, xto) 的所有消息。
+     * 
+     * @param [in ] xfunc : 消息的处理操作：bool xfunc(uint64_t xoffset, const x_view_t & xview) ，
+     *                      返回 false 时停止回放。
+     * 
+     * @return uint64_t : 最后回放的消息的下一个偏移量。
+     */
+    template< typename __func_t >
+    uint64_t replay(uint64_t xfrom, uint64_t xto, __func_t && xfunc) const
+    {
+        xto = std::min(xto, m_xnext);
+        if (xfrom >= xto)
+        {
+            return xfrom;
+        }
+
+        // 定位起始的分段文件
+        size_t xiter = 0;
+        while ((xiter + 1 < m_xsegments.size()) && (m_xsegments[xiter + 1].xbase <= xfrom))
+            ++xiter;
+
+        uint64_t xoffset = xfrom;
+        for (; xiter < m_xsegments.size(); ++xiter)
+        {
+            const x_segment_t & xsegment = m_xsegments[xiter];
+            size_t xpos = 0;
+            while ((xpos < xsegment.xused) && (xoffset < xto))
+            {
+                const x_entry_t * xentry = reinterpret_cast< const x_entry_t * >(xsegment.xaddr + xpos);
+                if (xentry->xoffset >= xfrom)
+                {
+                    if (!xfunc(xentry->xoffset, x_view_t(xentry + 1)))
+                        return xentry->xoffset;
+                    xoffset = xentry->xoffset + 1;
+                }
+
+                xpos += sizeof(x_entry_t) + xentry->xsize;
+            }
+
+            if (xoffset >= xto)
+                break;
+        }
+
+        return xoffset;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 回放消息键 xmkey 的、偏移量位于 [xfrom, xto) 的消息（按偏移量的顺序）。
+     * 
+     * @param [in ] xfunc : 消息的处理操作：bool xfunc(uint64_t xoffset, const x_view_t & xview) ，
+     *                      返回 false 时停止回放。
+     * 
+     * @return size_t : 回放的消息数量。
+     */
+    template< typename __func_t >
+    size_t replay(const x_mkey_t & xmkey, uint64_t xfrom, uint64_t xto, __func_t && xfunc) const
+    {
+        typename x_index_t::const_iterator xiter = m_xindex.find(xmkey);
+        if (xiter == m_xindex.end())
+        {
+            return 0;
+        }
+
+        // 按下标访问：回放过程中（如 处理操作中追加消息）索引数组可能扩容
+        const x_locvec_t & xlocvec = xiter->second;
+        size_t xindex = static_cast< size_t >(
+            std::lower_bound(xlocvec.begin(), xlocvec.end(), xfrom,
+                             [](const x_locator_t & xloc, uint64_t xvalue)
+                             {
+                                 return xloc.xoffset < xvalue;
+                             }) - xlocvec.begin());
+
+        size_t xcount = 0;
+        for (; xindex < xlocvec.size(); ++xindex)
+        {
+            const x_locator_t xloc = xlocvec[xindex];
+            if (xloc.xoffset >= xto)
+                break;
+
+            const x_entry_t * xentry = reinterpret_cast< const x_entry_t * >(
+                        m_xsegments[xloc.xsegment].xaddr + xloc.xpos);
+            if (!xfunc(xloc.xoffset, x_view_t(xentry + 1)))
+                break;
+            xcount += 1;
+        }
+
+        return xcount;
+    }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 编码记录的校验值（按 8 字节字计算，并混入消息的偏移量）。
+     */
+    static uint32_t checksum(const char * xdata, size_t xsize, uint64_t xoffset)
+    {
+        uint64_t xhash = 0x9E3779B97F4A7C15ULL ^ xoffset;
+        for (size_t xpos = 0; xpos < xsize; xpos += 8)
+        {
+            uint64_t xword;
+            std::memcpy(&xword, xdata + xpos, sizeof(xword));
+            xhash  = (xhash ^ xword) * 0x100000001B3ULL;
+            xhash ^= xhash >> 29;
+        }
+
+        return static_cast< uint32_t >(xhash ^ (xhash >> 32));
+    }
+
+    static inline size_t page_size(void)
+    {
+        static const size_t xpage_size = static_cast< size_t >(::sysconf(_SC_PAGESIZE));
+        return xpage_size;
+    }
+
+    static inline size_t page_align(size_t xsize)
+    {
+        return (xsize + page_size() - 1) & ~(page_size() - 1);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 偏移量为 xbase 的分段文件的路径。
+     */
+    std::string segment_path(uint64_t xbase) const
+    {
+        char xname[32];
+        std::snprintf(xname, sizeof(xname), "%020llu.xjournal",
+                      static_cast< unsigned long long >(xbase));
+        return m_xdir + "/" + xname;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 日志目录中所有分段文件的偏移量（升序）。
+     */
+    std::vector< uint64_t > list_segments(void) const
+    {
+        std::vector< uint64_t > xbases;
+
+        DIR * xdir = ::opendir(m_xdir.c_str());
+        if (nullptr == xdir)
+        {
+            throw std::system_error(errno, std::system_category(), "opendir()");
+        }
+
+        while (struct dirent * xent = ::readdir(xdir))
+        {
+            unsigned long long xbase = 0;
+            char xtail[16] = { 0 };
+            if ((2 == std::sscanf(xent->d_name, "%20llu.%15s", &xbase, xtail)) &&
+                (0 == std::strcmp(xtail, "xjournal")))
+            {
+                xbases.push_back(static_cast< uint64_t >(xbase));
+            }
+        }
+
+        ::closedir(xdir);
+        std::sort(xbases.begin(), xbases.end());
+        return xbases;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 映射分段文件（失败时关闭 xfd 并抛出 std::system_error 异常）。
+     */
+    void map_segment(int xfd, uint64_t xbase, size_t xcapacity)
+    {
+        void * xaddr = ::mmap(nullptr, xcapacity, PROT_READ | PROT_WRITE, MAP_SHARED, xfd, 0);
+        if (MAP_FAILED == xaddr)
+        {
+            int xerrno = errno;
+            ::close(xfd);
+            throw std::system_error(xerrno, std::system_category(), "mmap()");
+        }
+
+        x_segment_t xsegment;
+        xsegment.xbase     = xbase;
+        xsegment.xfd       = xfd;
+        xsegment.xaddr     = static_cast< char * >(xaddr);
+        xsegment.xcapacity = xcapacity;
+        xsegment.xused     = 0;
+        m_xsegments.push_back(xsegment);
+    }
+
+    static void unmap_segment(x_segment_t & xsegment)
+    {
+        ::munmap(xsegment.xaddr, xsegment.xcapacity);
+        ::close(xsegment.xfd);
+        xsegment.xaddr = nullptr;
+        xsegment.xfd   = -1;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 为文件预先分配 xcapacity 字节的磁盘空间（不是稀疏文件），
+     *        返回错误码（0 表示成功）。
+     * @note
+     * 若只是 ftruncate() 扩展文件长度，则磁盘空间不足时，
+     * 经由 mmap 的写入会触发 SIGBUS ，而不是返回错误。
+     */
+    static int allocate_file(int xfd, size_t xcapacity)
+    {
+#if defined(__APPLE__)
+        fstore_t xstore;
+        xstore.fst_flags      = F_ALLOCATEALL;
+        xstore.fst_posmode    = F_PEOFPOSMODE;
+        xstore.fst_offset     = 0;
+        xstore.fst_length     = static_cast< off_t >(xcapacity);
+        xstore.fst_bytesalloc = 0;
+        if (-1 == ::fcntl(xfd, F_PREALLOCATE, &xstore))
+        {
+            return errno;
+        }
+
+        return (0 == ::ftruncate(xfd, static_cast< off_t >(xcapacity))) ? 0 : errno;
+#else // !defined(__APPLE__)
+        // posix_fallocate() 直接返回错误码（不设置 errno）
+        return ::posix_fallocate(xfd, 0, static_cast< off_t >(xcapacity));
+#endif // defined(__APPLE__)
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将日志目录的目录项（新建的分段文件）写入磁盘，
+     *        返回错误码（0 表示成功）。
+     */
+    int sync_directory(void) const
+    {
+        int xfd = ::open(m_xdir.c_str(), O_RDONLY | O_CLOEXEC);
+        if (xfd < 0)
+        {
+            return errno;
+        }
+
+        int xerrno = (0 == ::fsync(xfd)) ? 0 : errno;
+        ::close(xfd);
+        return xerrno;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 创建新的分段文件（容量至少可容纳 xbytes 字节的日志项）。
+     */
+    void create_segment(size_t xbytes)
+    {
+        const size_t xcapacity = std::max(m_xsegment_size, page_align(xbytes));
+        const std::string xpath = segment_path(m_xnext);
+
+        int xfd = ::open(xpath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (xfd < 0)
+        {
+            throw std::system_error(errno, std::system_category(), "open()");
+        }
+
+        int xerrno = allocate_file(xfd, xcapacity);
+        if (0 != xerrno)
+        {
+            ::close(xfd);
+            ::unlink(xpath.c_str());
+            throw std::system_error(xerrno, std::system_category(), "posix_fallocate()");
+        }
+
+        // 新建的目录项须先落盘，否则掉电后已提交的日志项可能随文件一同丢失
+        xerrno = sync_directory();
+        if (0 != xerrno)
+        {
+            ::close(xfd);
+            ::unlink(xpath.c_str());
+            throw std::system_error(xerrno, std::system_category(), "fsync()");
+        }
+
+        map_segment(xfd, m_xnext, xcapacity);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 扫描已有的分段文件，重建索引（遇到无效的日志项即停止）。
+     */
+    void scan_segment(size_t xsegment_index)
+    {
+        x_segment_t & xsegment = m_xsegments[xsegment_index];
+        ::madvise(xsegment.xaddr, xsegment.xcapacity, MADV_SEQUENTIAL);
+
+        size_t xpos = 0;
+        while (xpos + sizeof(x_entry_t) <= xsegment.xcapacity)
+        {
+            const x_entry_t * xentry = reinterpret_cast< const x_entry_t * >(xsegment.xaddr + xpos);
+            const char      * xdata  = xsegment.xaddr + xpos + sizeof(x_entry_t);
+            const size_t      xavail = xsegment.xcapacity - xpos - sizeof(x_entry_t);
+
+            if ((xentry->xoffset != m_xnext) ||
+                (xentry->xsize > xavail) ||
+                (xentry->xsize != x_codec_t::verify(xdata, xentry->xsize)) ||
+                (xentry->xcheck != checksum(xdata, xentry->xsize, xentry->xoffset)))
+            {
+                break;
+            }
+
+            index_entry(x_codec_t::view(xdata).mkey(), xsegment_index, xpos);
+            xpos    += sizeof(x_entry_t) + xentry->xsize;
+            m_xnext += 1;
+        }
+
+        xsegment.xused = xpos;
+        ::madvise(xsegment.xaddr, xsegment.xcapacity, MADV_NORMAL);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将偏移量为 m_xnext 的日志项加入到消息键的索引中。
+     */
+    template< typename __mkey_view_t >
+    void index_entry(const __mkey_view_t & xmkey, size_t xsegment_index, size_t xpos)
+    {
+        x_locator_t xloc;
+        xloc.xoffset  = m_xnext;
+        xloc.xsegment = static_cast< uint32_t >(xsegment_index);
+        xloc.xpos     = static_cast< uint32_t >(xpos);
+        m_xindex[to_mkey(xmkey)].push_back(xloc);
+    }
+
+    static inline const x_mkey_t & to_mkey(const x_mkey_t & xmkey)
+    {
+        return xmkey;
+    }
+
+    template< typename __elem_t >
+    static inline x_mkey_t to_mkey(const xmsg_codec_span_t< __elem_t > & xspan)
+    {
+        return x_mkey_t(xspan.begin(), xspan.end());
+    }
+
+    // data members
+private:
+    std::string                m_xdir;          ///< 日志目录
+    size_t                     m_xsegment_size; ///< 新建分段文件的容量
+    std::vector< x_segment_t > m_xsegments;     ///< 分段文件列表（按偏移量升序）
+    x_index_t                  m_xindex;        ///< 消息键的索引
+    uint64_t                   m_xnext;         ///< 下一条追加消息的偏移量
+    uint64_t                   m_xcommitted;    ///< 已提交的消息的偏移量上界
+    size_t                     m_xsync_segment; ///< 未落盘数据所在的首个分段文件
+    size_t                     m_xsync_pos;     ///< 未落盘数据在该分段文件中的起始位置
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_journal_stage_t
+
+/**
+ * @class xmsg_journal_stage_t< __publisher_t >
+ * @brief 发布者的日志阶段：publish() 在消息入队的同时追加到日志，
+ *        dispatch() 在投递之前组提交日志；subscribe_from() 先向新的订阅者
+ *        回放历史消息，再由发布者继续投递实时消息（不重复、不遗漏）。
+ * @note
+ * 1. 须通过本对象发布消息，且发布者的消息队列须为 FIFO 队列
+ *    （用已入队未投递的消息数量确定 历史消息 与 实时消息 的分界）；
+ * 2. subscribe_from() 不能在 dispatch() 的消息处理接口中调用。
+ * 
+ * @param [in ] __publisher_t : 发布者类型（xmsg_publisher_t）。
+ */
+template< typename __publisher_t >
+class xmsg_journal_stage_t
+{
+    // common data types
+public:
+    using x_publisher_t = __publisher_t;
+    using x_msgctxt_t   = typename x_publisher_t::x_msgctxt_t;
+    using x_mkey_t      = typename x_publisher_t::x_mkey_t;
+    using x_subkey_t    = typename x_publisher_t::x_subkey_t;
+    using x_journal_t   = xmsg_journal_t< x_msgctxt_t >;
+    using x_codec_t     = typename x_journal_t::x_codec_t;
+    using x_view_t      = typename x_journal_t::x_view_t;
+
+private:
+    /**
+     * @struct x_dispatching_t
+     * @brief 投递结束（包括消息处理接口抛出异常）时，清除投递标识。
+     */
+    struct x_dispatching_t
+    {
+        xmsg_journal_stage_t & xthis;
+
+        ~x_dispatching_t(void)
+        {
+            xthis.m_xdispatching = false;
+        }
+    };
+
+    // constructor/destructor
+public:
+    xmsg_journal_stage_t(x_publisher_t & xpublisher, x_journal_t & xjournal)
+        : m_xpublisher(xpublisher)
+        , m_xjournal(xjournal)
+        , m_xqueued(0)
+        , m_xdispatching(false)
+    {
+
+    }
+
+    ~xmsg_journal_stage_t(void)
+    {
+
+    }
+
+    xmsg_journal_stage_t(xmsg_journal_stage_t && xobject) = delete;
+    xmsg_journal_stage_t & operator=(xmsg_journal_stage_t && xobject) = delete;
+    xmsg_journal_stage_t(const xmsg_journal_stage_t & xobject) = delete;
+    xmsg_journal_stage_t & operator=(const xmsg_journal_stage_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 发布者。
+     */
+    inline x_publisher_t & publisher(void)
+    {
+        return m_xpublisher;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 消息日志。
+     */
+    inline x_journal_t & journal(void)
+    {
+        return m_xjournal;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 发布消息：先追加到日志，再入队；入队失败时撤销日志项。
+     * @note
+     * 追加日志失败（抛出异常）时，消息不会入队，因此不会有未记入日志的消息被投递。
+     */
+    template< typename... __args_t >
+    bool publish(const x_mkey_t & xmkey, __args_t &&... xargs)
+    {
+        const x_msgctxt_t xmsg_ctxt(xmkey, std::forward< __args_t >(xargs)...);
+
+        m_xjournal.append(xmsg_ctxt);
+        if (!m_xpublisher.publish(xmsg_ctxt))
+        {
+            m_xjournal.revert(xmkey);
+            return false;
+        }
+
+        m_xqueued += 1;
+        return true;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 组提交日志（一次落盘操作覆盖上次投递之后发布的所有消息），再投递消息。
+     * @note
+     * 逐个投递消息：消息出队之后才调用消息处理接口，因此即便其抛出异常，
+     * m_xqueued 也与队列保持一致，m_xdispatching 则由 x_dispatching_t 清除。
+     */
+    size_t dispatch(size_t xmsg_maxcount = (size_t)-1)
+    {
+        m_xjournal.commit();
+
+        m_xdispatching = true;
+        x_dispatching_t xdispatching{ *this };
+
+        size_t xcount = 0;
+        while ((xcount < xmsg_maxcount) && !m_xpublisher.empty())
+        {
+            m_xqueued -= std::min(static_cast< size_t >(1), m_xqueued);
+            xcount += m_xpublisher.dispatch(1);
+        }
+
+        return xcount;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 订阅消息，并先回放该消息键自偏移量 xoffset 起的历史消息。
+     * @note
+     * 历史消息在本接口返回之前同步回放给新的订阅者；
+     * 已入队未投递的消息，不回放，而是随后由 dispatch() 投递。
+     * 
+     * @param [in ] xmkey    : 消息键。
+     * @param [in ] xoffset  : 回放的起始偏移量（0 表示从头回放）。
+     * @param [in ] xfunc    : 消息处理的接口函数。
+     * @param [in ] xargs... : 回调的参数（或 类对象）。
+     */
+    template< typename __mfunc_t, typename... __args_t >
+    x_subkey_t subscribe_from(const x_mkey_t & xmkey,
+                              uint64_t xoffset,
+                              __mfunc_t && xfunc,
+                              __args_t &&... xargs)
+    {
+        assert(!m_xdispatching);
+
+        x_subkey_t xsub_key = m_xpublisher.subscribe(xmkey,
+                                                     std::forward< __mfunc_t >(xfunc),
+                                                     std::forward< __args_t >(xargs)...);
+
+        const uint64_t xlive = m_xjournal.next_offset() - m_xqueued;
+        m_xjournal.replay(xmkey, xoffset, xlive,
+            [&xsub_key](uint64_t, const x_view_t & xview)
+            {
+                // 回放过程中，订阅者可能已取消订阅
+                typename x_publisher_t::x_subsptr_t xsub_sptr = xsub_key.xwptr.lock();
+                if (!xsub_sptr)
+                    return false;
+                xsub_sptr->invoke(x_codec_t::decode(xview.data()));
+                return true;
+            });
+
+        return xsub_key;
+    }
+
+    // data members
+private:
+    x_publisher_t & m_xpublisher;   ///< 发布者
+    x_journal_t   & m_xjournal;     ///< 消息日志
+    size_t          m_xqueued;      ///< 已入队（并已追加到日志）未投递的消息数量
+    bool            m_xdispatching; ///< 是否正在投递
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __XMSG_JOURNAL_H__
@@ -0,0 +1,355 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file xmsg_lane_queue.h
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * @author  ：Gaaagaa
+ * @date    : 2026-10-18
+ * @version : 1.0.0.0
+ * @brief   : 多优先级通道的消息队列。
+ */
+
+#ifndef __XMSG_LANE_QUEUE_H__
+#define __XMSG_LANE_QUEUE_H__
+
+#include "xmsg_pubsub.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_lane_policy_t
+
+/**
+ * @enum xmsg_lane_policy_t
+ * @brief xmsg_lane_queue_t 在各个优先级通道之间的调度策略。
+ */
+enum xmsg_lane_policy_t
+{
+    XLANE_STRICT   = 0, ///< 严格优先级：总是先取出优先级最高的非空通道中的消息
+    XLANE_WEIGHTED = 1, ///< 加权轮转：各通道轮流取出，每轮最多取出 权重值 个消息
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_lane_queue_t
+
+/**
+ * @class xmsg_lane_queue_t< __value_t, __lanes, __policy, __lane_t >
+ * @brief 多优先级通道的消息队列。
+ * @note
+ * 1. 接口与 std::queue 保持一致，可直接作为 xmsg_publisher_t 的
+ *    __msg_queue_t 模板参数使用；xmsg_publisher_t::publish(xmsg_prio_t, ...)
+ *    将消息发布到指定的通道，而普通的 publish() 则发布到优先级最低的通道；
+ * 2. 每个通道为一个独立的 __lane_t 队列（默认为 std::queue），
+ *    若为 xmsg_mpsc_queue_t 或 xmsg_ring_queue_t，则任意线程均可发布消息；
+ *    调度相关的操作（empty()/front()/pop()）只能在消费者线程中调用；
+ * 3. XLANE_WEIGHTED 策略下，通道 i 的默认权重为 (__lanes - i)，
+ *    可通过 set_weight() 修改（如 xpub.msg_queue().set_weight(0, 8)）；
+ * 4. 配合 dispatch_batch() 使用时，批次只限定本轮投递的消息数量，
+ *    投递过程中发布到高优先级通道的消息，仍可在本轮中优先投递。
+ *
+ * @param [in ] __value_t : 队列元素类型。
+ * @param [in ] __lanes   : 优先级通道的数量。
+ * @param [in ] __policy  : 各通道之间的调度策略。
+ * @param [in ] __lane_t  : 每个通道所使用的队列类型。
+ */
+template< typename __value_t,
+          size_t __lanes,
+          xmsg_lane_policy_t __policy = XLANE_STRICT,
+          typename __lane_t = std::queue< __value_t > >
+class xmsg_lane_queue_t
+{
+    static_assert(__lanes >= 1, "__lanes >= 1");
+
+    // common data types
+public:
+    typedef __value_t           value_type;
+    typedef size_t              size_type;
+    typedef __value_t &         reference;
+    typedef const __value_t &   const_reference;
+
+    /**
+     * @class x_batch_t
+     * @brief 供 xmsg_publisher_t::dispatch_batch() 使用的批次视图
+     *        （只记录摘取时的消息数量，消息仍按调度策略从各通道中取出）。
+     */
+    class x_batch_t
+    {
+        friend class xmsg_lane_queue_t;
+
+    public:
+        x_batch_t(void) : m_xqueue(nullptr), m_xcount(0) { }
+
+        inline bool empty(void) const
+        {
+            return ((0 == m_xcount) || m_xqueue->empty());
+        }
+
+        inline reference front(void)
+        {
+            return m_xqueue->front();
+        }
+
+        inline void pop(void)
+        {
+            m_xqueue->pop();
+            m_xcount -= 1;
+        }
+
+    private:
+        xmsg_lane_queue_t * m_xqueue; ///< 所属的队列
+        size_type           m_xcount; ///< 批次中剩余的消息数量
+    };
+
+private:
+    using x_lane_traits_t = xmsg_queue_traits_t< __lane_t >;
+
+    /** 表示未选定通道 */
+    static constexpr size_type XLANE_NONE = (size_type)-1;
+
+    // constructor/destructor
+public:
+    xmsg_lane_queue_t(void)
+        : m_xselect(XLANE_NONE)
+        , m_xcursor(0)
+    {
+        for (size_type xlane = 0; xlane < __lanes; ++xlane)
+        {
+            m_xweights[xlane] = __lanes - xlane;
+            m_xcredits[xlane] = m_xweights[xlane];
+        }
+    }
+
+    xmsg_lane_queue_t(xmsg_lane_queue_t && xobject) = delete;
+    xmsg_lane_queue_t & operator=(xmsg_lane_queue_t && xobject) = delete;
+    xmsg_lane_queue_t(const xmsg_lane_queue_t & xobject) = delete;
+    xmsg_lane_queue_t & operator=(const xmsg_lane_queue_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 优先级通道的数量。
+     */
+    inline size_type lanes(void) const
+    {
+        return __lanes;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 指定通道中的消息数量（通道深度）。
+     */
+    inline size_type lane_size(size_type xlane) const
+    {
+        assert(xlane < __lanes);
+        return m_xlanes[xlane].size();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 设置 XLANE_WEIGHTED 策略下指定通道的权重（每轮最多取出的消息数量）。
+     */
+    void set_weight(size_type xlane, size_type xweight)
+    {
+        assert(xlane < __lanes);
+        m_xweights[xlane] = (xweight > 0) ? xweight : 1;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 返回所有通道中的消息总数。
+     */
+    size_type size(void) const
+    {
+        size_type xsize = 0;
+        for (size_type xlane = 0; xlane < __lanes; ++xlane)
+        {
+            xsize += m_xlanes[xlane].size();
+        }
+
+        return xsize;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 判断所有通道是否都为空。
+     */
+    bool empty(void) const
+    {
+        for (size_type xlane = 0; xlane < __lanes; ++xlane)
+        {
+            if (!m_xlanes[xlane].empty())
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将元素压入优先级最低的通道。
+     */
+    bool push(const value_type & xvalue)
+    {
+        return x_lane_traits_t::push(m_xlanes[__lanes - 1], xvalue);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将元素压入优先级最低的通道。
+     */
+    bool push(value_type && xvalue)
+    {
+        return x_lane_traits_t::push(m_xlanes[__lanes - 1],
+                                     std::forward< value_type >(xvalue));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 在优先级最低的通道中直接构造元素。
+     */
+    template< typename... __args_t >
+    bool emplace(__args_t &&... xargs)
+    {
+        return x_lane_traits_t::emplace(m_xlanes[__lanes - 1],
+                                        std::forward< __args_t >(xargs)...);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 在指定的优先级通道中直接构造元素（超出范围的通道号按最低优先级处理）。
+     */
+    template< typename... __args_t >
+    bool emplace_prio(xmsg_prio_t xprio, __args_t &&... xargs)
+    {
+        size_type xlane = (xprio.xlane < __lanes) ? xprio.xlane : (__lanes - 1);
+        return x_lane_traits_t::emplace(m_xlanes[xlane],
+                                        std::forward< __args_t >(xargs)...);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 返回按调度策略选定的队首元素（仅限消费者线程调用，且队列不为空）。
+     */
+    reference front(void)
+    {
+        if (XLANE_NONE == m_xselect)
+        {
+            m_xselect = select();
+        }
+
+        assert(XLANE_NONE != m_xselect);
+        return m_xlanes[m_xselect].front();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 弹出按调度策略选定的队首元素（仅限消费者线程调用，且队列不为空）。
+     */
+    void pop(void)
+    {
+        if (XLANE_NONE == m_xselect)
+        {
+            m_xselect = select();
+        }
+
+        assert(XLANE_NONE != m_xselect);
+        m_xlanes[m_xselect].pop();
+        if (m_xcredits[m_xselect] > 0)
+        {
+            m_xcredits[m_xselect] -= 1;
+        }
+
+        m_xselect = XLANE_NONE;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 摘取队列中已有的消息到批次视图 xbatch 中（仅限消费者线程调用）。
+     */
+    void detach(x_batch_t & xbatch)
+    {
+        xbatch.m_xqueue = this;
+        xbatch.m_xcount = size();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 放回批次视图 xbatch 中剩余的消息（消息从未离开过队列，只需解除绑定）。
+     */
+    void restore(x_batch_t & xbatch)
+    {
+        xbatch.m_xqueue = nullptr;
+        xbatch.m_xcount = 0;
+    }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 按调度策略选定下一个取出消息的通道，所有通道都为空时返回 XLANE_NONE 。
+     */
+    size_type select(void)
+    {
+        if (XLANE_STRICT == __policy)
+        {
+            for (size_type xlane = 0; xlane < __lanes; ++xlane)
+            {
+                if (!m_xlanes[xlane].empty())
+                {
+                    return xlane;
+                }
+            }
+
+            return XLANE_NONE;
+        }
+
+        // 加权轮转：当前通道为空 或 本轮配额已用完时，
+        // 重置其配额并轮转到下一个通道（至多轮转两圈）
+        for (size_type xiter = 0; xiter < 2 * __lanes; ++xiter)
+        {
+            if ((m_xcredits[m_xcursor] > 0) && !m_xlanes[m_xcursor].empty())
+            {
+                return m_xcursor;
+            }
+
+            m_xcredits[m_xcursor] = m_xweights[m_xcursor];
+            m_xcursor = (m_xcursor + 1) % __lanes;
+        }
+
+        return XLANE_NONE;
+    }
+
+    // data members
+private:
+    __lane_t   m_xlanes[__lanes];   ///< 各个优先级通道
+    size_type  m_xweights[__lanes]; ///< XLANE_WEIGHTED 策略下各通道的权重
+    size_type  m_xcredits[__lanes]; ///< XLANE_WEIGHTED 策略下各通道本轮剩余的配额
+    size_type  m_xselect;           ///< front() 已选定的通道
+    size_type  m_xcursor;           ///< XLANE_WEIGHTED 策略下当前轮转到的通道
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __XMSG_LANE_QUEUE_H__
@@ -0,0 +1,324 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file xmsg_mpsc_queue.h
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * @author  ：Gaaagaa
+ * @date    : 2026-10-18
+ * @version : 1.0.0.0
+ * @brief   : 多生产者/单消费者（MPSC）的无锁消息队列。
+ */
+
+#ifndef __XMSG_MPSC_QUEUE_H__
+#define __XMSG_MPSC_QUEUE_H__
+
+#include <atomic>
+#include <utility>
+#include <cstddef>
+#include <cassert>
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_mpsc_queue_t
+
+/**
+ * @class xmsg_mpsc_queue_t< __value_t >
+ * @brief 多生产者/单消费者（MPSC）的无锁侵入式链表队列。
+ * @note
+ * 1. 接口与 std::queue 保持一致，可直接作为 xmsg_publisher_t 的
+ *    __msg_queue_t 模板参数使用：任意线程均可调用 publish()（即 push()），
+ *    而 dispatch()（即 empty()/front()/pop()）只能在同一个消费者线程中调用。
+ * 2. 生产者端为一个无锁栈（push 时使用 CAS 挂接节点），消费者端
+ *    一次性摘取整个栈（exchange），再逆序为私有的 FIFO 链表后逐个弹出，
+ *    因此消费者端的 front()/pop() 操作不会与生产者产生竞争。
+ * 3. size() 返回的是近似值（生产者与消费者并发时），仅用于统计显示。
+ *
+ * @param [in ] __value_t : 队列元素类型。
+ */
+template< typename __value_t >
+class xmsg_mpsc_queue_t
+{
+    // common data types
+public:
+    typedef __value_t           value_type;
+    typedef size_t              size_type;
+    typedef __value_t &         reference;
+    typedef const __value_t &   const_reference;
+
+private:
+    /**
+     * @struct x_node_t
+     * @brief 队列的链表节点（侵入式：链接指针 与 元素 在同一块内存中）。
+     */
+    struct x_node_t
+    {
+        x_node_t * xnext;  ///< 下一个节点
+        value_type xvalue; ///< 元素对象
+
+        template< typename... __args_t >
+        explicit x_node_t(__args_t &&... xargs)
+            : xnext(nullptr)
+            , xvalue(std::forward< __args_t >(xargs)...)
+        {
+
+        }
+    };
+
+    /** 缓存行大小（用于隔离 生产者 与 消费者 的数据成员，避免伪共享） */
+    static constexpr size_t XCACHE_LINE_SIZE = 64;
+
+    // constructor/destructor
+public:
+    xmsg_mpsc_queue_t(void)
+        : m_xstack(nullptr)
+        , m_xcount(0)
+        , m_xfront(nullptr)
+        , m_xfsize(0)
+    {
+
+    }
+
+    ~xmsg_mpsc_queue_t(void)
+    {
+        free_list(m_xfront);
+        free_list(m_xstack.exchange(nullptr, std::memory_order_acquire));
+    }
+
+    xmsg_mpsc_queue_t(xmsg_mpsc_queue_t && xobject) = delete;
+    xmsg_mpsc_queue_t & operator=(xmsg_mpsc_queue_t && xobject) = delete;
+    xmsg_mpsc_queue_t(const xmsg_mpsc_queue_t & xobject) = delete;
+    xmsg_mpsc_queue_t & operator=(const xmsg_mpsc_queue_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 返回队列中的元素数量（多线程并发时为近似值）。
+     */
+    inline size_type size(void) const
+    {
+        ptrdiff_t xcount = m_xcount.load(std::memory_order_relaxed);
+        return (xcount > 0) ? static_cast< size_type >(xcount) : 0;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 判断队列是否为空（仅在消费者线程中调用时结果才是准确的）。
+     */
+    inline bool empty(void) const
+    {
+        return ((nullptr == m_xfront) &&
+                (nullptr == m_xstack.load(std::memory_order_acquire)));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将元素压入队列（可在任意线程中调用）。
+     */
+    void push(const value_type & xvalue)
+    {
+        push_node(new x_node_t(xvalue));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将元素压入队列（可在任意线程中调用）。
+     */
+    void push(value_type && xvalue)
+    {
+        push_node(new x_node_t(std::forward< value_type >(xvalue)));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 在队列节点中直接构造元素（可在任意线程中调用）。
+     */
+    template< typename... __args_t >
+    void emplace(__args_t &&... xargs)
+    {
+        push_node(new x_node_t(std::forward< __args_t >(xargs)...));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 返回队首元素（仅限消费者线程调用，且队列不为空）。
+     */
+    reference front(void)
+    {
+        if (nullptr == m_xfront)
+        {
+            m_xfront = take_stack(m_xfsize);
+        }
+
+        assert(nullptr != m_xfront);
+        return m_xfront->xvalue;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 弹出队首元素（仅限消费者线程调用，且队列不为空）。
+     */
+    void pop(void)
+    {
+        if (nullptr == m_xfront)
+        {
+            m_xfront = take_stack(m_xfsize);
+        }
+
+        assert(nullptr != m_xfront);
+
+        x_node_t * xnode = m_xfront;
+        m_xfront = xnode->xnext;
+        m_xfsize -= 1;
+        delete xnode;
+
+        m_xcount.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将队列中已就绪的消息整体摘取到（空的）本地队列 xbatch 中
+     *        （仅限消费者线程调用）。
+     * @note
+     * xbatch 应为消费者线程私有的本地队列；摘取操作只转移链表指针，
+     * 在摘取之后才发布的元素仍保留在本队列中。
+     */
+    void detach(xmsg_mpsc_queue_t & xbatch)
+    {
+        assert(xbatch.empty());
+
+        if (nullptr == m_xfront)
+        {
+            m_xfront = take_stack(m_xfsize);
+        }
+
+        xbatch.m_xfront = m_xfront;
+        xbatch.m_xfsize = m_xfsize;
+        xbatch.m_xcount.fetch_add(static_cast< ptrdiff_t >(m_xfsize),
+                                  std::memory_order_relaxed);
+        m_xcount.fetch_sub(static_cast< ptrdiff_t >(m_xfsize),
+                           std::memory_order_relaxed);
+
+        m_xfront = nullptr;
+        m_xfsize = 0;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将本地队列 xbatch 中剩余的元素按原有顺序放回到本队列的最前面
+     *        （仅限消费者线程调用）。
+     */
+    void restore(xmsg_mpsc_queue_t & xbatch)
+    {
+        if (nullptr == xbatch.m_xfront)
+        {
+            return;
+        }
+
+        x_node_t * xback = xbatch.m_xfront;
+        while (nullptr != xback->xnext)
+        {
+            xback = xback->xnext;
+        }
+
+        xback->xnext = m_xfront;
+        m_xfront  = xbatch.m_xfront;
+        m_xfsize += xbatch.m_xfsize;
+        m_xcount.fetch_add(static_cast< ptrdiff_t >(xbatch.m_xfsize),
+                           std::memory_order_relaxed);
+        xbatch.m_xcount.fetch_sub(static_cast< ptrdiff_t >(xbatch.m_xfsize),
+                                  std::memory_order_relaxed);
+
+        xbatch.m_xfront = nullptr;
+        xbatch.m_xfsize = 0;
+    }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 使用 CAS 操作将节点挂接到生产者端的无锁栈上。
+     */
+    inline void push_node(x_node_t * xnode)
+    {
+        xnode->xnext = m_xstack.load(std::memory_order_relaxed);
+        while (!m_xstack.compare_exchange_weak(xnode->xnext,
+                                               xnode,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed))
+        {
+        }
+
+        m_xcount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 一次性摘取生产者端的整个栈，并逆序为 FIFO 链表返回。
+     * 
+     * @param [out] xsize : 返回链表的节点数量。
+     */
+    x_node_t * take_stack(size_type & xsize)
+    {
+        x_node_t * xnode = m_xstack.exchange(nullptr, std::memory_order_acquire);
+        x_node_t * xlist = nullptr;
+
+        xsize = 0;
+        while (nullptr != xnode)
+        {
+            x_node_t * xnext = xnode->xnext;
+            xnode->xnext = xlist;
+            xlist = xnode;
+            xnode = xnext;
+            xsize += 1;
+        }
+
+        return xlist;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 释放链表中的所有节点。
+     */
+    static void free_list(x_node_t * xnode)
+    {
+        while (nullptr != xnode)
+        {
+            x_node_t * xnext = xnode->xnext;
+            delete xnode;
+            xnode = xnext;
+        }
+    }
+
+    // data members
+private:
+    std::atomic< x_node_t * > m_xstack;  ///< 生产者端的无锁栈（栈顶为最新的元素）
+    std::atomic< ptrdiff_t >  m_xcount;  ///< 队列中的元素数量（近似值）
+    char m_xpad[XCACHE_LINE_SIZE];       ///< 隔离 生产者 与 消费者 的数据成员
+    x_node_t *                m_xfront;  ///< 消费者端的私有 FIFO 链表
+    size_type                 m_xfsize;  ///< 消费者端私有链表的节点数量
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __XMSG_MPSC_QUEUE_H__
@@ -0,0 +1,315 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file xmsg_payload.h
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * @author  ：Gaaagaa
+ * @date    : 2026-10-18
+ * @version : 1.0.0.0
+ * @brief   : 以引用计数共享的只读消息参数（用于高扇出、多消息键的发布）。
+ */
+
+#ifndef __XMSG_PAYLOAD_H__
+#define __XMSG_PAYLOAD_H__
+
+#include "xmsg_pubsub.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_refcnt_t
+
+/**
+ * @enum xmsg_refcnt_t
+ * @brief xmsg_payload_t 的引用计数策略。
+ */
+enum xmsg_refcnt_t
+{
+    XREFCNT_ATOMIC = 0, ///< 原子引用计数（消息对象可在多个线程中 拷贝/析构）
+    XREFCNT_SINGLE = 1, ///< 非原子引用计数（消息对象只在同一个线程中 拷贝/析构）
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_payload_t
+
+/**
+ * @class xmsg_payload_t< __args_t, __refcnt >
+ * @brief 以引用计数共享的只读消息参数元组。
+ * @note
+ * 1. 参数元组在构造时一次性分配（使用 xmsg_slab_allocator_t），此后只读；
+ *    拷贝 xmsg_payload_t 对象只增加引用计数，不拷贝参数元组，
+ *    因此同一份参数发布到多个消息键（或再次发布收到的消息）时，
+ *    每次只需一次引用计数操作；
+ * 2. XREFCNT_SINGLE 策略的引用计数不是原子操作：要求所有共享同一份参数的
+ *    消息对象都在同一个线程中 拷贝/析构（如 使用默认的 std::queue
+ *    作为消息队列，且不使用 dispatch_parallel()）；
+ * 3. 默认构造的对象为空对象（不可调用 get()）。
+ *
+ * @param [in ] __args_t : 消息参数元组类型（std::tuple）。
+ * @param [in ] __refcnt : 引用计数策略。
+ */
+template< typename __args_t, xmsg_refcnt_t __refcnt = XREFCNT_ATOMIC >
+class xmsg_payload_t
+{
+    // common data types
+public:
+    typedef __args_t x_args_t;
+
+    /** 拷贝/析构 操作能否在多个线程中并发执行 */
+    static constexpr bool XTHREAD_SAFE = (XREFCNT_ATOMIC == __refcnt);
+
+private:
+    /** 引用计数类型 */
+    using x_count_t = typename std::conditional<
+                            XTHREAD_SAFE, std::atomic< size_t >, size_t >::type;
+
+    /**
+     * @struct x_block_t
+     * @brief 共享的存储块（引用计数 与 参数元组 在同一块内存中）。
+     */
+    struct x_block_t
+    {
+        x_count_t      xrefs; ///< 引用计数
+        const x_args_t xargs; ///< 参数元组
+
+        template< typename... __vargs_t >
+        explicit x_block_t(__vargs_t &&... xvargs)
+            : xrefs(1)
+            , xargs(std::forward< __vargs_t >(xvargs)...)
+        {
+
+        }
+    };
+
+    using x_alloc_t = xmsg_slab_allocator_t< x_block_t >;
+
+    /**
+     * @struct x_is_self_t< __vargs_t... >
+     * @brief 判断构造参数是否为（单个）xmsg_payload_t 对象，
+     *        用于避免参数构造函数屏蔽 拷贝/移动 构造函数。
+     */
+    template< typename... __vargs_t >
+    struct x_is_self_t : std::false_type
+    {
+    };
+
+    template< typename __varg_t >
+    struct x_is_self_t< __varg_t >
+        : std::is_same< typename std::decay< __varg_t >::type, xmsg_payload_t >
+    {
+    };
+
+    // constructor/destructor
+public:
+    xmsg_payload_t(void) noexcept
+        : m_xblock(nullptr)
+    {
+
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 以参数（或参数元组）构造共享的参数元组。
+     */
+    template< typename... __vargs_t,
+              typename = typename std::enable_if<
+                    (sizeof...(__vargs_t) > 0) &&
+                    !x_is_self_t< __vargs_t... >::value >::type >
+    explicit xmsg_payload_t(__vargs_t &&... xvargs)
+        : m_xblock(make_block(std::forward< __vargs_t >(xvargs)...))
+    {
+
+    }
+
+    xmsg_payload_t(const xmsg_payload_t & xobject) noexcept
+        : m_xblock(xobject.m_xblock)
+    {
+        if (nullptr != m_xblock)
+        {
+            add_ref(m_xblock->xrefs);
+        }
+    }
+
+    xmsg_payload_t(xmsg_payload_t && xobject) noexcept
+        : m_xblock(xobject.m_xblock)
+    {
+        xobject.m_xblock = nullptr;
+    }
+
+    xmsg_payload_t & operator = (const xmsg_payload_t & xobject) noexcept
+    {
+        if (m_xblock != xobject.m_xblock)
+        {
+            xmsg_payload_t(xobject).swap(*this);
+        }
+
+        return *this;
+    }
+
+    xmsg_payload_t & operator = (xmsg_payload_t && xobject) noexcept
+    {
+        if (this != &xobject)
+        {
+            xmsg_payload_t(std::move(xobject)).swap(*this);
+        }
+
+        return *this;
+    }
+
+    ~xmsg_payload_t(void)
+    {
+        if ((nullptr != m_xblock) && (0 == release_ref(m_xblock->xrefs)))
+        {
+            x_alloc_t xalloc;
+            m_xblock->~x_block_t();
+            xalloc.deallocate(m_xblock, 1);
+        }
+    }
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 共享的参数元组（对象不能为空）。
+     */
+    inline const x_args_t & get(void) const
+    {
+        assert(nullptr != m_xblock);
+        return m_xblock->xargs;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 共享参数元组的对象数量（空对象返回 0）。
+     */
+    inline size_t use_count(void) const
+    {
+        return (nullptr != m_xblock) ? static_cast< size_t >(m_xblock->xrefs) : 0;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 判断是否为空对象。
+     */
+    explicit operator bool (void) const { return (nullptr != m_xblock); }
+
+    /**********************************************************/
+    /**
+     * @brief 交换两个对象。
+     */
+    inline void swap(xmsg_payload_t & xobject) noexcept
+    {
+        std::swap(m_xblock, xobject.m_xblock);
+    }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 分配并构造共享的存储块。
+     */
+    template< typename... __vargs_t >
+    static x_block_t * make_block(__vargs_t &&... xvargs)
+    {
+        x_alloc_t xalloc;
+        x_block_t * xblock = xalloc.allocate(1);
+
+        try
+        {
+            ::new (static_cast< void * >(xblock))
+                x_block_t(std::forward< __vargs_t >(xvargs)...);
+        }
+        catch (...)
+        {
+            xalloc.deallocate(xblock, 1);
+            throw;
+        }
+
+        return xblock;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 增加引用计数。
+     */
+    static inline void add_ref(std::atomic< size_t > & xrefs)
+    {
+        xrefs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static inline void add_ref(size_t & xrefs)
+    {
+        xrefs += 1;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 减少引用计数，返回减少后的计数值。
+     */
+    static inline size_t release_ref(std::atomic< size_t > & xrefs)
+    {
+        return xrefs.fetch_sub(1, std::memory_order_acq_rel) - 1;
+    }
+
+    static inline size_t release_ref(size_t & xrefs)
+    {
+        return (xrefs -= 1);
+    }
+
+    // data members
+private:
+    x_block_t * m_xblock; ///< 共享的存储块
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_shared_args_t
+
+/**
+ * @struct xmsg_shared_args_t< __msg_args_t, __refcnt >
+ * @brief 用于声明以引用计数共享的消息参数列表（作为 xmsg_context_t 的
+ *        __msg_args_t 模板参数）。
+ * @note
+ * 消息对象中存储的是 xmsg_payload_t ，订阅者接收到的参数与 xmsg_args_t
+ * 声明时完全相同（以常量引用传递）。同一份参数发布到多个消息键时，
+ * 先构造共享对象，再逐个发布：
+ * <pre>
+ *   using x_ctxt_t = xmsg_context_t< xmsg_mkey_t< int >,
+ *                                    xmsg_shared_args_t< xmsg_args_t< std::string > > >;
+ *   x_ctxt_t::x_payload_t xpayload(std::string(4096, 'x'));
+ *   for (int xkey : xkeys)
+ *       xpub.publish(xkey, xpayload);
+ * </pre>
+ * 订阅者中也可以通过 xmsg_ctxt.payload() 将收到的参数再次发布。
+ *
+ * @param [in ] __msg_args_t : 消息参数列表（使用 xmsg_args_t 构建）。
+ * @param [in ] __refcnt     : 引用计数策略。
+ */
+template< typename __msg_args_t, xmsg_refcnt_t __refcnt = XREFCNT_ATOMIC >
+struct xmsg_shared_args_t
+{
+    typedef typename __msg_args_t::type type;
+    typedef xmsg_payload_t< type, __refcnt > x_payload_t;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __XMSG_PAYLOAD_H__
@@ -35,11 +35,19 @@
 
 #include <unordered_set>
 #include <unordered_map>
+#include <vector>
 #include <queue>
+#include <algorithm>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <new>
 #include <memory>
 #include <tuple>
 #include <functional>
 #include <atomic>
+#include <exception>
 #include <cassert>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -78,869 +86,4480 @@ struct xbuild_index_sequence_t< 0, xindex_sequence_t< __indexes... > >
 #endif // __X_BUILD_INDEX_SEQUENCE__
 
 ////////////////////////////////////////////////////////////////////////////////
-// xmsg_context_t
+// xmsg_invoke
 
+/**********************************************************/
 /**
- * @struct xmsg_mkey_t< __mkey_t >
- * @brief  用于消息索引键类型声明。
+ * @brief 调用 “类似函数类型” 的对象（函数指针、仿函数、lambda表达式 等）。
+ * @note
+ * 在 C++17 之前，用于替代 std::invoke()，以避免使用 std::bind()
+ * 每次调用时都构建（并拷贝参数到）临时的绑定对象。
  */
-template< typename __mkey_t,
-          typename __equal_t = std::equal_to< __mkey_t >,
-          typename __hasher_t = std::hash< __mkey_t > >
-struct xmsg_mkey_t
+template< typename __func_t, typename... __args_t >
+inline auto xmsg_invoke(__func_t && xfunc, __args_t &&... xargs)
+    -> decltype(std::forward< __func_t >(xfunc)(std::forward< __args_t >(xargs)...))
 {
-    typedef typename std::decay< __mkey_t >::type type;
-    typedef __equal_t x_equal_t;
-    typedef __hasher_t x_hash_t;
-};
+    return std::forward< __func_t >(xfunc)(std::forward< __args_t >(xargs)...);
+}
 
+/**********************************************************/
 /**
- * @struct xmsg_args_t< __args_t... >
- * @brief  用于消息参数列表类型声明。
+ * @brief 以对象引用调用类对象成员函数。
  */
-template< typename... __args_t >
-struct xmsg_args_t
+template< typename __mfunc_t, typename __class_t,
+          typename __object_t, typename... __args_t >
+inline auto xmsg_invoke(__mfunc_t __class_t::* xmfunc,
+                        __object_t && xobject,
+                        __args_t &&... xargs)
+    -> typename std::enable_if<
+            std::is_base_of< __class_t,
+                             typename std::decay< __object_t >::type >::value,
+            decltype((std::forward< __object_t >(xobject).*xmfunc)(
+                                std::forward< __args_t >(xargs)...)) >::type
 {
-    typedef typename std::tuple<
-                typename std::decay< __args_t >::type... > type;
-};
+    return (std::forward< __object_t >(xobject).*xmfunc)(
+                                std::forward< __args_t >(xargs)...);
+}
 
+/**********************************************************/
 /**
- * @class xmsg_context_t< __msg_mkey_t, __msg_args_t... >
- * @brief 发布订阅模式使用的消息模板类。
- * 
- * @param [in ] __msg_mkey_t : 消息索引键值（使用 xmsg_mkey_t 构建）。
- * @param [in ] __msg_args_t : 消息参数列表（使用 xmsg_args_t 构建）。
+ * @brief 以对象指针（包括智能指针）调用类对象成员函数。
  */
-template< typename __msg_mkey_t, typename __msg_args_t >
-class xmsg_context_t
+template< typename __mfunc_t, typename __class_t,
+          typename __object_t, typename... __args_t >
+inline auto xmsg_invoke(__mfunc_t __class_t::* xmfunc,
+                        __object_t && xobject,
+                        __args_t &&... xargs)
+    -> typename std::enable_if<
+            !std::is_base_of< __class_t,
+                              typename std::decay< __object_t >::type >::value,
+            decltype(((*std::forward< __object_t >(xobject)).*xmfunc)(
+                                std::forward< __args_t >(xargs)...)) >::type
 {
-    // common data types
-public:
-    typedef __msg_mkey_t xmsg_mkey_t;
-    typedef __msg_args_t xmsg_args_t;
+    return ((*std::forward< __object_t >(xobject)).*xmfunc)(
+                                std::forward< __args_t >(xargs)...);
+}
 
-    using x_mkey_t = typename xmsg_mkey_t::type;
-    using x_args_t = typename xmsg_args_t::type;
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_stats
 
-    // constructor/destructor
-public:
-    explicit xmsg_context_t(void)
-        : m_mkey()
-        , m_args()
-    {
+/**
+ * @brief 是否启用 xmsg_publisher_t 的统计功能（计数器 与 耗时直方图）。
+ * @note
+ * 默认不启用：此时与统计相关的类型、数据成员 以及 接口都不会被编译，
+ * 不产生任何额外开销；若要启用，须在包含本头文件之前将其定义为 1
+ * （或使用编译选项 -DXMSG_ENABLE_STATS=1）。
+ */
+#ifndef XMSG_ENABLE_STATS
+#define XMSG_ENABLE_STATS 0
+#endif // XMSG_ENABLE_STATS
 
-    }
+#if XMSG_ENABLE_STATS
+#include <chrono>
+#if defined(_MSC_VER) && defined(_WIN64)
+#include <intrin.h>
+#endif // defined(_MSC_VER) && defined(_WIN64)
+#endif // XMSG_ENABLE_STATS
 
-    explicit xmsg_context_t(const x_mkey_t & xmkey, const x_args_t & xargs)
-        : m_mkey(xmkey)
-        , m_args(xargs)
-    {
+/**
+ * @brief 以内联命名空间标记 XMSG_ENABLE_STATS 的取值（链接期检查）。
+ * @note
+ * 启用统计时，xmsg_context_t、xmsg_subscriber_t、xmsg_publisher_t 等类型的
+ * 内存布局不同；两种编译方式下的类型分属不同的内联命名空间（名字修饰不同），
+ * 因此各个编译单元的 XMSG_ENABLE_STATS 不一致、又相互传递这些类型时，
+ * 将在链接时报告未定义的符号，而不是违反 ODR 的未定义行为。
+ */
+#if XMSG_ENABLE_STATS
+inline namespace xmsg_abi_stats {
+#else // !XMSG_ENABLE_STATS
+inline namespace xmsg_abi_plain {
+#endif // XMSG_ENABLE_STATS
 
-    }
+#if XMSG_ENABLE_STATS
 
-    explicit xmsg_context_t(const x_mkey_t & xmkey, x_args_t && xargs)
-        : m_mkey(xmkey)
-        , m_args(std::forward< x_args_t >(xargs))
-    {
+/**
+ * @brief 统计数据按线程划分条带：同时使用统计功能的线程数量上限。
+ * @note
+ * 每个线程在首次更新统计数据时领取一个线程序号（线程退出时归还），
+ * 序号对应的条带只由该线程写入（无需原子的 读-改-写 操作）；
+ * 超出上限的线程共用最后一个条带（使用原子的 读-改-写 操作）。
+ */
+#ifndef XMSG_STATS_THREADS
+#define XMSG_STATS_THREADS 64
+#endif // XMSG_STATS_THREADS
 
-    }
+/**
+ * @brief 耗时统计的抽样间隔（须为 2 的幂）。
+ * @note
+ * 平均每发布 XMSG_STATS_SAMPLE 个消息，只为其中一个记录发布时间戳
+ * （驻留耗时）；平均每调用 XMSG_STATS_SAMPLE 次消息处理接口，只对其中一次计时；
+ * 定义为 1 时，不抽样。计数器（xmsg_stats_counters_t）不受影响。
+ */
+#ifndef XMSG_STATS_SAMPLE
+#define XMSG_STATS_SAMPLE 16
+#endif // XMSG_STATS_SAMPLE
 
-    template< typename... __vargs_t >
-    explicit constexpr xmsg_context_t(const x_mkey_t & xmkey, __vargs_t &&... xargs)
-        : m_mkey(xmkey)
-        , m_args(std::forward< __vargs_t >(xargs)...)
-    {
+static_assert(0 == (XMSG_STATS_SAMPLE & (XMSG_STATS_SAMPLE - 1)),
+              "XMSG_STATS_SAMPLE must be a power of two!");
 
-    }
+/**********************************************************/
+/**
+ * @brief 统计使用的时间戳（单调时钟，单位为 纳秒）。
+ */
+inline uint64_t xmsg_stats_now(void)
+{
+    return static_cast< uint64_t >(
+        std::chrono::duration_cast< std::chrono::nanoseconds >(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
 
-    xmsg_context_t(xmsg_context_t && xobject) noexcept
+/**********************************************************/
+/**
+ * @brief 本次计时是否被抽中（概率为 1/XMSG_STATS_SAMPLE）。
+ * @note
+ * 使用线程局部的 xorshift 伪随机数，而不是固定间隔的计数：
+ * 若按固定间隔抽样，轮流投递给多个订阅者时，可能总是抽中同一个订阅者。
+ */
+inline bool xmsg_stats_sampled(void)
+{
+    static thread_local uint32_t xstate = 0x9E3779B9;
+    xstate ^= (xstate << 13);
+    xstate ^= (xstate >> 17);
+    xstate ^= (xstate << 5);
+    return (0 == (xstate & (XMSG_STATS_SAMPLE - 1)));
+}
+
+/**********************************************************/
+/**
+ * @brief 累加计数值：xshared 为 false 时，计数器只由当前线程写入，
+ *        只需 relaxed 的 读取 与 存储 操作；否则使用原子的 读-改-写 操作。
+ */
+inline void xmsg_stats_add(std::atomic< uint64_t > & xcounter,
+                           uint64_t xvalue,
+                           bool xshared)
+{
+    if (xshared)
     {
-        *this = std::forward< xmsg_context_t >(xobject);
+        xcounter.fetch_add(xvalue, std::memory_order_relaxed);
     }
-
-    xmsg_context_t & operator = (xmsg_context_t && xobject) noexcept
+    else
     {
-        if (this == &xobject)
-            return *this;
-
-        this->m_mkey = std::move(xobject.m_mkey);
-        this->m_args = std::move(xobject.m_args);
-
-        return *this;
+        xcounter.store(xcounter.load(std::memory_order_relaxed) + xvalue,
+                       std::memory_order_relaxed);
     }
+}
 
-    xmsg_context_t(const xmsg_context_t & xobject)
-    {
-        *this = xobject;
-    }
+/**
+ * @class xmsg_stats_thread_t
+ * @brief 统计功能使用的线程序号（每个线程独占一个，线程退出时归还）。
+ */
+class xmsg_stats_thread_t
+{
+    // common data types
+private:
+    /** 线程序号位图的字数 */
+    static constexpr size_t XWORDS = (XMSG_STATS_THREADS + 63) / 64;
 
-    xmsg_context_t & operator = (const xmsg_context_t & xobject)
+    // constructor/destructor
+private:
+    xmsg_stats_thread_t(void)
+        : m_xindex(acquire())
     {
-        if (this == &xobject)
-            return *this;
 
-        this->m_mkey = xobject.m_mkey;
-        this->m_args = xobject.m_args;
-
-        return *this;
     }
 
-    ~xmsg_context_t(void)
+    ~xmsg_stats_thread_t(void)
     {
-
+        release(m_xindex);
     }
 
+    xmsg_stats_thread_t(xmsg_stats_thread_t && xobject) = delete;
+    xmsg_stats_thread_t & operator=(xmsg_stats_thread_t && xobject) = delete;
+    xmsg_stats_thread_t(const xmsg_stats_thread_t & xobject) = delete;
+    xmsg_stats_thread_t & operator=(const xmsg_stats_thread_t & xobject) = delete;
+
     // public interfaces
 public:
     /**********************************************************/
     /**
-     * @brief 消息索引键值。
+     * @brief 当前线程的序号（取值范围为 [0, XMSG_STATS_THREADS]，
+     *        等于 XMSG_STATS_THREADS 时，表示与其他线程共用）。
      */
-    inline const x_mkey_t & mkey(void) const { return m_mkey; }
+    static inline size_t index(void)
+    {
+        static thread_local xmsg_stats_thread_t xthread;
+        return xthread.m_xindex;
+    }
 
+    // inner invoking
+private:
     /**********************************************************/
     /**
-     * @brief 消息参数列表。
+     * @brief 线程序号的占用位图（只含原子整数，不依赖析构顺序）。
      */
-    inline const x_args_t & args(void) const { return m_args; }
+    static std::atomic< uint64_t > * bitmap(void)
+    {
+        static std::atomic< uint64_t > xbitmap[XWORDS];
+        return xbitmap;
+    }
 
     /**********************************************************/
     /**
-     * @brief 消息参数列表。
+     * @brief 领取一个空闲的线程序号。
+     */
+    static size_t acquire(void)
+    {
+        std::atomic< uint64_t > * xbitmap = bitmap();
+
+        for (size_t xword = 0; xword < XWORDS; ++xword)
+        {
+            uint64_t xbits = xbitmap[xword].load(std::memory_order_relaxed);
+            for (size_t xbit = 0; xbit < 64; ++xbit)
+            {
+                const size_t xindex = xword * 64 + xbit;
+                if (xindex >= XMSG_STATS_THREADS)
+                {
+                    return XMSG_STATS_THREADS;
+                }
+
+                const uint64_t xmask = (1ull << xbit);
+                if (0 != (xbits & xmask))
+                {
+                    continue;
+                }
+
+                // 领取失败时（被其他线程抢先），重新检查该位
+                if (0 == (xbitmap[xword].fetch_or(xmask, std::memory_order_acquire) & xmask))
+                {
+                    return xindex;
+                }
+
+                xbits = xbitmap[xword].load(std::memory_order_relaxed);
+            }
+        }
+
+        return XMSG_STATS_THREADS;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 归还线程序号。
      */
-    inline x_args_t & args(void) { return m_args; }
+    static void release(size_t xindex)
+    {
+        if (xindex < XMSG_STATS_THREADS)
+        {
+            bitmap()[xindex / 64].fetch_and(~(1ull << (xindex % 64)),
+                                            std::memory_order_release);
+        }
+    }
 
     // data members
 private:
-    x_mkey_t  m_mkey;  ///< 消息索引键值
-    x_args_t  m_args;  ///< 消息参数列表
+    size_t m_xindex; ///< 线程序号
 };
 
-////////////////////////////////////////////////////////////////////////////////
-// xmsg_subscriber_t
+/**
+ * @struct xmsg_stats_tstamp_t
+ * @brief 消息对象的发布时间戳（随消息对象一同拷贝/移动）。
+ * @note
+ * 默认构造时不读取时钟，而是取用当前线程的 pending() 值：
+ * xmsg_publisher_t 在消息入队前读取一次时钟（未被抽中时为 0），
+ * 对于直接在队列中构造的消息，先写入 pending() 再构造；
+ * 对于已构造的消息对象，则直接重新记录。
+ */
+struct xmsg_stats_tstamp_t
+{
+    uint64_t xvalue; ///< 时间戳（纳秒，为 0 时表示不统计其驻留耗时）
 
-typedef size_t   xsub_type_t;
+    xmsg_stats_tstamp_t(void) : xvalue(pending()) { }
 
-/** 
- * @brief 定义 订阅者基类的类型标识值。
- */
-static constexpr xsub_type_t
-            XSUBER_BASE_TYPE = (xsub_type_t)(((xsub_type_t)-1) / 2);
+    /**********************************************************/
+    /**
+     * @brief 当前线程中，下一个构造的消息对象所使用的时间戳。
+     */
+    static inline uint64_t & pending(void)
+    {
+        static thread_local uint64_t xpending = 0;
+        return xpending;
+    }
+};
 
 /**
- * @class xmsg_subscriber_t< __msg_ctxt_t, __sub_type >
- * @brief 发布订阅模式使用的订阅者模板类。
- * 
- * @param [in ] __sub_type   : 订阅者类型标识。
- * @param [in ] __msg_ctxt_t : 消息类型。
+ * @struct xmsg_stats_counters_t
+ * @brief 消息计数器。
  */
-template< xsub_type_t __sub_type, typename __msg_ctxt_t >
-class xmsg_subscriber_t;
+struct xmsg_stats_counters_t
+{
+    uint64_t xpublished;  ///< 已发布（成功入队）的消息数量
+    uint64_t xdropped;    ///< 发布时被消息队列拒绝（丢弃）的消息数量
+    uint64_t xdispatched; ///< 已投递的消息数量
+    uint64_t xinvoked;    ///< 订阅者消息处理接口的调用次数
+
+    xmsg_stats_counters_t(void)
+        : xpublished(0)
+        , xdropped(0)
+        , xdispatched(0)
+        , xinvoked(0)
+    {
+
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 累加另一组计数器。
+     */
+    xmsg_stats_counters_t & operator += (const xmsg_stats_counters_t & xobject)
+    {
+        xpublished  += xobject.xpublished;
+        xdropped    += xobject.xdropped;
+        xdispatched += xobject.xdispatched;
+        xinvoked    += xobject.xinvoked;
+        return *this;
+    }
+};
 
 /**
- * @class xmsg_subscriber_t< __msg_ctxt_t, __sub_type >
- * @brief 发布订阅模式使用的订阅者模板类。
- * 
- * @param [in ] __sub_type   : 订阅者类型标识。
- * @param [in ] __msg_ctxt_t : 消息类型。
+ * @struct xmsg_histogram_snapshot_t
+ * @brief xmsg_histogram_t 的快照（各个桶的计数值 与 汇总信息）。
  */
-template< typename __msg_ctxt_t >
-class xmsg_subscriber_t< XSUBER_BASE_TYPE, __msg_ctxt_t >
+struct xmsg_histogram_snapshot_t
 {
-    // common data types
-public:
-    using x_msgctxt_t = __msg_ctxt_t;
+    uint64_t xcount;                 ///< 记录的数值个数
+    uint64_t xsum;                   ///< 记录的数值之和
+    uint64_t xmax;                   ///< 记录的最大值
+    std::vector< uint64_t > xbucket; ///< 各个桶的计数值（为空时表示没有任何记录）
+
+    xmsg_histogram_snapshot_t(void)
+        : xcount(0)
+        , xsum(0)
+        , xmax(0)
+    {
 
-    // constructor/destructor
-public:
-    xmsg_subscriber_t(void) { }
-    virtual ~xmsg_subscriber_t(void) { }
+    }
 
-    // extensible interfaces
-public:
     /**********************************************************/
     /**
-     * @brief 订阅者类型。
+     * @brief 平均值。
      */
-    virtual xsub_type_t sub_type(void) const
+    inline double mean(void) const
     {
-        return XSUBER_BASE_TYPE;
+        return (xcount > 0) ? (static_cast< double >(xsum) / xcount) : 0.0;
     }
 
     /**********************************************************/
     /**
-     * @brief 订阅消息的分派接口。
+     * @brief 百分位值（xpct 取值范围为 [0, 1]；
+     *        返回所在桶的上界，即误差不超过 1/8 的近似值）。
      */
-    virtual void translate(const x_msgctxt_t & xmsg_ctxt)
-    {
-#if 0
-        using x_mkey_t = typename x_msgctxt_t::x_mkey_t;
-        using x_args_t = typename x_msgctxt_t::x_args_t;
-        using x_indices_t =
-            typename xbuild_index_sequence_t<
-                std::tuple_size< x_args_t >::value >::type;
-
-        invoke_mfunc(xmsg_ctxt.args(), x_indices_t());
-#endif
-    }
+    uint64_t percentile(double xpct) const;
 
-    // public interfaces
-public:
-#if 0
     /**********************************************************/
     /**
-     * @brief 调用消息处理接口。
+     * @brief 合并另一个快照。
      */
-    template< typename __tuple_t, size_t... __indexes >
-    void invoke_mfunc(const __tuple_t & xargs,
-                      xindex_sequence_t< __indexes... >)
+    xmsg_histogram_snapshot_t & operator += (const xmsg_histogram_snapshot_t & xobject)
     {
-        // 下面中的 x_subclass_t 为派生的子类。
-        using x_mfunc_t = typename void (x_subclass_t::*)(
-                            const std::tuple_element< __indexes,
-                                                    __tuple_t >::type & ...);
+        if (xbucket.size() < xobject.xbucket.size())
+        {
+            xbucket.resize(xobject.xbucket.size(), 0);
+        }
 
-        (static_cast< x_subclass_t * >(this)->*(x_mfunc_t))(
-                                            std::get< __indexes >(xargs)...);
+        for (size_t xiter = 0; xiter < xobject.xbucket.size(); ++xiter)
+        {
+            xbucket[xiter] += xobject.xbucket[xiter];
+        }
+
+        xcount += xobject.xcount;
+        xsum   += xobject.xsum;
+        xmax    = std::max(xmax, xobject.xmax);
+        return *this;
     }
-#endif
 };
 
 /**
- * @class xmsg_subscriber_t< __msg_ctxt_t, __sub_type >
- * @brief 用户自定义（重载）订阅者类 所使用的模板基类。
+ * @class xmsg_histogram_t
+ * @brief 记录耗时（纳秒）分布的无锁直方图（HDR 风格的对数-线性分桶）。
  * @note
- * 该模板类用于用户自定义（重载）订阅者类。
- * 强制要求（__sub_type < 0x80000000），主要是为了区别于
- * xmsg_publisher_t 内部的 x_subinvoke_t 订阅者类型。
- * 
- * @param [in ] __sub_type   : 订阅者类型标识。
- * @param [in ] __msg_ctxt_t : 消息类型。
+ * 1. 小于 8 的数值各占一个桶；此后每个 2 的幂区间 [2^e, 2^(e+1)) 等分为 8 个桶，
+ *    因此相对误差不超过 1/8；大于等于 2^40（约 18 分钟）的数值计入最后一个桶；
+ * 2. record() 只对各个计数值执行 relaxed 原子操作（无锁），可在任意线程中调用；
+ *    若直方图只由单个线程写入，则可令 xshared 为 false ，以避免 读-改-写 操作；
+ * 3. snapshot() 可与 record() 并发执行（快照不保证各计数值之间严格一致）。
  */
-template< xsub_type_t __sub_type, typename __msg_ctxt_t >
-class xmsg_subscriber_t
-    : public xmsg_subscriber_t< XSUBER_BASE_TYPE, __msg_ctxt_t >
+class xmsg_histogram_t
 {
-    static_assert(__sub_type < XSUBER_BASE_TYPE,
-                 "__sub_type < XSUBER_BASE_TYPE");
-
     // common data types
 public:
-    using x_msgctxt_t = __msg_ctxt_t;
+    /** 每个 2 的幂区间等分的桶数量（2^XSUB_BITS） */
+    static constexpr size_t XSUB_BITS  = 3;
+    static constexpr size_t XSUB_COUNT = (1 << XSUB_BITS);
+
+    /** 可分辨的数值上限为 2^XMAX_EXP */
+    static constexpr size_t XMAX_EXP   = 40;
+
+    /** 桶的数量 */
+    static constexpr size_t XBUCKETS   = (XMAX_EXP - XSUB_BITS + 1) * XSUB_COUNT;
 
     // constructor/destructor
 public:
-    xmsg_subscriber_t(void) { }
-    virtual ~xmsg_subscriber_t(void) { }
+    xmsg_histogram_t(void)
+        : m_xsum(0)
+        , m_xmax(0)
+    {
+        for (size_t xiter = 0; xiter < XBUCKETS; ++xiter)
+        {
+            m_xbucket[xiter].store(0, std::memory_order_relaxed);
+        }
+    }
 
-    // extensible interfaces
+    xmsg_histogram_t(xmsg_histogram_t && xobject) = delete;
+    xmsg_histogram_t & operator=(xmsg_histogram_t && xobject) = delete;
+    xmsg_histogram_t(const xmsg_histogram_t & xobject) = delete;
+    xmsg_histogram_t & operator=(const xmsg_histogram_t & xobject) = delete;
+
+    // public interfaces
 public:
     /**********************************************************/
     /**
-     * @brief 订阅者类型。
-     * @note 用户自定义的订阅者类型都 小于 XSUBER_BASE_TYPE 。
+     * @brief 数值 xvalue 所在桶的下标。
      */
-    virtual xsub_type_t sub_type(void) const override
+    static inline size_t bucket_index(uint64_t xvalue)
     {
-        return __sub_type;
-    }
-};
+        if (xvalue < XSUB_COUNT)
+        {
+            return static_cast< size_t >(xvalue);
+        }
 
-////////////////////////////////////////////////////////////////////////////////
-// xmsg_publisher_t
+        size_t xexp = highest_bit(xvalue);
+        if (xexp >= XMAX_EXP)
+        {
+            return (XBUCKETS - 1);
+        }
 
-/**
- * @class xmsg_publisher_t< __msg_context_t, __msg_queue_t >
- * @brief 发布订阅模式使用的订阅者模板类。
- * 
- * @param [in ] __msg_context_t : 消息类型。
- * @param [in ] __msg_queue_t   : 消息队列。
- */
-template< typename __msg_context_t,
-          typename __msg_queue_t = std::queue< __msg_context_t > >
-class xmsg_publisher_t
-{
-    // common data types
-public:
-    using x_msgctxt_t    = __msg_context_t;
-    using x_msgqueue_t   = __msg_queue_t;
-    using x_mkey_t       = typename x_msgctxt_t::x_mkey_t;
-    using x_subscriber_t = xmsg_subscriber_t< XSUBER_BASE_TYPE, x_msgctxt_t >;
-    using x_subsptr_t    = std::shared_ptr< x_subscriber_t >;
-    using x_subwptr_t    = std::weak_ptr< x_subscriber_t >;
+        return ((xexp - XSUB_BITS + 1) * XSUB_COUNT +
+                static_cast< size_t >((xvalue >> (xexp - XSUB_BITS)) & (XSUB_COUNT - 1)));
+    }
 
+    /**********************************************************/
     /**
-     * @struct x_subkey_t
-     * @brief 订阅者对象 在 发布者对象 中的索引键。
-     * @note
-     * 调用 subscribe() 发起订阅操作时，返回该对象。
-     * 其在后续执行中，可用于 unsubscribe() 取消订阅操作。
+     * @brief 下标为 xindex 的桶所表示的数值下界。
      */
-    struct x_subkey_t
+    static inline uint64_t bucket_lower(size_t xindex)
     {
-        x_mkey_t    xmkey; ///< 订阅的消息索引键
-        x_subwptr_t xwptr; ///< 订阅者对象的弱指针
-
-        // constructor/destructor
-    public:
-        x_subkey_t(void)
-            : xmkey()
-            , xwptr()
+        if (xindex < XSUB_COUNT)
         {
-
+            return static_cast< uint64_t >(xindex);
         }
 
-        x_subkey_t(const x_mkey_t & xmkey, const x_subwptr_t & xwptr)
-        {
-            this->xmkey = xmkey;
-            this->xwptr = xwptr;
-        }
+        size_t xexp = xindex / XSUB_COUNT + XSUB_BITS - 1;
+        return ((static_cast< uint64_t >(XSUB_COUNT + (xindex % XSUB_COUNT)))
+                << (xexp - XSUB_BITS));
+    }
 
-        x_subkey_t(const x_subkey_t & xobject)
+    /**********************************************************/
+    /**
+     * @brief 下标为 xindex 的桶所表示的数值上界。
+     */
+    static inline uint64_t bucket_upper(size_t xindex)
+    {
+        return (bucket_lower(xindex + 1) - 1);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 记录一个数值。
+     * 
+     * @param [in ] xvalue  : 记录的数值。
+     * @param [in ] xshared : 是否有多个线程同时写入该直方图。
+     */
+    inline void record(uint64_t xvalue, bool xshared = true)
+    {
+        xmsg_stats_add(m_xbucket[bucket_index(xvalue)], 1, xshared);
+        xmsg_stats_add(m_xsum, xvalue, xshared);
+
+        uint64_t xmax = m_xmax.load(std::memory_order_relaxed);
+        while ((xvalue > xmax) &&
+               !m_xmax.compare_exchange_weak(xmax, xvalue, std::memory_order_relaxed))
         {
-            *this = xobject;
         }
+    }
 
-        x_subkey_t & operator=(const x_subkey_t & xobject)
-        {
-            if (this != &xobject)
-            {
-                this->xmkey = xobject.xmkey;
-                this->xwptr = xobject.xwptr;
-            }
+    /**********************************************************/
+    /**
+     * @brief 获取直方图的快照。
+     */
+    xmsg_histogram_snapshot_t snapshot(void) const
+    {
+        xmsg_histogram_snapshot_t xsnapshot;
+        xsnapshot.xbucket.resize(XBUCKETS, 0);
 
-            return *this;
+        for (size_t xiter = 0; xiter < XBUCKETS; ++xiter)
+        {
+            xsnapshot.xbucket[xiter] = m_xbucket[xiter].load(std::memory_order_relaxed);
+            xsnapshot.xcount += xsnapshot.xbucket[xiter];
         }
 
-        // public interfaces
-    public:
-        /**********************************************************/
-        /**
-         * @brief 判断订阅者对象的订阅状态是否仍然有效。
-         */
-        inline bool is_valid(void) const { return !xwptr.expired(); }
-
-        /**********************************************************/
-        /**
-         * @brief 用 bool 操作符判断有效性。
-         */
-        operator bool (void) const { return is_valid(); }
-    };
+        xsnapshot.xsum   = m_xsum.load(std::memory_order_relaxed);
+        xsnapshot.xmax   = m_xmax.load(std::memory_order_relaxed);
+        return xsnapshot;
+    }
 
+    // inner invoking
 private:
-    /** 用于生成 x_subinvoke_t 类型标识的流水号 */
-    static std::atomic_size_t sub_type_seqno;
-
-public:
     /**********************************************************/
     /**
-     * @brief 创建一个 x_subinvoke_t 订阅者类的类型标识。
+     * @brief 数值 xvalue（非 0）最高的有效二进制位的位置。
      */
-    static xsub_type_t make_sub_type(void)
+    static inline size_t highest_bit(uint64_t xvalue)
     {
-        return sub_type_seqno.fetch_add(1);
+#if defined(_MSC_VER) && defined(_WIN64)
+        unsigned long xindex = 0;
+        _BitScanReverse64(&xindex, xvalue);
+        return static_cast< size_t >(xindex);
+#elif defined(__GNUC__) || defined(__clang__)
+        return static_cast< size_t >(63 - __builtin_clzll(xvalue));
+#else
+        size_t xindex = 0;
+        while (xvalue >>= 1)
+        {
+            xindex += 1;
+        }
+        return xindex;
+#endif
     }
 
+    // data members
 private:
-    /**
-     * @class x_subinvoke_t< __mfunc_t, __tuple_t >
-     * @brief 为了使用 “仿函数对象 与 lambda 表达式 等类函数的泛型接口” 
-     * 进行消息处理，而设计的订阅者模板类。
-     * 
-     * @param [in ] __mfunc_t : 消息处理的回调接口函数。
-     * @param [in ] __tuple_t : 回调的参数元组。
-     */
-    template< typename __mfunc_t, typename __tuple_t >
-    class x_subinvoke_t : public x_subscriber_t
+    std::atomic< uint64_t > m_xbucket[XBUCKETS]; ///< 各个桶的计数值
+    std::atomic< uint64_t > m_xsum;              ///< 记录的数值之和
+    std::atomic< uint64_t > m_xmax;              ///< 记录的最大值
+};
+
+/**********************************************************/
+/**
+ * @brief 百分位值（xpct 取值范围为 [0, 1]）。
+ */
+inline uint64_t xmsg_histogram_snapshot_t::percentile(double xpct) const
+{
+    if (0 == xcount)
     {
-        // common data types
-    public:
-        using x_mfunc_t = __mfunc_t;
-        using x_tuple_t = __tuple_t;
+        return 0;
+    }
 
-    private:
-        /** x_subinvoke_t 的订阅者类型 */
-        static xsub_type_t sub_type_value;
+    uint64_t xrank = static_cast< uint64_t >(xpct * xcount + 0.5);
+    if (xrank < 1)      xrank = 1;
+    if (xrank > xcount) xrank = xcount;
 
-        // constructor/destructor
-    public:
-        x_subinvoke_t(x_mfunc_t && xfunc, x_tuple_t && xargs)
-            : m_xfunc(std::forward< x_mfunc_t >(xfunc))
-            , m_xargs(std::forward< x_tuple_t >(xargs))
+    uint64_t xsum_count = 0;
+    for (size_t xiter = 0; xiter < xbucket.size(); ++xiter)
+    {
+        xsum_count += xbucket[xiter];
+        if (xsum_count >= xrank)
         {
-
+            return std::min(xmsg_histogram_t::bucket_upper(xiter), xmax);
         }
+    }
 
-        // extensible interfaces
-    public:
-        /**********************************************************/
-        /**
-         * @brief 订阅者类型。
-         * @note 所有 x_subinvoke_t 的订阅者类型都大于 0x80000000。
-         */
-        virtual xsub_type_t sub_type(void) const override
-        {
-            return sub_type_value;
-        }
+    return xmax;
+}
 
-        /**********************************************************/
-        /**
-         * @brief 订阅消息的分派接口。
-         */
-        virtual void translate(const x_msgctxt_t & xmsg_ctxt) override
+/**
+ * @class xmsg_histogram_stripes_t
+ * @brief 按线程划分条带的直方图（用于订阅者消息处理接口的耗时）。
+ * @note
+ * 每个线程按 xmsg_stats_thread_t::index() 写入各自的直方图（首次写入时创建），
+ * 因此不会有多个线程争用同一组计数值；snapshot() 时合并各个条带。
+ */
+class xmsg_histogram_stripes_t
+{
+    // constructor/destructor
+public:
+    xmsg_histogram_stripes_t(void)
+    {
+        for (size_t xiter = 0; xiter <= XMSG_STATS_THREADS; ++xiter)
         {
-            using x_indices_args_t =
-                typename xbuild_index_sequence_t<
-                    std::tuple_size<
-                        typename x_msgctxt_t::x_args_t >::value >::type;
-
-            using x_indices_invk_t =
-                typename xbuild_index_sequence_t<
-                    std::tuple_size< x_tuple_t >::value >::type;
-
-            sub_invoke(xmsg_ctxt.args(), x_indices_args_t(), x_indices_invk_t());
+            m_xstripe[xiter].store(nullptr, std::memory_order_relaxed);
         }
+    }
 
-        // inner invoking
-    private:
-        /**********************************************************/
-        /**
-         * @brief 调用消息处理接口。
-         */
-        template< typename __args_t,
-                  size_t... __indexes_args,
-                  size_t... __indexes_invk >
-        void sub_invoke(const __args_t & xargs,
-                        xindex_sequence_t< __indexes_args... >,
-                        xindex_sequence_t< __indexes_invk... >)
+    ~xmsg_histogram_stripes_t(void)
+    {
+        for (size_t xiter = 0; xiter <= XMSG_STATS_THREADS; ++xiter)
         {
-#if __cplusplus >= 201703L
-            std::invoke(std::forward< __mfunc_t >(m_xfunc),
-                        std::get< __indexes_invk >(m_xargs)...,
-                        std::get< __indexes_args >(xargs)...);
-#else // !(__cplusplus >= 201703L)
-            auto xinvoker = std::bind(std::forward< __mfunc_t >(m_xfunc),
-                                      std::get< __indexes_invk >(m_xargs)...,
-                                      std::get< __indexes_args >(xargs)...);
-            xinvoker();
-#endif // __cplusplus >= 201703L
+            delete m_xstripe[xiter].load(std::memory_order_relaxed);
         }
+    }
 
-        // data members
-    private:
-        x_mfunc_t  m_xfunc; ///< 消息处理接口
-        x_tuple_t  m_xargs; ///< 回调的参数元组
-    };
+    xmsg_histogram_stripes_t(xmsg_histogram_stripes_t && xobject) = delete;
+    xmsg_histogram_stripes_t & operator=(xmsg_histogram_stripes_t && xobject) = delete;
+    xmsg_histogram_stripes_t(const xmsg_histogram_stripes_t & xobject) = delete;
+    xmsg_histogram_stripes_t & operator=(const xmsg_histogram_stripes_t & xobject) = delete;
 
+    // public interfaces
+public:
+    /**********************************************************/
     /**
-     * @class x_subptr_t
-     * @brief 订阅者对象使用的智能指针类。
+     * @brief 在当前线程的条带中记录一个数值。
      */
-    class x_subptr_t : public x_subsptr_t
+    inline void record(uint64_t xvalue)
     {
-        // common data types
-    public:
-        /**
-         * @struct x_hash_t
-         * @brief 用于计算 哈希键值 的仿函数结构体类型。
-         */
-        struct x_hash_t
-        {
-        public:
-            typedef x_subptr_t argument_type;
-            typedef size_t result_type;
+        const size_t xindex = xmsg_stats_thread_t::index();
+        stripe(xindex).record(xvalue, XMSG_STATS_THREADS == xindex);
+    }
 
-            size_t operator()(const x_subptr_t & xsub_ptr) const
+    /**********************************************************/
+    /**
+     * @brief 获取合并各个条带之后的快照。
+     */
+    xmsg_histogram_snapshot_t snapshot(void) const
+    {
+        xmsg_histogram_snapshot_t xsnapshot;
+
+        for (size_t xiter = 0; xiter <= XMSG_STATS_THREADS; ++xiter)
+        {
+            const xmsg_histogram_t * xstripe = m_xstripe[xiter].load(std::memory_order_acquire);
+            if (nullptr != xstripe)
             {
-                return m_xfunctor(xsub_ptr.get());
+                xsnapshot += xstripe->snapshot();
             }
+        }
 
-        private:
-            std::hash< x_subscriber_t * > m_xfunctor; ///< 仿函数操作实现的对象
-        };
+        return xsnapshot;
+    }
 
-        /**
-         * @struct x_equal_t
-         * @brief 判断相等的仿函数结构体类型。
-         */
-        struct x_equal_t
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 线程序号 xindex 的条带（首次使用时创建）。
+     */
+    xmsg_histogram_t & stripe(size_t xindex)
+    {
+        xmsg_histogram_t * xstripe = m_xstripe[xindex].load(std::memory_order_acquire);
+        if (nullptr == xstripe)
         {
-        public:
-            typedef x_subptr_t first_argument_type;
-            typedef x_subptr_t second_argument_type;
-            typedef bool result_type;
-
-            bool operator()(const x_subptr_t & xsub_lptr,
-                            const x_subptr_t & xsub_rptr) const
+            // 只有共用的条带才可能被多个线程同时创建
+            xmsg_histogram_t * xstripe_new = new xmsg_histogram_t();
+            if (m_xstripe[xindex].compare_exchange_strong(xstripe,
+                                                          xstripe_new,
+                                                          std::memory_order_acq_rel,
+                                                          std::memory_order_acquire))
             {
-                return (xsub_lptr.get() == xsub_rptr.get());
+                xstripe = xstripe_new;
             }
-        };
+            else
+            {
+                delete xstripe_new;
+            }
+        }
 
-    private:
-        using x_super_t = x_subsptr_t;
+        return *xstripe;
+    }
+
+    // data members
+private:
+    std::atomic< xmsg_histogram_t * > m_xstripe[XMSG_STATS_THREADS + 1]; ///< 各个线程的条带
+};
+
+/**
+ * @struct xmsg_stats_snapshot_t< __mkey_t >
+ * @brief xmsg_publisher_t::stats() 返回的统计快照。
+ */
+template< typename __mkey_t >
+struct xmsg_stats_snapshot_t
+{
+    using x_mkey_t  = __mkey_t;
+    using x_keyed_t = std::pair< x_mkey_t, xmsg_stats_counters_t >;
+
+    xmsg_stats_counters_t     xtotal;     ///< 全局计数器
+    std::vector< x_keyed_t >  xkeys;      ///< 各个消息索引键的计数器
+    xmsg_histogram_snapshot_t xresidency; ///< 消息在队列中的驻留耗时（纳秒，publish 到 dispatch）
+};
+
+#endif // XMSG_ENABLE_STATS
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_context_t
+
+/**
+ * @struct xmsg_mkey_t< __mkey_t >
+ * @brief  用于消息索引键类型声明。
+ */
+template< typename __mkey_t,
+          typename __equal_t = std::equal_to< __mkey_t >,
+          typename __hasher_t = std::hash< __mkey_t > >
+struct xmsg_mkey_t
+{
+    typedef typename std::decay< __mkey_t >::type type;
+    typedef __equal_t x_equal_t;
+    typedef __hasher_t x_hash_t;
+};
+
+/**
+ * @struct xmsg_args_t< __args_t... >
+ * @brief  用于消息参数列表类型声明。
+ */
+template< typename... __args_t >
+struct xmsg_args_t
+{
+    typedef typename std::tuple<
+                typename std::decay< __args_t >::type... > type;
+};
+
+/**
+ * @struct xmsg_args_payload_t< __msg_args_t >
+ * @brief 消息参数列表在消息对象中的存储类型：若消息参数列表声明类型定义了
+ *        x_payload_t（如 xmsg_shared_args_t），则使用之；否则直接存储参数元组。
+ * @note
+ * 自定义的存储类型须提供 get() 接口返回参数元组的常量引用，
+ * 以及 XTHREAD_SAFE 常量（其 拷贝/析构 操作能否在多个线程中并发执行）。
+ */
+template< typename __msg_args_t, typename = void >
+struct xmsg_args_payload_t
+{
+    using type     = typename __msg_args_t::type;
+    using x_args_t = typename __msg_args_t::type;
+
+    static constexpr bool XTHREAD_SAFE = true;
+
+    static inline const x_args_t & get(const type & xpayload) { return xpayload; }
+};
+
+template< typename __msg_args_t >
+struct xmsg_args_payload_t< __msg_args_t,
+                            typename std::conditional<
+                                true,
+                                void,
+                                typename __msg_args_t::x_payload_t >::type >
+{
+    using type     = typename __msg_args_t::x_payload_t;
+    using x_args_t = typename __msg_args_t::type;
+
+    static constexpr bool XTHREAD_SAFE = type::XTHREAD_SAFE;
+
+    static inline const x_args_t & get(const type & xpayload) { return xpayload.get(); }
+};
+
+/**
+ * @struct xmsg_args_check_t< __msg_ctxt_t, __args_t... >
+ * @brief 判断 publish(xmkey, xargs...) 的参数能否构造消息对象：
+ *        参数数量与参数列表一致，或者只有一个参数且为消息参数的存储类型
+ *        （如 直接发布已有的共享参数对象）。
+ */
+template< typename __msg_ctxt_t, typename... __args_t >
+struct xmsg_args_check_t
+    : std::integral_constant<
+            bool,
+            std::tuple_size< typename __msg_ctxt_t::x_args_t >::value ==
+                sizeof...(__args_t) >
+{
+};
+
+template< typename __msg_ctxt_t, typename __arg_t >
+struct xmsg_args_check_t< __msg_ctxt_t, __arg_t >
+    : std::integral_constant<
+            bool,
+            (std::tuple_size< typename __msg_ctxt_t::x_args_t >::value == 1) ||
+            std::is_same< typename std::decay< __arg_t >::type,
+                          typename __msg_ctxt_t::x_payload_t >::value >
+{
+};
+
+/**
+ * @class xmsg_context_t< __msg_mkey_t, __msg_args_t... >
+ * @brief 发布订阅模式使用的消息模板类。
+ * 
+ * @param [in ] __msg_mkey_t : 消息索引键值（使用 xmsg_mkey_t 构建）。
+ * @param [in ] __msg_args_t : 消息参数列表（使用 xmsg_args_t 或 xmsg_shared_args_t 构建）。
+ */
+template< typename __msg_mkey_t, typename __msg_args_t >
+class xmsg_context_t
+{
+    // common data types
+public:
+    typedef __msg_mkey_t xmsg_mkey_t;
+    typedef __msg_args_t xmsg_args_t;
+
+    using x_mkey_t = typename xmsg_mkey_t::type;
+    using x_args_t = typename xmsg_args_t::type;
+
+    /** 消息参数列表的存储类型（默认为参数元组自身） */
+    using x_payload_traits_t = xmsg_args_payload_t< xmsg_args_t >;
+    using x_payload_t        = typename x_payload_traits_t::type;
+
+    // constructor/destructor
+public:
+    explicit xmsg_context_t(void)
+        : m_mkey()
+        , m_args()
+    {
+
+    }
+
+    explicit xmsg_context_t(const x_mkey_t & xmkey, const x_args_t & xargs)
+        : m_mkey(xmkey)
+        , m_args(xargs)
+    {
+
+    }
+
+    explicit xmsg_context_t(const x_mkey_t & xmkey, x_args_t && xargs)
+        : m_mkey(xmkey)
+        , m_args(std::forward< x_args_t >(xargs))
+    {
+
+    }
+
+    template< typename... __vargs_t >
+    explicit constexpr xmsg_context_t(const x_mkey_t & xmkey, __vargs_t &&... xargs)
+        : m_mkey(xmkey)
+        , m_args(std::forward< __vargs_t >(xargs)...)
+    {
+
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 使用分配器构造消息参数列表（std::tuple 的 uses-allocator 构造：
+     *        参数类型支持该分配器时，如 xmsg_arena_string_t，才会使用之）。
+     * @note 要求消息参数列表直接存储参数元组（xmsg_args_t）。
+     */
+    template< typename __alloc_t, typename... __vargs_t >
+    xmsg_context_t(std::allocator_arg_t,
+                   const __alloc_t & xalloc,
+                   const x_mkey_t & xmkey,
+                   __vargs_t &&... xargs)
+        : m_mkey(xmkey)
+        , m_args(std::allocator_arg, xalloc, std::forward< __vargs_t >(xargs)...)
+    {
+
+    }
+
+    template< typename __alloc_t >
+    xmsg_context_t(std::allocator_arg_t,
+                   const __alloc_t & xalloc,
+                   const xmsg_context_t & xobject)
+        : m_mkey(xobject.m_mkey)
+        , m_args(std::allocator_arg, xalloc, xobject.m_args)
+#if XMSG_ENABLE_STATS
+        , m_xtstamp(xobject.m_xtstamp)
+#endif // XMSG_ENABLE_STATS
+    {
+
+    }
+
+    template< typename __alloc_t >
+    xmsg_context_t(std::allocator_arg_t,
+                   const __alloc_t & xalloc,
+                   xmsg_context_t && xobject)
+        : m_mkey(std::move(xobject.m_mkey))
+        , m_args(std::allocator_arg, xalloc, std::move(xobject.m_args))
+#if XMSG_ENABLE_STATS
+        , m_xtstamp(xobject.m_xtstamp)
+#endif // XMSG_ENABLE_STATS
+    {
+
+    }
+
+    xmsg_context_t(xmsg_context_t && xobject) noexcept
+        : m_mkey(std::move(xobject.m_mkey))
+        , m_args(std::move(xobject.m_args))
+#if XMSG_ENABLE_STATS
+        , m_xtstamp(xobject.m_xtstamp)
+#endif // XMSG_ENABLE_STATS
+    {
+
+    }
+
+    xmsg_context_t & operator = (xmsg_context_t && xobject) noexcept
+    {
+        if (this == &xobject)
+            return *this;
+
+        this->m_mkey = std::move(xobject.m_mkey);
+        this->m_args = std::move(xobject.m_args);
+#if XMSG_ENABLE_STATS
+        this->m_xtstamp = xobject.m_xtstamp;
+#endif // XMSG_ENABLE_STATS
+
+        return *this;
+    }
+
+    xmsg_context_t(const xmsg_context_t & xobject)
+        : m_mkey(xobject.m_mkey)
+        , m_args(xobject.m_args)
+#if XMSG_ENABLE_STATS
+        , m_xtstamp(xobject.m_xtstamp)
+#endif // XMSG_ENABLE_STATS
+    {
+
+    }
+
+    xmsg_context_t & operator = (const xmsg_context_t & xobject)
+    {
+        if (this == &xobject)
+            return *this;
+
+        this->m_mkey = xobject.m_mkey;
+        this->m_args = xobject.m_args;
+#if XMSG_ENABLE_STATS
+        this->m_xtstamp = xobject.m_xtstamp;
+#endif // XMSG_ENABLE_STATS
+
+        return *this;
+    }
+
+    ~xmsg_context_t(void)
+    {
+
+    }
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 消息索引键值。
+     */
+    inline const x_mkey_t & mkey(void) const { return m_mkey; }
+
+    /**********************************************************/
+    /**
+     * @brief 消息参数列表。
+     */
+    inline const x_args_t & args(void) const
+    {
+        return x_payload_traits_t::get(m_args);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 消息参数列表（存储类型为参数元组自身时，才可修改）。
+     */
+    template< typename __payload_t = x_payload_t >
+    inline typename std::enable_if<
+                std::is_same< __payload_t, x_args_t >::value,
+                x_args_t & >::type args(void)
+    {
+        return m_args;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 消息参数列表的存储对象（如 xmsg_shared_args_t 的共享参数对象，
+     *        可用于将同一份参数再次发布到其他消息键）。
+     */
+    inline const x_payload_t & payload(void) const { return m_args; }
+
+#if XMSG_ENABLE_STATS
+    /**********************************************************/
+    /**
+     * @brief 消息的发布时间戳（纳秒，xmsg_stats_now() 的时间基准）。
+     */
+    inline uint64_t tstamp(void) const { return m_xtstamp.xvalue; }
+
+    /**********************************************************/
+    /**
+     * @brief 重新记录消息的发布时间戳（消息入队前调用）。
+     */
+    inline void stamp(uint64_t xtstamp) { m_xtstamp.xvalue = xtstamp; }
+#endif // XMSG_ENABLE_STATS
+
+    // data members
+private:
+    x_mkey_t    m_mkey;  ///< 消息索引键值
+    x_payload_t m_args;  ///< 消息参数列表
+#if XMSG_ENABLE_STATS
+    xmsg_stats_tstamp_t m_xtstamp; ///< 消息的发布时间戳（入队时记录）
+#endif // XMSG_ENABLE_STATS
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_subscriber_t
+
+typedef size_t   xsub_type_t;
+
+/** 
+ * @brief 定义 订阅者基类的类型标识值。
+ */
+static constexpr xsub_type_t
+            XSUBER_BASE_TYPE = (xsub_type_t)(((xsub_type_t)-1) / 2);
+
+/**
+ * @class xmsg_subscriber_t< __msg_ctxt_t, __sub_type >
+ * @brief 发布订阅模式使用的订阅者模板类。
+ * 
+ * @param [in ] __sub_type   : 订阅者类型标识。
+ * @param [in ] __msg_ctxt_t : 消息类型。
+ */
+template< xsub_type_t __sub_type, typename __msg_ctxt_t >
+class xmsg_subscriber_t;
+
+/**
+ * @class xmsg_subscriber_t< __msg_ctxt_t, __sub_type >
+ * @brief 发布订阅模式使用的订阅者模板类。
+ * 
+ * @param [in ] __sub_type   : 订阅者类型标识。
+ * @param [in ] __msg_ctxt_t : 消息类型。
+ */
+template< typename __msg_ctxt_t >
+class xmsg_subscriber_t< XSUBER_BASE_TYPE, __msg_ctxt_t >
+{
+    // common data types
+public:
+    using x_msgctxt_t = __msg_ctxt_t;
+
+    /**
+     * @brief 消息投递的调用接口（thunk）类型。
+     * @note
+     * 投递消息时，直接通过该函数指针调用，而不经过虚函数表；
+     * 默认的调用接口转而调用虚函数 translate()。
+     */
+    using x_thunk_t = void (*)(xmsg_subscriber_t *, const x_msgctxt_t &);
+
+    // constructor/destructor
+public:
+#if XMSG_ENABLE_STATS
+    xmsg_subscriber_t(void) : m_xthunk(&translate_thunk), m_xhstats(nullptr) { }
+    virtual ~xmsg_subscriber_t(void) { delete m_xhstats.load(); }
+
+    /**
+     * @brief 拷贝订阅者对象时，不拷贝其消息处理耗时的统计数据。
+     */
+    xmsg_subscriber_t(const xmsg_subscriber_t & xobject)
+        : m_xthunk(xobject.m_xthunk)
+        , m_xhstats(nullptr)
+    {
+
+    }
+
+    xmsg_subscriber_t & operator = (const xmsg_subscriber_t & xobject)
+    {
+        m_xthunk = xobject.m_xthunk;
+        return *this;
+    }
+
+protected:
+    explicit xmsg_subscriber_t(x_thunk_t xthunk) : m_xthunk(xthunk), m_xhstats(nullptr) { }
+#else // !XMSG_ENABLE_STATS
+    xmsg_subscriber_t(void) : m_xthunk(&translate_thunk) { }
+    virtual ~xmsg_subscriber_t(void) { }
+
+protected:
+    explicit xmsg_subscriber_t(x_thunk_t xthunk) : m_xthunk(xthunk) { }
+#endif // XMSG_ENABLE_STATS
+
+    // extensible interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 订阅者类型。
+     */
+    virtual xsub_type_t sub_type(void) const
+    {
+        return XSUBER_BASE_TYPE;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 订阅消息的分派接口。
+     */
+    virtual void translate(const x_msgctxt_t & xmsg_ctxt)
+    {
+#if 0
+        using x_mkey_t = typename x_msgctxt_t::x_mkey_t;
+        using x_args_t = typename x_msgctxt_t::x_args_t;
+        using x_indices_t =
+            typename xbuild_index_sequence_t<
+                std::tuple_size< x_args_t >::value >::type;
+
+        invoke_mfunc(xmsg_ctxt.args(), x_indices_t());
+#endif
+    }
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 消息投递的调用接口。
+     */
+    inline x_thunk_t thunk(void) const { return m_xthunk; }
+
+    /**********************************************************/
+    /**
+     * @brief 投递消息（经由调用接口 thunk() 进行调用）。
+     */
+    inline void invoke(const x_msgctxt_t & xmsg_ctxt)
+    {
+        invoke(m_xthunk, this, xmsg_ctxt);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 经由调用接口 xthunk 向订阅者对象 xthis 投递消息
+     *        （启用统计时，按 XMSG_STATS_SAMPLE 抽样记录消息处理接口的耗时）。
+     * @note
+     * 启用统计时，调用方须保证 xthis 在消息处理接口返回后仍然有效。
+     */
+    static inline void invoke(x_thunk_t xthunk,
+                              xmsg_subscriber_t * xthis,
+                              const x_msgctxt_t & xmsg_ctxt)
+    {
+#if XMSG_ENABLE_STATS
+        if (xmsg_stats_sampled())
+        {
+            invoke_timed(xthunk, xthis, xmsg_ctxt);
+            return;
+        }
+#endif // XMSG_ENABLE_STATS
+
+        xthunk(xthis, xmsg_ctxt);
+    }
+
+#if XMSG_ENABLE_STATS
+    /**********************************************************/
+    /**
+     * @brief 投递消息，并记录消息处理接口的耗时。
+     * @note
+     * 在调用前后各读取一次时钟，因此不经过 xmsg_publisher_t 投递的调用
+     * （如 日志回放、xmsg_concurrent_publisher_t）同样记录准确的耗时。
+     */
+    static inline void invoke_timed(x_thunk_t xthunk,
+                                    xmsg_subscriber_t * xthis,
+                                    const x_msgctxt_t & xmsg_ctxt)
+    {
+        const uint64_t xtm_beg = xmsg_stats_now();
+        xthunk(xthis, xmsg_ctxt);
+        const uint64_t xtm_end = xmsg_stats_now();
+        xthis->handler_histogram().record(xtm_end - xtm_beg);
+    }
+#endif // XMSG_ENABLE_STATS
+
+#if XMSG_ENABLE_STATS
+    /**********************************************************/
+    /**
+     * @brief 消息处理接口耗时（纳秒）的统计快照（只含抽样计时的调用）。
+     */
+    xmsg_histogram_snapshot_t handler_stats(void) const
+    {
+        const xmsg_histogram_stripes_t * xhstats = m_xhstats.load(std::memory_order_acquire);
+        return (nullptr != xhstats) ? xhstats->snapshot() : xmsg_histogram_snapshot_t();
+    }
+
+private:
+    /**********************************************************/
+    /**
+     * @brief 消息处理接口耗时的直方图（首次计时时才创建）。
+     */
+    xmsg_histogram_stripes_t & handler_histogram(void)
+    {
+        xmsg_histogram_stripes_t * xhstats = m_xhstats.load(std::memory_order_acquire);
+        if (nullptr == xhstats)
+        {
+            xmsg_histogram_stripes_t * xhstats_new = new xmsg_histogram_stripes_t();
+            if (m_xhstats.compare_exchange_strong(xhstats,
+                                                  xhstats_new,
+                                                  std::memory_order_acq_rel,
+                                                  std::memory_order_acquire))
+            {
+                xhstats = xhstats_new;
+            }
+            else
+            {
+                delete xhstats_new;
+            }
+        }
+
+        return *xhstats;
+    }
+#endif // XMSG_ENABLE_STATS
+
+private:
+    /**********************************************************/
+    /**
+     * @brief 默认的调用接口：转而调用虚函数 translate() 。
+     */
+    static void translate_thunk(xmsg_subscriber_t * xthis,
+                                const x_msgctxt_t & xmsg_ctxt)
+    {
+        xthis->translate(xmsg_ctxt);
+    }
+
+public:
+#if 0
+    /**********************************************************/
+    /**
+     * @brief 调用消息处理接口。
+     */
+    template< typename __tuple_t, size_t... __indexes >
+    void invoke_mfunc(const __tuple_t & xargs,
+                      xindex_sequence_t< __indexes... >)
+    {
+        // 下面中的 x_subclass_t 为派生的子类。
+        using x_mfunc_t = typename void (x_subclass_t::*)(
+                            const std::tuple_element< __indexes,
+                                                    __tuple_t >::type & ...);
+
+        (static_cast< x_subclass_t * >(this)->*(x_mfunc_t))(
+                                            std::get< __indexes >(xargs)...);
+    }
+#endif
+
+    // data members
+private:
+    x_thunk_t m_xthunk;  ///< 消息投递的调用接口
+#if XMSG_ENABLE_STATS
+    std::atomic< xmsg_histogram_stripes_t * >
+              m_xhstats; ///< 消息处理接口耗时的直方图
+#endif // XMSG_ENABLE_STATS
+};
+
+/**
+ * @class xmsg_subscriber_t< __msg_ctxt_t, __sub_type >
+ * @brief 用户自定义（重载）订阅者类 所使用的模板基类。
+ * @note
+ * 该模板类用于用户自定义（重载）订阅者类。
+ * 强制要求（__sub_type < 0x80000000），主要是为了区别于
+ * xmsg_publisher_t 内部的 x_subinvoke_t 订阅者类型。
+ * 
+ * @param [in ] __sub_type   : 订阅者类型标识。
+ * @param [in ] __msg_ctxt_t : 消息类型。
+ */
+template< xsub_type_t __sub_type, typename __msg_ctxt_t >
+class xmsg_subscriber_t
+    : public xmsg_subscriber_t< XSUBER_BASE_TYPE, __msg_ctxt_t >
+{
+    static_assert(__sub_type < XSUBER_BASE_TYPE,
+                 "__sub_type < XSUBER_BASE_TYPE");
+
+    // common data types
+public:
+    using x_msgctxt_t = __msg_ctxt_t;
+
+    // constructor/destructor
+public:
+    xmsg_subscriber_t(void) { }
+    virtual ~xmsg_subscriber_t(void) { }
+
+    // extensible interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 订阅者类型。
+     * @note 用户自定义的订阅者类型都 小于 XSUBER_BASE_TYPE 。
+     */
+    virtual xsub_type_t sub_type(void) const override
+    {
+        return __sub_type;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_slab_pool_t / xmsg_slab_allocator_t
+
+/**
+ * @brief 由 xmsg_slab_allocator_t 分配的对象，小于等于该字节数时，
+ *        使用 xmsg_slab_pool_t 的内存块；否则直接从堆中分配。
+ */
+#ifndef XMSG_SLAB_MAX_SIZE
+#define XMSG_SLAB_MAX_SIZE 1024
+#endif // XMSG_SLAB_MAX_SIZE
+
+/**
+ * @brief 是否维护 xmsg_slab_stat_t 的内存分配计数器
+ *        （默认关闭，避免每次 分配/回收 都操作全局的原子变量）。
+ */
+#ifndef XMSG_SLAB_STATS
+#define XMSG_SLAB_STATS 0
+#endif // XMSG_SLAB_STATS
+
+/**
+ * @struct xmsg_slab_stat_t
+ * @brief xmsg_slab_allocator_t 的内存分配计数器（用于统计与验证）。
+ * @note 仅在 XMSG_SLAB_STATS 非 0 时计数，否则各个计数器始终为 0 。
+ */
+struct xmsg_slab_stat_t
+{
+    std::atomic_size_t xheap_alloc; ///< 从堆中分配内存的次数（包括 内存块组 与 超大对象）
+    std::atomic_size_t xheap_free;  ///< 释放到堆中的次数（超大对象）
+    std::atomic_size_t xslab_alloc; ///< 从内存池中分配内存块的次数
+    std::atomic_size_t xslab_free;  ///< 回收到内存池中的内存块次数
+};
+
+/**********************************************************/
+/**
+ * @brief 返回全局的 xmsg_slab_stat_t 计数器对象。
+ */
+inline xmsg_slab_stat_t & xmsg_slab_stat(void)
+{
+    static xmsg_slab_stat_t xslab_stat = { { 0 }, { 0 }, { 0 }, { 0 } };
+    return xslab_stat;
+}
+
+/**
+ * @class xmsg_slab_pool_t< __block_size >
+ * @brief 固定大小内存块的内存池。
+ * @note
+ * 1. 每个线程持有一个本地的空闲链表缓存，分配与回收操作通常不需要加锁；
+ *    本地缓存为空（或者过多）时，才会与全局的空闲链表批量交换内存块；
+ * 2. 全局的空闲链表为空时，一次从堆中分配一组内存块；
+ * 3. 内存块一经分配，就不会再归还给堆（订阅者对象的控制块可能被
+ *    x_subkey_t 中的 weak_ptr 持有至程序退出，内存池不能先于其销毁）；
+ * 4. 线程本地缓存析构后（如其他 thread_local 对象的析构流程中），
+ *    该线程的分配与回收操作直接使用全局的空闲链表。
+ * 
+ * @param [in ] __block_size : 内存块的大小。
+ */
+template< size_t __block_size >
+class xmsg_slab_pool_t
+{
+    // common data types
+private:
+    /**
+     * @union x_block_t
+     * @brief 内存块。
+     */
+    union x_block_t
+    {
+        x_block_t * xnext;                ///< 空闲链表中的下一个内存块
+        char   xdata[__block_size];       ///< 内存块数据
+        std::max_align_t xalign;          ///< 对齐方式
+    };
+
+    /** 每次从堆中分配的内存块数量 */
+    static constexpr size_t XCHUNK_BLOCKS = 64;
+
+    /** 线程本地缓存的内存块数量上限 */
+    static constexpr size_t XCACHE_BLOCKS = 128;
+
+    /**
+     * @struct x_global_t
+     * @brief 全局的空闲链表。
+     */
+    struct x_global_t
+    {
+        std::mutex  xmutex; ///< 同步操作的互斥锁
+        x_block_t * xfree;  ///< 空闲链表
+    };
+
+    /**
+     * @struct x_cache_t
+     * @brief 线程本地的空闲链表缓存。
+     */
+    struct x_cache_t
+    {
+        x_block_t * xfree;  ///< 空闲链表
+        size_t      xsize;  ///< 空闲链表的内存块数量
+
+        x_cache_t(void) : xfree(nullptr), xsize(0) { }
+
+        ~x_cache_t(void)
+        {
+            // 线程退出时，将缓存的内存块全部归还到全局的空闲链表，
+            // 此后该线程不再访问本地缓存
+            give_back(*this, xsize);
+            destroyed() = true;
+        }
+    };
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 分配一个内存块。
+     */
+    static void * alloc(void)
+    {
+#if XMSG_SLAB_STATS
+        xmsg_slab_stat().xslab_alloc.fetch_add(1, std::memory_order_relaxed);
+#endif // XMSG_SLAB_STATS
+
+        x_cache_t * xcache = cache();
+        if (nullptr == xcache)
+        {
+            return alloc_global();
+        }
+
+        if (nullptr == xcache->xfree)
+        {
+            refill(*xcache);
+        }
+
+        x_block_t * xblock = xcache->xfree;
+        xcache->xfree  = xblock->xnext;
+        xcache->xsize -= 1;
+
+        return xblock;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 回收一个内存块。
+     */
+    static void free(void * xblock_ptr)
+    {
+#if XMSG_SLAB_STATS
+        xmsg_slab_stat().xslab_free.fetch_add(1, std::memory_order_relaxed);
+#endif // XMSG_SLAB_STATS
+
+        x_block_t * xblock = static_cast< x_block_t * >(xblock_ptr);
+
+        x_cache_t * xcache = cache();
+        if (nullptr == xcache)
+        {
+            free_global(xblock);
+            return;
+        }
+
+        xblock->xnext  = xcache->xfree;
+        xcache->xfree  = xblock;
+        xcache->xsize += 1;
+
+        if (xcache->xsize > XCACHE_BLOCKS)
+        {
+            give_back(*xcache, XCACHE_BLOCKS / 2);
+        }
+    }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 全局的空闲链表（有意不析构，见类的说明）。
+     */
+    static x_global_t & global(void)
+    {
+        static x_global_t * xglobal = new x_global_t{ {}, nullptr };
+        return *xglobal;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 线程本地缓存是否已经析构
+     *        （平凡类型的 thread_local 变量，在线程退出的全过程中都可访问）。
+     */
+    static bool & destroyed(void)
+    {
+        static thread_local bool xdestroyed = false;
+        return xdestroyed;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 线程本地的空闲链表缓存；已经析构时，返回 nullptr 。
+     */
+    static x_cache_t * cache(void)
+    {
+        if (destroyed())
+        {
+            return nullptr;
+        }
+
+        static thread_local x_cache_t xcache;
+        return &xcache;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 从堆中分配一组内存块，并串成空闲链表（返回链表头）。
+     */
+    static x_block_t * new_chunk(void)
+    {
+        x_block_t * xchunk = static_cast< x_block_t * >(
+                        ::operator new(XCHUNK_BLOCKS * sizeof(x_block_t)));
+#if XMSG_SLAB_STATS
+        xmsg_slab_stat().xheap_alloc.fetch_add(1, std::memory_order_relaxed);
+#endif // XMSG_SLAB_STATS
+
+        for (size_t xiter = 0; xiter < XCHUNK_BLOCKS - 1; ++xiter)
+        {
+            xchunk[xiter].xnext = &xchunk[xiter + 1];
+        }
+        xchunk[XCHUNK_BLOCKS - 1].xnext = nullptr;
+
+        return xchunk;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 不经过本地缓存，直接从全局的空闲链表中分配一个内存块。
+     */
+    static void * alloc_global(void)
+    {
+        x_global_t & xglobal = global();
+        std::lock_guard< std::mutex > xautolock(xglobal.xmutex);
+
+        if (nullptr == xglobal.xfree)
+        {
+            xglobal.xfree = new_chunk();
+        }
+
+        x_block_t * xblock = xglobal.xfree;
+        xglobal.xfree = xblock->xnext;
+        return xblock;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 不经过本地缓存，直接将内存块回收到全局的空闲链表。
+     */
+    static void free_global(x_block_t * xblock)
+    {
+        x_global_t & xglobal = global();
+        std::lock_guard< std::mutex > xautolock(xglobal.xmutex);
+
+        xblock->xnext = xglobal.xfree;
+        xglobal.xfree = xblock;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 从全局的空闲链表（或者堆）中批量获取内存块，填充本地缓存。
+     */
+    static void refill(x_cache_t & xcache)
+    {
+        x_global_t & xglobal = global();
+
+        {
+            std::lock_guard< std::mutex > xautolock(xglobal.xmutex);
+            while ((nullptr != xglobal.xfree) && (xcache.xsize < XCACHE_BLOCKS / 2))
+            {
+                x_block_t * xblock = xglobal.xfree;
+                xglobal.xfree = xblock->xnext;
+                xblock->xnext = xcache.xfree;
+                xcache.xfree  = xblock;
+                xcache.xsize += 1;
+            }
+        }
+
+        if (nullptr != xcache.xfree)
+        {
+            return;
+        }
+
+        xcache.xfree  = new_chunk();
+        xcache.xsize += XCHUNK_BLOCKS;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将本地缓存中的 xcount 个内存块归还到全局的空闲链表。
+     */
+    static void give_back(x_cache_t & xcache, size_t xcount)
+    {
+        if ((0 == xcount) || (nullptr == xcache.xfree))
+        {
+            return;
+        }
+
+        x_block_t * xhead = xcache.xfree;
+        x_block_t * xtail = xhead;
+        for (size_t xiter = 1; (xiter < xcount) && (nullptr != xtail->xnext); ++xiter)
+        {
+            xtail = xtail->xnext;
+            xcache.xsize -= 1;
+        }
+
+        xcache.xfree  = xtail->xnext;
+        xcache.xsize -= 1;
+
+        x_global_t & xglobal = global();
+        std::lock_guard< std::mutex > xautolock(xglobal.xmutex);
+        xtail->xnext  = xglobal.xfree;
+        xglobal.xfree = xhead;
+    }
+};
+
+/**
+ * @class xmsg_slab_allocator_t< __value_t >
+ * @brief 使用 xmsg_slab_pool_t 的内存分配器（符合 C++11 的 Allocator 要求）。
+ * @note
+ * 单个对象（大小不超过 XMSG_SLAB_MAX_SIZE）从相应大小的内存池中分配，
+ * 数组 或 超大对象 则直接从堆中分配。
+ * 
+ * @param [in ] __value_t : 分配的对象类型。
+ */
+template< typename __value_t >
+class xmsg_slab_allocator_t
+{
+    // common data types
+public:
+    typedef __value_t value_type;
+
+    template< typename __other_t >
+    struct rebind
+    {
+        typedef xmsg_slab_allocator_t< __other_t > other;
+    };
+
+private:
+    /** 按 std::max_align_t 的对齐大小 取整后的内存块大小 */
+    static constexpr size_t XBLOCK_SIZE =
+        (sizeof(value_type) + alignof(std::max_align_t) - 1) /
+            alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    /** 是否使用内存池进行分配 */
+    static constexpr bool XUSE_SLAB =
+        (sizeof(value_type) <= XMSG_SLAB_MAX_SIZE) &&
+        (alignof(value_type) <= alignof(std::max_align_t));
+
+    using x_pool_t = xmsg_slab_pool_t< XBLOCK_SIZE >;
+
+    // constructor/destructor
+public:
+    xmsg_slab_allocator_t(void) noexcept { }
+
+    template< typename __other_t >
+    xmsg_slab_allocator_t(const xmsg_slab_allocator_t< __other_t > &) noexcept { }
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 分配 xcount 个对象的内存。
+     */
+    value_type * allocate(size_t xcount)
+    {
+        if (XUSE_SLAB && (1 == xcount))
+        {
+            return static_cast< value_type * >(x_pool_t::alloc());
+        }
+
+#if XMSG_SLAB_STATS
+        xmsg_slab_stat().xheap_alloc.fetch_add(1, std::memory_order_relaxed);
+#endif // XMSG_SLAB_STATS
+        return static_cast< value_type * >(
+                    ::operator new(xcount * sizeof(value_type)));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 释放 allocate() 分配的内存。
+     */
+    void deallocate(value_type * xvalue_ptr, size_t xcount)
+    {
+        if (XUSE_SLAB && (1 == xcount))
+        {
+            x_pool_t::free(xvalue_ptr);
+            return;
+        }
+
+#if XMSG_SLAB_STATS
+        xmsg_slab_stat().xheap_free.fetch_add(1, std::memory_order_relaxed);
+#endif // XMSG_SLAB_STATS
+        ::operator delete(xvalue_ptr);
+    }
+
+    template< typename __other_t >
+    inline bool operator == (const xmsg_slab_allocator_t< __other_t > &) const
+    {
+        return true;
+    }
+
+    template< typename __other_t >
+    inline bool operator != (const xmsg_slab_allocator_t< __other_t > &) const
+    {
+        return false;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_subset_hash_t / xmsg_subset_flat_t
+
+/**
+ * @class xmsg_subset_hash_t< __subptr_t >
+ * @brief 消息订阅者集合：基于 std::unordered_set 的实现（默认）。
+ * @note
+ * 作为 xmsg_publisher_t 的 __subset_t 模板参数使用，
+ * 其内部记录了当前正在投递操作的迭代器，以保证订阅者在消息处理接口中
+ * 取消订阅（包括自我取消订阅）时，投递操作仍可继续进行。
+ * 
+ * @param [in ] __subptr_t : 订阅者对象的智能指针类型。
+ */
+template< typename __subptr_t >
+class xmsg_subset_hash_t
+{
+    // common data types
+public:
+    using x_subptr_t = __subptr_t;
+    using x_suber_t  = typename x_subptr_t::element_type;
+
+private:
+    using x_subset_t = std::unordered_set<
+                                x_subptr_t,
+                                typename x_subptr_t::x_hash_t,
+                                typename x_subptr_t::x_equal_t,
+                                xmsg_slab_allocator_t< x_subptr_t > >;
+    using x_iterator_t = typename x_subset_t::iterator;
+
+    // constructor/destructor
+public:
+    xmsg_subset_hash_t(void)
+        : m_xiter(nullptr)
+        , m_xinvk(false)
+    {
+
+    }
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 订阅者数量。
+     */
+    inline size_t size(void) const { return m_xsubset.size(); }
+
+    /**********************************************************/
+    /**
+     * @brief 判断集合是否为空。
+     */
+    inline bool empty(void) const { return m_xsubset.empty(); }
+
+    /**********************************************************/
+    /**
+     * @brief 判断当前是否正在进行投递操作。
+     */
+    inline bool is_dispatching(void) const { return m_xinvk; }
+
+    /**********************************************************/
+    /**
+     * @brief 加入订阅者对象，若其已存在，则返回 false 。
+     */
+    bool insert(const x_subptr_t & xsub_optr)
+    {
+        return m_xsubset.insert(xsub_optr).second;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 移除订阅者对象，若其不存在，则返回 false 。
+     */
+    bool erase(x_suber_t * xsub_ptr)
+    {
+        // 若 移除的订阅者 为当前正在投递操作的 订阅者对象，
+        // 则需要同步递增 dispatch() 内部操作的 集合迭代器
+        if ((nullptr != m_xiter) && (xsub_ptr == (*m_xiter)->get()))
+        {
+            m_xsubset.erase((*m_xiter)++);
+            m_xiter = nullptr;
+            return true;
+        }
+
+        return (m_xsubset.erase(x_subptr_t(xsub_ptr, false)) > 0);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将消息投递给集合中的所有订阅者对象。
+     */
+    template< typename __msg_ctxt_t >
+    void dispatch(const __msg_ctxt_t & xmsg_ctxt)
+    {
+        x_iterator_t itsub;
+
+        m_xinvk = true;
+
+        for (itsub = m_xsubset.begin(); itsub != m_xsubset.end();)
+        {
+            m_xiter = &itsub;
+#if XMSG_ENABLE_STATS
+            if (xmsg_stats_sampled())
+            {
+                // 订阅者可能在消息处理接口中取消订阅（对象随之释放），
+                // 须持有其引用，直至记录完消息处理的耗时
+                x_subptr_t xsub_optr(*itsub);
+                x_suber_t::invoke_timed(xsub_optr->thunk(), xsub_optr.get(), xmsg_ctxt);
+            }
+            else
+            {
+                (*itsub)->thunk()(itsub->get(), xmsg_ctxt);
+            }
+#else // !XMSG_ENABLE_STATS
+            (*itsub)->invoke(xmsg_ctxt);
+#endif // XMSG_ENABLE_STATS
+
+            if (nullptr != m_xiter)
+            {
+                ++itsub;
+                m_xiter = nullptr;
+            }
+        }
+
+        m_xinvk = false;
+    }
+
+    // data members
+private:
+    x_subset_t     m_xsubset;  ///< 订阅者集合
+    x_iterator_t * m_xiter;    ///< 指向当前正在进行投递操作的迭代器
+    bool           m_xinvk;    ///< 标识当前是否正在进行投递操作
+};
+
+/**
+ * @class xmsg_subset_flat_t< __subptr_t >
+ * @brief 消息订阅者集合：基于连续内存数组（std::vector）的实现。
+ * @note
+ * 1. 作为 xmsg_publisher_t 的 __subset_t 模板参数使用；
+ * 2. 每个槽位直接保存订阅者对象的 指针 与 调用接口，投递时按下标线性遍历数组，
+ *    不再经过 哈希节点、shared_ptr 与 虚函数表 的多次间接寻址；
+ *    可调用对象本身并不内联存放在槽位中，仍位于订阅者对象（x_subinvoke_t）内：
+ *    订阅者对象是 x_subkey_t 取消订阅 与 用户自定义订阅者 的身份标识，
+ *    须独立于数组存在；其内存由 xmsg_slab_pool_t 分配，调用时只多一次间接寻址；
+ * 3. 投递期间取消订阅的槽位只标记为“墓碑”（指针置空），
+ *    订阅者对象也延迟到本次投递结束、压缩数组时才释放；
+ * 4. 投递期间新加入的订阅者，不会收到当前正在投递的消息；
+ * 5. 投递顺序与订阅顺序一致；代价是 erase() 与 用户自定义订阅者的 insert()
+ *    需要线性查找，为 O(n) 操作（x_subinvoke_t 订阅者的 insert() 为 O(1)）。
+ *    适用于投递远多于订阅变更的场景；订阅变更频繁 且 订阅者众多时，
+ *    应使用 xmsg_subset_hash_t 。
+ * 
+ * @param [in ] __subptr_t : 订阅者对象的智能指针类型。
+ */
+template< typename __subptr_t >
+class xmsg_subset_flat_t
+{
+    // common data types
+public:
+    using x_subptr_t = __subptr_t;
+    using x_suber_t  = typename x_subptr_t::element_type;
+
+private:
+    using x_thunk_t = typename x_suber_t::x_thunk_t;
+
+    /**
+     * @struct x_slot_t
+     * @brief 订阅者槽位。
+     */
+    struct x_slot_t
+    {
+        x_thunk_t    xthunk;    ///< 订阅者对象的调用接口（与对象指针相邻存放）
+        x_suber_t  * xsub_ptr;  ///< 订阅者对象（为 nullptr 时，表示该槽位为墓碑）
+        x_subptr_t   xsub_optr; ///< 持有订阅者对象的智能指针
+
+        x_slot_t(const x_subptr_t & xsub_optr)
+            : xthunk(xsub_optr->thunk())
+            , xsub_ptr(xsub_optr.get())
+            , xsub_optr(xsub_optr)
+        {
+
+        }
+    };
+
+    using x_slots_t = std::vector< x_slot_t >;
+
+    // constructor/destructor
+public:
+    xmsg_subset_flat_t(void)
+        : m_xcount(0)
+        , m_xtombs(0)
+        , m_xdepth(0)
+    {
+
+    }
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 订阅者数量。
+     */
+    inline size_t size(void) const { return m_xcount; }
+
+    /**********************************************************/
+    /**
+     * @brief 判断集合是否为空。
+     */
+    inline bool empty(void) const { return (0 == m_xcount); }
+
+    /**********************************************************/
+    /**
+     * @brief 判断当前是否正在进行投递操作。
+     */
+    inline bool is_dispatching(void) const { return (m_xdepth > 0); }
+
+    /**********************************************************/
+    /**
+     * @brief 加入订阅者对象，若其已存在，则返回 false 。
+     * @note
+     * 只有用户自定义的订阅者对象才可能重复订阅，
+     * 新创建的 x_subinvoke_t 订阅者对象不需要进行查重操作。
+     */
+    bool insert(const x_subptr_t & xsub_optr)
+    {
+        if ((xsub_optr->sub_type() < XSUBER_BASE_TYPE) &&
+            (m_xslots.size() != find(xsub_optr.get())))
+        {
+            return false;
+        }
+
+        m_xslots.push_back(x_slot_t(xsub_optr));
+        m_xcount += 1;
+
+        return true;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 移除订阅者对象，若其不存在，则返回 false 。
+     */
+    bool erase(x_suber_t * xsub_ptr)
+    {
+        size_t xiter = find(xsub_ptr);
+        if (xiter == m_xslots.size())
+        {
+            return false;
+        }
+
+        if (is_dispatching())
+        {
+            m_xslots[xiter].xsub_ptr = nullptr;
+            m_xtombs += 1;
+        }
+        else
+        {
+            m_xslots.erase(m_xslots.begin() + xiter);
+        }
+
+        m_xcount -= 1;
+
+        return true;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将消息投递给集合中的所有订阅者对象。
+     */
+    template< typename __msg_ctxt_t >
+    void dispatch(const __msg_ctxt_t & xmsg_ctxt)
+    {
+        // 投递期间可能有新的订阅者加入（数组可能重新分配内存），
+        // 所以只按下标访问 投递开始时 已存在的槽位
+        const size_t xsize = m_xslots.size();
+
+        m_xdepth += 1;
+
+        for (size_t xiter = 0; xiter < xsize; ++xiter)
+        {
+            const x_slot_t & xslot = m_xslots[xiter];
+            if (nullptr != xslot.xsub_ptr)
+            {
+                x_suber_t::invoke(xslot.xthunk, xslot.xsub_ptr, xmsg_ctxt);
+            }
+        }
+
+        m_xdepth -= 1;
+
+        if ((0 == m_xdepth) && (m_xtombs > 0))
+        {
+            compact();
+        }
+    }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 查找订阅者对象所在的槽位，若不存在，则返回 m_xslots.size() 。
+     */
+    size_t find(x_suber_t * xsub_ptr) const
+    {
+        size_t xiter = 0;
+        for (; xiter < m_xslots.size(); ++xiter)
+        {
+            if (xsub_ptr == m_xslots[xiter].xsub_ptr)
+                break;
+        }
+
+        return xiter;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 清除所有的墓碑槽位（同时释放相应的订阅者对象）。
+     */
+    void compact(void)
+    {
+        typename x_slots_t::iterator itslot =
+            std::remove_if(m_xslots.begin(),
+                           m_xslots.end(),
+                           [](const x_slot_t & xslot) -> bool
+                           {
+                               return (nullptr == xslot.xsub_ptr);
+                           });
+        m_xslots.erase(itslot, m_xslots.end());
+        m_xtombs = 0;
+    }
+
+    // data members
+private:
+    x_slots_t  m_xslots;  ///< 订阅者槽位数组
+    size_t     m_xcount;  ///< 有效的订阅者数量
+    size_t     m_xtombs;  ///< 墓碑槽位的数量
+    size_t     m_xdepth;  ///< 当前投递操作的嵌套深度
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_submap_flat_t / xmsg_submap_hash_t / xmsg_submap_auto_t
+
+/**
+ * @class xmsg_submap_flat_t< __key_t, __value_t, __hash_t, __equal_t >
+ * @brief 消息订阅者映射表：基于开放寻址（Robin Hood 探测）的哈希表实现。
+ * @note
+ * 1. 作为 xmsg_publisher_t 的 __submap_t 模板参数使用，
+ *    只实现了 xmsg_publisher_t 所需要的 std::unordered_map 的接口子集；
+ * 2. 哈希桶数组中只保存 { 探测距离、元素索引、键码 }，不再遍历链式的哈希节点；
+ *    对于 算术类型、枚举类型、指针类型 的键，键码即为键值本身，查找时只访问哈希桶；
+ *    其他类型的键，键码为哈希值，哈希值相同时才访问元素进行键值比较；
+ * 3. 元素（键值对）分块存放，其地址在插入/删除其他元素 以及 扩容时都保持不变，
+ *    所以迭代器（以及元素的引用）只在该元素被删除时才会失效。
+ * 
+ * @param [in ] __key_t   : 键类型。
+ * @param [in ] __value_t : 值类型。
+ * @param [in ] __hash_t  : 计算哈希值的仿函数类型。
+ * @param [in ] __equal_t : 判断键相等的仿函数类型。
+ */
+template< typename __key_t,
+          typename __value_t,
+          typename __hash_t  = std::hash< __key_t >,
+          typename __equal_t = std::equal_to< __key_t > >
+class xmsg_submap_flat_t
+{
+    // common data types
+public:
+    typedef __key_t                                 key_type;
+    typedef __value_t                               mapped_type;
+    typedef std::pair< const __key_t, __value_t >   value_type;
+    typedef __hash_t                                hasher;
+    typedef __equal_t                               key_equal;
+
+    /**
+     * @class iterator
+     * @brief 指向映射表元素的迭代器（只支持 解引用 与 比较 操作）。
+     */
+    class iterator
+    {
+    public:
+        iterator(value_type * xvalue_ptr = nullptr) : m_xvalue_ptr(xvalue_ptr) { }
+
+        inline value_type & operator * (void) const { return *m_xvalue_ptr; }
+        inline value_type * operator ->(void) const { return m_xvalue_ptr; }
+
+        inline bool operator == (const iterator & xiter) const
+        { return (m_xvalue_ptr == xiter.m_xvalue_ptr); }
+        inline bool operator != (const iterator & xiter) const
+        { return (m_xvalue_ptr != xiter.m_xvalue_ptr); }
+
+    private:
+        value_type * m_xvalue_ptr;
+    };
+
+private:
+    /** 是否在哈希桶中直接保存键值 */
+    using x_inline_t = std::integral_constant< bool,
+                            std::is_arithmetic< key_type >::value ||
+                            std::is_enum< key_type >::value ||
+                            std::is_pointer< key_type >::value >;
+
+    /** 键码类型：键值本身 或者 混淆后的哈希值 */
+    using x_code_t = typename std::conditional<
+                            x_inline_t::value, key_type, uint64_t >::type;
+
+    /**
+     * @struct x_bucket_t
+     * @brief 哈希桶。
+     */
+    struct x_bucket_t
+    {
+        uint32_t xdist;  ///< 探测距离 + 1（为 0 时，表示空桶）
+        uint32_t xindex; ///< 元素的存储索引
+        x_code_t xcode;  ///< 键码
+    };
+
+    using x_buckets_t = std::vector< x_bucket_t >;
+    using x_storage_t = typename std::aligned_storage<
+                                    sizeof(value_type),
+                                    alignof(value_type) >::type;
+    using x_chunks_t  = std::vector< std::unique_ptr< x_storage_t[] > >;
+
+    /** 元素存储块的大小（2 的幂次方） */
+    static constexpr uint32_t XCHUNK_BITS = 6;
+    static constexpr uint32_t XCHUNK_SIZE = (1 << XCHUNK_BITS);
+
+    /** 哈希桶数组的初始大小（2 的幂次方） */
+    static constexpr size_t XBUCKET_MIN = 16;
+
+    // constructor/destructor
+public:
+    xmsg_submap_flat_t(void)
+        : m_xsize(0)
+        , m_xshift(64)
+        , m_xnext(0)
+    {
+
+    }
+
+    ~xmsg_submap_flat_t(void)
+    {
+        clear();
+    }
+
+    xmsg_submap_flat_t(xmsg_submap_flat_t && xobject) = delete;
+    xmsg_submap_flat_t & operator=(xmsg_submap_flat_t && xobject) = delete;
+    xmsg_submap_flat_t(const xmsg_submap_flat_t & xobject) = delete;
+    xmsg_submap_flat_t & operator=(const xmsg_submap_flat_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 元素数量。
+     */
+    inline size_t size(void) const { return m_xsize; }
+
+    /**********************************************************/
+    /**
+     * @brief 判断映射表是否为空。
+     */
+    inline bool empty(void) const { return (0 == m_xsize); }
+
+    /**********************************************************/
+    /**
+     * @brief 查找失败时返回的迭代器。
+     */
+    inline iterator end(void) const { return iterator(); }
+
+    /**********************************************************/
+    /**
+     * @brief 查找元素。
+     */
+    iterator find(const key_type & xkey)
+    {
+        size_t xpos = find_bucket(xkey);
+        if (xpos == m_xbuckets.size())
+        {
+            return end();
+        }
+
+        return iterator(&value_at(m_xbuckets[xpos].xindex));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 访问元素，若不存在，则插入默认值的元素。
+     */
+    mapped_type & operator [] (const key_type & xkey)
+    {
+        size_t xpos = find_bucket(xkey);
+        if (xpos != m_xbuckets.size())
+        {
+            return value_at(m_xbuckets[xpos].xindex).second;
+        }
+
+        // 装载因子超过 0.5 时扩容（较短的探测距离，可减少查找时的分支预测失败）
+        if (m_xbuckets.empty())
+        {
+            rehash(XBUCKET_MIN);
+        }
+        else if (2 * (m_xsize + 1) > m_xbuckets.size())
+        {
+            rehash(2 * m_xbuckets.size());
+        }
+
+        uint32_t xindex = alloc_index();
+        try
+        {
+            new (&m_xchunks[xindex >> XCHUNK_BITS][xindex & (XCHUNK_SIZE - 1)])
+                value_type(std::piecewise_construct,
+                           std::forward_as_tuple(xkey),
+                           std::forward_as_tuple());
+        }
+        catch (...)
+        {
+            m_xfree.push_back(xindex);
+            throw;
+        }
+
+        x_bucket_t xbucket;
+        xbucket.xdist  = 1;
+        xbucket.xindex = xindex;
+        xbucket.xcode  = key_code(xkey, x_inline_t());
+        insert_bucket(xbucket);
+
+        m_xsize += 1;
+
+        return value_at(xindex).second;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 删除元素，返回删除的元素数量。
+     */
+    size_t erase(const key_type & xkey)
+    {
+        size_t xpos = find_bucket(xkey);
+        if (xpos == m_xbuckets.size())
+        {
+            return 0;
+        }
+
+        uint32_t xindex = m_xbuckets[xpos].xindex;
+
+        // 后移删除（backward shift）：将后续的桶逐个前移，直到空桶或在其理想位置的桶
+        const size_t xmask = m_xbuckets.size() - 1;
+        size_t xnext = (xpos + 1) & xmask;
+        while (m_xbuckets[xnext].xdist > 1)
+        {
+            m_xbuckets[xpos] = m_xbuckets[xnext];
+            m_xbuckets[xpos].xdist -= 1;
+            xpos  = xnext;
+            xnext = (xnext + 1) & xmask;
+        }
+        m_xbuckets[xpos].xdist = 0;
+
+        // xkey 可能引用的就是被删除的元素，所以最后才析构元素
+        value_at(xindex).~value_type();
+        m_xfree.push_back(xindex);
+        m_xsize -= 1;
+
+        return 1;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 删除迭代器所指向的元素。
+     */
+    void erase(iterator itpos)
+    {
+        erase(itpos->first);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 清除所有元素。
+     */
+    void clear(void)
+    {
+        for (x_bucket_t & xbucket : m_xbuckets)
+        {
+            if (0 != xbucket.xdist)
+            {
+                value_at(xbucket.xindex).~value_type();
+                xbucket.xdist = 0;
+            }
+        }
+
+        m_xsize = 0;
+        m_xnext = 0;
+        m_xfree.clear();
+    }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 计算混淆后的哈希值（Fibonacci 哈希，使低质量的哈希值分布均匀）。
+     */
+    inline uint64_t mix_hash(const key_type & xkey) const
+    {
+        return (static_cast< uint64_t >(m_xfunc_hash(xkey)) *
+                UINT64_C(0x9E3779B97F4A7C15));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 哈希值对应的理想桶位置。
+     */
+    inline size_t home_bucket(uint64_t xhash) const
+    {
+        return static_cast< size_t >(xhash >> m_xshift);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 计算键码（直接保存键值）。
+     */
+    inline x_code_t key_code(const key_type & xkey, std::true_type) const
+    {
+        return xkey;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 计算键码（保存混淆后的哈希值）。
+     */
+    inline x_code_t key_code(const key_type & xkey, std::false_type) const
+    {
+        return mix_hash(xkey);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 哈希桶的理想桶位置（直接保存键值）。
+     */
+    inline size_t home_bucket(const x_bucket_t & xbucket, std::true_type) const
+    {
+        return home_bucket(mix_hash(xbucket.xcode));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 哈希桶的理想桶位置（保存混淆后的哈希值）。
+     */
+    inline size_t home_bucket(const x_bucket_t & xbucket, std::false_type) const
+    {
+        return home_bucket(xbucket.xcode);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 判断哈希桶中的键是否与 xkey 相等（直接保存键值）。
+     */
+    inline bool is_match(const x_bucket_t & xbucket,
+                         const key_type & xkey,
+                         const x_code_t &,
+                         std::true_type) const
+    {
+        return m_xfunc_equal(xbucket.xcode, xkey);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 判断哈希桶中的键是否与 xkey 相等（保存混淆后的哈希值）。
+     */
+    inline bool is_match(const x_bucket_t & xbucket,
+                         const key_type & xkey,
+                         const x_code_t & xcode,
+                         std::false_type) const
+    {
+        return ((xbucket.xcode == xcode) &&
+                m_xfunc_equal(value_at(xbucket.xindex).first, xkey));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 访问指定存储索引的元素。
+     */
+    inline value_type & value_at(uint32_t xindex) const
+    {
+        return *reinterpret_cast< value_type * >(
+                    &m_xchunks[xindex >> XCHUNK_BITS][xindex & (XCHUNK_SIZE - 1)]);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 查找键所在的桶位置，若不存在，则返回 m_xbuckets.size() 。
+     */
+    size_t find_bucket(const key_type & xkey) const
+    {
+        if (0 == m_xsize)
+        {
+            return m_xbuckets.size();
+        }
+
+        const uint64_t xhash = mix_hash(xkey);
+        const x_code_t xcode = key_code(xkey, x_inline_t());
+
+        const size_t xmask = m_xbuckets.size() - 1;
+        size_t   xpos  = home_bucket(xhash);
+        uint32_t xdist = 1;
+
+        for (;; ++xdist, xpos = (xpos + 1) & xmask)
+        {
+            const x_bucket_t & xbucket = m_xbuckets[xpos];
+
+            // 遇到空桶，或者遇到比当前探测距离更短的桶（Robin Hood 不变式），
+            // 则可以确定键不存在
+            if (xbucket.xdist < xdist)
+            {
+                break;
+            }
+
+            if (is_match(xbucket, xkey, xcode, x_inline_t()))
+            {
+                return xpos;
+            }
+        }
+
+        return m_xbuckets.size();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 插入桶（Robin Hood 方式：探测距离更长的桶 抢占 距离更短的桶的位置）。
+     */
+    void insert_bucket(x_bucket_t xbucket)
+    {
+        const size_t xmask = m_xbuckets.size() - 1;
+        size_t xpos = home_bucket(xbucket, x_inline_t());
+
+        for (;; xpos = (xpos + 1) & xmask, ++xbucket.xdist)
+        {
+            x_bucket_t & xcurrent = m_xbuckets[xpos];
+            if (0 == xcurrent.xdist)
+            {
+                xcurrent = xbucket;
+                break;
+            }
+
+            if (xcurrent.xdist < xbucket.xdist)
+            {
+                std::swap(xcurrent, xbucket);
+            }
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 重建哈希桶数组（元素的存储位置保持不变）。
+     */
+    void rehash(size_t xcount)
+    {
+        x_buckets_t xbuckets(xcount, x_bucket_t());
+        xbuckets.swap(m_xbuckets);
+
+        m_xshift = 64;
+        for (size_t xiter = xcount; xiter > 1; xiter >>= 1)
+        {
+            m_xshift -= 1;
+        }
+
+        for (x_bucket_t & xbucket : xbuckets)
+        {
+            if (0 != xbucket.xdist)
+            {
+                xbucket.xdist = 1;
+                insert_bucket(xbucket);
+            }
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 分配元素的存储索引。
+     */
+    uint32_t alloc_index(void)
+    {
+        if (!m_xfree.empty())
+        {
+            uint32_t xindex = m_xfree.back();
+            m_xfree.pop_back();
+            return xindex;
+        }
+
+        if (m_xnext == (m_xchunks.size() << XCHUNK_BITS))
+        {
+            m_xchunks.push_back(
+                std::unique_ptr< x_storage_t[] >(new x_storage_t[XCHUNK_SIZE]));
+        }
+
+        return m_xnext++;
+    }
+
+    // data members
+private:
+    x_buckets_t              m_xbuckets;      ///< 哈希桶数组
+    size_t                   m_xsize;         ///< 元素数量
+    uint32_t                 m_xshift;        ///< 计算理想桶位置时，哈希值的右移位数
+    uint32_t                 m_xnext;         ///< 下一个未曾使用过的存储索引
+    x_chunks_t               m_xchunks;       ///< 元素的存储块
+    std::vector< uint32_t >  m_xfree;         ///< 已回收的存储索引
+    hasher                   m_xfunc_hash;    ///< 计算哈希值的仿函数对象
+    key_equal                m_xfunc_equal;   ///< 判断键相等的仿函数对象
+};
+
+/**
+ * @brief 消息订阅者映射表：基于 std::unordered_map 的实现。
+ */
+template< typename __key_t,
+          typename __value_t,
+          typename __hash_t  = std::hash< __key_t >,
+          typename __equal_t = std::equal_to< __key_t > >
+using xmsg_submap_hash_t =
+            std::unordered_map< __key_t, __value_t, __hash_t, __equal_t >;
+
+/**
+ * @brief 消息订阅者映射表：xmsg_publisher_t 默认使用的实现。
+ * @note
+ * 对于 算术类型、枚举类型、指针类型 这类可简单计算哈希值的键类型，
+ * 使用 xmsg_submap_flat_t，否则使用 xmsg_submap_hash_t 。
+ */
+template< typename __key_t,
+          typename __value_t,
+          typename __hash_t  = std::hash< __key_t >,
+          typename __equal_t = std::equal_to< __key_t > >
+using xmsg_submap_auto_t =
+            typename std::conditional<
+                std::is_arithmetic< __key_t >::value ||
+                std::is_enum< __key_t >::value ||
+                std::is_pointer< __key_t >::value,
+                xmsg_submap_flat_t< __key_t, __value_t, __hash_t, __equal_t >,
+                xmsg_submap_hash_t< __key_t, __value_t, __hash_t, __equal_t >
+            >::type;
+
+/**
+ * @class xmsg_submap_array_t< __key_t, __value_t, __hash_t, __equal_t, __slots >
+ * @brief 消息订阅者映射表：键值在 [0, __slots) 范围内的，直接按键值索引槽位数组，
+ *        其余的键则存放在 xmsg_submap_auto_t 中。
+ * @note
+ * 1. 用于 键值为编译期常量 的消息类型（如 xmsg_topic_t 声明的静态主题、
+ *    从 0 开始连续编号的枚举值）：find() 只是一次数组访问，不计算哈希值，
+ *    也不进行探测；
+ * 2. 通过 xmsg_submap_static_t< __slots >::x_submap_t 作为
+ *    xmsg_publisher_t 的 __submap_t 模板参数使用；
+ * 3. 槽位数组中的元素地址始终不变；迭代器只是指向元素的指针，
+ *    只在该元素被删除时才会失效。
+ * 
+ * @param [in ] __key_t   : 键类型（整数类型 或 枚举类型）。
+ * @param [in ] __value_t : 值类型。
+ * @param [in ] __hash_t  : 计算哈希值的仿函数类型（用于范围之外的键）。
+ * @param [in ] __equal_t : 判断键相等的仿函数类型（用于范围之外的键）。
+ * @param [in ] __slots   : 槽位数量。
+ */
+template< typename __key_t,
+          typename __value_t,
+          typename __hash_t,
+          typename __equal_t,
+          size_t __slots >
+class xmsg_submap_array_t
+{
+    static_assert(std::is_integral< __key_t >::value || std::is_enum< __key_t >::value,
+                  "xmsg_submap_array_t requires an integral or enum key type");
+
+    // common data types
+public:
+    typedef __key_t                                 key_type;
+    typedef __value_t                               mapped_type;
+    typedef std::pair< const __key_t, __value_t >   value_type;
+    typedef __hash_t                                hasher;
+    typedef __equal_t                               key_equal;
+
+    /** 槽位数量 */
+    static constexpr size_t XSLOTS = __slots;
+
+    /**
+     * @class iterator
+     * @brief 指向映射表元素的迭代器（只支持 解引用 与 比较 操作）。
+     */
+    class iterator
+    {
+    public:
+        explicit iterator(value_type * xpair = nullptr) : m_xpair(xpair) { }
+
+        inline value_type & operator * (void) const { return *m_xpair; }
+        inline value_type * operator -> (void) const { return m_xpair; }
+
+        inline bool operator == (const iterator & xiter) const { return (m_xpair == xiter.m_xpair); }
+        inline bool operator != (const iterator & xiter) const { return (m_xpair != xiter.m_xpair); }
+
+    private:
+        value_type * m_xpair; ///< 指向的元素（为 nullptr 时即为 end()）
+    };
+
+private:
+    using x_fallback_t = xmsg_submap_auto_t< __key_t, __value_t, __hash_t, __equal_t >;
+
+    /**
+     * @struct x_slot_t
+     * @brief 槽位：元素 与 使用标识。
+     */
+    struct x_slot_t
+    {
+        value_type xpair; ///< 元素（键值即为槽位的索引号）
+        bool       xused; ///< 是否已插入
+
+        explicit x_slot_t(size_t xindex)
+            : xpair(std::piecewise_construct,
+                    std::forward_as_tuple(static_cast< __key_t >(xindex)),
+                    std::forward_as_tuple())
+            , xused(false)
+        {
+
+        }
+    };
+
+    // constructor/destructor
+public:
+    xmsg_submap_array_t(void)
+        : m_xcount(0)
+    {
+        m_xslots.reserve(XSLOTS);
+        for (size_t xiter = 0; xiter < XSLOTS; ++xiter)
+        {
+            m_xslots.emplace_back(xiter);
+        }
+    }
+
+    xmsg_submap_array_t(xmsg_submap_array_t && xobject) = delete;
+    xmsg_submap_array_t & operator=(xmsg_submap_array_t && xobject) = delete;
+    xmsg_submap_array_t(const xmsg_submap_array_t & xobject) = delete;
+    xmsg_submap_array_t & operator=(const xmsg_submap_array_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 元素数量。
+     */
+    inline size_t size(void) const { return m_xcount + m_xfallback.size(); }
+
+    /**********************************************************/
+    /**
+     * @brief 判断映射表是否为空。
+     */
+    inline bool empty(void) const { return (0 == size()); }
+
+    /**********************************************************/
+    /**
+     * @brief 返回表示 “不存在” 的迭代器。
+     */
+    inline iterator end(void) { return iterator(); }
+
+    /**********************************************************/
+    /**
+     * @brief 查找元素。
+     */
+    inline iterator find(const key_type & xkey)
+    {
+        const size_t xindex = static_cast< size_t >(xkey);
+        if (xindex < XSLOTS)
+        {
+            x_slot_t & xslot = m_xslots[xindex];
+            return xslot.xused ? iterator(&xslot.xpair) : iterator();
+        }
+
+        typename x_fallback_t::iterator itfind = m_xfallback.find(xkey);
+        return (itfind != m_xfallback.end()) ? iterator(&(*itfind)) : iterator();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 返回键对应的值（不存在时插入默认值）。
+     */
+    mapped_type & operator [] (const key_type & xkey)
+    {
+        const size_t xindex = static_cast< size_t >(xkey);
+        if (xindex < XSLOTS)
+        {
+            x_slot_t & xslot = m_xslots[xindex];
+            if (!xslot.xused)
+            {
+                xslot.xused = true;
+                m_xcount   += 1;
+            }
+
+            return xslot.xpair.second;
+        }
+
+        return m_xfallback[xkey];
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 删除迭代器所指向的元素。
+     */
+    void erase(iterator itpos)
+    {
+        erase(itpos->first);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 删除键对应的元素，返回删除的元素数量。
+     */
+    size_t erase(const key_type & xkey)
+    {
+        const size_t xindex = static_cast< size_t >(xkey);
+        if (xindex >= XSLOTS)
+        {
+            return m_xfallback.erase(xkey);
+        }
+
+        x_slot_t & xslot = m_xslots[xindex];
+        if (!xslot.xused)
+        {
+            return 0;
+        }
+
+        // 槽位的值（订阅者集合）重置为初始状态，以便再次插入
+        xslot.xpair.second.~mapped_type();
+        new (&xslot.xpair.second) mapped_type();
+        xslot.xused = false;
+        m_xcount   -= 1;
+
+        return 1;
+    }
+
+    // data members
+private:
+    std::vector< x_slot_t > m_xslots;    ///< 槽位数组（键值即为索引号）
+    size_t                  m_xcount;    ///< 槽位数组中已插入的元素数量
+    x_fallback_t            m_xfallback; ///< 范围之外的键
+};
+
+template< typename __key_t,
+          typename __value_t,
+          typename __hash_t,
+          typename __equal_t,
+          size_t __slots >
+constexpr size_t xmsg_submap_array_t<
+                    __key_t, __value_t, __hash_t, __equal_t, __slots >::XSLOTS;
+
+/**
+ * @struct xmsg_submap_static_t< __slots >
+ * @brief 将 xmsg_submap_array_t 的槽位数量绑定为 __slots，其中的 x_submap_t
+ *        可直接作为 xmsg_publisher_t 的 __submap_t 模板参数使用。
+ */
+template< size_t __slots >
+struct xmsg_submap_static_t
+{
+    template< typename __key_t,
+              typename __value_t,
+              typename __hash_t  = std::hash< __key_t >,
+              typename __equal_t = std::equal_to< __key_t > >
+    using x_submap_t =
+            xmsg_submap_array_t< __key_t, __value_t, __hash_t, __equal_t, __slots >;
+};
+
+/**
+ * @struct xmsg_submap_slots_t< __submap_t >
+ * @brief 消息订阅者映射表中 直接按键值索引 的槽位数量
+ *        （xmsg_submap_array_t 为 XSLOTS，其他映射表为 0）。
+ */
+template< typename __submap_t, typename = void >
+struct xmsg_submap_slots_t : std::integral_constant< size_t, 0 >
+{
+};
+
+template< typename __submap_t >
+struct xmsg_submap_slots_t< __submap_t,
+                            typename std::conditional<
+                                true,
+                                void,
+                                decltype(__submap_t::XSLOTS) >::type >
+    : std::integral_constant< size_t, __submap_t::XSLOTS >
+{
+};
+
+/**
+ * @struct xmsg_submap_match_t< __submap_t >
+ * @brief 判断消息订阅者映射表是否支持主题匹配：若其定义了 x_match_tag_t
+ *        （如 xmsg_submap_topic_t），则为 std::true_type，
+ *        否则为 std::false_type（只按键值精确查找）。
+ */
+template< typename __submap_t, typename = void >
+struct xmsg_submap_match_t : std::false_type
+{
+};
+
+template< typename __submap_t >
+struct xmsg_submap_match_t< __submap_t,
+                            typename std::conditional<
+                                true,
+                                void,
+                                typename __submap_t::x_match_tag_t >::type >
+    : std::true_type
+{
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_queue_traits_t
+
+/**
+ * @struct xmsg_queue_batch_t< __msg_queue_t >
+ * @brief 消息队列的批次类型：若消息队列类型定义了 x_batch_t
+ *        （如 xmsg_ring_queue_t），则使用之；否则为消息队列类型自身。
+ */
+template< typename __msg_queue_t, typename = void >
+struct xmsg_queue_batch_t
+{
+    using type = __msg_queue_t;
+};
+
+template< typename __msg_queue_t >
+struct xmsg_queue_batch_t< __msg_queue_t,
+                           typename std::conditional<
+                                true,
+                                void,
+                                typename __msg_queue_t::x_batch_t >::type >
+{
+    using type = typename __msg_queue_t::x_batch_t;
+};
+
+/**
+ * @struct xmsg_queue_traits_t< __msg_queue_t >
+ * @brief 消息队列的 入队 与 批量摘取/放回 操作（供 xmsg_publisher_t 使用）。
+ * @note
+ * 1. 若消息队列类型提供了 detach() 与 restore() 成员函数（如 xmsg_mpsc_queue_t），
+ *    则直接使用之；否则使用 swap() 操作（如 std::queue）；
+ * 2. 若消息队列的 push()/emplace() 返回 bool 值（如 xmsg_ring_queue_t），
+ *    则返回该结果；否则总是返回 true 。
+ * 
+ * @param [in ] __msg_queue_t : 消息队列。
+ */
+template< typename __msg_queue_t >
+struct xmsg_queue_traits_t
+{
+    /** 批次类型（dispatch_batch() 从消息队列中摘取的本地批次） */
+    using x_batch_t = typename xmsg_queue_batch_t< __msg_queue_t >::type;
+
+    /**********************************************************/
+    /**
+     * @brief 将元素压入 xqueue ，返回元素是否已入队。
+     */
+    template< typename __value_t >
+    static bool push(__msg_queue_t & xqueue, __value_t && xvalue)
+    {
+        return iinvk_push(0, xqueue, std::forward< __value_t >(xvalue));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 在 xqueue 中直接构造元素，返回元素是否已入队。
+     */
+    template< typename... __args_t >
+    static bool emplace(__msg_queue_t & xqueue, __args_t &&... xargs)
+    {
+        return iinvk_emplace(0, xqueue, std::forward< __args_t >(xargs)...);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将 xqueue 中的所有消息摘取到（空的）xbatch 中。
+     */
+    static void detach(__msg_queue_t & xqueue, x_batch_t & xbatch)
+    {
+        detach(xqueue, xbatch, 0);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将 xbatch 中剩余的消息按原有顺序放回到 xqueue 的最前面。
+     */
+    static void restore(__msg_queue_t & xqueue, x_batch_t & xbatch)
+    {
+        restore(xqueue, xbatch, 0);
+    }
+
+private:
+    template< typename __queue_t, typename __value_t >
+    static auto iinvk_push(int, __queue_t & xqueue, __value_t && xvalue)
+        -> typename std::enable_if<
+                std::is_same< decltype(xqueue.push(std::forward< __value_t >(xvalue))),
+                              bool >::value,
+                bool >::type
+    {
+        return xqueue.push(std::forward< __value_t >(xvalue));
+    }
+
+    template< typename __queue_t, typename __value_t >
+    static bool iinvk_push(long, __queue_t & xqueue, __value_t && xvalue)
+    {
+        xqueue.push(std::forward< __value_t >(xvalue));
+        return true;
+    }
+
+    template< typename __queue_t, typename... __args_t >
+    static auto iinvk_emplace(int, __queue_t & xqueue, __args_t &&... xargs)
+        -> typename std::enable_if<
+                std::is_same< decltype(xqueue.emplace(std::forward< __args_t >(xargs)...)),
+                              bool >::value,
+                bool >::type
+    {
+        return xqueue.emplace(std::forward< __args_t >(xargs)...);
+    }
+
+    template< typename __queue_t, typename... __args_t >
+    static bool iinvk_emplace(long, __queue_t & xqueue, __args_t &&... xargs)
+    {
+        xqueue.emplace(std::forward< __args_t >(xargs)...);
+        return true;
+    }
+
+    template< typename __queue_t, typename __batch_t >
+    static auto detach(__queue_t & xqueue, __batch_t & xbatch, int)
+        -> decltype(xqueue.detach(xbatch), void())
+    {
+        xqueue.detach(xbatch);
+    }
+
+    template< typename __queue_t >
+    static void detach(__queue_t & xqueue, __queue_t & xbatch, long)
+    {
+        xbatch.swap(xqueue);
+    }
+
+    template< typename __queue_t, typename __batch_t >
+    static auto restore(__queue_t & xqueue, __batch_t & xbatch, int)
+        -> decltype(xqueue.restore(xbatch), void())
+    {
+        xqueue.restore(xbatch);
+    }
+
+    template< typename __queue_t >
+    static void restore(__queue_t & xqueue, __queue_t & xbatch, long)
+    {
+        while (!xqueue.empty())
+        {
+            xbatch.push(std::move(xqueue.front()));
+            xqueue.pop();
+        }
+
+        xbatch.swap(xqueue);
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_prio_t
+
+/**
+ * @struct xmsg_prio_t
+ * @brief 消息的优先级通道（用于 xmsg_publisher_t::publish(xmsg_prio_t, ...)）。
+ * @note
+ * 使用独立的类型（而非整数），以避免与 整数类型消息键 的 publish() 重载产生歧义；
+ * 通道号越小，优先级越高（0 为最高优先级）。
+ */
+struct xmsg_prio_t
+{
+    size_t xlane; ///< 优先级通道号
+
+    explicit xmsg_prio_t(size_t xlane) : xlane(xlane) { }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_topic_t
+
+/**
+ * @struct xmsg_topic_t< __mkey_t, __mkey, __args_t... >
+ * @brief 静态主题（编译期常量的消息键）的类型标签，用于
+ *        xmsg_publisher_t::publish< 主题 >() / subscribe< 主题 >() 等接口。
+ * @note
+ * 1. 以派生的方式声明主题，如：
+ *    struct xtopic_test_t : xmsg_topic_t< int, 100, std::string > { };
+ * 2. 主题声明的参数类型须与发布者的消息参数类型一致，
+ *    发布时传入的参数 也须能构造出主题的各个参数，均在编译期检查；
+ * 3. 发布者使用 xmsg_submap_static_t 的映射表时，主题的键值即为
+ *    其在槽位数组中的索引号（编译期检查其不超出槽位数量），
+ *    投递该主题的消息只需一次数组访问。
+ * 
+ * @param [in ] __mkey_t  : 消息键类型（整数类型 或 枚举类型）。
+ * @param [in ] __mkey    : 消息键值。
+ * @param [in ] __args_t  : 主题的参数类型列表。
+ */
+template< typename __mkey_t, __mkey_t __mkey, typename... __args_t >
+struct xmsg_topic_t
+{
+    using x_mkey_t = __mkey_t;
+    using x_args_t = std::tuple< __args_t... >;
+
+    /** 主题的消息键值 */
+    static constexpr __mkey_t value = __mkey;
+};
+
+template< typename __mkey_t, __mkey_t __mkey, typename... __args_t >
+constexpr __mkey_t xmsg_topic_t< __mkey_t, __mkey, __args_t... >::value;
+
+/**
+ * @struct xmsg_topic_check_t< __topic_t, __mkey_t, __args_t >
+ * @brief 判断 __topic_t 是否为 消息键类型为 __mkey_t、参数元组为 __args_t 的主题
+ *        （用于在编译期检查 主题 与 发布者 的类型是否匹配）。
+ */
+template< typename __topic_t, typename __mkey_t, typename __args_t, typename = void >
+struct xmsg_topic_check_t : std::false_type
+{
+};
+
+template< typename __topic_t, typename __mkey_t, typename __args_t >
+struct xmsg_topic_check_t< __topic_t,
+                           __mkey_t,
+                           __args_t,
+                           typename std::conditional<
+                                true,
+                                void,
+                                typename __topic_t::x_args_t >::type >
+    : std::integral_constant< bool,
+                std::is_same< typename __topic_t::x_mkey_t, __mkey_t >::value &&
+                std::is_same< typename __topic_t::x_args_t, __args_t >::value >
+{
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_publisher_t
+
+/**
+ * @class xmsg_publisher_t< __msg_context_t, __msg_queue_t >
+ * @brief 发布订阅模式使用的订阅者模板类。
+ * 
+ * @note
+ * 使用默认的 std::queue 作为消息队列时，所有操作都必须在同一线程中进行；
+ * 若以 xmsg_mpsc_queue_t 作为消息队列，则任意线程都可调用 publish()，
+ * 但 dispatch() 以及 订阅/取消订阅 操作仍须在同一个（投递）线程中进行。
+ * 
+ * @param [in ] __msg_context_t : 消息类型。
+ * @param [in ] __msg_queue_t   : 消息队列。
+ * @param [in ] __subset_t      : 订阅者集合（xmsg_subset_hash_t 或 xmsg_subset_flat_t）。
+ * @param [in ] __submap_t      : 消息订阅者映射表（xmsg_submap_auto_t、
+ *                                xmsg_submap_flat_t 或 xmsg_submap_hash_t）。
+ */
+template< typename __msg_context_t,
+          typename __msg_queue_t = std::queue< __msg_context_t >,
+          template< typename > class __subset_t = xmsg_subset_hash_t,
+          template< typename, typename, typename, typename >
+                    class __submap_t = xmsg_submap_auto_t >
+class xmsg_publisher_t
+{
+    // common data types
+public:
+    using x_msgctxt_t    = __msg_context_t;
+    using x_msgqueue_t   = __msg_queue_t;
+    using x_mkey_t       = typename x_msgctxt_t::x_mkey_t;
+    using x_subscriber_t = xmsg_subscriber_t< XSUBER_BASE_TYPE, x_msgctxt_t >;
+    using x_subsptr_t    = std::shared_ptr< x_subscriber_t >;
+    using x_subwptr_t    = std::weak_ptr< x_subscriber_t >;
+
+    /**
+     * @struct x_subkey_t
+     * @brief 订阅者对象 在 发布者对象 中的索引键。
+     * @note
+     * 调用 subscribe() 发起订阅操作时，返回该对象。
+     * 其在后续执行中，可用于 unsubscribe() 取消订阅操作。
+     */
+    struct x_subkey_t
+    {
+        x_mkey_t    xmkey; ///< 订阅的消息索引键
+        x_subwptr_t xwptr; ///< 订阅者对象的弱指针
+
+        // constructor/destructor
+    public:
+        x_subkey_t(void)
+            : xmkey()
+            , xwptr()
+        {
+
+        }
+
+        x_subkey_t(const x_mkey_t & xmkey, const x_subwptr_t & xwptr)
+        {
+            this->xmkey = xmkey;
+            this->xwptr = xwptr;
+        }
+
+        x_subkey_t(const x_subkey_t & xobject)
+        {
+            *this = xobject;
+        }
+
+        x_subkey_t & operator=(const x_subkey_t & xobject)
+        {
+            if (this != &xobject)
+            {
+                this->xmkey = xobject.xmkey;
+                this->xwptr = xobject.xwptr;
+            }
+
+            return *this;
+        }
+
+        // public interfaces
+    public:
+        /**********************************************************/
+        /**
+         * @brief 判断订阅者对象的订阅状态是否仍然有效。
+         */
+        inline bool is_valid(void) const { return !xwptr.expired(); }
+
+        /**********************************************************/
+        /**
+         * @brief 用 bool 操作符判断有效性。
+         */
+        operator bool (void) const { return is_valid(); }
+    };
+
+private:
+    /** 用于生成 x_subinvoke_t 类型标识的流水号 */
+    static std::atomic_size_t sub_type_seqno;
+
+public:
+    /**********************************************************/
+    /**
+     * @brief 创建一个 x_subinvoke_t 订阅者类的类型标识。
+     */
+    static xsub_type_t make_sub_type(void)
+    {
+        return sub_type_seqno.fetch_add(1);
+    }
+
+private:
+    /**
+     * @class x_subinvoke_t< __mfunc_t, __tuple_t >
+     * @brief 为了使用 “仿函数对象 与 lambda 表达式 等类函数的泛型接口” 
+     * 进行消息处理，而设计的订阅者模板类。
+     * 
+     * @param [in ] __mfunc_t : 消息处理的回调接口函数。
+     * @param [in ] __tuple_t : 回调的参数元组。
+     */
+    template< typename __mfunc_t, typename __tuple_t >
+    class x_subinvoke_t final : public x_subscriber_t
+    {
+        // common data types
+    public:
+        using x_mfunc_t = __mfunc_t;
+        using x_tuple_t = __tuple_t;
+
+    private:
+        /** x_subinvoke_t 的订阅者类型 */
+        static xsub_type_t sub_type_value;
+
+        // constructor/destructor
+    public:
+        template< typename __func_t >
+        x_subinvoke_t(__func_t && xfunc, x_tuple_t && xargs)
+            : x_subscriber_t(&invoke_thunk)
+            , m_xfunc(std::forward< __func_t >(xfunc))
+            , m_xargs(std::forward< x_tuple_t >(xargs))
+        {
+
+        }
+
+        // extensible interfaces
+    public:
+        /**********************************************************/
+        /**
+         * @brief 订阅者类型。
+         * @note 所有 x_subinvoke_t 的订阅者类型都大于 0x80000000。
+         */
+        virtual xsub_type_t sub_type(void) const override
+        {
+            return sub_type_value;
+        }
+
+        /**********************************************************/
+        /**
+         * @brief 订阅消息的分派接口。
+         */
+        virtual void translate(const x_msgctxt_t & xmsg_ctxt) override
+        {
+            using x_indices_args_t =
+                typename xbuild_index_sequence_t<
+                    std::tuple_size<
+                        typename x_msgctxt_t::x_args_t >::value >::type;
+
+            using x_indices_invk_t =
+                typename xbuild_index_sequence_t<
+                    std::tuple_size< x_tuple_t >::value >::type;
+
+            sub_invoke(xmsg_ctxt.args(), x_indices_args_t(), x_indices_invk_t());
+        }
+
+        // inner invoking
+    private:
+        /**********************************************************/
+        /**
+         * @brief 消息投递的调用接口（每个 x_subinvoke_t 实例化类型各自生成）。
+         * @note
+         * 由于 x_subinvoke_t 为 final 类，此处对 translate() 的调用
+         * 会被静态绑定（不经过虚函数表）。
+         */
+        static void invoke_thunk(x_subscriber_t * xthis,
+                                 const x_msgctxt_t & xmsg_ctxt)
+        {
+            static_cast< x_subinvoke_t * >(xthis)->x_subinvoke_t::translate(xmsg_ctxt);
+        }
+
+        /**********************************************************/
+        /**
+         * @brief 调用消息处理接口。
+         */
+        template< typename __args_t,
+                  size_t... __indexes_args,
+                  size_t... __indexes_invk >
+        void sub_invoke(const __args_t & xargs,
+                        xindex_sequence_t< __indexes_args... >,
+                        xindex_sequence_t< __indexes_invk... >)
+        {
+#if __cplusplus >= 201703L
+            std::invoke(m_xfunc,
+                        std::get< __indexes_invk >(m_xargs)...,
+                        std::get< __indexes_args >(xargs)...);
+#else // !(__cplusplus >= 201703L)
+            xmsg_invoke(m_xfunc,
+                        std::get< __indexes_invk >(m_xargs)...,
+                        std::get< __indexes_args >(xargs)...);
+#endif // __cplusplus >= 201703L
+        }
+
+        // data members
+    private:
+        x_mfunc_t  m_xfunc; ///< 消息处理接口
+        x_tuple_t  m_xargs; ///< 回调的参数元组
+    };
+
+    /**
+     * @class x_subptr_t
+     * @brief 订阅者对象使用的智能指针类。
+     */
+    class x_subptr_t : public x_subsptr_t
+    {
+        // common data types
+    public:
+        /**
+         * @struct x_hash_t
+         * @brief 用于计算 哈希键值 的仿函数结构体类型。
+         */
+        struct x_hash_t
+        {
+        public:
+            typedef x_subptr_t argument_type;
+            typedef size_t result_type;
+
+            size_t operator()(const x_subptr_t & xsub_ptr) const
+            {
+                return m_xfunctor(xsub_ptr.get());
+            }
+
+        private:
+            std::hash< x_subscriber_t * > m_xfunctor; ///< 仿函数操作实现的对象
+        };
+
+        /**
+         * @struct x_equal_t
+         * @brief 判断相等的仿函数结构体类型。
+         */
+        struct x_equal_t
+        {
+        public:
+            typedef x_subptr_t first_argument_type;
+            typedef x_subptr_t second_argument_type;
+            typedef bool result_type;
+
+            bool operator()(const x_subptr_t & xsub_lptr,
+                            const x_subptr_t & xsub_rptr) const
+            {
+                return (xsub_lptr.get() == xsub_rptr.get());
+            }
+        };
+
+    private:
+        using x_super_t = x_subsptr_t;
+
+        /**
+         * @struct x_deleter_t
+         * @brief 订阅者对象的删除器。
+         * @note
+         * 忽略订阅者对象的删除操作：非 x_subinvoke_t 类型的订阅者
+         * 为外部用户自定义的订阅者，交由外部自行管理。
+         */
+        struct x_deleter_t
+        {
+            void operator()(x_subscriber_t *) const { }
+        };
+
+        // constructor/destructor
+    public:
+        /**
+         * @brief 持有 x_subinvoke_t 订阅者对象
+         *        （由 std::allocate_shared() 创建，对象与控制块在同一内存块中）。
+         */
+        x_subptr_t(x_subsptr_t && xsub_sptr)
+            : x_super_t(std::forward< x_subsptr_t >(xsub_sptr))
+        {
+
+        }
+
+        /**
+         * @brief 引用（不持有）用户自定义的订阅者对象
+         *        （控制块从 xmsg_slab_pool_t 中分配）。
+         */
+        x_subptr_t(x_subscriber_t * xsub_ptr, bool)
+            : x_super_t(xsub_ptr,
+                        x_deleter_t(),
+                        xmsg_slab_allocator_t< x_subscriber_t >())
+        {
+
+        }
+
+        // public interfaces
+    public:
+        /**********************************************************/
+        /**
+         * @brief 创建 weak_ptr 类型的指针对象。
+         */
+        inline x_subwptr_t make_weak_ptr(void) const noexcept
+        {
+            return x_subwptr_t(
+                        *static_cast< x_super_t * >(
+                            const_cast< x_subptr_t * >(this)));
+        }
+    };
+
+    using x_subset_t = __subset_t< x_subptr_t >;
+
+    using x_submap_t = __submap_t<
+                                x_mkey_t,
+                                x_subset_t,
+                                typename x_msgctxt_t::xmsg_mkey_t::x_hash_t,
+                                typename x_msgctxt_t::xmsg_mkey_t::x_equal_t >;
+
+    using x_queue_traits_t = xmsg_queue_traits_t< x_msgqueue_t >;
+    using x_msgbatch_t     = typename x_queue_traits_t::x_batch_t;
+
+    /** 消息订阅者映射表是否支持主题匹配（std::true_type/std::false_type） */
+    using x_match_t        = xmsg_submap_match_t< x_submap_t >;
+
+#if XMSG_ENABLE_STATS
+public:
+    /** stats() 返回的统计快照类型 */
+    using x_stats_t        = xmsg_stats_snapshot_t< x_mkey_t >;
+
+private:
+    /**
+     * @struct x_counters_t
+     * @brief 统计条带中的计数器（由条带的所属线程写入，stats() 可并发读取）。
+     */
+    struct x_counters_t
+    {
+        std::atomic< uint64_t > xpublished;  ///< 已发布的消息数量
+        std::atomic< uint64_t > xdropped;    ///< 发布时被拒绝的消息数量
+        std::atomic< uint64_t > xdispatched; ///< 已投递的消息数量
+        std::atomic< uint64_t > xinvoked;    ///< 消息处理接口的调用次数
+
+        x_counters_t(void)
+            : xpublished(0)
+            , xdropped(0)
+            , xdispatched(0)
+            , xinvoked(0)
+        {
+
+        }
+
+        /**********************************************************/
+        /**
+         * @brief 读取各个计数值。
+         */
+        xmsg_stats_counters_t load(void) const
+        {
+            xmsg_stats_counters_t xcounters;
+            xcounters.xpublished  = xpublished.load(std::memory_order_relaxed);
+            xcounters.xdropped    = xdropped.load(std::memory_order_relaxed);
+            xcounters.xdispatched = xdispatched.load(std::memory_order_relaxed);
+            xcounters.xinvoked    = xinvoked.load(std::memory_order_relaxed);
+            return xcounters;
+        }
+    };
+
+    using x_keystats_t     = std::unordered_map<
+                                x_mkey_t,
+                                x_counters_t,
+                                typename x_msgctxt_t::xmsg_mkey_t::x_hash_t,
+                                typename x_msgctxt_t::xmsg_mkey_t::x_equal_t >;
+
+    /**
+     * @struct x_stripe_t
+     * @brief 统计数据的条带（每个线程按 xmsg_stats_thread_t::index() 使用各自的条带）。
+     * @note
+     * 1. 条带只由所属线程写入（xshared 为 false）时，各个计数值只需
+     *    relaxed 的 读取/存储 操作；超出线程数量上限的线程共用最后一个条带
+     *    （xshared 为 true），此时使用原子的 读-改-写 操作；
+     * 2. xkeys 的结构只会被写入线程改变（插入新键），因此所属线程查找
+     *    已有的键无需加锁；插入新键 与 stats() 遍历 时才需要获取 xlock 。
+     */
+    struct x_stripe_t
+    {
+        const bool       xshared;    ///< 是否由多个线程共用
+        x_counters_t     xtotal;     ///< 全局计数器
+        xmsg_histogram_t xresidency; ///< 消息在队列中的驻留耗时
+        std::mutex       xlock;      ///< 保护 xkeys 结构变更的互斥锁
+        x_keystats_t     xkeys;      ///< 各个消息索引键的计数器
+
+        explicit x_stripe_t(bool xshared) : xshared(xshared) { }
+    };
+#endif // XMSG_ENABLE_STATS
+
+    // constructor/destructor
+public:
+    xmsg_publisher_t(void)
+        : m_xparallel(false)
+        , m_xparts_count(1)
+    {
+#if XMSG_ENABLE_STATS
+        for (size_t xiter = 0; xiter <= XMSG_STATS_THREADS; ++xiter)
+        {
+            m_xstats[xiter].store(nullptr, std::memory_order_relaxed);
+        }
+#endif // XMSG_ENABLE_STATS
+    }
+
+    ~xmsg_publisher_t(void)
+    {
+#if XMSG_ENABLE_STATS
+        for (size_t xiter = 0; xiter <= XMSG_STATS_THREADS; ++xiter)
+        {
+            delete m_xstats[xiter].load(std::memory_order_relaxed);
+        }
+#endif // XMSG_ENABLE_STATS
+    }
+
+    xmsg_publisher_t(xmsg_publisher_t && xobject) = delete;
+    xmsg_publisher_t & operator=(xmsg_publisher_t && xobject) = delete;
+    xmsg_publisher_t(const xmsg_publisher_t & xobject) = delete;
+    xmsg_publisher_t & operator=(const xmsg_publisher_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 订阅者对象 订阅指定的消息类型。
+     * @note 该接口用于 非x_subinvoke_t（即用户重载的订阅者类） 类型的订阅操作。
+     * 
+     * @param [in ] xmkey    : 消息类型。
+     * @param [in ] xsub_ptr : 订阅者对象。
+     * 
+     * @return x_subkey_t
+     *         - 成功，返回的 x_subkey_t 有效；
+     *         - 失败，返回的 x_subkey_t 无效。
+     */
+    x_subkey_t subscribe(const x_mkey_t & xmkey, x_subscriber_t * xsub_ptr)
+    {
+        assert(nullptr != xsub_ptr);
+        assert(xsub_ptr->sub_type() < XSUBER_BASE_TYPE);
+
+        return iinvk_subscribe(xmkey, x_subptr_t(xsub_ptr, false));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 以共享所有权的方式，订阅 已存在的订阅者对象。
+     * @note
+     * 用于在多个同类型的 发布者对象 之间迁移订阅者对象
+     * （如 xmsg_sharded_publisher_t 迁移热点消息）：xsub_sptr 通常由
+     * 另一个发布者返回的 x_subkey_t::xwptr.lock() 得到，迁移之后，
+     * 原有的 x_subkey_t 仍然指向同一个订阅者对象。
+     * 
+     * @param [in ] xmkey     : 消息类型。
+     * @param [in ] xsub_sptr : 订阅者对象。
+     * 
+     * @return x_subkey_t
+     *         - 成功，返回的 x_subkey_t 有效；
+     *         - 失败，返回的 x_subkey_t 无效。
+     */
+    x_subkey_t subscribe_shared(const x_mkey_t & xmkey, const x_subsptr_t & xsub_sptr)
+    {
+        assert(nullptr != xsub_sptr);
+        return iinvk_subscribe(xmkey, x_subptr_t(x_subsptr_t(xsub_sptr)));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 使用 “类似函数类型” 的订阅者 订阅指定的消息类型。
+     * @note 
+     * 1. “类似函数类型”，可泛指为 类对象成员函数、仿函数、lambda表达式 等。
+     * 2. 可以使用返回的 weak_ptr 所指向的 订阅者对象，
+     *    进行 unsubscribe() 取消该消息的订阅操作。
+     * 
+     * @param [in ] xmkey    : 消息类型。
+     * @param [in ] xfunc    : 消息处理的接口函数。
+     * @param [in ] xargs... : 回调的参数（或 类对象）。
+     * 
+     * @return x_subkey_t
+     *         - 成功，返回的 x_subkey_t 有效；
+     *         - 失败，返回的 x_subkey_t 无效。
+     */
+    template< typename __mfunc_t, typename... __args_t >
+    x_subkey_t subscribe(const x_mkey_t & xmkey,
+                         __mfunc_t && xfunc,
+                         __args_t &&... xargs)
+    {
+        return iinvk_subscribe(xmkey,
+                               x_subptr_t(make_subscriber(
+                                    std::forward< __mfunc_t >(xfunc),
+                                    std::forward< __args_t >(xargs)...)));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 创建 “类似函数类型” 的订阅者对象（x_subinvoke_t）。
+     * @note
+     * subscribe() 使用的订阅者对象即由此创建；也可供其他的订阅表
+     * （如 xmsg_sharded_publisher_t、xmsg_concurrent_publisher_t）创建同样的订阅者对象。
+     * 
+     * @param [in ] xfunc    : 消息处理的接口函数。
+     * @param [in ] xargs... : 回调的参数（或 类对象）。
+     */
+    template< typename __mfunc_t, typename... __args_t >
+    static x_subsptr_t make_subscriber(__mfunc_t && xfunc, __args_t &&... xargs)
+    {
+        using x_mfunc_t  = typename std::decay< __mfunc_t >::type;
+        using x_tuple_t  = typename std::tuple<
+                                typename std::decay< __args_t >::type... >;
+        using x_invoke_t = x_subinvoke_t< x_mfunc_t, x_tuple_t >;
+
+        // 订阅者对象 与 shared_ptr 的控制块 在同一个内存块中构造，
+        // 且该内存块从 xmsg_slab_pool_t 中分配（不再每次都从堆中分配）
+        return std::allocate_shared< x_invoke_t >(
+                    xmsg_slab_allocator_t< x_invoke_t >(),
+                    std::forward< __mfunc_t >(xfunc),
+                    x_tuple_t{ std::forward< __args_t >(xargs)... });
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 使用 “类似函数类型” 的订阅者 订阅静态主题 __topic_t（xmsg_topic_t）。
+     * @note 与 subscribe(__topic_t::value, xfunc, xargs...) 相同，
+     *       但在编译期检查主题的类型是否与发布者匹配。
+     */
+    template< typename __topic_t, typename __mfunc_t, typename... __args_t >
+    x_subkey_t subscribe(__mfunc_t && xfunc, __args_t &&... xargs)
+    {
+        topic_check< __topic_t >();
+        return subscribe(__topic_t::value,
+                         std::forward< __mfunc_t >(xfunc),
+                         std::forward< __args_t >(xargs)...);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 订阅者对象 取消订阅指定的消息类型。
+     * @note
+     * 1. 在单线程环境下，若 dispatch() 操作的当前订阅者对象在处理消息时，
+     *    调用 unsubscribe() 进行自我取消订阅操作，这是没问题的；
+     *    多线程环境下，调用 unsubscribe() 是不安全的操作。
+     * 2. 在 dispatch_parallel() 投递过程中（订阅者的消息处理接口中）调用时，
+     *    若 xmkey 的消息分区正由当前线程投递（如 自我取消订阅），则立即生效；
+     *    否则，操作将延迟到本轮并行投递结束后才执行；
+     *    若订阅者对象不在 xmkey 的订阅者集合中（如 其订阅操作仍在延迟队列中），
+     *    取消操作同样延迟执行（排在之前延迟的订阅操作之后）。
+     * 
+     * @param [in ] xmkey    : 消息类型。
+     * @param [in ] xsub_ptr : 订阅者对象。
+     */
+    void unsubscribe(const x_mkey_t & xmkey, x_subscriber_t * xsub_ptr)
+    {
+        if (m_xparallel && !is_local_part(xmkey))
+        {
+            defer_unsubscribe(xmkey, xsub_ptr);
+            return;
+        }
+
+        typename x_submap_t::iterator itset = m_xmap_suber.find(xmkey);
+        if (itset == m_xmap_suber.end())
+        {
+            if (m_xparallel)
+                defer_unsubscribe(xmkey, xsub_ptr);
+            return;
+        }
+
+        // 若 取消的订阅者 为当前正在投递操作的 订阅者对象，
+        // 则由 订阅者集合 内部负责维护其投递操作的迭代状态
+        if (!itset->second.erase(xsub_ptr))
+        {
+            if (m_xparallel)
+                defer_unsubscribe(xmkey, xsub_ptr);
+            return;
+        }
+
+        // 若 消息集 为空，则从 消息订阅 的映射表中 删除该 消息集
+        // （要取消的消息类型集合，不能为 当前正在投递操作 的集合；
+        //   并行投递过程中，映射表只读，删除操作延迟执行）
+        if (itset->second.empty() && !itset->second.is_dispatching())
+        {
+            if (m_xparallel)
+                defer_invoke([this, xmkey](void) { erase_empty(xmkey); });
+            else
+                m_xmap_suber.erase(itset);
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 订阅者对象 取消订阅指定的消息类型。
+     * 
+     * @param [in ] xsub_key : 其为 subscribe() 返回的订阅者索引键。
+     */
+    void unsubscribe(const x_subkey_t & xsub_key)
+    {
+        x_subsptr_t xsub_sptr = xsub_key.xwptr.lock();
+        if (nullptr != xsub_sptr)
+        {
+            unsubscribe(xsub_key.xmkey, xsub_sptr.get());
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 取消 xmkey 下所有的订阅者对象。
+     */
+    void unsubscribe(const x_mkey_t & xmkey)
+    {
+        if (m_xparallel)
+        {
+            defer_invoke([this, xmkey](void) { unsubscribe(xmkey); });
+            return;
+        }
+
+        typename x_submap_t::iterator itset = m_xmap_suber.find(xmkey);
+        if (itset != m_xmap_suber.end())
+        {
+            // 要取消的消息类型集合，不能为 当前正在投递操作 的集合
+            if (!itset->second.is_dispatching())
+            {
+                m_xmap_suber.erase(itset);
+            }
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 取消静态主题 __topic_t（xmsg_topic_t）下所有的订阅者对象。
+     */
+    template< typename __topic_t >
+    void unsubscribe(void)
+    {
+        topic_check< __topic_t >();
+        unsubscribe(__topic_t::value);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 返回当前待投递的消息数量。
+     */
+    inline size_t size(void) const
+    {
+        return m_xmsg_queue.size();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 判断消息队列是否为空。
+     * @note
+     * 直接使用消息队列的 empty() 判断，对于 xmsg_mpsc_queue_t 这类
+     * 并发队列，size() 只是近似值，而 empty() 在消费者线程中是准确的。
+     */
+    inline bool empty(void) const
+    {
+        return m_xmsg_queue.empty();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 返回消息队列（用于读取 xmsg_ring_queue_t 等队列的统计信息）。
+     */
+    inline const x_msgqueue_t & msg_queue(void) const
+    {
+        return m_xmsg_queue;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 返回消息队列（用于配置 xmsg_lane_queue_t 等队列的参数）。
+     */
+    inline x_msgqueue_t & msg_queue(void)
+    {
+        return m_xmsg_queue;
+    }
+
+#if XMSG_ENABLE_STATS
+    /**********************************************************/
+    /**
+     * @brief 获取统计快照（可在任意线程中调用，用于定期采集）。
+     * @note
+     * 1. xtotal 为全局计数器，xkeys 为各个消息索引键的计数器，
+     *    xresidency 为消息从 publish() 到 dispatch() 的驻留耗时
+     *    （纳秒，按 XMSG_STATS_SAMPLE 抽样）；
+     * 2. xdropped 只统计 publish() 时被消息队列拒绝的消息，
+     *    队列内部的丢弃（如 XOVERFLOW_DROP_OLDEST）与合并，
+     *    由队列自身的 drops()/merges() 等接口统计；
+     * 3. xinvoked 按投递时订阅者集合的大小计数。
+     */
+    x_stats_t stats(void) const
+    {
+        x_stats_t xstats;
+
+        std::unordered_map< x_mkey_t,
+                            xmsg_stats_counters_t,
+                            typename x_msgctxt_t::xmsg_mkey_t::x_hash_t,
+                            typename x_msgctxt_t::xmsg_mkey_t::x_equal_t > xkeys;
+
+        for (size_t xiter = 0; xiter <= XMSG_STATS_THREADS; ++xiter)
+        {
+            x_stripe_t * xstripe = m_xstats[xiter].load(std::memory_order_acquire);
+            if (nullptr == xstripe)
+            {
+                continue;
+            }
+
+            xstats.xtotal     += xstripe->xtotal.load();
+            xstats.xresidency += xstripe->xresidency.snapshot();
+
+            std::lock_guard< std::mutex > xlock(xstripe->xlock);
+            for (const typename x_keystats_t::value_type & xkey_stats : xstripe->xkeys)
+            {
+                xkeys[xkey_stats.first] += xkey_stats.second.load();
+            }
+        }
+
+        xstats.xkeys.assign(xkeys.begin(), xkeys.end());
+        return xstats;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 获取订阅者对象的消息处理耗时（纳秒）的统计快照
+     *        （订阅已失效时，返回空的快照）。
+     */
+    static xmsg_histogram_snapshot_t handler_stats(const x_subkey_t & xsub_key)
+    {
+        x_subsptr_t xsub_sptr = xsub_key.xwptr.lock();
+        if (!xsub_sptr)
+        {
+            return xmsg_histogram_snapshot_t();
+        }
+
+        return xsub_sptr->handler_stats();
+    }
+#endif // XMSG_ENABLE_STATS
+
+    /**********************************************************/
+    /**
+     * @brief 发布消息（将消息加入到消息队列）。
+     * @return bool : 消息是否已入队（如 xmsg_ring_queue_t 以 XOVERFLOW_REJECT
+     *                策略拒绝入队时，返回 false）。
+     */
+    bool publish(const x_msgctxt_t & xmsg_ctxt)
+    {
+#if XMSG_ENABLE_STATS
+        // 驻留耗时从入队时刻算起（不含调用方构造消息的耗时）
+        x_msgctxt_t xmsg_copy(xmsg_ctxt);
+        xmsg_copy.stamp(stats_tstamp());
+        return stats_publish(xmsg_ctxt.mkey(),
+                             x_queue_traits_t::push(m_xmsg_queue, std::move(xmsg_copy)));
+#else // !XMSG_ENABLE_STATS
+        return x_queue_traits_t::push(m_xmsg_queue, xmsg_ctxt);
+#endif // XMSG_ENABLE_STATS
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 发布消息（将消息加入到消息队列）。
+     * @return bool : 消息是否已入队。
+     */
+    bool publish(x_msgctxt_t && xmsg_ctxt)
+    {
+#if XMSG_ENABLE_STATS
+        // 入队后 xmsg_ctxt 已被移走，须先保留其索引键
+        const x_mkey_t xmkey = xmsg_ctxt.mkey();
+        xmsg_ctxt.stamp(stats_tstamp());
+        return stats_publish(xmkey,
+                             x_queue_traits_t::push(m_xmsg_queue,
+                                                    std::forward< x_msgctxt_t >(xmsg_ctxt)));
+#else // !XMSG_ENABLE_STATS
+        return x_queue_traits_t::push(m_xmsg_queue,
+                                      std::forward< x_msgctxt_t >(xmsg_ctxt));
+#endif // XMSG_ENABLE_STATS
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 发布消息（将消息加入到消息队列）。
+     * @return bool : 消息是否已入队。
+     */
+    template< typename... __args_t >
+    bool publish(const x_mkey_t & xmkey, __args_t &&... xargs)
+    {
+        return emplace_publish(xmkey, std::forward< __args_t >(xargs)...);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 以指定的优先级通道发布消息。
+     * @note
+     * 要求消息队列提供 emplace_prio() 接口（如 xmsg_lane_queue_t）。
+     * 
+     * @param [in ] xprio    : 优先级通道。
+     * @param [in ] xmkey    : 消息键。
+     * @param [in ] xargs... : 消息参数。
+     * 
+     * @return bool : 消息是否已入队。
+     */
+    template< typename... __args_t >
+    bool publish(xmsg_prio_t xprio, const x_mkey_t & xmkey, __args_t &&... xargs)
+    {
+        static_assert(
+            xmsg_args_check_t< x_msgctxt_t, __args_t... >::value,
+            "Incorrect the number of arguments!");
+
+        stats_stamp();
+        return stats_publish(xmkey,
+                             m_xmsg_queue.emplace_prio(
+                                 xprio, xmkey, std::forward< __args_t >(xargs)...));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 发布静态主题 __topic_t（xmsg_topic_t）的消息。
+     * @note
+     * 与 publish(__topic_t::value, xargs...) 相同，但在编译期检查
+     * 主题的类型 以及 xargs... 能否构造出主题的参数。
+     * 
+     * @return bool : 消息是否已入队。
+     */
+    template< typename __topic_t, typename... __args_t >
+    bool publish(__args_t &&... xargs)
+    {
+        topic_check< __topic_t >();
+        static_assert(
+            std::is_constructible< typename __topic_t::x_args_t, __args_t &&... >::value ||
+            std::is_constructible< typename x_msgctxt_t::x_payload_t, __args_t &&... >::value,
+            "The arguments do not match the parameters of the topic!");
+
+        return emplace_publish(__topic_t::value, std::forward< __args_t >(xargs)...);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 发布消息（在消息队列的存储空间中直接构造消息对象）。
+     * @note
+     * 消息参数直接转发给 x_msgctxt_t 的构造函数，不会产生临时的消息对象，
+     * 要求消息队列提供 emplace() 接口（std::queue、xmsg_mpsc_queue_t、
+     * xmsg_ring_queue_t 均已支持）。
+     * 
+     * @return bool : 消息是否已入队。
+     */
+    template< typename... __args_t >
+    bool emplace_publish(const x_mkey_t & xmkey, __args_t &&... xargs)
+    {
+        static_assert(
+            xmsg_args_check_t< x_msgctxt_t, __args_t... >::value,
+            "Incorrect the number of arguments!");
+
+        stats_stamp();
+        return stats_publish(xmkey,
+                             x_queue_traits_t::emplace(
+                                 m_xmsg_queue, xmkey, std::forward< __args_t >(xargs)...));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 投递消息，结果返回投递的消息数量。
+     */
+    size_t dispatch(size_t xmsg_maxcount = (size_t)-1)
+    {
+        size_t xmsg_count = 0;
+        x_msgctxt_t xmsg_ctxt;
+
+        while (!empty() && (xmsg_maxcount-- > 0))
+        {
+            xmsg_ctxt = std::move(m_xmsg_queue.front());
+            m_xmsg_queue.pop();
+
+            deliver(xmsg_ctxt);
+
+            xmsg_count += 1;
+        }
+
+        return xmsg_count;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 不经过消息队列，直接将消息投递给其订阅者。
+     * @note
+     * 用于 由外部存储消息对象 的场合（如 xmsg_hetero_publisher_t
+     * 在其字节流队列中直接投递消息对象）；须与 dispatch() 在同一个线程中调用。
+     */
+    void deliver(const x_msgctxt_t & xmsg_ctxt)
+    {
+        if (x_match_t::value)
+        {
+            dispatch_match(xmsg_ctxt, x_match_t());
+            return;
+        }
+
+        typename x_submap_t::iterator itset = m_xmap_suber.find(xmsg_ctxt.mkey());
+        stats_dispatch(xmsg_ctxt,
+                       (itset != m_xmap_suber.end()) ? itset->second.size() : 0);
+        if (itset != m_xmap_suber.end())
+        {
+            itset->second.dispatch(xmsg_ctxt);
+
+            if (itset->second.empty())
+            {
+                m_xmap_suber.erase(itset);
+            }
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 批量投递消息，结果返回投递的消息数量。
+     * @note
+     * 1. 先以 O(1) 的交换操作，将整个待投递的消息队列摘取到本地批次中，
+     *    然后直接在本地批次上投递消息（不再逐个移动到临时对象中）；
+     * 2. 连续的 mkey() 相同的消息，共用同一次订阅者集合的查找结果；
+     * 3. 投递过程中（在订阅者的消息处理接口中）新发布的消息，
+     *    留待下一次 dispatch_batch() 调用时再投递；
+     * 4. 若达到 xmsg_maxcount 时批次中仍有剩余消息，
+     *    则按原有顺序放回到消息队列的最前面。
+     */
+    size_t dispatch_batch(size_t xmsg_maxcount = (size_t)-1)
+    {
+        size_t xmsg_count = 0;
+        if ((0 == xmsg_maxcount) || empty())
+        {
+            return xmsg_count;
+        }
+
+        x_msgbatch_t xmsg_batch;
+        x_queue_traits_t::detach(m_xmsg_queue, xmsg_batch);
+
+        bool         xlookup  = false;      // 是否已有上一个消息的查找结果
+        x_mkey_t     xmkey    = x_mkey_t(); // 上一个消息的索引键
+        x_subset_t * xsub_set = nullptr;    // 上一个消息的订阅者集合
+
+        typename x_submap_t::iterator itset;
+        typename x_msgctxt_t::xmsg_mkey_t::x_equal_t xfunc_equal;
+
+        while (!xmsg_batch.empty() && (xmsg_count < xmsg_maxcount))
+        {
+            const x_msgctxt_t & xmsg_ctxt = xmsg_batch.front();
+
+            if (x_match_t::value)
+            {
+                dispatch_match(xmsg_ctxt, x_match_t());
+                xmsg_batch.pop();
+                xmsg_count += 1;
+                continue;
+            }
+
+            if (!xlookup || !xfunc_equal(xmkey, xmsg_ctxt.mkey()))
+            {
+                if ((nullptr != xsub_set) && xsub_set->empty())
+                {
+                    m_xmap_suber.erase(xmkey);
+                }
+
+                xlookup = true;
+                xmkey   = xmsg_ctxt.mkey();
+                itset   = m_xmap_suber.find(xmkey);
+                xsub_set = (itset != m_xmap_suber.end()) ? &itset->second : nullptr;
+            }
+
+            stats_dispatch(xmsg_ctxt, (nullptr != xsub_set) ? xsub_set->size() : 0);
+            if (nullptr != xsub_set)
+            {
+                xsub_set->dispatch(xmsg_ctxt);
+            }
+
+            xmsg_batch.pop();
+            xmsg_count += 1;
+        }
+
+        if ((nullptr != xsub_set) && xsub_set->empty())
+        {
+            m_xmap_suber.erase(xmkey);
+        }
+
+        if (!xmsg_batch.empty())
+        {
+            x_queue_traits_t::restore(m_xmsg_queue, xmsg_batch);
+        }
+
+        return xmsg_count;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 使用线程池并行投递消息，结果返回投递的消息数量。
+     * @note
+     * 1. 先摘取整个待投递的消息队列，按 hash(mkey()) 将消息划分到
+     *    若干个分区（线程数量的 4 倍）中，再由线程池的各个线程
+     *    逐个领取分区进行投递：同一个 mkey() 的消息总是在同一个分区中，
+     *    且按发布顺序投递；不同分区的消息则并发投递；
+     * 2. 投递过程中，消息订阅者映射表 只读不写（各线程无需加锁查找），
+     *    订阅者的消息处理接口中调用的 subscribe()/unsubscribe() 操作，
+     *    除了对当前线程所投递分区的 unsubscribe() 会立即生效外，
+     *    其余均延迟到本轮投递结束后（在调用线程中）执行；
+     * 3. 订阅者的消息处理接口会在多个线程中并发调用（不同的 mkey()），
+     *    若其中还会调用 publish() ，则消息队列须支持多线程并发写入
+     *    （如 xmsg_mpsc_queue_t）；
+     * 4. 须与 dispatch()/dispatch_batch() 在同一个线程中调用；
+     * 5. 消息对象在线程池的线程中析构，因此不支持以非原子引用计数
+     *    共享的消息参数（xmsg_shared_args_t 的 XREFCNT_SINGLE 策略）；
+     * 6. 消息处理接口抛出异常时，本轮尚未投递的消息被丢弃（与 dispatch() 相同，
+     *    已摘取的消息不再放回队列），延迟的订阅操作照常执行，随后重新抛出该异常。
+     * 
+     * @param [in ] xpool         : 线程池（如 xmsg_dispatch_pool_t）。
+     * @param [in ] xmsg_maxcount : 本轮投递的最大消息数量。
+     */
+    template< typename __pool_t >
+    size_t dispatch_parallel(__pool_t & xpool, size_t xmsg_maxcount = (size_t)-1)
+    {
+        static_assert(!x_match_t::value,
+                      "dispatch_parallel() does not support topic matching submap!");
+        static_assert(x_msgctxt_t::x_payload_traits_t::XTHREAD_SAFE,
+                      "dispatch_parallel() requires a thread-safe message payload!");
+
+        assert(!m_xparallel);
+
+        size_t xmsg_count = 0;
+        if ((0 == xmsg_maxcount) || empty())
+        {
+            return xmsg_count;
+        }
+
+        x_msgbatch_t xmsg_batch;
+        x_queue_traits_t::detach(m_xmsg_queue, xmsg_batch);
 
-        /**
-         * @struct x_deleter_t< __check_delete >
-         * @brief  订阅者对象的删除器。
-         */
-        template< typename __suber_t, bool __check_delete >
-        struct x_deleter_t;
+        //======================================
+        // 按 hash(mkey()) 划分消息分区
 
-        /**
-         * @struct x_deleter_t< true >
-         * @brief 订阅者对象的删除器。
-         * @note
-         * 仅对 x_subinvoke_t 类型的订阅者对象进行删除操作；
-         * 非 x_subinvoke_t 类型的订阅者为外部用户自定义的订阅者，
-         * 交由外部自行管理。
-         */
-        template< typename __suber_t >
-        struct x_deleter_t< __suber_t, true >
+        const size_t xparts = 4 * xpool.size();
+        if (m_xmsg_parts.size() < xparts)
         {
-            void operator()(__suber_t * xsub_ptr) const
-            {
-                if (xsub_ptr->sub_type() > XSUBER_BASE_TYPE)
-                    delete xsub_ptr;
-            }
-        };
+            m_xmsg_parts.resize(xparts);
+        }
 
-        /**
-         * @struct x_deleter_t< false >
-         * @brief 订阅者对象的删除器。
-         * @note 忽略订阅者对象的删除操作。
-         */
-        template< typename __suber_t >
-        struct x_deleter_t< __suber_t, false >
-        {
-            void operator()(__suber_t * xsub_ptr) const { }
-        };
+        m_xparts_count = xparts;
 
-        // constructor/destructor
-    public:
-        x_subptr_t(x_subscriber_t * xsub_ptr)
-            : x_super_t(xsub_ptr, x_deleter_t< x_subscriber_t, true >())
+        while (!xmsg_batch.empty() && (xmsg_count < xmsg_maxcount))
         {
+            x_msgctxt_t & xmsg_ctxt = xmsg_batch.front();
+
+            m_xmsg_parts[part_index(xmsg_ctxt.mkey())].push_back(
+                                                    std::move(xmsg_ctxt));
 
+            xmsg_batch.pop();
+            xmsg_count += 1;
         }
 
-        x_subptr_t(x_subscriber_t * xsub_ptr, bool)
-            : x_super_t(xsub_ptr, x_deleter_t< x_subscriber_t, false >())
+        if (!xmsg_batch.empty())
         {
-
+            x_queue_traits_t::restore(m_xmsg_queue, xmsg_batch);
         }
 
-        // public interfaces
-    public:
-        /**********************************************************/
-        /**
-         * @brief 创建 weak_ptr 类型的指针对象。
-         */
-        inline x_subwptr_t make_weak_ptr(void) const noexcept
+        //======================================
+        // 并行投递各个分区
+
+        std::exception_ptr xerror;
+
+        m_xparallel = true;
+        try
         {
-            return x_subwptr_t(
-                        *static_cast< x_super_t * >(
-                            const_cast< x_subptr_t * >(this)));
+            xpool.run(xparts, [this](size_t xpart) { dispatch_part(xpart); });
         }
-    };
+        catch (...)
+        {
+            xerror = std::current_exception();
+            for (size_t xpart = 0; xpart < xparts; ++xpart)
+            {
+                m_xmsg_parts[xpart].clear();
+            }
+        }
+        m_xparallel = false;
 
-    using x_subset_t = std::unordered_set<
-                                x_subptr_t,
-                                typename x_subptr_t::x_hash_t,
-                                typename x_subptr_t::x_equal_t >;
+        //======================================
+        // 执行投递过程中延迟的 subscribe()/unsubscribe() 操作
 
-    using x_submap_t = std::unordered_map<
-                                x_mkey_t,
-                                x_subset_t,
-                                typename x_msgctxt_t::xmsg_mkey_t::x_hash_t,
-                                typename x_msgctxt_t::xmsg_mkey_t::x_equal_t >;
+        std::vector< std::function< void(void) > > xdeferred;
+        {
+            std::lock_guard< std::mutex > xlock(m_xdefer_lock);
+            xdeferred.swap(m_xdeferred);
+        }
+
+        for (std::function< void(void) > & xfunc : xdeferred)
+        {
+            xfunc();
+        }
 
-    using x_iterptr_t = std::pair< x_mkey_t, typename x_subset_t::iterator * >;
+        if (xerror)
+        {
+            std::rethrow_exception(xerror);
+        }
 
-    // constructor/destructor
-public:
-    xmsg_publisher_t(void)
-    {
-        m_iter_suber.first  = x_mkey_t();
-        m_iter_suber.second = nullptr;
+        return xmsg_count;
     }
 
-    ~xmsg_publisher_t(void)
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 在编译期检查静态主题 __topic_t 与发布者的类型是否匹配，
+     *        以及其键值是否在映射表的槽位数组范围之内（若使用 xmsg_submap_static_t）。
+     */
+    template< typename __topic_t >
+    static inline void topic_check(void)
     {
-
+        static_assert(
+            xmsg_topic_check_t< __topic_t, x_mkey_t, typename x_msgctxt_t::x_args_t >::value,
+            "The topic's key type or parameter types do not match the publisher!");
+        static_assert(
+            (0 == xmsg_submap_slots_t< x_submap_t >::value) ||
+            (static_cast< size_t >(__topic_t::value) < xmsg_submap_slots_t< x_submap_t >::value),
+            "The topic's key is out of the static slots of the submap!");
     }
 
-    xmsg_publisher_t(xmsg_publisher_t && xobject) = delete;
-    xmsg_publisher_t & operator=(xmsg_publisher_t && xobject) = delete;
-    xmsg_publisher_t(const xmsg_publisher_t & xobject) = delete;
-    xmsg_publisher_t & operator=(const xmsg_publisher_t & xobject) = delete;
-
-    // public interfaces
-public:
     /**********************************************************/
     /**
-     * @brief 订阅者对象 订阅指定的消息类型。
-     * @note 该接口用于 非x_subinvoke_t（即用户重载的订阅者类） 类型的订阅操作。
-     * 
-     * @param [in ] xmkey    : 消息类型。
-     * @param [in ] xsub_ptr : 订阅者对象。
-     * 
-     * @return x_subkey_t
-     *         - 成功，返回的 x_subkey_t 有效；
-     *         - 失败，返回的 x_subkey_t 无效。
+     * @brief 将消息投递到所有与 mkey() 匹配的订阅者集合中
+     *        （消息订阅者映射表支持主题匹配时，如 xmsg_submap_topic_t）。
+     * @note
+     * 映射表在 match() 的回调过程中，会延迟执行 erase() 操作，
+     * 因此可以在回调中直接删除变为空的订阅者集合。
      */
-    x_subkey_t subscribe(const x_mkey_t & xmkey, x_subscriber_t * xsub_ptr)
+    void dispatch_match(const x_msgctxt_t & xmsg_ctxt, std::true_type)
     {
-        assert(nullptr != xsub_ptr);
-        assert(xsub_ptr->sub_type() < XSUBER_BASE_TYPE);
+        size_t xinvoked = 0;
+        stats_dispatch(xmsg_ctxt, 0);
+
+        m_xmap_suber.match(
+            xmsg_ctxt.mkey(),
+            [this, &xmsg_ctxt, &xinvoked](const x_mkey_t & xmkey, x_subset_t & xsub_set)
+            {
+                xinvoked += xsub_set.size();
+                xsub_set.dispatch(xmsg_ctxt);
 
-        return iinvk_subscribe(xmkey, xsub_ptr);
+                if (xsub_set.empty())
+                {
+                    m_xmap_suber.erase(xmkey);
+                }
+            });
+
+        stats_invoked(xmsg_ctxt.mkey(), xinvoked);
     }
 
     /**********************************************************/
     /**
-     * @brief 使用 “类似函数类型” 的订阅者 订阅指定的消息类型。
-     * @note 
-     * 1. “类似函数类型”，可泛指为 类对象成员函数、仿函数、lambda表达式 等。
-     * 2. 可以使用返回的 weak_ptr 所指向的 订阅者对象，
-     *    进行 unsubscribe() 取消该消息的订阅操作。
-     * 
-     * @param [in ] xmkey    : 消息类型。
-     * @param [in ] xfunc    : 消息处理的接口函数。
-     * @param [in ] xargs... : 回调的参数（或 类对象）。
-     * 
-     * @return x_subkey_t
-     *         - 成功，返回的 x_subkey_t 有效；
-     *         - 失败，返回的 x_subkey_t 无效。
+     * @brief 映射表不支持主题匹配时，不会调用该接口。
      */
-    template< typename __mfunc_t, typename... __args_t >
-    x_subkey_t subscribe(const x_mkey_t & xmkey,
-                         __mfunc_t && xfunc,
-                         __args_t &&... xargs)
+    void dispatch_match(const x_msgctxt_t &, std::false_type)
     {
-        using x_mfunc_t = __mfunc_t;
-        using x_tuple_t = typename std::tuple<
-                                typename std::decay< __args_t >::type... >;
-
-        x_subscriber_t * xsub_ptr =
-            new x_subinvoke_t< x_mfunc_t, x_tuple_t >(
-                    std::forward< x_mfunc_t >(xfunc),
-                    std::forward< x_tuple_t >(
-                        x_tuple_t{ std::forward< __args_t >(xargs)... }));
-        assert(nullptr != xsub_ptr);
 
-        return iinvk_subscribe(xmkey, xsub_ptr);
     }
 
     /**********************************************************/
     /**
-     * @brief 订阅者对象 取消订阅指定的消息类型。
-     * @note
-     * 在单线程环境下，若 dispatch() 操作的当前订阅者对象在处理消息时，
-     * 调用 unsubscribe() 进行自我取消订阅操作，这是没问题的；
-     * 多线程环境下，调用 unsubscribe() 是不安全的操作。
-     * 
-     * @param [in ] xmkey    : 消息类型。
-     * @param [in ] xsub_ptr : 订阅者对象。
+     * @brief 投递 dispatch_parallel() 中的一个消息分区（在线程池的线程中执行）。
      */
-    void unsubscribe(const x_mkey_t & xmkey, x_subscriber_t * xsub_ptr)
+    void dispatch_part(size_t xpart)
     {
-        typename x_submap_t::iterator itset = m_xmap_suber.find(xmkey);
-        if (itset == m_xmap_suber.end())
-        {
-            return;
-        }
+        std::vector< x_msgctxt_t > & xmsg_part = m_xmsg_parts[xpart];
 
-        // 若 取消的订阅者 为当前正在投递操作的 订阅者对象，
-        // 则需要同步递增 diapatch() 内部操作的 集合迭代器
-        if ((nullptr != m_iter_suber.second) &&
-            (xmkey == m_iter_suber.first))
-        {
-            typename x_subset_t::iterator & itsub = *m_iter_suber.second;
-            if (xsub_ptr == (*itsub).get())
-            {
-                itset->second.erase(itsub++);
-                m_iter_suber.second = nullptr;
+        // 记录当前线程正在投递的分区（用于 is_local_part() 的判断），
+        // 返回时（包括消息处理接口抛出异常）恢复
+        x_partscope_t xpart_scope{ part_context(), part_context() };
+        xpart_scope.xctx.xpublisher = this;
+        xpart_scope.xctx.xpart      = xpart;
 
-                return;
-            }
-        }
+        const x_mkey_t * xmkey    = nullptr; // 上一个消息的索引键
+        x_subset_t     * xsub_set = nullptr; // 上一个消息的订阅者集合
 
-        itset->second.erase(x_subptr_t(xsub_ptr, false));
+        typename x_submap_t::iterator itset;
+        typename x_msgctxt_t::xmsg_mkey_t::x_equal_t xfunc_equal;
 
-        // 若 消息集 为空，则从 消息订阅 的映射表中 删除该 消息集
-        if (itset->second.empty())
+        for (const x_msgctxt_t & xmsg_ctxt : xmsg_part)
         {
-            // 要取消的消息类型集合，不能为 当前正在投递操作 的集合
-            if ((nullptr == m_iter_suber.second) ||
-                (xmkey != m_iter_suber.first))
+            if ((nullptr == xmkey) || !xfunc_equal(*xmkey, xmsg_ctxt.mkey()))
             {
-                m_xmap_suber.erase(itset);
+                xmkey    = &xmsg_ctxt.mkey();
+                itset    = m_xmap_suber.find(*xmkey);
+                xsub_set = (itset != m_xmap_suber.end()) ? &itset->second : nullptr;
+            }
+
+            stats_dispatch(xmsg_ctxt, (nullptr != xsub_set) ? xsub_set->size() : 0);
+            if (nullptr != xsub_set)
+            {
+                xsub_set->dispatch(xmsg_ctxt);
+
+                // 订阅者集合在投递过程中变为空，则延迟删除该集合
+                if (xsub_set->empty())
+                {
+                    const x_mkey_t & xmkey_empty = *xmkey;
+                    defer_invoke([this, xmkey_empty](void)
+                                 {
+                                     erase_empty(xmkey_empty);
+                                 });
+                    xsub_set = nullptr;
+                }
             }
         }
+
+        xmsg_part.clear();
     }
 
-    /**********************************************************/
     /**
-     * @brief 订阅者对象 取消订阅指定的消息类型。
-     * 
-     * @param [in ] xsub_key : 其为 subscribe() 返回的订阅者索引键。
+     * @struct x_partctx_t
+     * @brief 记录当前线程正在投递的消息分区。
      */
-    void unsubscribe(const x_subkey_t & xsub_key)
+    struct x_partctx_t
     {
-        x_subsptr_t xsub_sptr = xsub_key.xwptr.lock();
-        if (nullptr != xsub_sptr)
+        const xmsg_publisher_t * xpublisher; ///< 所属的发布者
+        size_t                   xpart;      ///< 分区下标
+    };
+
+    /**
+     * @struct x_partscope_t
+     * @brief 离开作用域时，恢复当前线程正在投递的消息分区。
+     */
+    struct x_partscope_t
+    {
+        x_partctx_t       & xctx; ///< 当前线程的分区记录
+        const x_partctx_t   xold; ///< 进入作用域之前的分区记录
+
+        ~x_partscope_t(void)
         {
-            unsubscribe(xsub_key.xmkey, xsub_sptr.get());
+            xctx = xold;
         }
-    }
+    };
 
     /**********************************************************/
     /**
-     * @brief 取消 xmkey 下所有的订阅者对象。
+     * @brief 当前线程正在投递的消息分区（线程局部变量）。
      */
-    void unsubscribe(const x_mkey_t & xmkey)
+    static x_partctx_t & part_context(void)
     {
-        typename x_submap_t::iterator itset = m_xmap_suber.find(xmkey);
-        if (itset != m_xmap_suber.end())
-        {
-            // 要取消的消息类型集合，不能为 当前正在投递操作 的集合
-            if ((nullptr == m_iter_suber.second) ||
-                (xmkey != m_iter_suber.first))
-            {
-                m_xmap_suber.erase(itset);
-            }
-        }
+        static thread_local x_partctx_t xpart_ctx = { nullptr, 0 };
+        return xpart_ctx;
     }
 
     /**********************************************************/
     /**
-     * @brief 返回当前待投递的消息数量。
+     * @brief 计算 xmkey 在 dispatch_parallel() 中所属的消息分区下标。
      */
-    inline size_t size(void) const
+    inline size_t part_index(const x_mkey_t & xmkey) const
     {
-        return m_xmsg_queue.size();
+        // 先打散 std::hash 对整数类型的恒等映射，再取分区下标
+        uint64_t xhash = static_cast< uint64_t >(
+            typename x_msgctxt_t::xmsg_mkey_t::x_hash_t()(xmkey));
+        xhash = (xhash * 0x9E3779B97F4A7C15ull) >> 32;
+
+        return static_cast< size_t >(xhash % m_xparts_count);
     }
 
     /**********************************************************/
     /**
-     * @brief 判断消息队列是否为空。
+     * @brief 判断 xmkey 所属的消息分区是否正由当前线程投递。
      */
-    inline bool empty(void) const
+    inline bool is_local_part(const x_mkey_t & xmkey) const
     {
-        return (0 == size());
+        const x_partctx_t & xpart_ctx = part_context();
+        return ((this == xpart_ctx.xpublisher) &&
+                (part_index(xmkey) == xpart_ctx.xpart));
     }
 
     /**********************************************************/
     /**
-     * @brief 发布消息（将消息加入到消息队列）。
+     * @brief 记录接下来在队列中直接构造的消息对象的发布时间戳。
      */
-    void publish(const x_msgctxt_t & xmsg_ctxt)
+    inline void stats_stamp(void)
     {
-        m_xmsg_queue.push(xmsg_ctxt);
+#if XMSG_ENABLE_STATS
+        xmsg_stats_tstamp_t::pending() = stats_tstamp();
+#endif // XMSG_ENABLE_STATS
     }
 
+#if XMSG_ENABLE_STATS
     /**********************************************************/
     /**
-     * @brief 发布消息（将消息加入到消息队列）。
+     * @brief 发布消息的时间戳（按 XMSG_STATS_SAMPLE 抽样，未被抽中时为 0）。
      */
-    void publish(x_msgctxt_t && xmsg_ctxt)
+    static inline uint64_t stats_tstamp(void)
     {
-        m_xmsg_queue.push(std::forward< x_msgctxt_t >(xmsg_ctxt));
+        return xmsg_stats_sampled() ? xmsg_stats_now() : 0;
     }
+#endif // XMSG_ENABLE_STATS
 
     /**********************************************************/
     /**
-     * @brief 发布消息（将消息加入到消息队列）。
+     * @brief 统计发布消息的结果（未启用统计时，直接返回 xok）。
      */
-    template< typename... __args_t >
-    void publish(const x_mkey_t & xmkey, __args_t &&... xargs)
+    inline bool stats_publish(const x_mkey_t & xmkey, bool xok)
     {
-        static_assert(
-            std::tuple_size<
-                    typename x_msgctxt_t::x_args_t
-                >::value == sizeof...(xargs),
-            "Incorrect the number of arguments!");
+#if XMSG_ENABLE_STATS
+        x_stripe_t   & xstripe   = stats_stripe();
+        x_counters_t & xcounters = stats_counters(xstripe, xmkey);
 
-        publish(
-            std::forward< x_msgctxt_t >(
-                x_msgctxt_t(xmkey, std::forward< __args_t >(xargs)...)));
+        if (xok)
+        {
+            xmsg_stats_add(xstripe.xtotal.xpublished, 1, xstripe.xshared);
+            xmsg_stats_add(xcounters.xpublished, 1, xstripe.xshared);
+        }
+        else
+        {
+            xmsg_stats_add(xstripe.xtotal.xdropped, 1, xstripe.xshared);
+            xmsg_stats_add(xcounters.xdropped, 1, xstripe.xshared);
+        }
+#else // !XMSG_ENABLE_STATS
+        (void)xmkey;
+#endif // XMSG_ENABLE_STATS
+        return xok;
     }
 
     /**********************************************************/
     /**
-     * @brief 投递消息，结果返回投递的消息数量。
+     * @brief 统计投递的消息（在消息投递给订阅者之前调用）。
+     * 
+     * @param [in ] xmsg_ctxt : 投递的消息。
+     * @param [in ] xinvoked  : 将要调用的订阅者数量。
      */
-    size_t dispatch(size_t xmsg_maxcount = (size_t)-1)
+    inline void stats_dispatch(const x_msgctxt_t & xmsg_ctxt, size_t xinvoked)
     {
-        size_t xmsg_count = 0;
-        x_msgctxt_t xmsg_ctxt;
+#if XMSG_ENABLE_STATS
+        x_stripe_t   & xstripe   = stats_stripe();
+        x_counters_t & xcounters = stats_counters(xstripe, xmsg_ctxt.mkey());
 
-        typename x_submap_t::iterator itset;
-        typename x_subset_t::iterator itsub;
+        xmsg_stats_add(xstripe.xtotal.xdispatched, 1, xstripe.xshared);
+        xmsg_stats_add(xstripe.xtotal.xinvoked, xinvoked, xstripe.xshared);
+        xmsg_stats_add(xcounters.xdispatched, 1, xstripe.xshared);
+        xmsg_stats_add(xcounters.xinvoked, xinvoked, xstripe.xshared);
 
-        while (!empty() && (xmsg_maxcount-- > 0))
+        if (0 != xmsg_ctxt.tstamp())
         {
-            xmsg_ctxt = std::move(m_xmsg_queue.front());
-            m_xmsg_queue.pop();
+            const uint64_t xtm_now = xmsg_stats_now();
 
-            itset = m_xmap_suber.find(xmsg_ctxt.mkey());
-            if (itset != m_xmap_suber.end())
-            {
-                m_iter_suber.first = xmsg_ctxt.mkey();
+            xstripe.xresidency.record(
+                (xtm_now > xmsg_ctxt.tstamp()) ? (xtm_now - xmsg_ctxt.tstamp()) : 0,
+                xstripe.xshared);
+        }
+#else // !XMSG_ENABLE_STATS
+        (void)xmsg_ctxt;
+        (void)xinvoked;
+#endif // XMSG_ENABLE_STATS
+    }
 
-                for (itsub = itset->second.begin();
-                     itsub != itset->second.end();)
-                {
-                    m_iter_suber.second = &itsub;
-                    (*itsub)->translate(xmsg_ctxt);
-
-                    if (nullptr != m_iter_suber.second)
-                    {
-                        ++itsub;
-                        m_iter_suber.second = nullptr;
-                    }
-                }
+    /**********************************************************/
+    /**
+     * @brief 统计消息处理接口的调用次数（用于主题匹配的投递过程，
+     *        匹配完成后才能得知调用的订阅者数量）。
+     */
+    inline void stats_invoked(const x_mkey_t & xmkey, size_t xinvoked)
+    {
+#if XMSG_ENABLE_STATS
+        x_stripe_t & xstripe = stats_stripe();
+        xmsg_stats_add(xstripe.xtotal.xinvoked, xinvoked, xstripe.xshared);
+        xmsg_stats_add(stats_counters(xstripe, xmkey).xinvoked, xinvoked, xstripe.xshared);
+#else // !XMSG_ENABLE_STATS
+        (void)xmkey;
+        (void)xinvoked;
+#endif // XMSG_ENABLE_STATS
+    }
 
-                m_iter_suber.first = x_mkey_t();
+#if XMSG_ENABLE_STATS
+    /**********************************************************/
+    /**
+     * @brief 当前线程使用的统计条带（首次使用时创建）。
+     */
+    x_stripe_t & stats_stripe(void)
+    {
+        const size_t xindex = xmsg_stats_thread_t::index();
 
-                if (itset->second.empty())
-                {
-                    m_xmap_suber.erase(itset);
-                }
+        x_stripe_t * xstripe = m_xstats[xindex].load(std::memory_order_acquire);
+        if (nullptr == xstripe)
+        {
+            // 只有共用的条带才可能被多个线程同时创建
+            x_stripe_t * xstripe_new = new x_stripe_t(XMSG_STATS_THREADS == xindex);
+            if (m_xstats[xindex].compare_exchange_strong(xstripe,
+                                                         xstripe_new,
+                                                         std::memory_order_acq_rel,
+                                                         std::memory_order_acquire))
+            {
+                xstripe = xstripe_new;
             }
+            else
+            {
+                delete xstripe_new;
+            }
+        }
 
-            xmsg_count += 1;
+        return *xstripe;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 统计条带中 xmkey 的计数器（不存在时插入）。
+     * @note
+     * 返回的引用一直有效（std::unordered_map 的重新散列不会移动元素）。
+     */
+    x_counters_t & stats_counters(x_stripe_t & xstripe, const x_mkey_t & xmkey)
+    {
+        if (!xstripe.xshared)
+        {
+            typename x_keystats_t::iterator itkey = xstripe.xkeys.find(xmkey);
+            if (itkey != xstripe.xkeys.end())
+            {
+                return itkey->second;
+            }
         }
 
-        return xmsg_count;
+        std::lock_guard< std::mutex > xlock(xstripe.xlock);
+        return xstripe.xkeys[xmkey];
+    }
+#endif // XMSG_ENABLE_STATS
+
+    /**********************************************************/
+    /**
+     * @brief 若 xmkey 的订阅者集合为空，则从映射表中删除该集合。
+     */
+    void erase_empty(const x_mkey_t & xmkey)
+    {
+        typename x_submap_t::iterator itset = m_xmap_suber.find(xmkey);
+        if ((itset != m_xmap_suber.end()) &&
+            itset->second.empty() &&
+            !itset->second.is_dispatching())
+        {
+            m_xmap_suber.erase(itset);
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 延迟执行 dispatch_parallel() 投递过程中的订阅操作
+     *        （可在线程池的多个线程中并发调用）。
+     */
+    template< typename __func_t >
+    void defer_invoke(__func_t && xfunc)
+    {
+        std::lock_guard< std::mutex > xlock(m_xdefer_lock);
+        m_xdeferred.push_back(std::forward< __func_t >(xfunc));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 延迟执行 dispatch_parallel() 投递过程中的取消订阅操作。
+     */
+    inline void defer_unsubscribe(const x_mkey_t & xmkey, x_subscriber_t * xsub_ptr)
+    {
+        defer_invoke([this, xmkey, xsub_ptr](void)
+                     {
+                         unsubscribe(xmkey, xsub_ptr);
+                     });
     }
 
-    // inner invoking
-private:
     /**********************************************************/
     /**
      * @brief 订阅者对象 订阅指定的消息类型。
      * 
-     * @param [in ] xmkey    : 消息类型。
-     * @param [in ] xsub_ptr : 订阅者对象。
+     * @param [in ] xmkey     : 消息类型。
+     * @param [in ] xsub_optr : 订阅者对象的智能指针。
      * 
      * @return x_subkey_t
      *         - 成功，返回的 x_subkey_t 有效；
      *         - 失败，返回的 x_subkey_t 无效。
      */
     x_subkey_t iinvk_subscribe(const x_mkey_t & xmkey,
-                               x_subscriber_t * xsub_ptr)
+                               const x_subptr_t & xsub_optr)
     {
-        using x_ipair_t = typename std::pair<
-                                typename x_subset_t::iterator, bool >;
+        // dispatch_parallel() 投递过程中，订阅者对象由延迟操作持有，
+        // 待本轮投递结束后才加入到 订阅者集合 中
+        if (m_xparallel)
+        {
+            defer_invoke([this, xmkey, xsub_optr](void)
+                         {
+                             iinvk_subscribe(xmkey, xsub_optr);
+                         });
+            return x_subkey_t(xmkey, xsub_optr.make_weak_ptr());
+        }
 
-        x_subptr_t xsub_optr(xsub_ptr);
         x_subset_t & xsub_set = m_xmap_suber[xmkey];
 
-        x_ipair_t xipair = xsub_set.insert(xsub_optr);
-        if (xipair.second)
+        if (xsub_set.insert(xsub_optr))
         {
             return x_subkey_t(xmkey, xsub_optr.make_weak_ptr());
         }
@@ -955,30 +4574,57 @@ private:
 
     // data members
 private:
-    x_iterptr_t   m_iter_suber;  ///< 指向当前正在进行消息投递操作的订阅者信息
-    x_submap_t    m_xmap_suber;  ///< 消息订阅者映射表
-    x_msgqueue_t  m_xmsg_queue;  ///< 消息队列
+    x_submap_t    m_xmap_suber;   ///< 消息订阅者映射表
+    x_msgqueue_t  m_xmsg_queue;   ///< 消息队列
+
+    bool          m_xparallel;    ///< 是否处于 dispatch_parallel() 的并行投递过程中
+    size_t        m_xparts_count; ///< 当前并行投递的消息分区数量
+    std::mutex    m_xdefer_lock;  ///< 保护 m_xdeferred 的互斥锁
+    std::vector< std::function< void(void) > >
+                  m_xdeferred;    ///< 并行投递过程中延迟执行的订阅操作
+    std::vector< std::vector< x_msgctxt_t > >
+                  m_xmsg_parts;   ///< 并行投递使用的消息分区
+#if XMSG_ENABLE_STATS
+    std::atomic< x_stripe_t * >
+                  m_xstats[XMSG_STATS_THREADS + 1]; ///< 各个线程的统计条带
+#endif // XMSG_ENABLE_STATS
 };
 
 /** 用于生成 x_subinvoke_t 类型标识的流水号 */
-template< typename __msg_context_t, typename __msg_queue_t >
+template< typename __msg_context_t,
+          typename __msg_queue_t,
+          template< typename > class __subset_t,
+          template< typename, typename, typename, typename > class __submap_t >
 std::atomic_size_t xmsg_publisher_t<
                         __msg_context_t,
-                        __msg_queue_t
+                        __msg_queue_t,
+                        __subset_t,
+                        __submap_t
                    >::sub_type_seqno(XSUBER_BASE_TYPE + 1);
 
 /** x_subinvoke_t 的订阅者类型 */
-template< typename __msg_context_t, typename __msg_queue_t >
+template< typename __msg_context_t,
+          typename __msg_queue_t,
+          template< typename > class __subset_t,
+          template< typename, typename, typename, typename > class __submap_t >
 template< typename __mfunc_t, typename __tuple_t >
 xsub_type_t xmsg_publisher_t<
                         __msg_context_t,
-                        __msg_queue_t
+                        __msg_queue_t,
+                        __subset_t,
+                        __submap_t
                    >::x_subinvoke_t<
                         __mfunc_t,
                         __tuple_t >::sub_type_value =
             xmsg_publisher_t<
                         __msg_context_t,
-                        __msg_queue_t >::make_sub_type();
+                        __msg_queue_t,
+                        __subset_t,
+                        __submap_t >::make_sub_type();
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // inline namespace xmsg_abi_stats / xmsg_abi_plain
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -0,0 +1,633 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file xmsg_ring_queue.h
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * @author  ：Gaaagaa
+ * @date    : 2026-10-18
+ * @version : 1.0.0.0
+ * @brief   : 预分配存储空间的有界环形消息队列（支持多种溢出策略）。
+ */
+
+#ifndef __XMSG_RING_QUEUE_H__
+#define __XMSG_RING_QUEUE_H__
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <utility>
+#include <type_traits>
+#include <cstddef>
+#include <cassert>
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_overflow_t
+
+/**
+ * @enum xmsg_overflow_t
+ * @brief xmsg_ring_queue_t 队列已满时，push()/emplace() 的溢出策略。
+ */
+enum xmsg_overflow_t
+{
+    XOVERFLOW_BLOCK       = 0, ///< 阻塞等待，直至队列有空闲位置（返回 true）
+    XOVERFLOW_DROP_NEWEST = 1, ///< 丢弃新入队的消息（返回 true，计入丢弃数量）
+    XOVERFLOW_DROP_OLDEST = 2, ///< 丢弃队列中最早的消息，为新消息腾出位置（返回 true）
+    XOVERFLOW_REJECT      = 3, ///< 拒绝入队（返回 false，计入丢弃数量）
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_ring_queue_t
+
+/**
+ * @class xmsg_ring_queue_t< __value_t, __capacity, __overflow >
+ * @brief 多生产者/单消费者（MPSC）的有界环形队列。
+ * @note
+ * 1. 接口与 std::queue 保持一致，可直接作为 xmsg_publisher_t 的
+ *    __msg_queue_t 模板参数使用：任意线程均可调用 publish()（即 push()），
+ *    而 dispatch()（即 empty()/front()/pop()）只能在同一个消费者线程中调用；
+ * 2. 存储空间在构造时一次性分配（__capacity 个元素），此后入队/出队
+ *    都不再分配内存；每个槽位带有序号，生产者之间以 CAS 竞争写入位置，
+ *    无需加锁（有界队列的序号算法）；
+ * 3. push()/emplace() 返回 false 表示消息未入队（仅 XOVERFLOW_REJECT），
+ *    xmsg_publisher_t::publish() 会将该结果返回给调用方；
+ * 4. XOVERFLOW_BLOCK 策略下，生产者先短暂让出时间片，之后在条件变量上
+ *    等待消费者 pop() 的唤醒（仅当有生产者等待时，pop() 才会加锁通知）；
+ *    不能在消费者线程（如 订阅者的消息处理接口）中向已满的队列发布消息，
+ *    否则会永久阻塞；
+ * 5. XOVERFLOW_DROP_OLDEST 策略下，生产者也会从队首取出（丢弃）元素，
+ *    因此消费者端先将队首元素取出到私有的存储空间中，再由 front() 返回；
+ *    empty() 只读取队列状态，不会取出元素。
+ *
+ * @param [in ] __value_t  : 队列元素类型。
+ * @param [in ] __capacity : 队列容量（必须为 2 的幂）。
+ * @param [in ] __overflow : 队列已满时的溢出策略。
+ */
+template< typename __value_t,
+          size_t __capacity,
+          xmsg_overflow_t __overflow = XOVERFLOW_BLOCK >
+class xmsg_ring_queue_t
+{
+    static_assert((__capacity >= 2) && (0 == (__capacity & (__capacity - 1))),
+                  "__capacity must be a power of 2!");
+
+    // common data types
+public:
+    typedef __value_t           value_type;
+    typedef size_t              size_type;
+    typedef __value_t &         reference;
+    typedef const __value_t &   const_reference;
+
+    /**
+     * @class x_batch_t
+     * @brief 供 xmsg_publisher_t::dispatch_batch() 使用的批次视图。
+     * @note
+     * 摘取（detach）时只记录当前的写入位置，批次中的元素
+     * 仍然保存在环形队列中，直接在队列上逐个投递，无需移动；
+     * 写入位置之后发布的消息不属于该批次（即便队首元素被丢弃）。
+     */
+    class x_batch_t
+    {
+        friend class xmsg_ring_queue_t;
+
+    public:
+        x_batch_t(void) : m_xqueue(nullptr), m_xend(0) { }
+
+        inline bool empty(void) const
+        {
+            return ((nullptr == m_xqueue) || !m_xqueue->ready_before(m_xend));
+        }
+
+        inline reference front(void)
+        {
+            return m_xqueue->front();
+        }
+
+        inline void pop(void)
+        {
+            m_xqueue->pop();
+        }
+
+    private:
+        xmsg_ring_queue_t * m_xqueue; ///< 所属的环形队列
+        size_type           m_xend;   ///< 摘取时的写入位置（批次只包含其之前的元素）
+    };
+
+private:
+    /**
+     * @struct x_slot_t
+     * @brief 环形队列的槽位。
+     */
+    struct x_slot_t
+    {
+        std::atomic< size_type > xseq; ///< 槽位序号（用于判断槽位可读/可写）
+        typename std::aligned_storage< sizeof(value_type),
+                                       alignof(value_type) >::type
+                                 xvalue; ///< 元素对象的存储空间
+    };
+
+    /** 队列容量 */
+    static constexpr size_type XCAPACITY = __capacity;
+    /** 槽位下标的掩码 */
+    static constexpr size_type XMASK     = __capacity - 1;
+
+    /** 缓存行大小（用于隔离 生产者 与 消费者 的数据成员，避免伪共享） */
+    static constexpr size_t XCACHE_LINE_SIZE = 64;
+
+    // constructor/destructor
+public:
+    xmsg_ring_queue_t(void)
+        : m_xslots(new x_slot_t[__capacity])
+        , m_xtail(0)
+        , m_xhead(0)
+        , m_xfvalid(false)
+        , m_xfpos(0)
+        , m_xdrops(0)
+        , m_xhigh(0)
+        , m_xwaiters(0)
+    {
+        for (size_type xiter = 0; xiter < XCAPACITY; ++xiter)
+        {
+            m_xslots[xiter].xseq.store(xiter, std::memory_order_relaxed);
+        }
+    }
+
+    ~xmsg_ring_queue_t(void)
+    {
+        if (m_xfvalid)
+        {
+            front_value()->~value_type();
+        }
+
+        while (take(nullptr, nullptr))
+        {
+        }
+    }
+
+    xmsg_ring_queue_t(xmsg_ring_queue_t && xobject) = delete;
+    xmsg_ring_queue_t & operator=(xmsg_ring_queue_t && xobject) = delete;
+    xmsg_ring_queue_t(const xmsg_ring_queue_t & xobject) = delete;
+    xmsg_ring_queue_t & operator=(const xmsg_ring_queue_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 队列容量。
+     */
+    inline size_type capacity(void) const
+    {
+        return XCAPACITY;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 返回队列中的元素数量（多线程并发时为近似值）。
+     */
+    inline size_type size(void) const
+    {
+        size_type xtail = m_xtail.load(std::memory_order_relaxed);
+        size_type xhead = m_xhead.load(std::memory_order_relaxed);
+        return (xtail > xhead) ? (xtail - xhead) : 0;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 判断队列是否为空（仅限消费者线程调用）。
+     */
+    inline bool empty(void) const
+    {
+        if ((XOVERFLOW_DROP_OLDEST == __overflow) && m_xfvalid)
+        {
+            return false;
+        }
+
+        size_type xhead = m_xhead.load(std::memory_order_relaxed);
+        return (m_xslots[xhead & XMASK].xseq.load(std::memory_order_acquire) !=
+                (xhead + 1));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 因队列已满而 丢弃/拒绝 的消息数量。
+     */
+    inline size_type drops(void) const
+    {
+        return m_xdrops.load(std::memory_order_relaxed);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 队列中元素数量的最高水位。
+     */
+    inline size_type high_water(void) const
+    {
+        return m_xhigh.load(std::memory_order_relaxed);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将元素压入队列（可在任意线程中调用）。
+     * @return bool : 返回 false 时，表示队列已满且拒绝了该元素。
+     */
+    bool push(const value_type & xvalue)
+    {
+        return emplace(xvalue);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将元素压入队列（可在任意线程中调用）。
+     * @return bool : 返回 false 时，表示队列已满且拒绝了该元素。
+     */
+    bool push(value_type && xvalue)
+    {
+        return emplace(std::forward< value_type >(xvalue));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 在队列槽位中直接构造元素（可在任意线程中调用）。
+     * @return bool : 返回 false 时，表示队列已满且拒绝了该元素。
+     */
+    template< typename... __args_t >
+    bool emplace(__args_t &&... xargs)
+    {
+        for (size_t xspin = 0; !try_emplace(std::forward< __args_t >(xargs)...); ++xspin)
+        {
+            switch (__overflow)
+            {
+            case XOVERFLOW_BLOCK:
+                // 先让出时间片，多次之后阻塞等待消费者的唤醒
+                if (xspin < 64)
+                    std::this_thread::yield();
+                else
+                    wait_for_space();
+                break;
+
+            case XOVERFLOW_DROP_OLDEST:
+                if (take(nullptr, nullptr))
+                    m_xdrops.fetch_add(1, std::memory_order_relaxed);
+                break;
+
+            case XOVERFLOW_DROP_NEWEST:
+                m_xdrops.fetch_add(1, std::memory_order_relaxed);
+                return true;
+
+            default:
+                m_xdrops.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 返回队首元素（仅限消费者线程调用，且队列不为空）。
+     */
+    reference front(void)
+    {
+        if (XOVERFLOW_DROP_OLDEST == __overflow)
+        {
+            fetch_front();
+            return *front_value();
+        }
+
+        x_slot_t & xslot = m_xslots[m_xhead.load(std::memory_order_relaxed) & XMASK];
+        return *reinterpret_cast< value_type * >(&xslot.xvalue);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 弹出队首元素（仅限消费者线程调用，且队列不为空）。
+     */
+    void pop(void)
+    {
+        if (XOVERFLOW_DROP_OLDEST == __overflow)
+        {
+            fetch_front();
+            front_value()->~value_type();
+            m_xfvalid = false;
+            return;
+        }
+
+        // 仅有消费者线程会移动读取位置，无需 CAS 操作
+        size_type  xpos  = m_xhead.load(std::memory_order_relaxed);
+        x_slot_t & xslot = m_xslots[xpos & XMASK];
+        assert(xslot.xseq.load(std::memory_order_relaxed) == (xpos + 1));
+
+        reinterpret_cast< value_type * >(&xslot.xvalue)->~value_type();
+        m_xhead.store(xpos + 1, std::memory_order_relaxed);
+
+        // XOVERFLOW_BLOCK 策略下，与 notify_space() 中读取等待者数量的操作
+        // 构成全序（参看 wait_for_space() 的说明）
+        xslot.xseq.store(xpos + XCAPACITY,
+                         (XOVERFLOW_BLOCK == __overflow) ? std::memory_order_seq_cst :
+                                                          std::memory_order_release);
+
+        notify_space();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 摘取队列中已就绪的消息到批次视图 xbatch 中（仅限消费者线程调用）。
+     */
+    void detach(x_batch_t & xbatch)
+    {
+        xbatch.m_xqueue = this;
+        xbatch.m_xend   = m_xtail.load(std::memory_order_acquire);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 放回批次视图 xbatch 中剩余的消息（仅限消费者线程调用）。
+     * @note 批次中的元素从未离开过队列，此处只需解除绑定。
+     */
+    void restore(x_batch_t & xbatch)
+    {
+        xbatch.m_xqueue = nullptr;
+        xbatch.m_xend   = 0;
+    }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 尝试在队尾构造元素，队列已满时返回 false 。
+     */
+    template< typename... __args_t >
+    bool try_emplace(__args_t &&... xargs)
+    {
+        size_type xpos = m_xtail.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            x_slot_t & xslot = m_xslots[xpos & XMASK];
+            size_type xseq = xslot.xseq.load(std::memory_order_acquire);
+            ptrdiff_t xdiff = static_cast< ptrdiff_t >(xseq - xpos);
+
+            if (0 == xdiff)
+            {
+                if (m_xtail.compare_exchange_weak(xpos, xpos + 1,
+                                                  std::memory_order_relaxed))
+                {
+                    ::new (static_cast< void * >(&xslot.xvalue))
+                        value_type(std::forward< __args_t >(xargs)...);
+                    xslot.xseq.store(xpos + 1, std::memory_order_release);
+
+                    update_high_water(xpos + 1);
+                    return true;
+                }
+            }
+            else if (xdiff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                xpos = m_xtail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 尝试从队首取出元素（移动构造到 xdest 中；xdest 为 nullptr 时直接销毁），
+     *        队列为空时返回 false 。
+     * 
+     * @param [out] xtaken : 操作成功返回时，回填取出元素的位置（可为 nullptr）。
+     */
+    bool take(void * xdest, size_type * xtaken)
+    {
+        size_type xpos = m_xhead.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            x_slot_t & xslot = m_xslots[xpos & XMASK];
+            size_type xseq = xslot.xseq.load(std::memory_order_acquire);
+            ptrdiff_t xdiff = static_cast< ptrdiff_t >(xseq - (xpos + 1));
+
+            if (0 == xdiff)
+            {
+                if (m_xhead.compare_exchange_weak(xpos, xpos + 1,
+                                                  std::memory_order_relaxed))
+                {
+                    value_type * xvalue = reinterpret_cast< value_type * >(&xslot.xvalue);
+                    if (nullptr != xdest)
+                    {
+                        ::new (xdest) value_type(std::move(*xvalue));
+                    }
+
+                    xvalue->~value_type();
+                    xslot.xseq.store(xpos + XCAPACITY, std::memory_order_release);
+
+                    if (nullptr != xtaken)
+                    {
+                        *xtaken = xpos;
+                    }
+
+                    return true;
+                }
+            }
+            else if (xdiff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                xpos = m_xhead.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将队首元素预先取出到消费者端私有的存储空间中
+     *        （仅用于 XOVERFLOW_DROP_OLDEST 策略）。
+     */
+    inline bool prefetch(void)
+    {
+        if (!m_xfvalid)
+        {
+            m_xfvalid = take(&m_xfront, &m_xfpos);
+        }
+
+        return m_xfvalid;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 确保队首元素已取出到私有的存储空间中
+     *        （仅用于 XOVERFLOW_DROP_OLDEST 策略，且 empty() 返回 false 之后）。
+     * @note
+     * empty() 之后，队首元素仍可能被丢弃消息的生产者先行取出；
+     * 生产者只在队列已满时丢弃，并随即写入新的元素，所以只需短暂等待。
+     */
+    inline void fetch_front(void)
+    {
+        while (!prefetch())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 判断队首元素是否已就绪，且其位置在 xend 之前（仅限消费者线程调用）。
+     */
+    inline bool ready_before(size_type xend)
+    {
+        size_type xpos = 0;
+
+        if (XOVERFLOW_DROP_OLDEST == __overflow)
+        {
+            // 队首元素可能同时被生产者丢弃，须先取出，才能确定其位置
+            if (!prefetch())
+            {
+                return false;
+            }
+
+            xpos = m_xfpos;
+        }
+        else
+        {
+            if (empty())
+            {
+                return false;
+            }
+
+            xpos = m_xhead.load(std::memory_order_relaxed);
+        }
+
+        return (static_cast< ptrdiff_t >(xpos - xend) < 0);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 判断队列是否已满（队尾位置的槽位尚未被消费者释放）。
+     */
+    inline bool full(void) const
+    {
+        size_type xpos = m_xtail.load(std::memory_order_relaxed);
+        size_type xseq = m_xslots[xpos & XMASK].xseq.load(std::memory_order_seq_cst);
+        return (static_cast< ptrdiff_t >(xseq - xpos) < 0);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 阻塞等待，直至队列有空闲位置（仅用于 XOVERFLOW_BLOCK 策略）。
+     * @note
+     * 本线程 先递增等待者数量 再检查槽位，消费者 先释放槽位 再读取等待者数量，
+     * 这四个操作都是 seq_cst 的：消费者要么看到本线程在等待（加锁后通知），
+     * 要么本线程看到其释放的槽位（不进入等待）。
+     */
+    void wait_for_space(void)
+    {
+        std::unique_lock< std::mutex > xlock(m_xmutex);
+
+        m_xwaiters.fetch_add(1, std::memory_order_seq_cst);
+        m_xcond.wait(xlock, [this](void) -> bool { return !full(); });
+        m_xwaiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 释放槽位后，唤醒等待空闲位置的生产者（仅用于 XOVERFLOW_BLOCK 策略）。
+     */
+    inline void notify_space(void)
+    {
+        if (XOVERFLOW_BLOCK != __overflow)
+        {
+            return;
+        }
+
+        if (m_xwaiters.load(std::memory_order_seq_cst) > 0)
+        {
+            // 加锁以确保 等待者 已进入等待状态（或者尚未检查等待条件）
+            {
+                std::lock_guard< std::mutex > xautolock(m_xmutex);
+            }
+
+            m_xcond.notify_all();
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 消费者端私有存储空间中的元素对象。
+     */
+    inline value_type * front_value(void)
+    {
+        return reinterpret_cast< value_type * >(&m_xfront);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 更新队列元素数量的最高水位。
+     */
+    inline void update_high_water(size_type xtail)
+    {
+        size_type xhead = m_xhead.load(std::memory_order_relaxed);
+        size_type xsize = (xtail > xhead) ? (xtail - xhead) : 0;
+        if (xsize > XCAPACITY)
+        {
+            // 读取位置 为旧值时的估算误差
+            xsize = XCAPACITY;
+        }
+
+        size_type xhigh = m_xhigh.load(std::memory_order_relaxed);
+
+        while ((xsize > xhigh) &&
+               !m_xhigh.compare_exchange_weak(xhigh, xsize,
+                                              std::memory_order_relaxed))
+        {
+        }
+    }
+
+    // data members
+private:
+    std::unique_ptr< x_slot_t[] >  m_xslots;  ///< 环形队列的槽位数组
+    char m_xpad0[XCACHE_LINE_SIZE];           ///< 隔离 槽位数组 与 生产者 的数据成员
+    std::atomic< size_type >       m_xtail;   ///< 生产者端的写入位置
+    char m_xpad1[XCACHE_LINE_SIZE];           ///< 隔离 生产者 与 消费者 的数据成员
+    std::atomic< size_type >       m_xhead;   ///< 消费者端的读取位置
+    bool                           m_xfvalid; ///< 私有存储空间中是否有元素
+    size_type                      m_xfpos;   ///< 私有存储空间中的元素原先所在的位置
+    typename std::aligned_storage< sizeof(value_type),
+                                   alignof(value_type) >::type
+                                   m_xfront;  ///< 消费者端私有的存储空间
+    char m_xpad2[XCACHE_LINE_SIZE];           ///< 隔离 消费者 与 统计计数 的数据成员
+    std::atomic< size_type >       m_xdrops;  ///< 丢弃/拒绝 的消息数量
+    std::atomic< size_type >       m_xhigh;   ///< 元素数量的最高水位
+    std::atomic< size_type >     m_xwaiters;  ///< 等待空闲位置的生产者数量
+    std::mutex                     m_xmutex;  ///< 等待空闲位置时使用的互斥锁
+    std::condition_variable        m_xcond;   ///< 等待空闲位置时使用的条件变量
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __XMSG_RING_QUEUE_H__
@@ -0,0 +1,702 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file xmsg_run_loop.h
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * @author  ：Gaaagaa
+ * @date    : 2026-10-18
+ * @version : 1.0.0.0
+ * @brief   : 事件驱动的消息投递循环（队列为空时阻塞等待，发布消息时唤醒）。
+ */
+
+#ifndef __XMSG_RUN_LOOP_H__
+#define __XMSG_RUN_LOOP_H__
+
+#include "xmsg_pubsub.h"
+#include "xmsg_mpsc_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <system_error>
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#else // !defined(__linux__)
+#include <mutex>
+#include <condition_variable>
+#endif // defined(__linux__)
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif // defined(_MSC_VER)
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_event_t
+
+/**********************************************************/
+/**
+ * @brief 自旋等待时降低 CPU 的占用（x86 的 pause 指令）。
+ */
+inline void xmsg_cpu_relax(void)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+/**
+ * @class xmsg_event_t
+ * @brief 消费者（投递线程）阻塞等待、生产者唤醒的事件对象。
+ * @note
+ * 1. Linux 下使用 eventfd 实现，fd() 可加入到 epoll/poll 中监听；
+ *    其他平台使用 std::condition_variable 实现（fd() 返回 -1）；
+ * 2. 只有消费者处于等待状态（prepare_wait() 之后）时，notify()
+ *    才会真正写入 eventfd ，否则只有一次内存屏障 与 一次读取操作；
+ * 3. 消费者的等待流程：prepare_wait() -> 再次检查等待条件
+ *    -> 条件已满足则 cancel_wait()，否则 wait_for()。
+ */
+class xmsg_event_t
+{
+    // constructor/destructor
+public:
+    xmsg_event_t(void)
+        : m_xparked(false)
+#if defined(__linux__)
+        , m_xfd(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+#else // !defined(__linux__)
+        , m_xsignaled(false)
+#endif // defined(__linux__)
+    {
+#if defined(__linux__)
+        if (m_xfd < 0)
+        {
+            throw std::system_error(errno, std::system_category(), "eventfd()");
+        }
+#endif // defined(__linux__)
+    }
+
+    ~xmsg_event_t(void)
+    {
+#if defined(__linux__)
+        ::close(m_xfd);
+#endif // defined(__linux__)
+    }
+
+    xmsg_event_t(xmsg_event_t && xobject) = delete;
+    xmsg_event_t & operator=(xmsg_event_t && xobject) = delete;
+    xmsg_event_t(const xmsg_event_t & xobject) = delete;
+    xmsg_event_t & operator=(const xmsg_event_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 用于 epoll/poll 监听的文件描述符（不支持时返回 -1）。
+     */
+    inline int fd(void) const
+    {
+#if defined(__linux__)
+        return m_xfd;
+#else // !defined(__linux__)
+        return -1;
+#endif // defined(__linux__)
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 生产者完成入队操作后调用：若消费者正在等待，则唤醒之。
+     */
+    inline void notify(void)
+    {
+        // 与 prepare_wait() 中的屏障配对：要么消费者看到新的元素，
+        // 要么生产者看到消费者的等待标识
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_xparked.load(std::memory_order_relaxed) &&
+            m_xparked.exchange(false, std::memory_order_acq_rel))
+        {
+            signal();
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 无条件唤醒消费者（如 停止投递循环时）。
+     */
+    void signal(void)
+    {
+#if defined(__linux__)
+        const uint64_t xvalue = 1;
+        while ((::write(m_xfd, &xvalue, sizeof(xvalue)) < 0) && (EINTR == errno))
+        {
+        }
+#else // !defined(__linux__)
+        std::lock_guard< std::mutex > xlock(m_xlock);
+        m_xsignaled = true;
+        m_xcond.notify_one();
+#endif // defined(__linux__)
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 消费者进入等待状态（之后须再次检查等待条件）。
+     */
+    inline void prepare_wait(void)
+    {
+        m_xparked.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 消费者取消等待状态（等待条件已满足）。
+     */
+    inline void cancel_wait(void)
+    {
+        m_xparked.store(false, std::memory_order_relaxed);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 消费者阻塞等待唤醒（须先调用 prepare_wait()）。
+     * 
+     * @param [in ] xtimeout : 最长等待时间（负值表示一直等待）。
+     * 
+     * @return bool : 是否被唤醒（否则为超时）。
+     */
+    bool wait_for(std::chrono::nanoseconds xtimeout)
+    {
+#if defined(__linux__)
+        int xtimeout_ms = -1;
+        if (xtimeout.count() >= 0)
+        {
+            // 向上取整到毫秒，避免在到期之前反复提前返回
+            xtimeout_ms = static_cast< int >(
+                (std::min)(static_cast< int64_t >((xtimeout.count() + 999999) / 1000000),
+                           static_cast< int64_t >(0x7FFFFFFF)));
+        }
+
+        struct pollfd xpfd = { m_xfd, POLLIN, 0 };
+        const int xready = ::poll(&xpfd, 1, xtimeout_ms);
+        cancel_wait();
+
+        if (xready > 0)
+        {
+            consume();
+            return true;
+        }
+
+        return false;
+#else // !defined(__linux__)
+        std::unique_lock< std::mutex > xlock(m_xlock);
+        bool xsignaled = true;
+        if (xtimeout.count() < 0)
+            m_xcond.wait(xlock, [this](void) { return m_xsignaled; });
+        else
+            xsignaled = m_xcond.wait_for(xlock, xtimeout, [this](void) { return m_xsignaled; });
+        m_xsignaled = false;
+        cancel_wait();
+        return xsignaled;
+#endif // defined(__linux__)
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 清除已到达的唤醒信号（如 epoll 报告 fd() 可读之后）。
+     */
+    void consume(void)
+    {
+#if defined(__linux__)
+        uint64_t xvalue = 0;
+        while ((::read(m_xfd, &xvalue, sizeof(xvalue)) < 0) && (EINTR == errno))
+        {
+        }
+#else // !defined(__linux__)
+        std::lock_guard< std::mutex > xlock(m_xlock);
+        m_xsignaled = false;
+#endif // defined(__linux__)
+    }
+
+    // data members
+private:
+    std::atomic< bool >     m_xparked;   ///< 消费者是否处于等待状态
+#if defined(__linux__)
+    int                     m_xfd;       ///< eventfd
+#else // !defined(__linux__)
+    bool                    m_xsignaled; ///< 是否已发出唤醒信号
+    std::mutex              m_xlock;     ///< 等待使用的互斥锁
+    std::condition_variable m_xcond;     ///< 等待使用的条件变量
+#endif // defined(__linux__)
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_notify_queue_t
+
+/**
+ * @class xmsg_notify_queue_t< __value_t, __queue_t >
+ * @brief 入队时通知 xmsg_event_t 的消息队列（供 xmsg_run_loop_t 使用）。
+ * @note
+ * 接口与 std::queue 保持一致，可直接作为 xmsg_publisher_t 的 __msg_queue_t
+ * 模板参数使用；除了入队后调用 event().notify() 之外，其余操作都转发给
+ * 实际存储元素的队列 __queue_t（默认为 xmsg_mpsc_queue_t ，任意线程
+ * 都可发布消息；也可以使用 xmsg_ring_queue_t 等）。
+ *
+ * @param [in ] __value_t : 队列元素类型。
+ * @param [in ] __queue_t : 实际存储元素的队列类型。
+ */
+template< typename __value_t, typename __queue_t = xmsg_mpsc_queue_t< __value_t > >
+class xmsg_notify_queue_t
+{
+    // common data types
+public:
+    typedef __value_t           value_type;
+    typedef size_t              size_type;
+    typedef __value_t &         reference;
+    typedef const __value_t &   const_reference;
+
+private:
+    using x_traits_t = xmsg_queue_traits_t< __queue_t >;
+
+public:
+    /** 供 xmsg_publisher_t::dispatch_batch() 使用的批次类型 */
+    typedef typename x_traits_t::x_batch_t x_batch_t;
+
+    // constructor/destructor
+public:
+    xmsg_notify_queue_t(void)
+    {
+
+    }
+
+    ~xmsg_notify_queue_t(void)
+    {
+
+    }
+
+    xmsg_notify_queue_t(xmsg_notify_queue_t && xobject) = delete;
+    xmsg_notify_queue_t & operator=(xmsg_notify_queue_t && xobject) = delete;
+    xmsg_notify_queue_t(const xmsg_notify_queue_t & xobject) = delete;
+    xmsg_notify_queue_t & operator=(const xmsg_notify_queue_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 返回队列中的元素数量。
+     */
+    inline size_type size(void) const { return m_xqueue.size(); }
+
+    /**********************************************************/
+    /**
+     * @brief 判断队列是否为空。
+     */
+    inline bool empty(void) const { return m_xqueue.empty(); }
+
+    /**********************************************************/
+    /**
+     * @brief 将元素压入队列，并唤醒等待中的投递线程。
+     */
+    bool push(const value_type & xvalue)
+    {
+        return notify(x_traits_t::push(m_xqueue, xvalue));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将元素压入队列，并唤醒等待中的投递线程。
+     */
+    bool push(value_type && xvalue)
+    {
+        return notify(x_traits_t::push(m_xqueue, std::move(xvalue)));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 在队列中直接构造元素，并唤醒等待中的投递线程。
+     */
+    template< typename... __args_t >
+    bool emplace(__args_t &&... xargs)
+    {
+        return notify(x_traits_t::emplace(m_xqueue, std::forward< __args_t >(xargs)...));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 返回队首元素。
+     */
+    inline reference front(void) { return m_xqueue.front(); }
+
+    /**********************************************************/
+    /**
+     * @brief 弹出队首元素。
+     */
+    inline void pop(void) { m_xqueue.pop(); }
+
+    /**********************************************************/
+    /**
+     * @brief 将队列中的所有元素摘取到（空的）xbatch 中。
+     */
+    inline void detach(x_batch_t & xbatch) { x_traits_t::detach(m_xqueue, xbatch); }
+
+    /**********************************************************/
+    /**
+     * @brief 将 xbatch 中剩余的元素按原有顺序放回到本队列的最前面。
+     */
+    inline void restore(x_batch_t & xbatch) { x_traits_t::restore(m_xqueue, xbatch); }
+
+    /**********************************************************/
+    /**
+     * @brief 入队时通知的事件对象。
+     */
+    inline xmsg_event_t & event(void) { return m_xevent; }
+
+    /**********************************************************/
+    /**
+     * @brief 实际存储元素的队列（如 读取 xmsg_ring_queue_t 的统计数据）。
+     */
+    inline __queue_t & queue(void) { return m_xqueue; }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 元素已入队时，唤醒等待中的投递线程。
+     */
+    inline bool notify(bool xpushed)
+    {
+        if (xpushed)
+        {
+            m_xevent.notify();
+        }
+
+        return xpushed;
+    }
+
+    // data members
+private:
+    __queue_t    m_xqueue; ///< 实际存储元素的队列
+    xmsg_event_t m_xevent; ///< 入队时通知的事件对象
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_run_loop_t
+
+/**
+ * @class xmsg_run_loop_t< __publisher_t >
+ * @brief xmsg_publisher_t 的消息投递循环（消息队列须为 xmsg_notify_queue_t）。
+ * @note
+ * 1. run()/run_for() 在调用线程中循环投递消息（dispatch_batch()），
+ *    队列为空时先自旋等待一段时间，仍无消息才阻塞在 xmsg_event_t 上，
+ *    直至有新消息发布、超时 或者 stop()；自旋次数自适应调整：
+ *    自旋期间等到了消息则加倍，最终仍需阻塞则减半；
+ *    每批次至多投递 XBATCH_MAX 个消息，run_for() 在每批次之后检查超时，
+ *    即便队列持续有消息到达，也能按时返回；
+ * 2. start() 创建一个投递线程执行 run()，stop() 会等待该线程退出；
+ * 3. stop() 可在任意线程（包括订阅者的消息处理接口）中调用：
+ *    run() 投递完当前批次，以及调用 stop() 时已在队列中的消息之后返回；
+ *    调用 restart() 之后才能再次运行；
+ * 4. 集成到外部的 epoll 循环时：将 fd() 加入 epoll（EPOLLIN），
+ *    每次 epoll_wait() 之前调用 arm()（返回 false 表示仍有消息待投递，
+ *    不应阻塞），fd() 可读 或 arm() 返回 false 时调用 poll() 投递消息；
+ * 5. 除了 stop() 之外，其余接口都只能在同一个（投递）线程中调用。
+ *
+ * @param [in ] __publisher_t : 发布者类型（xmsg_publisher_t）。
+ */
+template< typename __publisher_t >
+class xmsg_run_loop_t
+{
+    // common data types
+public:
+    using x_publisher_t = __publisher_t;
+    using x_duration_t  = std::chrono::nanoseconds;
+    using x_clock_t     = std::chrono::steady_clock;
+
+    /** 自旋等待的次数范围 */
+    static constexpr size_t XSPIN_MIN = 64;
+    static constexpr size_t XSPIN_MAX = 16384;
+
+    /** 每批次投递的最大消息数量 */
+    static constexpr size_t XBATCH_MAX = 1024;
+
+    // constructor/destructor
+public:
+    explicit xmsg_run_loop_t(x_publisher_t & xpublisher)
+        : m_xpublisher(xpublisher)
+        , m_xstop(false)
+        , m_xspin(XSPIN_MIN)
+        , m_xparks(0)
+    {
+
+    }
+
+    ~xmsg_run_loop_t(void)
+    {
+        stop();
+    }
+
+    xmsg_run_loop_t(xmsg_run_loop_t && xobject) = delete;
+    xmsg_run_loop_t & operator=(xmsg_run_loop_t && xobject) = delete;
+    xmsg_run_loop_t(const xmsg_run_loop_t & xobject) = delete;
+    xmsg_run_loop_t & operator=(const xmsg_run_loop_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 循环投递消息，直至 stop()；返回投递的消息数量。
+     */
+    size_t run(void)
+    {
+        return run_until(nullptr);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 循环投递消息，直至 stop() 或者超过 xtimeout 时长；
+     *        返回投递的消息数量。
+     */
+    template< typename __rep_t, typename __period_t >
+    size_t run_for(const std::chrono::duration< __rep_t, __period_t > & xtimeout)
+    {
+        const x_clock_t::time_point xdeadline =
+            x_clock_t::now() + std::chrono::duration_cast< x_duration_t >(xtimeout);
+        return run_until(&xdeadline);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 不阻塞地投递当前队列中的消息（用于外部的事件循环）。
+     */
+    size_t poll(void)
+    {
+        event().consume();
+        return m_xpublisher.dispatch_batch();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 外部事件循环阻塞之前调用：返回 true 时，发布消息会使 fd() 可读；
+     *        返回 false 表示队列中仍有消息（或者已 stop()），不应阻塞。
+     */
+    bool arm(void)
+    {
+        event().prepare_wait();
+        if (ready())
+        {
+            event().cancel_wait();
+            return false;
+        }
+
+        return true;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 停止投递循环（可在任意线程中调用）；
+     *        若投递线程由 start() 创建，则等待其退出。
+     */
+    void stop(void)
+    {
+        m_xstop.store(true, std::memory_order_release);
+        event().signal();
+
+        if (m_xthread.joinable() && (std::this_thread::get_id() != m_xthread.get_id()))
+        {
+            m_xthread.join();
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 清除 stop() 的停止标识（之后可再次运行）。
+     */
+    void restart(void)
+    {
+        if (m_xthread.joinable() && (std::this_thread::get_id() != m_xthread.get_id()))
+        {
+            m_xthread.join();
+        }
+
+        m_xstop.store(false, std::memory_order_release);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 是否已 stop()。
+     */
+    inline bool stopped(void) const
+    {
+        return m_xstop.load(std::memory_order_acquire);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 创建投递线程执行 run()。
+     */
+    void start(void)
+    {
+        assert(!m_xthread.joinable());
+        m_xthread = std::thread([this](void) { run(); });
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 用于 epoll/poll 监听的文件描述符（不支持时返回 -1）。
+     */
+    inline int fd(void) { return event().fd(); }
+
+    /**********************************************************/
+    /**
+     * @brief 投递线程进入阻塞等待的次数（用于统计显示）。
+     */
+    inline size_t parks(void) const { return m_xparks; }
+
+    /**********************************************************/
+    /**
+     * @brief 当前的自旋等待次数。
+     */
+    inline size_t spin(void) const { return m_xspin; }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 消息队列的事件对象。
+     */
+    inline xmsg_event_t & event(void)
+    {
+        return m_xpublisher.msg_queue().event();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 是否无需等待（队列不为空，或者已 stop()）。
+     */
+    inline bool ready(void) const
+    {
+        return (!m_xpublisher.empty() || m_xstop.load(std::memory_order_acquire));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 循环投递消息，直至 stop() 或者到达 xdeadline（为 nullptr 时不限时）。
+     */
+    size_t run_until(const x_clock_t::time_point * xdeadline)
+    {
+        size_t xmsg_count = 0;
+
+        while (!stopped())
+        {
+            const size_t xcount = m_xpublisher.dispatch_batch(XBATCH_MAX);
+            xmsg_count += xcount;
+
+            if (0 == xcount)
+            {
+                if (!wait(xdeadline))
+                {
+                    return xmsg_count;
+                }
+            }
+            else if ((nullptr != xdeadline) && (x_clock_t::now() >= *xdeadline))
+            {
+                return xmsg_count;
+            }
+        }
+
+        // 优雅退出：投递 stop() 时已在队列中的消息
+        return xmsg_count + m_xpublisher.dispatch_batch();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 等待消息到达（先自旋，再阻塞）；到达 xdeadline 时返回 false 。
+     */
+    bool wait(const x_clock_t::time_point * xdeadline)
+    {
+        for (size_t xiter = 0; xiter < m_xspin; ++xiter)
+        {
+            if (ready())
+            {
+                m_xspin = (std::min)(m_xspin * 2, static_cast< size_t >(XSPIN_MAX));
+                return true;
+            }
+
+            xmsg_cpu_relax();
+        }
+
+        m_xspin = (std::max)(m_xspin / 2, static_cast< size_t >(XSPIN_MIN));
+
+        x_duration_t xtimeout(-1);
+        if (nullptr != xdeadline)
+        {
+            xtimeout = std::chrono::duration_cast< x_duration_t >(*xdeadline - x_clock_t::now());
+            if (xtimeout.count() <= 0)
+            {
+                return false;
+            }
+        }
+
+        event().prepare_wait();
+        if (ready())
+        {
+            event().cancel_wait();
+            return true;
+        }
+
+        m_xparks += 1;
+        event().wait_for(xtimeout);
+
+        return (nullptr == xdeadline) || (x_clock_t::now() < *xdeadline) || ready();
+    }
+
+    // data members
+private:
+    x_publisher_t &     m_xpublisher; ///< 发布者
+    std::atomic< bool > m_xstop;      ///< 停止标识
+    size_t              m_xspin;      ///< 当前的自旋等待次数
+    size_t              m_xparks;     ///< 阻塞等待的次数
+    std::thread         m_xthread;    ///< start() 创建的投递线程
+};
+
+template< typename __publisher_t >
+constexpr size_t xmsg_run_loop_t< __publisher_t >::XSPIN_MIN;
+
+template< typename __publisher_t >
+constexpr size_t xmsg_run_loop_t< __publisher_t >::XSPIN_MAX;
+
+template< typename __publisher_t >
+constexpr size_t xmsg_run_loop_t< __publisher_t >::XBATCH_MAX;
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __XMSG_RUN_LOOP_H__
@@ -0,0 +1,1007 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/**
+ * @file xmsg_sharded_publisher.h
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * @author  ：Gaaagaa
+ * @date    : 2026-10-18
+ * @version : 1.0.0.0
+ * @brief   : 按消息键分片的发布者（每个分片独立的 队列、订阅表 与 投递线程），
+ *            支持热点消息的迁移，以及分片负载的倾斜度统计。
+ */
+
+#ifndef __XMSG_SHARDED_PUBLISHER_H__
+#define __XMSG_SHARDED_PUBLISHER_H__
+
+#include "xmsg_pubsub.h"
+#include "xmsg_run_loop.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif // defined(__linux__)
+
+////////////////////////////////////////////////////////////////////////////////
+
+/** 转发者（热点消息从主分片转发到其迁入的分片）的订阅者类型 */
+#ifndef XMSG_SHARD_FORWARDER_TYPE
+#define XMSG_SHARD_FORWARDER_TYPE 0x7FFFFF00
+#endif // XMSG_SHARD_FORWARDER_TYPE
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_shard_stats_t / xmsg_sharded_stats_t
+
+/**
+ * @struct xmsg_shard_stats_t
+ * @brief 单个分片的负载统计。
+ */
+struct xmsg_shard_stats_t
+{
+    size_t   xshard;     ///< 分片索引号
+    int      xcpu;       ///< 投递线程绑定的 CPU（未绑定时为 -1）
+    uint64_t xpublished; ///< 以该分片为主分片 publish() 的消息数量
+    uint64_t xforwarded; ///< 从该分片转发出去的（已迁出的热点）消息数量
+    uint64_t xinbound;   ///< 转发到该分片的（已迁入的热点）消息数量
+    uint64_t xload;      ///< 在该分片投递的消息数量（xpublished - xforwarded + xinbound）
+    size_t   xqueued;    ///< 当前待投递的消息数量（近似值）
+    size_t   xkeys;      ///< 由该分片投递的（已订阅的）消息类型数量
+};
+
+/**
+ * @struct xmsg_sharded_stats_t
+ * @brief 所有分片的负载统计。
+ */
+struct xmsg_sharded_stats_t
+{
+    std::vector< xmsg_shard_stats_t > xshards; ///< 各个分片的统计
+    uint64_t xtotal;   ///< 所有分片的 xload 之和
+    size_t   xhottest; ///< xload 最大的分片
+    double   xskew;    ///< 倾斜度：最大 xload / 平均 xload（1.0 为完全均衡）
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_sharded_publisher_t
+
+/**
+ * @class xmsg_sharded_publisher_t< __publisher_t >
+ * @brief 按消息键分片的发布者：内部持有 N 个发布者（分片），每个分片有各自的
+ *        消息队列、订阅表，以及由 xmsg_run_loop_t 驱动的投递线程。
+ * @note
+ * 1. 消息按 消息键的哈希值 % N 路由到其 主分片，publish() 只访问主分片的
+ *    无锁队列，可在任意线程中调用；同一消息键的消息始终在同一个线程中按序投递；
+ * 2. 热点消息的迁移：rebalance(xmkey, xshard) 将 xmkey 的订阅者迁移到
+ *    xshard 分片，并在主分片上订阅一个转发者，将 xmkey 的消息转发到 xshard；
+ *    由于所有消息仍先经过主分片，迁移前后的消息顺序保持不变；
+ *    迁移期间，相关分片的投递线程短暂停顿，原分片中已转发的消息先投递完毕；
+ * 3. start(true) 时，第 i 个分片的投递线程绑定到进程可用的第 (i % CPU 数) 个 CPU
+ *    （仅 Linux 支持，绑定失败不影响运行）；
+ * 4. subscribe()/unsubscribe() 可在任意线程中调用：在投递线程外调用时，
+ *    同步地转交给负责该消息的分片执行；在订阅者的消息处理接口中调用时，
+ *    当前分片负责的消息类型（如 自我取消订阅）立即生效，其他分片负责的
+ *    消息类型则异步地提交给该分片执行（按调用的先后顺序）；
+ *    start()/stop()/flush()/rebalance() 不能在投递线程中调用；
+ * 5. stats() 给出各个分片的负载与倾斜度，可据此选择要迁移的热点消息
+ *    （各个消息键的计数可启用 XMSG_ENABLE_STATS 后，由 shard(i).stats() 获取）。
+ *
+ * @param [in ] __publisher_t : 分片使用的发布者类型
+ *                              （xmsg_publisher_t，消息队列须为 xmsg_notify_queue_t）。
+ */
+template< typename __publisher_t >
+class xmsg_sharded_publisher_t
+{
+    // common data types
+public:
+    using x_publisher_t  = __publisher_t;
+    using x_run_loop_t   = xmsg_run_loop_t< x_publisher_t >;
+    using x_msgctxt_t    = typename x_publisher_t::x_msgctxt_t;
+    using x_mkey_t       = typename x_publisher_t::x_mkey_t;
+    using x_subscriber_t = typename x_publisher_t::x_subscriber_t;
+    using x_subsptr_t    = typename x_publisher_t::x_subsptr_t;
+    using x_subwptr_t    = typename x_publisher_t::x_subwptr_t;
+    using x_subkey_t     = typename x_publisher_t::x_subkey_t;
+    using x_stats_t      = xmsg_sharded_stats_t;
+
+    /** 无效的分片索引号 */
+    static constexpr size_t XSHARD_NONE = (size_t)-1;
+
+private:
+    using x_hash_t  = typename x_msgctxt_t::xmsg_mkey_t::x_hash_t;
+    using x_equal_t = typename x_msgctxt_t::xmsg_mkey_t::x_equal_t;
+    using x_task_t  = std::function< void(void) >;
+
+    /**
+     * @struct x_shard_t
+     * @brief 分片：发布者、投递循环 与 投递线程。
+     */
+    struct x_shard_t
+    {
+        size_t                  xindex;     ///< 分片索引号
+        x_publisher_t           xpublisher; ///< 分片的发布者
+        x_run_loop_t            xrun_loop;  ///< 分片的投递循环
+        std::thread             xthread;    ///< 投递线程
+        std::mutex              xlock;      ///< 保护 xtasks 与 xquit
+        std::vector< x_task_t > xtasks;     ///< 待投递线程执行的控制任务
+        bool                    xquit;      ///< 投递线程的退出标识
+        int                     xcpu;       ///< 绑定的 CPU（未绑定时为 -1）
+        std::atomic< uint64_t > xpublished; ///< 以该分片为主分片发布的消息数量
+        std::atomic< uint64_t > xforwarded; ///< 从该分片转发出去的消息数量
+        std::atomic< uint64_t > xinbound;   ///< 转发到该分片的消息数量
+
+        explicit x_shard_t(size_t xindex)
+            : xindex(xindex)
+            , xrun_loop(xpublisher)
+            , xquit(false)
+            , xcpu(-1)
+            , xpublished(0)
+            , xforwarded(0)
+            , xinbound(0)
+        {
+
+        }
+    };
+
+    /**
+     * @class x_forwarder_t
+     * @brief 转发者：订阅主分片中已迁出的消息，将其转发到负责投递的分片。
+     */
+    class x_forwarder_t
+        : public xmsg_subscriber_t< XMSG_SHARD_FORWARDER_TYPE, x_msgctxt_t >
+    {
+        // constructor/destructor
+    public:
+        x_forwarder_t(x_shard_t & xhome, x_shard_t & xowner)
+            : m_xhome(xhome)
+            , m_xowner(xowner)
+        {
+
+        }
+
+        // extensible interfaces
+    public:
+        /**********************************************************/
+        /**
+         * @brief 订阅消息的分派接口（在主分片的投递线程中执行）。
+         */
+        virtual void translate(const x_msgctxt_t & xmsg_ctxt) override
+        {
+            if (m_xowner.xpublisher.publish(xmsg_ctxt))
+            {
+                m_xhome.xforwarded.fetch_add(1, std::memory_order_relaxed);
+                m_xowner.xinbound.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        // data members
+    private:
+        x_shard_t & m_xhome;  ///< 主分片
+        x_shard_t & m_xowner; ///< 负责投递的分片
+    };
+
+    /**
+     * @struct x_park_t
+     * @brief 迁移期间，用于使投递线程停顿的同步对象。
+     */
+    struct x_park_t
+    {
+        std::mutex              xlock;    ///< 互斥锁
+        std::condition_variable xcond;    ///< 条件变量
+        size_t                  xparked;  ///< 已停顿的投递线程数量
+        bool                    xrelease; ///< 是否已恢复运行
+
+        x_park_t(void) : xparked(0), xrelease(false) { }
+    };
+
+    using x_shard_ptr_t = std::unique_ptr< x_shard_t >;
+    using x_owners_t    = std::unordered_map< x_mkey_t, size_t, x_hash_t, x_equal_t >;
+    using x_subers_t    = std::unordered_map<
+                                x_mkey_t,
+                                std::vector< x_subwptr_t >,
+                                x_hash_t,
+                                x_equal_t >;
+    using x_forwards_t  = std::unordered_map<
+                                x_mkey_t,
+                                std::unique_ptr< x_forwarder_t >,
+                                x_hash_t,
+                                x_equal_t >;
+
+    // constructor/destructor
+public:
+    /**
+     * @brief 构造函数。
+     * 
+     * @param [in ] xshards : 分片数量（为 0 时，取 CPU 的数量）。
+     */
+    explicit xmsg_sharded_publisher_t(size_t xshards = 0)
+        : m_xstarted(false)
+    {
+        if (0 == xshards)
+        {
+            xshards = (std::max)(std::thread::hardware_concurrency(), 1u);
+        }
+
+        m_xshards.reserve(xshards);
+        for (size_t xiter = 0; xiter < xshards; ++xiter)
+        {
+            m_xshards.push_back(x_shard_ptr_t(new x_shard_t(xiter)));
+        }
+    }
+
+    ~xmsg_sharded_publisher_t(void)
+    {
+        stop();
+    }
+
+    xmsg_sharded_publisher_t(xmsg_sharded_publisher_t && xobject) = delete;
+    xmsg_sharded_publisher_t & operator=(xmsg_sharded_publisher_t && xobject) = delete;
+    xmsg_sharded_publisher_t(const xmsg_sharded_publisher_t & xobject) = delete;
+    xmsg_sharded_publisher_t & operator=(const xmsg_sharded_publisher_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 分片数量。
+     */
+    inline size_t shards(void) const { return m_xshards.size(); }
+
+    /**********************************************************/
+    /**
+     * @brief 返回分片的发布者（用于读取 stats()、msg_queue() 等统计信息）。
+     */
+    inline x_publisher_t & shard(size_t xshard)
+    {
+        assert(xshard < m_xshards.size());
+        return m_xshards[xshard]->xpublisher;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 消息类型的主分片（publish() 路由到的分片）。
+     */
+    inline size_t home_of(const x_mkey_t & xmkey) const
+    {
+        return (m_xhash(xmkey) % m_xshards.size());
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 负责投递 该消息类型 的分片（未迁移时为其主分片）。
+     */
+    size_t owner_of(const x_mkey_t & xmkey) const
+    {
+        std::lock_guard< std::mutex > xguard(m_xregistry);
+        return owner_locked(xmkey);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 是否已 start() 。
+     */
+    inline bool started(void) const { return m_xstarted; }
+
+    /**********************************************************/
+    /**
+     * @brief 为每个分片创建投递线程。
+     * 
+     * @param [in ] xpin : 是否将投递线程绑定到 CPU 。
+     */
+    void start(bool xpin = false)
+    {
+        assert(XSHARD_NONE == local_shard());
+
+        std::lock_guard< std::mutex > xguard(m_xcontrol);
+        if (m_xstarted)
+        {
+            return;
+        }
+
+        for (x_shard_ptr_t & xshard : m_xshards)
+        {
+            xshard->xquit = false;
+            xshard->xcpu  = -1;
+
+            x_shard_t * xshard_ptr = xshard.get();
+            xshard->xthread = std::thread([this, xshard_ptr](void) { shard_run(*xshard_ptr); });
+
+            if (xpin)
+            {
+                xshard->xcpu = pin_thread(xshard->xthread, xshard->xindex);
+            }
+        }
+
+        m_xstarted = true;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 投递完 stop() 之前发布的消息后，结束所有的投递线程。
+     */
+    void stop(void)
+    {
+        assert(XSHARD_NONE == local_shard());
+
+        std::lock_guard< std::mutex > xguard(m_xcontrol);
+        if (!m_xstarted)
+        {
+            return;
+        }
+
+        flush_locked();
+
+        for (x_shard_ptr_t & xshard : m_xshards)
+        {
+            {
+                std::lock_guard< std::mutex > xlock(xshard->xlock);
+                xshard->xquit = true;
+            }
+
+            xshard->xrun_loop.stop();
+        }
+
+        for (x_shard_ptr_t & xshard : m_xshards)
+        {
+            xshard->xthread.join();
+        }
+
+        m_xstarted = false;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 等待 flush() 之前发布的消息全部投递完成（包括转发的消息）。
+     * @note 未 start() 时，在当前线程中投递。
+     */
+    void flush(void)
+    {
+        assert(XSHARD_NONE == local_shard());
+
+        std::lock_guard< std::mutex > xguard(m_xcontrol);
+        flush_locked();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 发布消息（路由到其主分片，可在任意线程中调用）。
+     * @return bool : 消息是否已入队。
+     */
+    bool publish(const x_msgctxt_t & xmsg_ctxt)
+    {
+        return count_publish(home(xmsg_ctxt.mkey()), xmsg_ctxt);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 发布消息（路由到其主分片，可在任意线程中调用）。
+     * @return bool : 消息是否已入队。
+     */
+    bool publish(x_msgctxt_t && xmsg_ctxt)
+    {
+        x_shard_t & xshard = home(xmsg_ctxt.mkey());
+        return count_publish(xshard, std::forward< x_msgctxt_t >(xmsg_ctxt));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 发布消息（路由到其主分片，可在任意线程中调用）。
+     * @return bool : 消息是否已入队。
+     */
+    template< typename... __args_t >
+    bool publish(const x_mkey_t & xmkey, __args_t &&... xargs)
+    {
+        return count_publish(home(xmkey), xmkey, std::forward< __args_t >(xargs)...);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 订阅者对象 订阅指定的消息类型
+     *        （用户重载的订阅者类，见 xmsg_publisher_t::subscribe()）。
+     */
+    x_subkey_t subscribe(const x_mkey_t & xmkey, x_subscriber_t * xsub_ptr)
+    {
+        assert(nullptr != xsub_ptr);
+        assert(xsub_ptr->sub_type() < XSUBER_BASE_TYPE);
+
+        // 订阅者对象由外部自行管理（不由分片持有）
+        return subscribe_shared(xmkey, x_subsptr_t(xsub_ptr, [](x_subscriber_t *) { }));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 使用 “类似函数类型” 的订阅者 订阅指定的消息类型
+     *        （见 xmsg_publisher_t::subscribe()）。
+     * @note 订阅者在负责投递 xmkey 的分片的投递线程中被调用。
+     */
+    template< typename __mfunc_t, typename... __args_t >
+    x_subkey_t subscribe(const x_mkey_t & xmkey,
+                         __mfunc_t && xfunc,
+                         __args_t &&... xargs)
+    {
+        return subscribe_shared(xmkey,
+                                x_publisher_t::make_subscriber(
+                                    std::forward< __mfunc_t >(xfunc),
+                                    std::forward< __args_t >(xargs)...));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 以共享所有权的方式，订阅 已存在的订阅者对象。
+     * @note
+     * 异步提交时（见类说明），返回的 x_subkey_t 在订阅生效之前即可用于
+     * unsubscribe()（两者按调用的先后顺序执行）。
+     */
+    x_subkey_t subscribe_shared(const x_mkey_t & xmkey, const x_subsptr_t & xsub_sptr)
+    {
+        assert(nullptr != xsub_sptr);
+
+        control(xmkey,
+                [this, xmkey, xsub_sptr](x_publisher_t & xpublisher)
+                {
+                    remember(xpublisher.subscribe_shared(xmkey, xsub_sptr));
+                });
+
+        // 订阅失败（重复订阅）时，分片不持有 xsub_sptr ，返回的索引键随之失效
+        return x_subkey_t(xmkey, xsub_sptr);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 订阅者对象 取消订阅指定的消息类型。
+     * 
+     * @param [in ] xsub_key : 其为 subscribe() 返回的订阅者索引键。
+     */
+    void unsubscribe(const x_subkey_t & xsub_key)
+    {
+        control(xsub_key.xmkey,
+                [this, xsub_key](x_publisher_t & xpublisher)
+                {
+                    xpublisher.unsubscribe(xsub_key);
+                    forget(xsub_key);
+                });
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 取消 xmkey 下所有的订阅者对象。
+     */
+    void unsubscribe(const x_mkey_t & xmkey)
+    {
+        control(xmkey,
+                [this, xmkey](x_publisher_t & xpublisher)
+                {
+                    xpublisher.unsubscribe(xmkey);
+
+                    std::lock_guard< std::mutex > xguard(m_xregistry);
+                    m_xsubers.erase(xmkey);
+                });
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将 xmkey 的投递迁移到 xshard 分片（xshard 为其主分片时，即为迁回）。
+     * @note
+     * 1. 主分片、原分片 与 目标分片 的投递线程依次停顿：主分片停顿之后，
+     *    原分片先投递完 已转发给它的 xmkey 消息，再迁移订阅者 与 转发者；
+     * 2. 主分片队列中尚未投递的 xmkey 消息，恢复运行后经转发者投递，
+     *    因此 xmkey 的消息顺序保持不变。
+     * 
+     * @return bool : 是否迁移（xmkey 已由 xshard 分片负责投递时，返回 false）。
+     */
+    bool rebalance(const x_mkey_t & xmkey, size_t xshard)
+    {
+        assert(xshard < m_xshards.size());
+        assert(XSHARD_NONE == local_shard());
+
+        std::lock_guard< std::mutex > xguard(m_xcontrol);
+
+        const size_t xhome = home_of(xmkey);
+        const size_t xfrom = owner_of(xmkey);
+        if (xfrom == xshard)
+        {
+            return false;
+        }
+
+        std::shared_ptr< x_park_t > xpark = std::make_shared< x_park_t >();
+
+        try
+        {
+            park(xpark, xhome, false);
+            if (xfrom != xhome)
+                park(xpark, xfrom, true);
+            if (xshard != xhome)
+                park(xpark, xshard, false);
+
+            migrate(xmkey, xhome, xfrom, xshard);
+        }
+        catch (...)
+        {
+            unpark(xpark);
+            throw;
+        }
+
+        unpark(xpark);
+        return true;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 各个分片的负载统计，以及分片之间的倾斜度（可在任意线程中调用）。
+     */
+    x_stats_t stats(void) const
+    {
+        x_stats_t xstats;
+        xstats.xtotal   = 0;
+        xstats.xhottest = 0;
+        xstats.xskew    = 1.0;
+
+        for (const x_shard_ptr_t & xshard : m_xshards)
+        {
+            xmsg_shard_stats_t xshard_stats;
+            xshard_stats.xshard     = xshard->xindex;
+            xshard_stats.xcpu       = xshard->xcpu;
+            xshard_stats.xpublished = xshard->xpublished.load(std::memory_order_relaxed);
+            xshard_stats.xforwarded = xshard->xforwarded.load(std::memory_order_relaxed);
+            xshard_stats.xinbound   = xshard->xinbound.load(std::memory_order_relaxed);
+            xshard_stats.xload      = xshard_stats.xpublished
+                                    - xshard_stats.xforwarded
+                                    + xshard_stats.xinbound;
+            xshard_stats.xqueued    = xshard->xpublisher.size();
+            xshard_stats.xkeys      = 0;
+
+            xstats.xtotal += xshard_stats.xload;
+            xstats.xshards.push_back(xshard_stats);
+
+            if (xshard_stats.xload > xstats.xshards[xstats.xhottest].xload)
+            {
+                xstats.xhottest = xshard->xindex;
+            }
+        }
+
+        {
+            std::lock_guard< std::mutex > xguard(m_xregistry);
+            for (const typename x_subers_t::value_type & xiter : m_xsubers)
+            {
+                xstats.xshards[owner_locked(xiter.first)].xkeys += 1;
+            }
+        }
+
+        if (xstats.xtotal > 0)
+        {
+            xstats.xskew = static_cast< double >(xstats.xshards[xstats.xhottest].xload) *
+                           static_cast< double >(xstats.xshards.size()) /
+                           static_cast< double >(xstats.xtotal);
+        }
+
+        return xstats;
+    }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 消息类型的主分片。
+     */
+    inline x_shard_t & home(const x_mkey_t & xmkey)
+    {
+        return *m_xshards[home_of(xmkey)];
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 向分片发布消息，并累计其发布计数。
+     */
+    template< typename... __args_t >
+    inline bool count_publish(x_shard_t & xshard, __args_t &&... xargs)
+    {
+        if (xshard.xpublisher.publish(std::forward< __args_t >(xargs)...))
+        {
+            xshard.xpublished.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        return false;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 负责投递 xmkey 的分片（须已持有 m_xregistry）。
+     */
+    inline size_t owner_locked(const x_mkey_t & xmkey) const
+    {
+        typename x_owners_t::const_iterator itown = m_xowners.find(xmkey);
+        return (itown != m_xowners.end()) ? itown->second : home_of(xmkey);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 当前线程所属的分片（其投递线程中设置）。
+     */
+    static const x_shard_t *& current_shard(void)
+    {
+        static thread_local const x_shard_t * xshard = nullptr;
+        return xshard;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 当前线程为本对象的投递线程时，返回其分片索引号；
+     *        否则，返回 XSHARD_NONE 。
+     */
+    size_t local_shard(void) const
+    {
+        const x_shard_t * xshard = current_shard();
+        if ((nullptr != xshard) &&
+            (xshard->xindex < m_xshards.size()) &&
+            (xshard == m_xshards[xshard->xindex].get()))
+        {
+            return xshard->xindex;
+        }
+
+        return XSHARD_NONE;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 在负责投递 xmkey 的分片上执行订阅操作 xfunc(x_publisher_t &) 。
+     * @note
+     * 1. 在投递线程外调用时，串行化后交由该分片的投递线程同步执行；
+     * 2. 在投递线程中调用时：当前分片负责 xmkey 则直接执行；否则异步地
+     *    提交给负责的分片（不等待，避免投递线程之间相互等待），执行前若
+     *    xmkey 已被迁移，则继续转交；因此 xfunc 须以值捕获其使用的对象。
+     */
+    template< typename __func_t >
+    void control(const x_mkey_t & xmkey, const __func_t & xfunc)
+    {
+        const size_t xlocal = local_shard();
+        if (XSHARD_NONE != xlocal)
+        {
+            const size_t xowner = owner_of(xmkey);
+            if (xlocal == xowner)
+            {
+                xfunc(m_xshards[xlocal]->xpublisher);
+            }
+            else
+            {
+                post(*m_xshards[xowner], [this, xmkey, xfunc](void) { control(xmkey, xfunc); });
+            }
+
+            return;
+        }
+
+        std::lock_guard< std::mutex > xguard(m_xcontrol);
+
+        x_shard_t & xshard = *m_xshards[owner_of(xmkey)];
+        execute(xshard, [&xshard, &xfunc](void) { xfunc(xshard.xpublisher); });
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 在分片的投递线程中同步执行 xfunc（须已持有 m_xcontrol）；
+     *        未 start() 时，直接在当前线程中执行。
+     */
+    template< typename __func_t >
+    void execute(x_shard_t & xshard, __func_t && xfunc)
+    {
+        if (!m_xstarted)
+        {
+            xfunc();
+            return;
+        }
+
+        std::shared_ptr< std::packaged_task< void(void) > > xtask =
+            std::make_shared< std::packaged_task< void(void) > >(
+                std::forward< __func_t >(xfunc));
+
+        std::future< void > xfuture = xtask->get_future();
+        post(xshard, [xtask](void) { (*xtask)(); });
+        xfuture.get();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 向分片的投递线程提交控制任务，并唤醒投递线程。
+     */
+    void post(x_shard_t & xshard, x_task_t && xtask)
+    {
+        {
+            std::lock_guard< std::mutex > xlock(xshard.xlock);
+            xshard.xtasks.push_back(std::forward< x_task_t >(xtask));
+        }
+
+        xshard.xrun_loop.stop();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 投递完各个分片中的消息（须已持有 m_xcontrol）。
+     * @note
+     * 转发的消息只经过一次转发（主分片 -> 负责投递的分片），
+     * 因此依次投递所有分片两轮即可。
+     */
+    void flush_locked(void)
+    {
+        for (int xround = 0; xround < 2; ++xround)
+        {
+            for (x_shard_ptr_t & xshard : m_xshards)
+            {
+                x_shard_t * xshard_ptr = xshard.get();
+                execute(*xshard_ptr,
+                        [xshard_ptr](void) { xshard_ptr->xpublisher.dispatch_batch(); });
+            }
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 使分片的投递线程停顿，直至 unpark()（须已持有 m_xcontrol）。
+     * 
+     * @param [in ] xpark  : 停顿的同步对象。
+     * @param [in ] xindex : 分片索引号。
+     * @param [in ] xdrain : 停顿之前，是否先投递完分片队列中的消息。
+     */
+    void park(const std::shared_ptr< x_park_t > & xpark, size_t xindex, bool xdrain)
+    {
+        x_shard_t * xshard = m_xshards[xindex].get();
+        if (!m_xstarted)
+        {
+            if (xdrain)
+                xshard->xpublisher.dispatch_batch();
+            return;
+        }
+
+        std::unique_lock< std::mutex > xlock(xpark->xlock);
+        const size_t xparked = xpark->xparked + 1;
+
+        post(*xshard,
+             [xpark, xshard, xdrain](void)
+             {
+                 if (xdrain)
+                     xshard->xpublisher.dispatch_batch();
+
+                 std::unique_lock< std::mutex > xlock(xpark->xlock);
+                 xpark->xparked += 1;
+                 xpark->xcond.notify_all();
+                 xpark->xcond.wait(xlock, [&xpark](void) { return xpark->xrelease; });
+             });
+
+        xpark->xcond.wait(xlock, [&xpark, xparked](void) { return (xpark->xparked >= xparked); });
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 恢复 park() 停顿的投递线程。
+     */
+    void unpark(const std::shared_ptr< x_park_t > & xpark)
+    {
+        std::lock_guard< std::mutex > xlock(xpark->xlock);
+        xpark->xrelease = true;
+        xpark->xcond.notify_all();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将 xmkey 的订阅者从 xfrom 分片迁移到 xshard 分片，
+     *        并更新主分片 xhome 上的转发者（相关分片均已停顿）。
+     */
+    void migrate(const x_mkey_t & xmkey, size_t xhome, size_t xfrom, size_t xshard)
+    {
+        x_shard_t & xhome_shard = *m_xshards[xhome];
+        x_publisher_t & xsrc = m_xshards[xfrom]->xpublisher;
+        x_publisher_t & xdst = m_xshards[xshard]->xpublisher;
+
+        std::lock_guard< std::mutex > xguard(m_xregistry);
+
+        typename x_subers_t::iterator itsub = m_xsubers.find(xmkey);
+        if (itsub != m_xsubers.end())
+        {
+            for (const x_subwptr_t & xwptr : itsub->second)
+            {
+                x_subsptr_t xsub_sptr = xwptr.lock();
+                if (nullptr != xsub_sptr)
+                {
+                    xsrc.unsubscribe(xmkey, xsub_sptr.get());
+                    xdst.subscribe_shared(xmkey, xsub_sptr);
+                }
+            }
+        }
+
+        typename x_forwards_t::iterator itfwd = m_xforwards.find(xmkey);
+        if (itfwd != m_xforwards.end())
+        {
+            xhome_shard.xpublisher.unsubscribe(xmkey, itfwd->second.get());
+            m_xforwards.erase(itfwd);
+        }
+
+        if (xshard == xhome)
+        {
+            m_xowners.erase(xmkey);
+            return;
+        }
+
+        std::unique_ptr< x_forwarder_t > xforwarder(
+            new x_forwarder_t(xhome_shard, *m_xshards[xshard]));
+        xhome_shard.xpublisher.subscribe(
+            xmkey, static_cast< x_subscriber_t * >(xforwarder.get()));
+        m_xforwards[xmkey] = std::move(xforwarder);
+        m_xowners[xmkey]   = xshard;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 记录订阅者对象（用于迁移）。
+     */
+    void remember(const x_subkey_t & xsub_key)
+    {
+        if (!xsub_key.is_valid())
+        {
+            return;
+        }
+
+        std::lock_guard< std::mutex > xguard(m_xregistry);
+        m_xsubers[xsub_key.xmkey].push_back(xsub_key.xwptr);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 移除订阅者对象的记录（同时清理已失效的记录）。
+     */
+    void forget(const x_subkey_t & xsub_key)
+    {
+        std::lock_guard< std::mutex > xguard(m_xregistry);
+
+        typename x_subers_t::iterator itsub = m_xsubers.find(xsub_key.xmkey);
+        if (itsub == m_xsubers.end())
+        {
+            return;
+        }
+
+        std::vector< x_subwptr_t > & xwptrs = itsub->second;
+        xwptrs.erase(std::remove_if(xwptrs.begin(), xwptrs.end(),
+                                    [&xsub_key](const x_subwptr_t & xwptr)
+                                    {
+                                        return xwptr.expired() ||
+                                               (!xwptr.owner_before(xsub_key.xwptr) &&
+                                                !xsub_key.xwptr.owner_before(xwptr));
+                                    }),
+                     xwptrs.end());
+
+        if (xwptrs.empty())
+        {
+            m_xsubers.erase(itsub);
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 分片的投递线程：交替执行 控制任务 与 投递循环。
+     * @note
+     * post() 先加入任务再 stop() 投递循环，而投递线程先 restart() 再取任务，
+     * 因此任务不会被遗漏。
+     */
+    void shard_run(x_shard_t & xshard)
+    {
+        current_shard() = &xshard;
+
+        for (;;)
+        {
+            xshard.xrun_loop.restart();
+
+            std::vector< x_task_t > xtasks;
+            bool xquit = false;
+            {
+                std::lock_guard< std::mutex > xlock(xshard.xlock);
+                xtasks.swap(xshard.xtasks);
+                xquit = xshard.xquit;
+            }
+
+            for (x_task_t & xtask : xtasks)
+            {
+                xtask();
+            }
+
+            if (xquit)
+            {
+                break;
+            }
+
+            xshard.xrun_loop.run();
+        }
+
+        current_shard() = nullptr;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将投递线程绑定到进程可用的第 (xindex % CPU 数) 个 CPU；
+     *        返回绑定的 CPU（失败 或 不支持时返回 -1）。
+     */
+    static int pin_thread(std::thread & xthread, size_t xindex)
+    {
+#if defined(__linux__)
+        cpu_set_t xcpus;
+        CPU_ZERO(&xcpus);
+        if (0 != sched_getaffinity(0, sizeof(xcpus), &xcpus))
+        {
+            return -1;
+        }
+
+        const int xcount = CPU_COUNT(&xcpus);
+        if (xcount <= 0)
+        {
+            return -1;
+        }
+
+        size_t xnth = xindex % static_cast< size_t >(xcount);
+        for (int xcpu = 0; xcpu < CPU_SETSIZE; ++xcpu)
+        {
+            if (!CPU_ISSET(xcpu, &xcpus) || (0 != xnth--))
+            {
+                continue;
+            }
+
+            cpu_set_t xset;
+            CPU_ZERO(&xset);
+            CPU_SET(xcpu, &xset);
+            return (0 == pthread_setaffinity_np(xthread.native_handle(), sizeof(xset), &xset)) ?
+                   xcpu : -1;
+        }
+#else // !defined(__linux__)
+        (void)xthread;
+        (void)xindex;
+#endif // defined(__linux__)
+
+        return -1;
+    }
+
+    // data members
+private:
+    x_hash_t                     m_xhash;     ///< 消息键的哈希函数
+    x_forwards_t                 m_xforwards; ///< 主分片上的转发者（须晚于分片析构）
+    std::vector< x_shard_ptr_t > m_xshards;   ///< 各个分片
+    bool                         m_xstarted;  ///< 是否已 start()
+    std::mutex                   m_xcontrol;  ///< 串行化投递线程之外的控制操作
+    mutable std::mutex           m_xregistry; ///< 保护 m_xowners/m_xsubers/m_xforwards
+    x_owners_t                   m_xowners;   ///< 已迁移的消息类型 -> 负责投递的分片
+    x_subers_t                   m_xsubers;   ///< 消息类型 -> 订阅者对象（用于迁移）
+};
+
+template< typename __publisher_t >
+constexpr size_t xmsg_sharded_publisher_t< __publisher_t >::XSHARD_NONE;
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __XMSG_SHARDED_PUBLISHER_H__
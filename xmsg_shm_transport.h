@@ -0,0 +1,878 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/**
+ * @file xmsg_shm_transport.h
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * @author  ：Gaaagaa
+ * @date    : 2026-10-18
+ * @version : 1.0.0.0
+ * @brief   : 基于共享内存环形缓冲区的跨进程消息传输（仅支持 Linux）。
+ */
+
+#ifndef __XMSG_SHM_TRANSPORT_H__
+#define __XMSG_SHM_TRANSPORT_H__
+
+#if !defined(__linux__)
+#error "xmsg_shm_transport.h requires Linux (shm_open/memfd_create/futex)."
+#endif // !defined(__linux__)
+
+#include "xmsg_pubsub.h"
+
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <climits>
+#include <cassert>
+#include <type_traits>
+#include <system_error>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <ctime>
+#include <cerrno>
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_shm_ring_t
+
+/**
+ * @class xmsg_shm_ring_t
+ * @brief 映射在共享内存中的 单生产者/单消费者（SPSC）字节环形缓冲区。
+ * @note
+ * 1. 共享内存可以是具名的（shm_open，其他进程通过 open() 打开），
+ *    也可以是匿名的（memfd_create，通过 fork() 继承 或 SCM_RIGHTS 传递 fd()，
+ *    再由 attach() 映射）；
+ * 2. 每条记录由 8 字节的记录头（负载字节数 + 标识）与 负载数据 组成，
+ *    按 8 字节对齐连续存放；环尾剩余空间不足以存放整条记录时，
+ *    写入一条填充记录后从环首开始写入，因此记录的负载总是连续的；
+ * 3. 每个环形缓冲区只能有一个写入进程（线程）与一个读取进程（线程），
+ *    多个发布进程应各自使用独立的环形缓冲区；
+ * 4. 读取端可通过 wait_for() 阻塞等待（futex），写入端只有在读取端
+ *    处于等待状态时才会执行 futex 唤醒系统调用，且每次等待只唤醒一次
+ *    （读取端被调度运行之前，后续的写入不再重复唤醒）。
+ */
+class xmsg_shm_ring_t
+{
+    // common data types
+public:
+    /** 记录的对齐字节数 */
+    static constexpr size_t   XALIGN        = 8;
+    /** 环形缓冲区的最小容量（字节数） */
+    static constexpr size_t   XMIN_CAPACITY = 4096;
+    /** 共享内存头部的标识 */
+    static constexpr uint32_t XMAGIC        = 0x584D5352; // "XMSR"
+    /** 共享内存布局的版本号 */
+    static constexpr uint32_t XVERSION      = 1;
+
+private:
+    /**
+     * @struct x_header_t
+     * @brief 共享内存的头部（写入端 与 读取端 的数据成员位于不同的缓存行）。
+     */
+    struct x_header_t
+    {
+        uint32_t                xmagic;    ///< 共享内存头部的标识
+        uint32_t                xversion;  ///< 共享内存布局的版本号
+        uint64_t                xcapacity; ///< 环形缓冲区的容量（2 的幂）
+
+        alignas(64)
+        std::atomic< uint64_t > xhead;     ///< 写入位置（只增不减，由写入端修改）
+
+        alignas(64)
+        std::atomic< uint64_t > xtail;     ///< 读取位置（只增不减，由读取端修改）
+
+        alignas(64)
+        std::atomic< uint32_t > xseq;      ///< futex 等待字（写入端唤醒时递增）
+        std::atomic< uint32_t > xparked;   ///< 读取端是否处于等待状态
+    };
+
+    /**
+     * @struct x_record_t
+     * @brief 记录头。
+     */
+    struct x_record_t
+    {
+        uint32_t xsize;  ///< 负载字节数
+        uint32_t xflags; ///< 记录标识（XFLAG_PAD 表示环尾的填充记录）
+    };
+
+    static constexpr uint32_t XFLAG_PAD = 0x00000001;
+
+    static_assert(sizeof(x_record_t) == XALIGN, "sizeof(x_record_t) == XALIGN");
+    static_assert(2 == ATOMIC_LLONG_LOCK_FREE,
+                  "Lock-free (address-free) 64-bit atomics are required in shared memory!");
+
+    // constructor/destructor
+public:
+    xmsg_shm_ring_t(void)
+        : m_xfd(-1)
+        , m_xheader(nullptr)
+        , m_xbuffer(nullptr)
+        , m_xcapacity(0)
+        , m_xmsize(0)
+        , m_xhead_cache(0)
+        , m_xtail_cache(0)
+    {
+
+    }
+
+    ~xmsg_shm_ring_t(void)
+    {
+        close();
+    }
+
+    xmsg_shm_ring_t(xmsg_shm_ring_t && xobject) = delete;
+    xmsg_shm_ring_t & operator=(xmsg_shm_ring_t && xobject) = delete;
+    xmsg_shm_ring_t(const xmsg_shm_ring_t & xobject) = delete;
+    xmsg_shm_ring_t & operator=(const xmsg_shm_ring_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 创建环形缓冲区（失败时抛出 std::system_error 异常）。
+     * 
+     * @param [in ] xname     : 共享内存名称（如 "/xmsg_quotes"，须以 '/' 开头）；
+     *                          为 nullptr 时使用匿名的 memfd 。
+     * @param [in ] xcapacity : 环形缓冲区的容量（向上取整为 2 的幂）。
+     */
+    void create(const char * xname, size_t xcapacity)
+    {
+        close();
+
+        size_t xpow2 = XMIN_CAPACITY;
+        while (xpow2 < xcapacity)
+            xpow2 <<= 1;
+
+        int xfd = (nullptr != xname)
+                ? ::shm_open(xname, O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600)
+                : ::memfd_create("xmsg_shm_ring", MFD_CLOEXEC);
+        if (xfd < 0)
+        {
+            throw std::system_error(errno, std::system_category(), "shm_open()");
+        }
+
+        const size_t xmsize = sizeof(x_header_t) + xpow2;
+        if (0 != ::ftruncate(xfd, static_cast< off_t >(xmsize)))
+        {
+            int xerrno = errno;
+            ::close(xfd);
+            if (nullptr != xname)
+                ::shm_unlink(xname);
+            throw std::system_error(xerrno, std::system_category(), "ftruncate()");
+        }
+
+        map(xfd, xmsize);
+
+        x_header_t * xheader = new (m_xheader) x_header_t();
+        xheader->xcapacity = xpow2;
+        xheader->xhead.store(0, std::memory_order_relaxed);
+        xheader->xtail.store(0, std::memory_order_relaxed);
+        xheader->xseq.store(0, std::memory_order_relaxed);
+        xheader->xparked.store(0, std::memory_order_relaxed);
+        xheader->xversion = XVERSION;
+        std::atomic_thread_fence(std::memory_order_release);
+        xheader->xmagic = XMAGIC;
+
+        m_xcapacity = xpow2;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 打开其他进程创建的具名环形缓冲区（失败时抛出 std::system_error 异常）。
+     */
+    void open(const char * xname)
+    {
+        close();
+
+        int xfd = ::shm_open(xname, O_RDWR | O_CLOEXEC, 0600);
+        if (xfd < 0)
+        {
+            throw std::system_error(errno, std::system_category(), "shm_open()");
+        }
+
+        attach_fd(xfd);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 映射由其他进程传递过来的共享内存文件描述符
+     *        （内部复制 xfd ，调用方仍需自行关闭 xfd）。
+     */
+    void attach(int xfd)
+    {
+        close();
+
+        int xdup = ::fcntl(xfd, F_DUPFD_CLOEXEC, 0);
+        if (xdup < 0)
+        {
+            throw std::system_error(errno, std::system_category(), "fcntl()");
+        }
+
+        attach_fd(xdup);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 删除具名的共享内存（已映射的进程不受影响）。
+     */
+    static void unlink(const char * xname)
+    {
+        ::shm_unlink(xname);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 解除映射并关闭共享内存。
+     */
+    void close(void)
+    {
+        if (nullptr != m_xheader)
+        {
+            ::munmap(static_cast< void * >(m_xheader), m_xmsize);
+            m_xheader = nullptr;
+            m_xbuffer = nullptr;
+        }
+
+        if (m_xfd >= 0)
+        {
+            ::close(m_xfd);
+            m_xfd = -1;
+        }
+
+        m_xcapacity   = 0;
+        m_xmsize      = 0;
+        m_xhead_cache = 0;
+        m_xtail_cache = 0;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 是否已映射共享内存。
+     */
+    inline bool is_open(void) const
+    {
+        return (nullptr != m_xheader);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 共享内存的文件描述符（用于 fork() 或 SCM_RIGHTS 传递）。
+     */
+    inline int fd(void) const
+    {
+        return m_xfd;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 环形缓冲区的容量（字节数）。
+     */
+    inline size_t capacity(void) const
+    {
+        return m_xcapacity;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 环形缓冲区中未读取的字节数（含记录头，并发时为近似值）。
+     */
+    inline size_t size(void) const
+    {
+        return static_cast< size_t >(
+                    m_xheader->xhead.load(std::memory_order_acquire) -
+                    m_xheader->xtail.load(std::memory_order_acquire));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 判断环形缓冲区是否为空（仅在读取端调用时结果才是准确的）。
+     */
+    inline bool empty(void) const
+    {
+        return (m_xheader->xtail.load(std::memory_order_relaxed) ==
+                m_xheader->xhead.load(std::memory_order_acquire));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 写入一条记录（仅限写入端调用）。
+     * 
+     * @param [in ] xsize : 负载字节数。
+     * @param [in ] xfill : 负载的填充操作：void xfill(void * xdst) 。
+     * 
+     * @return bool : 剩余空间不足时返回 false 。
+     */
+    template< typename __fill_t >
+    bool write(size_t xsize, __fill_t && xfill)
+    {
+        assert(nullptr != m_xheader);
+
+        const uint64_t xrsize = record_size(xsize);
+        if (xrsize > m_xcapacity)
+        {
+            return false;
+        }
+
+        uint64_t xhead   = m_xheader->xhead.load(std::memory_order_relaxed);
+        uint64_t xoffset = xhead & (m_xcapacity - 1);
+        uint64_t xpad    = (xoffset + xrsize > m_xcapacity) ? (m_xcapacity - xoffset) : 0;
+
+        if (xhead + xpad + xrsize - m_xtail_cache > m_xcapacity)
+        {
+            m_xtail_cache = m_xheader->xtail.load(std::memory_order_acquire);
+            if (xhead + xpad + xrsize - m_xtail_cache > m_xcapacity)
+            {
+                return false;
+            }
+        }
+
+        if (0 != xpad)
+        {
+            x_record_t * xrecord = record_at(xoffset);
+            xrecord->xsize  = 0;
+            xrecord->xflags = XFLAG_PAD;
+            xhead  += xpad;
+            xoffset = 0;
+        }
+
+        x_record_t * xrecord = record_at(xoffset);
+        xrecord->xsize  = static_cast< uint32_t >(xsize);
+        xrecord->xflags = 0;
+        xfill(static_cast< void * >(xrecord + 1));
+
+        m_xheader->xhead.store(xhead + xrsize, std::memory_order_release);
+        notify();
+        return true;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 读取记录（仅限读取端调用）。
+     * 
+     * @param [in ] xfunc : 记录的处理操作：void xfunc(const void * xdata, size_t xsize) ，
+     *                      返回后记录所占用的空间即被回收。
+     * @param [in ] xmax  : 最多读取的记录数量。
+     * 
+     * @return size_t : 读取的记录数量。
+     */
+    template< typename __func_t >
+    size_t read(__func_t && xfunc, size_t xmax = SIZE_MAX)
+    {
+        assert(nullptr != m_xheader);
+
+        uint64_t xtail  = m_xheader->xtail.load(std::memory_order_relaxed);
+        size_t   xcount = 0;
+
+        while (xcount < xmax)
+        {
+            if (xtail == m_xhead_cache)
+            {
+                m_xhead_cache = m_xheader->xhead.load(std::memory_order_acquire);
+                if (xtail == m_xhead_cache)
+                    break;
+            }
+
+            const uint64_t xoffset = xtail & (m_xcapacity - 1);
+            const x_record_t * xrecord = record_at(xoffset);
+            if (0 != (xrecord->xflags & XFLAG_PAD))
+            {
+                xtail += m_xcapacity - xoffset;
+                m_xheader->xtail.store(xtail, std::memory_order_release);
+                continue;
+            }
+
+            xfunc(static_cast< const void * >(xrecord + 1),
+                  static_cast< size_t >(xrecord->xsize));
+
+            xtail += record_size(xrecord->xsize);
+            m_xheader->xtail.store(xtail, std::memory_order_release);
+            xcount += 1;
+        }
+
+        return xcount;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 读取端阻塞等待，直到环形缓冲区不为空（futex）。
+     * 
+     * @param [in ] xtimeout : 最长等待时间（负值表示一直等待）。
+     * 
+     * @return bool : 环形缓冲区是否不为空（否则为超时 或 被信号中断）。
+     */
+    bool wait_for(std::chrono::nanoseconds xtimeout)
+    {
+        assert(nullptr != m_xheader);
+
+        if (!empty())
+        {
+            return true;
+        }
+
+        // 与 notify() 中的屏障配对：要么读取端看到新的记录，
+        // 要么写入端看到读取端的等待标识
+        m_xheader->xparked.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        const uint32_t xseq = m_xheader->xseq.load(std::memory_order_acquire);
+        bool xready = !empty();
+        if (!xready)
+        {
+            struct timespec xtspec;
+            struct timespec * xptspec = nullptr;
+            if (xtimeout.count() >= 0)
+            {
+                xtspec.tv_sec  = static_cast< time_t >(xtimeout.count() / 1000000000);
+                xtspec.tv_nsec = static_cast< long   >(xtimeout.count() % 1000000000);
+                xptspec = &xtspec;
+            }
+
+            ::syscall(SYS_futex, futex_word(), FUTEX_WAIT, xseq, xptspec, nullptr, 0);
+            xready = !empty();
+        }
+
+        m_xheader->xparked.store(0, std::memory_order_relaxed);
+        return xready;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 唤醒处于等待状态的读取端（write() 内部已调用）。
+     */
+    inline void notify(void)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if ((0 != m_xheader->xparked.load(std::memory_order_relaxed)) &&
+            (0 != m_xheader->xparked.exchange(0, std::memory_order_acq_rel)))
+        {
+            m_xheader->xseq.fetch_add(1, std::memory_order_seq_cst);
+            ::syscall(SYS_futex, futex_word(), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+        }
+    }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 映射共享内存（失败时关闭 xfd 并抛出 std::system_error 异常）。
+     */
+    void map(int xfd, size_t xmsize)
+    {
+        void * xaddr = ::mmap(nullptr, xmsize, PROT_READ | PROT_WRITE, MAP_SHARED, xfd, 0);
+        if (MAP_FAILED == xaddr)
+        {
+            int xerrno = errno;
+            ::close(xfd);
+            throw std::system_error(xerrno, std::system_category(), "mmap()");
+        }
+
+        m_xfd     = xfd;
+        m_xmsize  = xmsize;
+        m_xheader = static_cast< x_header_t * >(xaddr);
+        m_xbuffer = static_cast< char * >(xaddr) + sizeof(x_header_t);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 映射已创建的共享内存，并校验其头部。
+     */
+    void attach_fd(int xfd)
+    {
+        struct stat xstat;
+        if (0 != ::fstat(xfd, &xstat))
+        {
+            int xerrno = errno;
+            ::close(xfd);
+            throw std::system_error(xerrno, std::system_category(), "fstat()");
+        }
+
+        if (static_cast< size_t >(xstat.st_size) < sizeof(x_header_t) + XMIN_CAPACITY)
+        {
+            ::close(xfd);
+            throw std::system_error(EINVAL, std::system_category(), "xmsg_shm_ring_t::attach()");
+        }
+
+        map(xfd, static_cast< size_t >(xstat.st_size));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((XMAGIC != m_xheader->xmagic) ||
+            (XVERSION != m_xheader->xversion) ||
+            (sizeof(x_header_t) + m_xheader->xcapacity != m_xmsize))
+        {
+            close();
+            throw std::system_error(EINVAL, std::system_category(), "xmsg_shm_ring_t::attach()");
+        }
+
+        m_xcapacity   = static_cast< size_t >(m_xheader->xcapacity);
+        m_xhead_cache = m_xheader->xhead.load(std::memory_order_acquire);
+        m_xtail_cache = m_xheader->xtail.load(std::memory_order_acquire);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 负载字节数为 xsize 的记录所占用的字节数（含记录头）。
+     */
+    static inline uint64_t record_size(size_t xsize)
+    {
+        return (sizeof(x_record_t) + xsize + XALIGN - 1) & ~static_cast< uint64_t >(XALIGN - 1);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 环形缓冲区中偏移量为 xoffset 的记录头。
+     */
+    inline x_record_t * record_at(uint64_t xoffset) const
+    {
+        return reinterpret_cast< x_record_t * >(m_xbuffer + xoffset);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief futex 系统调用使用的等待字地址。
+     */
+    inline uint32_t * futex_word(void) const
+    {
+        return reinterpret_cast< uint32_t * >(&m_xheader->xseq);
+    }
+
+    // data members
+private:
+    int          m_xfd;         ///< 共享内存的文件描述符
+    x_header_t * m_xheader;     ///< 共享内存的头部
+    char       * m_xbuffer;     ///< 环形缓冲区的数据区
+    size_t       m_xcapacity;   ///< 环形缓冲区的容量
+    size_t       m_xmsize;      ///< 映射的字节数
+    uint64_t     m_xhead_cache; ///< 读取端缓存的写入位置（减少对写入端缓存行的访问）
+    uint64_t     m_xtail_cache; ///< 写入端缓存的读取位置（减少对读取端缓存行的访问）
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_shm_codec_t
+
+/**
+ * @struct xmsg_shm_codec_t< __msg_context_t >
+ * @brief 消息对象（消息键 + 参数列表）与 环形缓冲区记录负载 之间的编解码：
+ *        各字段依次紧凑存放（使用 memcpy ，不要求对齐）。
+ * @note 消息键 与 各个参数 均须为可平凡复制（trivially copyable）的类型。
+ */
+template< typename __msg_context_t >
+struct xmsg_shm_codec_t
+{
+    using x_msgctxt_t = __msg_context_t;
+    using x_mkey_t    = typename x_msgctxt_t::x_mkey_t;
+    using x_args_t    = typename x_msgctxt_t::x_args_t;
+    using x_index_t   = typename xbuild_index_sequence_t<
+                                    std::tuple_size< x_args_t >::value >::type;
+
+    /**********************************************************/
+    /**
+     * @brief 参数列表中各参数的字节数之和（并校验各参数类型）。
+     */
+    template< typename... __types_t >
+    struct x_bytes_t;
+
+    template< typename... __types_t >
+    struct x_bytes_t< std::tuple< __types_t... > >
+    {
+        static constexpr size_t value = 0;
+    };
+
+    template< typename __first_t, typename... __types_t >
+    struct x_bytes_t< std::tuple< __first_t, __types_t... > >
+    {
+        static_assert(std::is_trivially_copyable< __first_t >::value,
+                      "The message arguments must be trivially copyable!");
+        static constexpr size_t value =
+            sizeof(__first_t) + x_bytes_t< std::tuple< __types_t... > >::value;
+    };
+
+    static_assert(std::is_trivially_copyable< x_mkey_t >::value,
+                  "The message key must be trivially copyable!");
+
+    /** 记录负载的字节数 */
+    static constexpr size_t XSIZE = sizeof(x_mkey_t) + x_bytes_t< x_args_t >::value;
+
+    /**********************************************************/
+    /**
+     * @brief 将消息编码到 xdst 中（xdst 至少有 XSIZE 个字节）。
+     */
+    static void store(void * xdst, const x_mkey_t & xmkey, const x_args_t & xargs)
+    {
+        char * xptr = static_cast< char * >(xdst);
+        std::memcpy(xptr, &xmkey, sizeof(x_mkey_t));
+        xptr += sizeof(x_mkey_t);
+        store_args(xptr, xargs, x_index_t());
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 从 xsrc 中解码消息对象。
+     */
+    static x_msgctxt_t load(const void * xsrc)
+    {
+        const char * xptr = static_cast< const char * >(xsrc);
+        x_mkey_t xmkey;
+        std::memcpy(&xmkey, xptr, sizeof(x_mkey_t));
+        xptr += sizeof(x_mkey_t);
+
+        x_args_t xargs;
+        load_args(xptr, xargs, x_index_t());
+        return x_msgctxt_t(xmkey, std::move(xargs));
+    }
+
+private:
+    template< size_t... __indexes >
+    static inline void store_args(char * xptr,
+                                  const x_args_t & xargs,
+                                  xindex_sequence_t< __indexes... >)
+    {
+        int xexpand[] =
+        {
+            0,
+            (std::memcpy(xptr, &std::get< __indexes >(xargs),
+                         sizeof(typename std::tuple_element< __indexes, x_args_t >::type)),
+             xptr += sizeof(typename std::tuple_element< __indexes, x_args_t >::type),
+             0)...
+        };
+        (void)xexpand;
+        (void)xptr;
+    }
+
+    template< size_t... __indexes >
+    static inline void load_args(const char * xptr,
+                                 x_args_t & xargs,
+                                 xindex_sequence_t< __indexes... >)
+    {
+        int xexpand[] =
+        {
+            0,
+            (std::memcpy(&std::get< __indexes >(xargs), xptr,
+                         sizeof(typename std::tuple_element< __indexes, x_args_t >::type)),
+             xptr += sizeof(typename std::tuple_element< __indexes, x_args_t >::type),
+             0)...
+        };
+        (void)xexpand;
+        (void)xptr;
+    }
+};
+
+template< typename __msg_context_t >
+constexpr size_t xmsg_shm_codec_t< __msg_context_t >::XSIZE;
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_shm_publisher_t
+
+/**
+ * @class xmsg_shm_publisher_t< __msg_context_t >
+ * @brief 跨进程消息的发布端：将消息编码后写入共享内存环形缓冲区。
+ * @note
+ * 发布端不维护订阅者：消息由读取进程中的 xmsg_shm_receiver_t
+ * 转发给本地的 xmsg_publisher_t ，再由其投递给订阅者。
+ * 
+ * @param [in ] __msg_context_t : 消息类型（与读取进程的 xmsg_publisher_t 一致）。
+ */
+template< typename __msg_context_t >
+class xmsg_shm_publisher_t
+{
+    // common data types
+public:
+    using x_msgctxt_t = __msg_context_t;
+    using x_codec_t   = xmsg_shm_codec_t< x_msgctxt_t >;
+    using x_mkey_t    = typename x_codec_t::x_mkey_t;
+    using x_args_t    = typename x_codec_t::x_args_t;
+
+    // constructor/destructor
+public:
+    xmsg_shm_publisher_t(void)
+    {
+
+    }
+
+    ~xmsg_shm_publisher_t(void)
+    {
+
+    }
+
+    xmsg_shm_publisher_t(xmsg_shm_publisher_t && xobject) = delete;
+    xmsg_shm_publisher_t & operator=(xmsg_shm_publisher_t && xobject) = delete;
+    xmsg_shm_publisher_t(const xmsg_shm_publisher_t & xobject) = delete;
+    xmsg_shm_publisher_t & operator=(const xmsg_shm_publisher_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 写入消息的共享内存环形缓冲区（调用 create()/open()/attach() 打开）。
+     */
+    inline xmsg_shm_ring_t & ring(void)
+    {
+        return m_xring;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 发布消息（写入环形缓冲区）。
+     * 
+     * @return bool : 环形缓冲区已满（读取进程处理不及时）时返回 false 。
+     */
+    template< typename... __vargs_t >
+    bool publish(const x_mkey_t & xmkey, __vargs_t &&... xargs)
+    {
+        const x_args_t xtuple(std::forward< __vargs_t >(xargs)...);
+        return m_xring.write(x_codec_t::XSIZE,
+                             [&xmkey, &xtuple](void * xdst)
+                             {
+                                 x_codec_t::store(xdst, xmkey, xtuple);
+                             });
+    }
+
+    // data members
+private:
+    xmsg_shm_ring_t m_xring; ///< 共享内存环形缓冲区
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_shm_receiver_t
+
+/**
+ * @class xmsg_shm_receiver_t< __publisher_t >
+ * @brief 跨进程消息的接收端：从共享内存环形缓冲区中读取消息，
+ *        并发布到本地的 xmsg_publisher_t（订阅者的用法不变）。
+ * @note
+ * receive() 只将消息放入本地发布者的消息队列，
+ * 投递仍由本地发布者的 dispatch() 完成。
+ * 
+ * @param [in ] __publisher_t : 本地的发布者类型（xmsg_publisher_t）。
+ */
+template< typename __publisher_t >
+class xmsg_shm_receiver_t
+{
+    // common data types
+public:
+    using x_publisher_t = __publisher_t;
+    using x_msgctxt_t   = typename x_publisher_t::x_msgctxt_t;
+    using x_codec_t     = xmsg_shm_codec_t< x_msgctxt_t >;
+
+    // constructor/destructor
+public:
+    explicit xmsg_shm_receiver_t(x_publisher_t & xpublisher)
+        : m_xpublisher(xpublisher)
+        , m_xdropped(0)
+    {
+
+    }
+
+    ~xmsg_shm_receiver_t(void)
+    {
+
+    }
+
+    xmsg_shm_receiver_t(xmsg_shm_receiver_t && xobject) = delete;
+    xmsg_shm_receiver_t & operator=(xmsg_shm_receiver_t && xobject) = delete;
+    xmsg_shm_receiver_t(const xmsg_shm_receiver_t & xobject) = delete;
+    xmsg_shm_receiver_t & operator=(const xmsg_shm_receiver_t & xobject) = delete;
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 读取消息的共享内存环形缓冲区（调用 create()/open()/attach() 打开）。
+     */
+    inline xmsg_shm_ring_t & ring(void)
+    {
+        return m_xring;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 本地的发布者。
+     */
+    inline x_publisher_t & publisher(void)
+    {
+        return m_xpublisher;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 负载长度不匹配（发布端的消息类型不一致）而被丢弃的记录数量。
+     */
+    inline size_t dropped(void) const
+    {
+        return m_xdropped;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将环形缓冲区中的消息发布到本地的发布者。
+     * 
+     * @param [in ] xmax : 最多读取的消息数量。
+     * 
+     * @return size_t : 读取的消息数量。
+     */
+    size_t receive(size_t xmax = SIZE_MAX)
+    {
+        return m_xring.read(
+            [this](const void * xdata, size_t xsize)
+            {
+                if (x_codec_t::XSIZE != xsize)
+                {
+                    m_xdropped += 1;
+                    return;
+                }
+
+                m_xpublisher.publish(x_codec_t::load(xdata));
+            },
+            xmax);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 阻塞等待，直到环形缓冲区中有新的消息（futex）。
+     * 
+     * @param [in ] xtimeout : 最长等待时间（负值表示一直等待）。
+     * 
+     * @return bool : 是否有新的消息（否则为超时）。
+     */
+    inline bool wait_for(std::chrono::nanoseconds xtimeout)
+    {
+        return m_xring.wait_for(xtimeout);
+    }
+
+    // data members
+private:
+    xmsg_shm_ring_t m_xring;      ///< 共享内存环形缓冲区
+    x_publisher_t & m_xpublisher; ///< 本地的发布者
+    size_t          m_xdropped;   ///< 被丢弃的记录数量
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __XMSG_SHM_TRANSPORT_H__
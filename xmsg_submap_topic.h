@@ -0,0 +1,561 @@
+﻿/**
+ * The MIT License (MIT)
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file xmsg_submap_topic.h
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * @author  ：Gaaagaa
+ * @date    : 2026-10-18
+ * @version : 1.0.0.0
+ * @brief   : 支持通配符主题匹配（字典树索引）的消息订阅者映射表。
+ */
+
+#ifndef __XMSG_SUBMAP_TOPIC_H__
+#define __XMSG_SUBMAP_TOPIC_H__
+
+#include "xmsg_pubsub.h"
+
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+// xmsg_submap_topic_t
+
+/**
+ * @brief 主题匹配结果缓存的最大条目数量（超出时整体清空后重新缓存）。
+ */
+#ifndef XMSG_TOPIC_CACHE_MAX
+#define XMSG_TOPIC_CACHE_MAX 4096
+#endif // XMSG_TOPIC_CACHE_MAX
+
+/**
+ * @class xmsg_submap_topic_t< __key_t, __value_t, __hash_t, __equal_t >
+ * @brief 支持通配符主题匹配的消息订阅者映射表（键类型为 std::string）。
+ * @note
+ * 1. 作为 xmsg_publisher_t 的 __submap_t 模板参数使用：
+ *    主题以 '.' 分隔为若干段，订阅时的键可以为通配模式：
+ *    "*" 段匹配任意的一段，"#" 段匹配零个或多个段（通常用于末尾，如 "a.#"）；
+ *    发布的消息键为具体的主题，投递时将依次投递到 与之相同的键 以及
+ *    所有与之匹配的通配模式 的订阅者集合；
+ * 2. 通配模式以字典树索引（每段一个节点），只在查找缓存未命中时才遍历；
+ *    每个具体主题的匹配结果（订阅者集合的指针数组）会被缓存，
+ *    重复发布同一主题时，只需一次哈希查找（与精确查找的开销相同）；
+ *    没有任何通配模式时，直接按键值精确查找；
+ * 3. 订阅者集合 的增删会使匹配结果缓存失效；在 match() 的回调过程中，
+ *    erase() 操作被延迟到回调结束后才执行（且仅当该集合仍为空时），
+ *    缓存的清理也随之延迟，因此回调中可以安全地 取消订阅/删除集合；
+ * 4. 值类型（订阅者集合）须提供 empty() 接口。
+ * 
+ * @param [in ] __key_t   : 键类型（std::string）。
+ * @param [in ] __value_t : 值类型。
+ * @param [in ] __hash_t  : 计算哈希值的仿函数类型。
+ * @param [in ] __equal_t : 判断键相等的仿函数类型。
+ */
+template< typename __key_t,
+          typename __value_t,
+          typename __hash_t  = std::hash< __key_t >,
+          typename __equal_t = std::equal_to< __key_t > >
+class xmsg_submap_topic_t
+{
+    // common data types
+public:
+    /** 标识支持主题匹配（见 xmsg_submap_match_t） */
+    using x_match_tag_t = void;
+
+    using x_map_t        = std::unordered_map< __key_t, __value_t, __hash_t, __equal_t >;
+    using key_type       = typename x_map_t::key_type;
+    using mapped_type    = typename x_map_t::mapped_type;
+    using value_type     = typename x_map_t::value_type;
+    using iterator       = typename x_map_t::iterator;
+    using const_iterator = typename x_map_t::const_iterator;
+
+private:
+    /** 主题段的分隔符 */
+    static constexpr char XTOPIC_SEPARATOR = '.';
+
+    using x_entries_t = std::vector< value_type * >;
+    using x_erase_t   = std::pair< key_type, bool >; ///< 延迟删除的 { 键值, 是否强制删除 }
+    using x_cache_t   = std::unordered_map< __key_t, x_entries_t, __hash_t, __equal_t >;
+
+    /**
+     * @struct x_node_t
+     * @brief 通配模式字典树的节点。
+     */
+    struct x_node_t
+    {
+        std::unordered_map< __key_t, std::unique_ptr< x_node_t > >
+                                    xchildren; ///< 普通段的子节点
+        std::unique_ptr< x_node_t > xstar;     ///< "*" 段的子节点
+        std::unique_ptr< x_node_t > xhash;     ///< "#" 段的子节点
+        value_type                * xentry;    ///< 以该节点结尾的通配模式
+
+        x_node_t(void) : xentry(nullptr) { }
+
+        inline bool empty(void) const
+        {
+            return ((nullptr == xentry) && xchildren.empty() && !xstar && !xhash);
+        }
+    };
+
+    // constructor/destructor
+public:
+    xmsg_submap_topic_t(void)
+        : m_xroot(new x_node_t())
+        , m_xpatterns(0)
+        , m_xdepth(0)
+        , m_xstale(false)
+    {
+
+    }
+
+    ~xmsg_submap_topic_t(void)
+    {
+
+    }
+
+    xmsg_submap_topic_t(xmsg_submap_topic_t && xobject) = delete;
+    xmsg_submap_topic_t & operator=(xmsg_submap_topic_t && xobject) = delete;
+    xmsg_submap_topic_t(const xmsg_submap_topic_t & xobject) = delete;
+    xmsg_submap_topic_t & operator=(const xmsg_submap_topic_t & xobject) = delete;
+
+    // public interfaces
+public:
+    inline size_t size(void) const { return m_xmap.size(); }
+    inline bool empty(void) const { return m_xmap.empty(); }
+    inline iterator begin(void) { return m_xmap.begin(); }
+    inline iterator end(void) { return m_xmap.end(); }
+
+    /**********************************************************/
+    /**
+     * @brief 按键值精确查找。
+     */
+    inline iterator find(const key_type & xkey)
+    {
+        return m_xmap.find(xkey);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 返回键值对应的值，不存在时插入默认构造的值。
+     */
+    mapped_type & operator[](const key_type & xkey)
+    {
+        iterator itfind = m_xmap.find(xkey);
+        if (itfind != m_xmap.end())
+        {
+            if (m_xdepth > 0)
+            {
+                cancel_erase(itfind);
+            }
+
+            return itfind->second;
+        }
+
+        value_type & xentry = *m_xmap.emplace(xkey, mapped_type()).first;
+
+        if (is_pattern(xkey))
+        {
+            trie_insert(xkey, &xentry);
+            m_xpatterns += 1;
+            invalidate_all();
+        }
+        else
+        {
+            invalidate(xkey);
+        }
+
+        return xentry.second;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 删除键值（match() 的回调过程中，延迟到回调结束后执行）。
+     */
+    void erase(const key_type & xkey)
+    {
+        iterator itfind = m_xmap.find(xkey);
+        if (itfind != m_xmap.end())
+        {
+            erase(itfind);
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 删除迭代器所指的元素（match() 的回调过程中，延迟到回调结束后执行）。
+     */
+    void erase(iterator itpos)
+    {
+        if (m_xdepth > 0)
+        {
+            // 删除 非空 的集合（如 取消某个键的所有订阅者）时，须强制删除
+            m_xerases.push_back(x_erase_t(itpos->first, !itpos->second.empty()));
+            return;
+        }
+
+        erase_entry(itpos);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 对与具体主题 xtopic 匹配的每个元素，调用 xfunc(键, 值) 。
+     */
+    template< typename __func_t >
+    void match(const key_type & xtopic, __func_t && xfunc)
+    {
+        if (0 == m_xpatterns)
+        {
+            // 没有通配模式时，直接精确查找
+            iterator itfind = m_xmap.find(xtopic);
+            if (itfind != m_xmap.end())
+            {
+                m_xdepth += 1;
+                xfunc(itfind->first, itfind->second);
+                leave_match();
+            }
+
+            return;
+        }
+
+        // 只在最外层调用时才整体清空缓存（内层调用时，外层仍在遍历缓存的数组）
+        if ((0 == m_xdepth) && (m_xcache.size() >= XMSG_TOPIC_CACHE_MAX))
+        {
+            m_xcache.clear();
+        }
+
+        const x_entries_t & xentries = lookup(xtopic);
+
+        m_xdepth += 1;
+        for (value_type * xentry : xentries)
+        {
+            xfunc(xentry->first, xentry->second);
+        }
+        leave_match();
+    }
+
+    // inner invoking
+private:
+    /**********************************************************/
+    /**
+     * @brief 判断键值是否为通配模式（含有 "*" 或 "#" 段）。
+     */
+    static bool is_pattern(const key_type & xkey)
+    {
+        size_t xbeg = 0;
+        for (;;)
+        {
+            size_t xend = xkey.find(XTOPIC_SEPARATOR, xbeg);
+            if (xend == key_type::npos)
+            {
+                xend = xkey.size();
+            }
+
+            if (((xend - xbeg) == 1) &&
+                (('*' == xkey[xbeg]) || ('#' == xkey[xbeg])))
+            {
+                return true;
+            }
+
+            if (xend == xkey.size())
+            {
+                break;
+            }
+
+            xbeg = xend + 1;
+        }
+
+        return false;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将主题（或通配模式）按分隔符拆分为若干段。
+     */
+    static void split(const key_type & xkey, std::vector< key_type > & xsegs)
+    {
+        size_t xbeg = 0;
+        for (;;)
+        {
+            size_t xend = xkey.find(XTOPIC_SEPARATOR, xbeg);
+            if (xend == key_type::npos)
+            {
+                xsegs.push_back(xkey.substr(xbeg));
+                break;
+            }
+
+            xsegs.push_back(xkey.substr(xbeg, xend - xbeg));
+            xbeg = xend + 1;
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 判断段是否为指定的通配符。
+     */
+    static inline bool is_wildcard(const key_type & xseg, char xwildcard)
+    {
+        return ((1 == xseg.size()) && (xwildcard == xseg[0]));
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 查找（或计算并缓存）具体主题的匹配结果。
+     */
+    const x_entries_t & lookup(const key_type & xtopic)
+    {
+        typename x_cache_t::iterator itcache = m_xcache.find(xtopic);
+        if (itcache != m_xcache.end())
+        {
+            return itcache->second;
+        }
+
+        x_entries_t xentries;
+
+        iterator itfind = m_xmap.find(xtopic);
+        if (itfind != m_xmap.end())
+        {
+            xentries.push_back(&*itfind);
+        }
+
+        std::vector< key_type > xsegs;
+        split(xtopic, xsegs);
+        trie_match(m_xroot.get(), xsegs, 0, xentries);
+
+        return m_xcache.emplace(xtopic, std::move(xentries)).first->second;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 在字典树中匹配 xsegs[xindex, ...) ，结果追加到 xentries（去重）。
+     */
+    static void trie_match(const x_node_t * xnode,
+                           const std::vector< key_type > & xsegs,
+                           size_t xindex,
+                           x_entries_t & xentries)
+    {
+        // "#" 匹配零个或多个段
+        if (xnode->xhash)
+        {
+            for (size_t xiter = xindex; xiter <= xsegs.size(); ++xiter)
+            {
+                trie_match(xnode->xhash.get(), xsegs, xiter, xentries);
+            }
+        }
+
+        if (xindex == xsegs.size())
+        {
+            if ((nullptr != xnode->xentry) &&
+                (std::find(xentries.begin(), xentries.end(), xnode->xentry) ==
+                 xentries.end()))
+            {
+                xentries.push_back(xnode->xentry);
+            }
+
+            return;
+        }
+
+        auto itchild = xnode->xchildren.find(xsegs[xindex]);
+        if (itchild != xnode->xchildren.end())
+        {
+            trie_match(itchild->second.get(), xsegs, xindex + 1, xentries);
+        }
+
+        if (xnode->xstar)
+        {
+            trie_match(xnode->xstar.get(), xsegs, xindex + 1, xentries);
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 将通配模式加入到字典树中。
+     */
+    void trie_insert(const key_type & xpattern, value_type * xentry)
+    {
+        std::vector< key_type > xsegs;
+        split(xpattern, xsegs);
+
+        x_node_t * xnode = m_xroot.get();
+        for (const key_type & xseg : xsegs)
+        {
+            std::unique_ptr< x_node_t > & xchild =
+                is_wildcard(xseg, '*') ? xnode->xstar :
+                is_wildcard(xseg, '#') ? xnode->xhash :
+                                         xnode->xchildren[xseg];
+            if (!xchild)
+            {
+                xchild.reset(new x_node_t());
+            }
+
+            xnode = xchild.get();
+        }
+
+        xnode->xentry = xentry;
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 从字典树中删除通配模式（同时回收不再使用的节点）。
+     * @return bool : xnode 是否已变为空节点。
+     */
+    static bool trie_erase(x_node_t * xnode,
+                           const std::vector< key_type > & xsegs,
+                           size_t xindex)
+    {
+        if (xindex == xsegs.size())
+        {
+            xnode->xentry = nullptr;
+            return xnode->empty();
+        }
+
+        const key_type & xseg = xsegs[xindex];
+        if (is_wildcard(xseg, '*') || is_wildcard(xseg, '#'))
+        {
+            std::unique_ptr< x_node_t > & xchild =
+                is_wildcard(xseg, '*') ? xnode->xstar : xnode->xhash;
+            if (xchild && trie_erase(xchild.get(), xsegs, xindex + 1))
+            {
+                xchild.reset();
+            }
+        }
+        else
+        {
+            auto itchild = xnode->xchildren.find(xseg);
+            if ((itchild != xnode->xchildren.end()) &&
+                trie_erase(itchild->second.get(), xsegs, xindex + 1))
+            {
+                xnode->xchildren.erase(itchild);
+            }
+        }
+
+        return xnode->empty();
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 删除元素（同时维护字典树与缓存）。
+     */
+    void erase_entry(iterator itpos)
+    {
+        if (is_pattern(itpos->first))
+        {
+            std::vector< key_type > xsegs;
+            split(itpos->first, xsegs);
+            trie_erase(m_xroot.get(), xsegs, 0);
+            m_xpatterns -= 1;
+            invalidate_all();
+        }
+        else
+        {
+            invalidate(itpos->first);
+        }
+
+        m_xmap.erase(itpos);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 退出 match() 的回调过程：执行延迟的 erase() 操作。
+     */
+    void leave_match(void)
+    {
+        if (--m_xdepth > 0)
+        {
+            return;
+        }
+
+        if (m_xstale)
+        {
+            m_xstale = false;
+            m_xcache.clear();
+        }
+
+        while (!m_xerases.empty())
+        {
+            x_erase_t xerase = std::move(m_xerases.back());
+            m_xerases.pop_back();
+
+            // 延迟期间，空集合可能又被重新订阅
+            iterator itfind = m_xmap.find(xerase.first);
+            if ((itfind != m_xmap.end()) &&
+                (xerase.second || itfind->second.empty()))
+            {
+                erase_entry(itfind);
+            }
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 回调过程中，重新使用延迟删除的集合（如 取消订阅后又重新订阅）：
+     *        强制删除 转为先清空集合，待回调结束时，仅当集合仍为空才删除。
+     */
+    void cancel_erase(iterator itpos)
+    {
+        for (x_erase_t & xerase : m_xerases)
+        {
+            if (xerase.second && (xerase.first == itpos->first))
+            {
+                itpos->second = mapped_type();
+                xerase.second = false;
+            }
+        }
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 具体主题 xtopic 的匹配结果失效。
+     */
+    inline void invalidate(const key_type & xtopic)
+    {
+        if (m_xdepth > 0)
+            m_xstale = true;
+        else
+            m_xcache.erase(xtopic);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 所有的匹配结果失效。
+     */
+    inline void invalidate_all(void)
+    {
+        if (m_xdepth > 0)
+            m_xstale = true;
+        else
+            m_xcache.clear();
+    }
+
+    // data members
+private:
+    x_map_t                     m_xmap;      ///< 键值 到 值 的映射表（含通配模式）
+    std::unique_ptr< x_node_t > m_xroot;     ///< 通配模式字典树的根节点
+    size_t                      m_xpatterns; ///< 通配模式的数量
+    x_cache_t                   m_xcache;    ///< 具体主题 的匹配结果缓存
+    size_t                      m_xdepth;    ///< match() 回调过程的嵌套深度
+    bool                        m_xstale;    ///< 回调过程中缓存是否已失效
+    std::vector< x_erase_t >    m_xerases;   ///< 回调过程中延迟删除的键值
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __XMSG_SUBMAP_TOPIC_H__